@@ -32,6 +32,7 @@
 import os
 import mmap
 import struct
+import array
 
 import AnimLiveBridge
 
@@ -61,12 +62,6 @@ g_JointProps = [] # model float properties
 global g_SharedData
 g_SharedData = AnimLiveBridge.SSharedModelData()
 
-global g_JointData
-g_JointData = AnimLiveBridge.SJointDataVector()
-
-global g_JointPropData
-g_JointPropData = AnimLiveBridge.SPropertyDataVector()
-
 # misc maya global data
 
 global g_Verbose
@@ -84,21 +79,16 @@ g_FPS = 30.0
    
 def track_models():
     
-    global g_JointData
-    
     q = OpenMaya.MQuaternion()
     q2 = OpenMaya.MQuaternion()
     scale_factor = 1.0
     
-    otr = AnimLiveBridge.SVector3()
-    oq = AnimLiveBridge.SVector4()
+    translations = array.array('f')
+    rotations = array.array('f')
     
-    # update joint transform
-
-    if len(g_Joints) != g_JointData.size():
-        g_JointData.resize(len(g_Joints))
+    # update joint transform, all joints go into a frame with one call
     
-    for index, obj in enumerate(g_Joints):
+    for obj in g_Joints:
 
         xformFn = OpenMaya.MFnTransform(obj)
         
@@ -112,25 +102,16 @@ def track_models():
             
             q = q * q2
         
-        (otr.m_X, otr.m_Y, otr.m_Z) = (scale_factor * v[0], scale_factor * v[1], scale_factor * v[2])
-        (oq.m_X, oq.m_Y, oq.m_Z, oq.m_W) = (q[0], q[1], q[2], q[3])
-        
-        g_JointData[index].m_Transform.m_Translation = otr
-        g_JointData[index].m_Transform.m_Rotation = oq
+        translations.extend((scale_factor * v[0], scale_factor * v[1], scale_factor * v[2]))
+        rotations.extend((q[0], q[1], q[2], q[3]))
 
-    AnimLiveBridge.SetModelDataJoints(g_SessionId, g_JointData)    
-    shared_data = AnimLiveBridge.MapModelData(g_SessionId)    
+    AnimLiveBridge.SetModelDataJointsBuffer(g_SessionId, 0, None, translations, rotations, None)
     
     # update joint properties
 
-    if len(g_JointProps) != g_JointPropData.size():
-        g_JointPropData.resize(len(g_JointProps))
-
-    for i, plug in enumerate(g_JointProps):
-        value = plug.asFloat()
-        g_JointPropData[i].m_Value = 0.01 * value
-        
-    AnimLiveBridge.SetModelDataProperties(g_SessionId, g_JointPropData)
+    if len(g_JointProps) > 0:
+        values = array.array('f', [0.01 * plug.asFloat() for (name, plug) in g_JointProps])
+        AnimLiveBridge.SetModelDataPropertiesBuffer(g_SessionId, 0, None, values)
 
     # update timeline
     conversion = 1.0 / g_FPS
@@ -158,7 +139,6 @@ def StartWithSelected(models):
     
     global g_MapFunc
     global g_Joints
-    global g_JointData
     global g_JointProps
     
     g_Joints = []
@@ -214,8 +194,9 @@ def StartWithSelected(models):
     shared_data.m_Header.m_ModelsCount = len(g_Joints)
     shared_data.m_Header.m_PropsCount = len(g_JointProps)
     
-    # fill name hashes
-    g_JointData.resize(len(g_Joints))
+    # fill name hashes, transforms and values are written every frame
+    hashes = array.array('I')
+    registry = AnimLiveBridge.CNameHashRegistry()
     for i in xrange(len(g_Joints)):
         dagPath = OpenMaya.MDagPath()
         
@@ -224,12 +205,16 @@ def StartWithSelected(models):
         model_name = getShortName(dagPath)
         objectSplit = model_name.split(':')
         
-        g_JointData[i].m_NameHash = AnimLiveBridge.HashPairName(str(objectSplit[-1]))
+        hashes.append(registry.Register(str(objectSplit[-1])))
+    
+    if registry.GetCollisionsCount() > 0:
+        OpenMaya.MGlobal.displayWarning('Some joint names have the same hash and can not be told apart in a stream')
+    
+    AnimLiveBridge.SetModelDataJointsBuffer(g_SessionId, 0, hashes, None, None, None)
     
-    g_JointPropData.resize(len(g_JointProps))
-    for i in xrange(len(g_JointProps)):
-        g_JointPropData[i].m_NameHash = AnimLiveBridge.HashPairName(str(g_JointData[i][0]))
-        g_JointPropData[i].m_Value = g_JointData[i][1].asFloat()
+    if len(g_JointProps) > 0:
+        prop_hashes = array.array('I', [AnimLiveBridge.HashPairName(str(name)) for (name, plug) in g_JointProps])
+        AnimLiveBridge.SetModelDataPropertiesBuffer(g_SessionId, 0, prop_hashes, None)
 
     #
     track_models()
@@ -26,19 +26,29 @@
 
 #include "AnimLiveBridge.h"
 #include "AnimLiveBridgeSession.h"
-
-#include <windows.h>
+#include "AnimLiveBridgeCodec.h"
+#include "AnimLiveBridgeMath.h"
+#include "AnimLiveBridgeHierarchy.h"
+#include "AnimLiveBridgeRegistry.h"
+#include "AnimLiveBridgeTake.h"
+#include "AnimLiveBridgeLog.h"
 
 #include <vector>
+#include <algorithm>
 #include <string>
+#include <cstring>
+#include <unordered_map>
 
-#define EXPORT_FUNCTION comment(linker, "/EXPORT:" __FUNCTION__ "=" __FUNCDNAME__)
+#ifdef _WIN32
+	#include <windows.h>
+	#define EXPORT_FUNCTION comment(linker, "/EXPORT:" __FUNCTION__ "=" __FUNCDNAME__)
+#endif
 
-// store all opened sessions
+// store all opened sessions, session id is a registry handle
 
-static std::vector<CAnimLiveBridgeSession*>		g_Sessions;
-static int										g_VerboseLevel{ 1 };		// 1 - minumum log, 2 - full log info
-static CLiveBridgeLogger*						g_Logger{ nullptr };
+static CAnimLiveBridgeRegistry					g_Sessions;
+int												g_VerboseLevel{ 1 };		// 1 - minumum log, 2 - full log info
+CLiveBridgeLogger*								g_Logger{ nullptr };
 
 ////////////////////////////////////////
 //
@@ -57,22 +67,41 @@ void SetLiveBridgeLogger(CLiveBridgeLogger* logger)
 	g_Logger = logger;
 }
 
+void SetLiveBridgeLogMode(const int mode)
+{
+#pragma EXPORT_FUNCTION
+
+	SetLogMode(mode);
+}
+
+int DrainLiveBridgeLog()
+{
+#pragma EXPORT_FUNCTION
+
+	return DrainLogMessages();
+}
+
+unsigned int GetLiveBridgeLogDropped()
+{
+#pragma EXPORT_FUNCTION
+
+	return static_cast<unsigned int>(GetLogDroppedCount());
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////
 //
 
-CAnimLiveBridgeSession* FindOpenSession(unsigned int session_id, const bool find_only_opened=true)
+// a found session is not freed by another thread until a returned reference goes out of scope
+CSessionRef FindOpenSession(unsigned int session_id, const bool find_only_opened=true)
 {
-	if (session_id >= static_cast<unsigned int>(g_Sessions.size()))
-		return nullptr;
+	CSessionRef session = g_Sessions.Acquire(session_id);
 
-	CAnimLiveBridgeSession* session = g_Sessions[session_id];
-
-	// session was already free
+	// session was already free or an id is stale
 	if (session == nullptr)
-		return nullptr;
+		return CSessionRef();
 
 	if (find_only_opened && !session->IsOpen())
-		return nullptr;
+		return CSessionRef();
 
 	return session;
 }
@@ -81,71 +110,102 @@ unsigned int HashPairName(const char* pair_name)
 {
 #pragma EXPORT_FUNCTION
 
-	unsigned int session_hash = static_cast<unsigned int>(std::hash<std::string>{}(pair_name));
-	return session_hash;
+	unsigned int hash = NAME_HASH_BASIS;
+
+	for (const char* c = pair_name; *c != 0; ++c)
+	{
+		hash = (hash ^ static_cast<unsigned char>(*c)) * NAME_HASH_PRIME;
+	}
+	return hash;
+}
+
+unsigned int GetJointSchemaId(const SSharedModelData* model_data)
+{
+#pragma EXPORT_FUNCTION
+
+	return (model_data) ? ComputeJointSchemaId(GetModelJoints(model_data), model_data->m_Header.m_ModelsCount) : 0;
+}
+
+int BuildJointRemap(const SSharedModelData* model_data, const unsigned int* name_hashes, const unsigned int count, int* remap)
+{
+#pragma EXPORT_FUNCTION
+
+	if (!model_data || !name_hashes || !remap)
+		return 0;
+
+	// frame joints sorted by a name hash, a first joint wins for a duplicated name
+	const SJointData* joints = GetModelJoints(model_data);
+	const unsigned int joints_count = model_data->m_Header.m_ModelsCount;
+
+	std::vector<std::pair<unsigned int, int>> sorted_joints(joints_count);
+	for (unsigned int i = 0; i < joints_count; ++i)
+	{
+		sorted_joints[i] = std::make_pair(joints[i].m_NameHash, static_cast<int>(i));
+	}
+	std::sort(sorted_joints.begin(), sorted_joints.end());
+
+	int found = 0;
+
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		const auto iter = std::lower_bound(sorted_joints.begin(), sorted_joints.end(), std::make_pair(name_hashes[i], 0));
+
+		remap[i] = (iter != sorted_joints.end() && iter->first == name_hashes[i]) ? iter->second : -1;
+		found += (remap[i] >= 0) ? 1 : 0;
+	}
+	return found;
 }
 
 unsigned int NewLiveSession()
 {
 #pragma EXPORT_FUNCTION
 
-	size_t index = g_Sessions.size();
+	CAnimLiveBridgeSession* session = new CAnimLiveBridgeSession();
+	const unsigned int session_id = g_Sessions.Insert(session);
 
-	for (size_t i = 0; i < g_Sessions.size(); ++i)
-		if (g_Sessions[i] == nullptr)
+	if (session_id == INVALID_SESSION_HANDLE)
+	{
+		if (g_VerboseLevel && g_Logger)
 		{
-			index = i;
-			break;
+			LogMessage(ELogMessage_SessionSlotsInUse, MAX_LIVE_SESSIONS);
 		}
 
-	CAnimLiveBridgeSession* session = new CAnimLiveBridgeSession();
+		delete session;
+		return INVALID_SESSION_HANDLE;
+	}
+
+	AddLogSession();
 
 	if (g_VerboseLevel && g_Logger)
 	{
-		std::string info("NewLiveSession ");
-		info += std::to_string(index);
-
-		g_Logger->LogInfo(info.c_str());
+		LogMessage(ELogMessage_NewSession, session_id);
 	}
 
-	if (index >= g_Sessions.size())
-		g_Sessions.emplace_back(session);
-	else
-		g_Sessions[index] = session;
-
-	return static_cast<unsigned int>(index);
+	return session_id;
 }
 
 bool FreeLiveSession(unsigned int session_id)
 {
 #pragma EXPORT_FUNCTION
 
-	if (session_id >= static_cast<unsigned int>(g_Sessions.size()))
+	// only one caller detaches a session, a second free of the same id is a stale id,
+	// it waits for calls of other threads which are still inside a session
+	CAnimLiveBridgeSession* session = g_Sessions.Remove(session_id);
+
+	if (session == nullptr)
 	{
 		if (g_VerboseLevel && g_Logger)
 		{
-			std::string info("[EraseLiveSession] session id is not found ");
-			info += std::to_string(session_id);
-
-			g_Logger->LogError(info.c_str());
+			LogMessage(ELogMessage_FreeSessionNotFound, session_id);
 		}
 		return false;
 	}
-	
-	auto iter = g_Sessions.begin() + session_id;
-	CAnimLiveBridgeSession* session = *iter;
-
-	if (session == nullptr)
-		return true;
 
 	if (session->IsOpen())
 	{
 		if (g_VerboseLevel && g_Logger)
 		{
-			std::string info("[EraseLiveSession] closing map file handle for session id ");
-			info += std::to_string(session_id);
-
-			g_Logger->LogInfo(info.c_str());
+			LogMessage(ELogMessage_FreeSessionClose, session_id);
 		}
 
 		session->Close();
@@ -154,16 +214,13 @@ bool FreeLiveSession(unsigned int session_id)
 	{
 		if (g_VerboseLevel && g_Logger)
 		{
-			std::string info("[EraseLiveSession] map file is already closed for session id ");
-			info += std::to_string(session_id);
-
-			g_Logger->LogWarning(info.c_str());
+			LogMessage(ELogMessage_FreeSessionClosed, session_id);
 		}
 	}
 	
-	*iter = nullptr;
 	delete session;
 
+	RemoveLogSession();
 	return true;
 }
 
@@ -182,14 +239,11 @@ int HardwareOpen(unsigned int session_id, const char* pair_name, const bool is_s
 		g_Logger->LogInfo(info.c_str());
 	}
 
-	if (session_id >= static_cast<unsigned int>(g_Sessions.size()))
+	if (FindOpenSession(session_id, false) == nullptr)
 	{
 		if (g_VerboseLevel && g_Logger)
 		{
-			std::string info("[HardwareOpen] session id is not found ");
-			info += std::to_string(session_id);
-
-			g_Logger->LogError(info.c_str());
+			LogMessage(ELogMessage_OpenSessionNotFound, session_id);
 		}
 
 		return -1;
@@ -197,10 +251,11 @@ int HardwareOpen(unsigned int session_id, const char* pair_name, const bool is_s
 	
 	HardwareClose(session_id);
 
-	if (g_Sessions[session_id] == nullptr)
+	CSessionRef found = FindOpenSession(session_id, false);
+	if (found == nullptr)
 		return -1;
 
-	CAnimLiveBridgeSession& session = *g_Sessions[session_id];
+	CAnimLiveBridgeSession& session = *found;
 
 	if (!session.IsOpen())
 	{
@@ -216,16 +271,13 @@ int HardwareClose(unsigned int session_id)
 {
 #pragma EXPORT_FUNCTION
 
-	if (CAnimLiveBridgeSession* session = FindOpenSession(session_id))
+	if (CSessionRef session = FindOpenSession(session_id))
 	{
 		if (session->IsOpen())
 		{
 			if (g_VerboseLevel && g_Logger)
 			{
-				std::string info("[HardwareClose] closing map file handle for session id ");
-				info += std::to_string(session_id);
-
-				g_Logger->LogInfo(info.c_str());
+				LogMessage(ELogMessage_HardwareClose, session_id);
 			}
 
 			session->Close();
@@ -238,9 +290,9 @@ SSharedModelData* MapModelData(unsigned int session_id)
 {
 #pragma EXPORT_FUNCTION
 
-	if (CAnimLiveBridgeSession* session = FindOpenSession(session_id))
+	if (CSessionRef session = FindOpenSession(session_id))
 	{
-		return session->GetDataPtr();
+		return session->GetUserFrame().m_Data;
 	}
 	return nullptr;
 }
@@ -249,11 +301,12 @@ bool SetModelDataJoints(unsigned int session_id, const std::vector<SJointData>&
 {
 #pragma EXPORT_FUNCTION
 
-	if (CAnimLiveBridgeSession* session = FindOpenSession(session_id))
+	if (CSessionRef session = FindOpenSession(session_id))
 	{
-		const size_t joints_len = static_cast<size_t>(NUMBER_OF_JOINTS);
+		const SFrameBuffer& frame = session->GetUserFrame();
+		const size_t joints_len = static_cast<size_t>(frame.m_JointsCapacity);
 		const size_t len = (data.size() < joints_len) ? data.size() : joints_len;
-		memcpy_s(session->GetDataPtr()->m_Joints.m_Data, sizeof(SJointData)*joints_len, data.data(), sizeof(SJointData) * len);
+		memcpy(GetModelJoints(frame.m_Data), data.data(), sizeof(SJointData) * len);
 		return true;
 	}
 	return false;
@@ -263,189 +316,994 @@ bool SetModelDataProperties(unsigned int session_id, const std::vector<SProperty
 {
 #pragma EXPORT_FUNCTION
 
-	if (CAnimLiveBridgeSession* session = FindOpenSession(session_id))
+	if (CSessionRef session = FindOpenSession(session_id))
 	{
-		const size_t max_len = static_cast<size_t>(NUMBER_OF_JOINTS);
+		const SFrameBuffer& frame = session->GetUserFrame();
+		const size_t max_len = static_cast<size_t>(frame.m_PropsCapacity);
 		const size_t len = (data.size() < max_len) ? data.size() : max_len;
 
-		memcpy_s(session->GetDataPtr()->m_Properties.m_Data, sizeof(SPropertyData)*max_len, data.data(), sizeof(SPropertyData) * len);
+		memcpy(GetModelProperties(frame.m_Data), data.data(), sizeof(SPropertyData) * len);
 		return true;
 	}
 	return false;
 }
 
-void UnMapModelData(unsigned int session_id)
+bool SetModelDataEntities(unsigned int session_id, const std::vector<SEntityBlock>& data)
 {
 #pragma EXPORT_FUNCTION
-	// TODO: if we think to make a thread safe data access
+
+	if (CSessionRef session = FindOpenSession(session_id))
+	{
+		const SFrameBuffer& frame = session->GetUserFrame();
+		SSharedModelData* model_data = frame.m_Data;
+		SEntityBlock* entities = GetModelEntities(model_data);
+		if (!entities)
+			return false;
+
+		const size_t max_len = static_cast<size_t>(frame.m_EntitiesCapacity);
+		const size_t len = (data.size() < max_len) ? data.size() : max_len;
+
+		memcpy(entities, data.data(), sizeof(SEntityBlock) * len);
+		model_data->m_Header.m_EntitiesCount = static_cast<unsigned int>(len);
+		return true;
+	}
+	return false;
 }
 
-STimelineSyncManager* MapTimelineSync(unsigned int session_id)
+const unsigned int STREAM_BLOCK_VALUES = 256;
+
+// float streams are read as they are, double streams are converted by blocks with one simd call
+static const float* ConvertStreamBlock(const float* src, float*, const unsigned int)
 {
-#pragma EXPORT_FUNCTION
+	return src;
+}
+
+static const float* ConvertStreamBlock(const double* src, float* block, const unsigned int count)
+{
+	DoubleToFloatData(src, block, count);
+	return block;
+}
+
+// a contiguous stream of count elements with a number of components, write is called per element with float values
+template<typename T, typename F>
+static void ReadStream(const T* src, const unsigned int count, const unsigned int components, F&& write)
+{
+	float block[STREAM_BLOCK_VALUES];
+	const unsigned int block_count = STREAM_BLOCK_VALUES / components;
 
-	if (CAnimLiveBridgeSession* session = FindOpenSession(session_id))
+	for (unsigned int first = 0; first < count; first += block_count)
 	{
-		return session->GetTimelinePtr();
+		const unsigned int len = std::min(block_count, count - first);
+		const float* values = ConvertStreamBlock(src + first * components, block, len * components);
+
+		for (unsigned int i = 0; i < len; ++i, values += components)
+			write(first + i, values);
 	}
-	return nullptr;
 }
 
-void UnMapTimelineSync(unsigned int session_id)
+// one pass per array, a missing array keeps frame values
+template<typename T>
+static void WriteJointStreams(SJointData* joints, const unsigned int count,
+	const unsigned int* name_hashes, const T* translations, const T* rotations, const T* scales)
+{
+	if (name_hashes)
+	{
+		for (unsigned int i = 0; i < count; ++i)
+			joints[i].m_NameHash = name_hashes[i];
+	}
+	if (translations)
+	{
+		ReadStream(translations, count, 3, [joints](const unsigned int i, const float* values)
+		{
+			memcpy(&joints[i].m_Transform.m_Translation, values, sizeof(SVector3));
+		});
+	}
+	if (rotations)
+	{
+		ReadStream(rotations, count, 4, [joints](const unsigned int i, const float* values)
+		{
+			memcpy(&joints[i].m_Transform.m_Rotation, values, sizeof(SVector4));
+		});
+	}
+	if (scales)
+	{
+		ReadStream(scales, count, 3, [joints](const unsigned int i, const float* values)
+		{
+			memcpy(&joints[i].m_Transform.m_Scale, values, sizeof(SVector3));
+		});
+	}
+}
+
+template<typename T>
+static void WritePropertyStreams(SPropertyData* props, const unsigned int count, const unsigned int* name_hashes, const T* values)
+{
+	if (name_hashes)
+	{
+		for (unsigned int i = 0; i < count; ++i)
+			props[i].m_NameHash = name_hashes[i];
+	}
+	if (values)
+	{
+		ReadStream(values, count, 1, [props](const unsigned int i, const float* value)
+		{
+			props[i].m_Value = *value;
+		});
+	}
+}
+
+template<typename T>
+static int SetJointStreams(unsigned int session_id, const unsigned int first, const unsigned int count,
+	const unsigned int* name_hashes, const T* translations, const T* rotations, const T* scales)
+{
+	if (CSessionRef session = FindOpenSession(session_id))
+	{
+		const SFrameBuffer& frame = session->GetUserFrame();
+		if (static_cast<unsigned long long>(first) + count > frame.m_JointsCapacity)
+			return -5;
+
+		WriteJointStreams(GetModelJoints(frame.m_Data) + first, count, name_hashes, translations, rotations, scales);
+		return 0;
+	}
+	return -3;
+}
+
+template<typename T>
+static int SetPropertyStreams(unsigned int session_id, const unsigned int first, const unsigned int count,
+	const unsigned int* name_hashes, const T* values)
+{
+	if (CSessionRef session = FindOpenSession(session_id))
+	{
+		const SFrameBuffer& frame = session->GetUserFrame();
+		if (static_cast<unsigned long long>(first) + count > frame.m_PropsCapacity)
+			return -5;
+
+		WritePropertyStreams(GetModelProperties(frame.m_Data) + first, count, name_hashes, values);
+		return 0;
+	}
+	return -3;
+}
+
+int SetModelDataJointsSoA(unsigned int session_id, const unsigned int first, const unsigned int count,
+	const unsigned int* name_hashes, const float* translations, const float* rotations, const float* scales)
 {
 #pragma EXPORT_FUNCTION
-	// TODO: if we think to make a thread safe data access
+
+	return SetJointStreams(session_id, first, count, name_hashes, translations, rotations, scales);
 }
 
-int HardwareCommit(unsigned int session_id, const bool auto_finish_event)
+int SetModelDataJointsSoAd(unsigned int session_id, const unsigned int first, const unsigned int count,
+	const unsigned int* name_hashes, const double* translations, const double* rotations, const double* scales)
+{
+#pragma EXPORT_FUNCTION
+
+	return SetJointStreams(session_id, first, count, name_hashes, translations, rotations, scales);
+}
+
+int SetModelDataPropertiesSoA(unsigned int session_id, const unsigned int first, const unsigned int count,
+	const unsigned int* name_hashes, const float* values)
+{
+#pragma EXPORT_FUNCTION
+
+	return SetPropertyStreams(session_id, first, count, name_hashes, values);
+}
+
+int SetModelDataPropertiesSoAd(unsigned int session_id, const unsigned int first, const unsigned int count,
+	const unsigned int* name_hashes, const double* values)
+{
+#pragma EXPORT_FUNCTION
+
+	return SetPropertyStreams(session_id, first, count, name_hashes, values);
+}
+
+int GetModelDataJointsCapacity(unsigned int session_id)
 {
 #pragma EXPORT_FUNCTION
 
-	if (CAnimLiveBridgeSession* session = FindOpenSession(session_id))
+	if (CSessionRef session = FindOpenSession(session_id))
 	{
-		return session->Commit(auto_finish_event);
+		return static_cast<int>(session->GetUserFrame().m_JointsCapacity);
 	}
-	
-	return -1;
+	return -3;
 }
 
-bool SetFinishEvent(unsigned int session_id)
+int GetModelDataPropertiesCapacity(unsigned int session_id)
 {
 #pragma EXPORT_FUNCTION
 
-	if (CAnimLiveBridgeSession* session = FindOpenSession(session_id))
+	if (CSessionRef session = FindOpenSession(session_id))
 	{
-		session->ManualPostCommitFinish();
-		return true;
+		return static_cast<int>(session->GetUserFrame().m_PropsCapacity);
 	}
-	return false;
+	return -3;
 }
 
-void SetModelJointData(SSharedModelData* model_data, const std::vector<SJointData>& data)
+void* RetainModelDataBuffer(unsigned int session_id)
 {
 #pragma EXPORT_FUNCTION
 
-	if (!model_data || data.empty())
-		return;
+	if (CSessionRef session = FindOpenSession(session_id))
+	{
+		return new std::shared_ptr<std::vector<unsigned long long>>(session->GetUserFrame().m_Storage);
+	}
+	return nullptr;
+}
+
+void ReleaseModelDataBuffer(void* token)
+{
+#pragma EXPORT_FUNCTION
 
-	const size_t len = (data.size() < NUMBER_OF_JOINTS) ? data.size() : NUMBER_OF_JOINTS;
-	memcpy(model_data->m_Joints.m_Data, data.data(), sizeof(SJointData) * len);
+	delete static_cast<std::shared_ptr<std::vector<unsigned long long>>*>(token);
 }
 
-void SetModelPropertyData(SSharedModelData* model_data, const std::vector<SPropertyData>& data)
+int SetModelDataChannelLayout(unsigned int session_id, const unsigned int* name_hashes, const unsigned int* types, const unsigned int count)
 {
 #pragma EXPORT_FUNCTION
 
-	if (!model_data || data.empty())
-		return;
+	if (CSessionRef session = FindOpenSession(session_id))
+	{
+		return session->SetChannelLayout(name_hashes, types, count);
+	}
+	return -3;
+}
+
+int SetModelDataChannelValues(unsigned int session_id, const unsigned int first, const unsigned int count, const float* values)
+{
+#pragma EXPORT_FUNCTION
 
-	const size_t len = (data.size() < NUMBER_OF_PROPERTIES) ? data.size() : NUMBER_OF_PROPERTIES;
-	memcpy(model_data->m_Properties.m_Data, data.data(), sizeof(SPropertyData) * len);
+	if (CSessionRef session = FindOpenSession(session_id))
+	{
+		return session->GetWriteChannels().SetValues(first, count, values);
+	}
+	return -3;
 }
 
-bool SetLookAtVectors(unsigned int session_id, const SVector4& lookat_root, const SVector4& lookat_left, const SVector4& lookat_right)
+int ReadModelDataChannels(unsigned int session_id)
 {
 #pragma EXPORT_FUNCTION
 
-	if (CAnimLiveBridgeSession* session = FindOpenSession(session_id, false))
+	if (CSessionRef session = FindOpenSession(session_id))
 	{
-		session->m_LookAtRootPos = lookat_root;
-		session->m_LookAtLeftPos = lookat_left;
-		session->m_LookAtRightPos = lookat_right;
-		return true;
+		return session->GetReadChannels().ReadBlock(session->GetUserFrame().m_Data);
 	}
-	return false;
+	return -3;
 }
 
-bool GetLookAtVectors(unsigned int session_id, SVector4& lookat_root, SVector4& lookat_left, SVector4& lookat_right)
+int GetModelDataChannelValues(unsigned int session_id, const unsigned int first, const unsigned int count, float* values)
 {
 #pragma EXPORT_FUNCTION
-	
-	if (CAnimLiveBridgeSession* session = FindOpenSession(session_id, false))
+
+	if (CSessionRef session = FindOpenSession(session_id))
 	{
-		lookat_root = session->m_LookAtRootPos;
-		lookat_left = session->m_LookAtLeftPos;
-		lookat_right = session->m_LookAtRightPos;
-		return true;
+		return session->GetReadChannels().GetValues(first, count, values);
 	}
-	return false;
+	return -3;
 }
 
-void SetHasNewSync(unsigned int session_id, const bool value)
+int FindModelDataChannel(unsigned int session_id, const unsigned int name_hash)
 {
 #pragma EXPORT_FUNCTION
 
-	if (CAnimLiveBridgeSession* session = FindOpenSession(session_id, false))
+	if (CSessionRef session = FindOpenSession(session_id))
 	{
-		session->m_HasNewSync = value;
+		return session->GetReadChannels().Find(name_hash);
 	}
+	return -3;
 }
 
-bool GetHasNewSync(unsigned int session_id)
+int GetModelDataChannelType(unsigned int session_id, const unsigned int index)
 {
 #pragma EXPORT_FUNCTION
 
-	if (CAnimLiveBridgeSession* session = FindOpenSession(session_id, false))
+	if (CSessionRef session = FindOpenSession(session_id))
 	{
-		return session->m_HasNewSync;
+		const CPropertyChannels& channels = session->GetReadChannels();
+		return (index < channels.GetCount()) ? static_cast<int>(channels.GetEntry(index).m_Type) : -1;
 	}
-	return false;
+	return -3;
 }
 
-bool GetAndResetHasNewSync(unsigned int session_id)
+bool GetModelDataEntity(unsigned int session_id, unsigned int index, SEntityBlock& entity)
 {
 #pragma EXPORT_FUNCTION
 
-	if (CAnimLiveBridgeSession* session = FindOpenSession(session_id, false))
+	if (CSessionRef session = FindOpenSession(session_id))
 	{
-		const bool value{ session->m_HasNewSync };
-		session->m_HasNewSync = false;
-		return value;
+		const SSharedModelData* model_data = session->GetUserFrame().m_Data;
+		const SEntityBlock* entities = GetModelEntities(model_data);
+		if (!entities || index >= model_data->m_Header.m_EntitiesCount)
+			return false;
+
+		entity = entities[index];
+		return true;
 	}
 	return false;
 }
 
-void SetSyncSaved(unsigned int session_id, const bool value)
+unsigned int EncodePose(const SJointData* joints, unsigned int count, unsigned int translation_bits, unsigned int rotation_bits, unsigned char* buffer, unsigned int buffer_size)
+{
+#pragma EXPORT_FUNCTION
+
+	SPoseCodecSettings settings;
+	settings.m_TranslationBits = (translation_bits > 0) ? translation_bits : DEFAULT_TRANSLATION_BITS;
+	settings.m_RotationBits = (rotation_bits > 0) ? rotation_bits : DEFAULT_ROTATION_BITS;
+
+	return static_cast<unsigned int>(EncodePoseData(joints, count, settings, buffer, buffer_size));
+}
+
+int DecodePose(const unsigned char* buffer, unsigned int size, SJointData* joints, unsigned int max_count)
+{
+#pragma EXPORT_FUNCTION
+
+	return DecodePoseData(buffer, size, joints, max_count);
+}
+
+bool GetPoseErrorBound(const unsigned char* buffer, unsigned int size, SVector3& translation_error, SVector3& euler_error, float& quaternion_error)
+{
+#pragma EXPORT_FUNCTION
+
+	if (size < sizeof(SPoseCodecHeader))
+		return false;
+
+	SPoseCodecHeader header;
+	memcpy(&header, buffer, sizeof(SPoseCodecHeader));
+
+	if (header.m_Version != POSE_CODEC_VERSION)
+		return false;
+
+	GetPoseDataErrorBound(header, translation_error, euler_error, quaternion_error);
+	return true;
+}
+
+void UnMapModelData(unsigned int session_id)
+{
+#pragma EXPORT_FUNCTION
+	// TODO: if we think to make a thread safe data access
+}
+
+STimelineSyncManager* MapTimelineSync(unsigned int session_id)
 {
 #pragma EXPORT_FUNCTION
 
-	if (CAnimLiveBridgeSession* session = FindOpenSession(session_id, false))
+	if (CSessionRef session = FindOpenSession(session_id))
 	{
-		session->m_SyncSaved = value;
+		return session->GetTimelinePtr();
 	}
+	return nullptr;
 }
 
-bool GetSyncSaved(unsigned int session_id)
+void UnMapTimelineSync(unsigned int session_id)
+{
+#pragma EXPORT_FUNCTION
+	// TODO: if we think to make a thread safe data access
+}
+
+int HardwareCommit(unsigned int session_id, const bool auto_finish_event)
 {
 #pragma EXPORT_FUNCTION
 
-	if (CAnimLiveBridgeSession* session = FindOpenSession(session_id, false))
+	if (CSessionRef session = FindOpenSession(session_id))
 	{
-		return session->m_SyncSaved;
+		return session->Commit(auto_finish_event);
 	}
-	return false;
+	
+	return -1;
 }
 
-void SetLiveSessionPropertyInt(unsigned int session_id, unsigned int property_id, int value)
+int HardwareWaitForFrame(unsigned int session_id, unsigned int timeout_ms)
 {
 #pragma EXPORT_FUNCTION
+
+	if (CSessionRef session = FindOpenSession(session_id))
+	{
+		return session->WaitForFrame(timeout_ms);
+	}
+	return -3;
 }
 
-void SetLiveSessionPropertyString(unsigned int session_id, unsigned int property_id, const char* value)
+double GetLiveBridgeTime()
 {
 #pragma EXPORT_FUNCTION
+
+	return 1e-9 * static_cast<double>(CLiveSessionStats::Now());
 }
 
-int GetLiveSessionPropertyInt(unsigned int session_id, unsigned int property_id)
+const SSharedModelData* SampleModelData(unsigned int session_id, double time)
 {
 #pragma EXPORT_FUNCTION
-	return 0;
+
+	if (CSessionRef session = FindOpenSession(session_id))
+	{
+		return session->SampleFrame((time > 0.0) ? time : GetLiveBridgeTime());
+	}
+	return nullptr;
 }
 
-const char* GetLiveSessionPropertyString(unsigned int session_id, unsigned int property_id)
+bool GetLiveSessionStats(unsigned int session_id, SLiveSessionStats& stats)
 {
 #pragma EXPORT_FUNCTION
-	return nullptr;
+
+	if (CSessionRef session = FindOpenSession(session_id, false))
+	{
+		session->GetStats().GetStats(stats);
+		return true;
+	}
+	return false;
+}
+
+bool GetLiveSessionLatency(unsigned int session_id, unsigned int latency_id, SLatencySummary& summary)
+{
+#pragma EXPORT_FUNCTION
+
+	if (CSessionRef session = FindOpenSession(session_id, false))
+	{
+		return session->GetStats().GetLatency(latency_id, summary);
+	}
+	return false;
+}
+
+bool ResetLiveSessionStats(unsigned int session_id)
+{
+#pragma EXPORT_FUNCTION
+
+	if (CSessionRef session = FindOpenSession(session_id, false))
+	{
+		session->GetStats().Reset();
+		return true;
+	}
+	return false;
+}
+
+bool GetLiveSessionClock(unsigned int session_id, SLiveSessionClock& clock)
+{
+#pragma EXPORT_FUNCTION
+
+	if (CSessionRef session = FindOpenSession(session_id, false))
+	{
+		session->GetClockSync().GetState(clock);
+		return true;
+	}
+	return false;
+}
+
+double GetLiveSessionClockTime(unsigned int session_id)
+{
+#pragma EXPORT_FUNCTION
+
+	if (CSessionRef session = FindOpenSession(session_id, false))
+	{
+		// a server clock is a time base, a client maps its own clock to it
+		const double now = GetLiveBridgeTime();
+		return (session->GetPropertyInt(ELiveSessionProperty_IsServer) != 0) ? now : session->GetClockSync().ToPeerTime(now);
+	}
+	return -1.0;
+}
+
+double GetModelDataFrameAge(unsigned int session_id)
+{
+#pragma EXPORT_FUNCTION
+
+	if (CSessionRef session = FindOpenSession(session_id))
+	{
+		const double frame_time = session->GetUserFrame().m_Data->m_ServerPlayer.m_SystemTime;
+		if (frame_time > 0.0)
+			return GetLiveSessionClockTime(session_id) - frame_time;
+	}
+	return -1.0;
+}
+
+bool SetFrameReadyCallback(unsigned int session_id, LiveBridgeFrameCallback callback, void* user_data)
+{
+#pragma EXPORT_FUNCTION
+
+	if (CSessionRef session = FindOpenSession(session_id, false))
+	{
+		session->SetFrameCallback(callback, user_data, session_id);
+		return true;
+	}
+	return false;
+}
+
+long long GetFrameReadyHandle(unsigned int session_id)
+{
+#pragma EXPORT_FUNCTION
+
+	if (CSessionRef session = FindOpenSession(session_id, false))
+	{
+		return session->GetFrameReadyHandle();
+	}
+	return -3;
+}
+
+int ResetFrameReadyHandle(unsigned int session_id)
+{
+#pragma EXPORT_FUNCTION
+
+	if (CSessionRef session = FindOpenSession(session_id, false))
+	{
+		return session->ResetFrameReadyHandle();
+	}
+	return -3;
+}
+
+int StartTakeRecording(unsigned int session_id, const char* file_name)
+{
+#pragma EXPORT_FUNCTION
+
+	if (CSessionRef session = FindOpenSession(session_id, false))
+	{
+		return session->StartRecording(file_name);
+	}
+	return -3;
+}
+
+int StopTakeRecording(unsigned int session_id)
+{
+#pragma EXPORT_FUNCTION
+
+	if (CSessionRef session = FindOpenSession(session_id, false))
+	{
+		return session->StopRecording();
+	}
+	return -3;
+}
+
+int StartTakeReplay(unsigned int session_id, const char* file_name, double speed, bool loop)
+{
+#pragma EXPORT_FUNCTION
+
+	if (CSessionRef session = FindOpenSession(session_id))
+	{
+		if (session->GetPropertyInt(ELiveSessionProperty_IsServer) == 0)
+			return -1;
+
+		return session->StartReplay(file_name, speed, loop);
+	}
+	return -3;
+}
+
+bool StopTakeReplay(unsigned int session_id)
+{
+#pragma EXPORT_FUNCTION
+
+	if (CSessionRef session = FindOpenSession(session_id, false))
+	{
+		session->StopReplay();
+		return true;
+	}
+	return false;
+}
+
+int GetTakeReplayPosition(unsigned int session_id)
+{
+#pragma EXPORT_FUNCTION
+
+	if (CSessionRef session = FindOpenSession(session_id, false))
+	{
+		CAnimLiveBridgeTakeReplay* replay = session->GetReplay();
+		return (replay) ? static_cast<int>(replay->GetPosition()) : -1;
+	}
+	return -3;
+}
+
+bool SeekTakeReplay(unsigned int session_id, unsigned int frame_index)
+{
+#pragma EXPORT_FUNCTION
+
+	if (CSessionRef session = FindOpenSession(session_id, false))
+	{
+		CAnimLiveBridgeTakeReplay* replay = session->GetReplay();
+		return (replay) ? replay->Seek(frame_index) : false;
+	}
+	return false;
+}
+
+SSharedModelData* AcquireWriteSlot(unsigned int session_id)
+{
+#pragma EXPORT_FUNCTION
+
+	if (CSessionRef session = FindOpenSession(session_id))
+	{
+		return session->AcquireWriteSlot();
+	}
+	return nullptr;
+}
+
+int PublishWriteSlot(unsigned int session_id, const bool auto_finish_event)
+{
+#pragma EXPORT_FUNCTION
+
+	if (CSessionRef session = FindOpenSession(session_id))
+	{
+		return session->PublishWriteSlot(auto_finish_event);
+	}
+	return -1;
+}
+
+const SSharedModelData* AcquireReadView(unsigned int session_id)
+{
+#pragma EXPORT_FUNCTION
+
+	if (CSessionRef session = FindOpenSession(session_id))
+	{
+		return session->AcquireReadView();
+	}
+	return nullptr;
+}
+
+int ReleaseReadView(unsigned int session_id, const bool auto_finish_event)
+{
+#pragma EXPORT_FUNCTION
+
+	if (CSessionRef session = FindOpenSession(session_id))
+	{
+		return session->ReleaseReadView(auto_finish_event);
+	}
+	return -1;
+}
+
+bool SetFinishEvent(unsigned int session_id)
+{
+#pragma EXPORT_FUNCTION
+
+	if (CSessionRef session = FindOpenSession(session_id))
+	{
+		session->ManualPostCommitFinish();
+		return true;
+	}
+	return false;
+}
+
+void EulerToQuaternions(const SVector3* euler, SVector4* quaternions, unsigned int count)
+{
+#pragma EXPORT_FUNCTION
+
+	EulerToQuaternionData(euler, quaternions, count);
+}
+
+void QuaternionsToEuler(const SVector4* quaternions, SVector3* euler, unsigned int count)
+{
+#pragma EXPORT_FUNCTION
+
+	QuaternionToEulerData(quaternions, euler, count);
+}
+
+void MultiplyQuaternions(const SVector4* a, const SVector4* b, SVector4* result, unsigned int count)
+{
+#pragma EXPORT_FUNCTION
+
+	MultiplyQuaternionData(a, b, result, count);
+}
+
+void MatricesToTransforms(const double* matrices, STransform* transforms, unsigned int count)
+{
+#pragma EXPORT_FUNCTION
+
+	MatrixToTransformData(matrices, transforms, count);
+}
+
+void TransformsToMatrices(const STransform* transforms, double* matrices, unsigned int count)
+{
+#pragma EXPORT_FUNCTION
+
+	TransformToMatrixData(transforms, matrices, count);
+}
+
+void ConvertJointRotations(SJointData* joints, unsigned int count, unsigned int rotation_hint)
+{
+#pragma EXPORT_FUNCTION
+
+	ConvertJointRotationData(joints, count, rotation_hint);
+}
+
+int ConvertJointSpace(SJointData* joints, unsigned int count, unsigned int space_hint)
+{
+#pragma EXPORT_FUNCTION
+
+	if (!joints)
+		return 0;
+
+	static thread_local CJointHierarchy hierarchy;
+	return hierarchy.Convert(joints, count, space_hint);
+}
+
+int ConvertModelDataSpace(unsigned int session_id, unsigned int space_hint)
+{
+#pragma EXPORT_FUNCTION
+
+	if (CSessionRef session = FindOpenSession(session_id))
+	{
+		return session->ConvertFrameSpace(space_hint);
+	}
+	return -3;
+}
+
+void ConvertDoublesToFloats(const double* src, float* dst, unsigned int count)
+{
+#pragma EXPORT_FUNCTION
+
+	DoubleToFloatData(src, dst, count);
+}
+
+void ConvertFloatsToDoubles(const float* src, double* dst, unsigned int count)
+{
+#pragma EXPORT_FUNCTION
+
+	FloatToDoubleData(src, dst, count);
+}
+
+const char* GetMathKernelName()
+{
+#pragma EXPORT_FUNCTION
+
+	return GetMathKernelType();
+}
+
+// a capacity of a frame from its layout, a properties capacity needs an entities offset or a session which owns a frame
+static bool GetFrameCapacity(const SSharedModelData* model_data, unsigned int& joints_capacity, unsigned int& props_capacity)
+{
+	const SHeader& header = model_data->m_Header;
+
+	if (header.m_ModelsOffset == 0 || header.m_PropsOffset == 0)
+	{
+		joints_capacity = NUMBER_OF_JOINTS;
+		props_capacity = NUMBER_OF_PROPERTIES;
+		return true;
+	}
+
+	if (header.m_PropsOffset < header.m_ModelsOffset)
+		return false;
+
+	joints_capacity = (header.m_PropsOffset - header.m_ModelsOffset) / static_cast<unsigned int>(sizeof(SJointData));
+
+	if (header.m_EntitiesOffset > header.m_PropsOffset)
+	{
+		props_capacity = (header.m_EntitiesOffset - header.m_PropsOffset) / static_cast<unsigned int>(sizeof(SPropertyData));
+		return true;
+	}
+
+	bool found = false;
+	g_Sessions.ForEach([&](const unsigned int, CAnimLiveBridgeSession* session)
+	{
+		const SFrameBuffer& frame = (session->GetUserFrame().m_Data == model_data) ? session->GetUserFrame() : session->GetFrame();
+		if (!found && frame.m_Data == model_data)
+		{
+			props_capacity = frame.m_PropsCapacity;
+			found = true;
+		}
+	});
+	return found;
+}
+
+void SetModelJointData(SSharedModelData* model_data, const std::vector<SJointData>& data)
+{
+#pragma EXPORT_FUNCTION
+
+	unsigned int joints_capacity = 0;
+	unsigned int props_capacity = 0;
+
+	if (!model_data || data.empty() || !GetFrameCapacity(model_data, joints_capacity, props_capacity))
+		return;
+
+	const size_t len = (data.size() < joints_capacity) ? data.size() : joints_capacity;
+	memcpy(GetModelJoints(model_data), data.data(), sizeof(SJointData) * len);
+}
+
+void SetModelPropertyData(SSharedModelData* model_data, const std::vector<SPropertyData>& data)
+{
+#pragma EXPORT_FUNCTION
+
+	unsigned int joints_capacity = 0;
+	unsigned int props_capacity = 0;
+
+	if (!model_data || data.empty() || !GetFrameCapacity(model_data, joints_capacity, props_capacity))
+	{
+		if (model_data && !data.empty() && g_VerboseLevel && g_Logger)
+		{
+			g_Logger->LogWarning("[SetModelPropertyData] Unknown frame properties capacity, use SetModelDataProperties with a session id");
+		}
+		return;
+	}
+
+	const size_t len = (data.size() < props_capacity) ? data.size() : props_capacity;
+	memcpy(GetModelProperties(model_data), data.data(), sizeof(SPropertyData) * len);
+}
+
+bool SetLookAtVectors(unsigned int session_id, const SVector4& lookat_root, const SVector4& lookat_left, const SVector4& lookat_right)
+{
+#pragma EXPORT_FUNCTION
+
+	if (CSessionRef session = FindOpenSession(session_id, false))
+	{
+		std::lock_guard<std::mutex> lock(session->GetStateLock());
+		session->m_LookAtRootPos = lookat_root;
+		session->m_LookAtLeftPos = lookat_left;
+		session->m_LookAtRightPos = lookat_right;
+		return true;
+	}
+	return false;
+}
+
+bool GetLookAtVectors(unsigned int session_id, SVector4& lookat_root, SVector4& lookat_left, SVector4& lookat_right)
+{
+#pragma EXPORT_FUNCTION
+	
+	if (CSessionRef session = FindOpenSession(session_id, false))
+	{
+		std::lock_guard<std::mutex> lock(session->GetStateLock());
+		lookat_root = session->m_LookAtRootPos;
+		lookat_left = session->m_LookAtLeftPos;
+		lookat_right = session->m_LookAtRightPos;
+		return true;
+	}
+	return false;
+}
+
+void SetHasNewSync(unsigned int session_id, const bool value)
+{
+#pragma EXPORT_FUNCTION
+
+	if (CSessionRef session = FindOpenSession(session_id, false))
+	{
+		std::lock_guard<std::mutex> lock(session->GetStateLock());
+		session->m_HasNewSync = value;
+	}
+}
+
+bool GetHasNewSync(unsigned int session_id)
+{
+#pragma EXPORT_FUNCTION
+
+	if (CSessionRef session = FindOpenSession(session_id, false))
+	{
+		std::lock_guard<std::mutex> lock(session->GetStateLock());
+		return session->m_HasNewSync;
+	}
+	return false;
+}
+
+bool GetAndResetHasNewSync(unsigned int session_id)
+{
+#pragma EXPORT_FUNCTION
+
+	if (CSessionRef session = FindOpenSession(session_id, false))
+	{
+		std::lock_guard<std::mutex> lock(session->GetStateLock());
+		const bool value{ session->m_HasNewSync };
+		session->m_HasNewSync = false;
+		return value;
+	}
+	return false;
+}
+
+void SetSyncSaved(unsigned int session_id, const bool value)
+{
+#pragma EXPORT_FUNCTION
+
+	if (CSessionRef session = FindOpenSession(session_id, false))
+	{
+		std::lock_guard<std::mutex> lock(session->GetStateLock());
+		session->m_SyncSaved = value;
+	}
+}
+
+bool GetSyncSaved(unsigned int session_id)
+{
+#pragma EXPORT_FUNCTION
+
+	if (CSessionRef session = FindOpenSession(session_id, false))
+	{
+		std::lock_guard<std::mutex> lock(session->GetStateLock());
+		return session->m_SyncSaved;
+	}
+	return false;
+}
+
+void SetLiveSessionPropertyInt(unsigned int session_id, unsigned int property_id, int value)
+{
+#pragma EXPORT_FUNCTION
+
+	if (CSessionRef session = FindOpenSession(session_id, false))
+	{
+		session->SetPropertyInt(property_id, value);
+	}
+}
+
+void SetLiveSessionPropertyString(unsigned int session_id, unsigned int property_id, const char* value)
+{
+#pragma EXPORT_FUNCTION
+
+	if (CSessionRef session = FindOpenSession(session_id, false))
+	{
+		session->SetPropertyString(property_id, value);
+	}
+}
+
+int GetLiveSessionPropertyInt(unsigned int session_id, unsigned int property_id)
+{
+#pragma EXPORT_FUNCTION
+
+	if (CSessionRef session = FindOpenSession(session_id, false))
+	{
+		return session->GetPropertyInt(property_id);
+	}
+	return 0;
+}
+
+const char* GetLiveSessionPropertyString(unsigned int session_id, unsigned int property_id)
+{
+#pragma EXPORT_FUNCTION
+
+	if (CSessionRef session = FindOpenSession(session_id, false))
+	{
+		return session->GetPropertyString(property_id);
+	}
+	return nullptr;
+}
+
+/////////////////////////////////////////////////////////////////
+// CNameHashRegistry
+
+struct CNameHashRegistry::SNames
+{
+	std::unordered_map<unsigned int, std::string>	m_Names;
+};
+
+CNameHashRegistry::CNameHashRegistry()
+	: m_Names(new SNames())
+{}
+
+CNameHashRegistry::~CNameHashRegistry()
+{
+	delete m_Names;
+}
+
+unsigned int CNameHashRegistry::Register(const char* name)
+{
+	const unsigned int hash = HashPairName(name);
+
+	std::unordered_map<unsigned int, std::string>& names = m_Names->m_Names;
+
+	auto iter = names.find(hash);
+	if (iter == end(names))
+	{
+		names.emplace(hash, name);
+	}
+	else if (iter->second != name)
+	{
+		++m_Collisions;
+
+		if (g_VerboseLevel && g_Logger)
+		{
+			std::string info("[NameHash] Names have the same hash - ");
+			info += iter->second;
+			info += ", ";
+			info += name;
+			info += ", hash - ";
+			info += std::to_string(hash);
+
+			g_Logger->LogError(info.c_str());
+		}
+	}
+	return hash;
+}
+
+const char* CNameHashRegistry::FindName(const unsigned int hash) const
+{
+	const std::unordered_map<unsigned int, std::string>& names = m_Names->m_Names;
+
+	auto iter = names.find(hash);
+	return (iter != end(names)) ? iter->second.c_str() : nullptr;
+}
+
+int CNameHashRegistry::GetCollisionsCount() const
+{
+	return m_Collisions;
+}
+
+void CNameHashRegistry::Clear()
+{
+	m_Names->m_Names.clear();
+	m_Collisions = 0;
 }
 
 /////////////////////////////////////////////////////////////////
@@ -29,12 +29,14 @@
 
 #ifdef SWIG
 	#define LIBRARY_API
-#else
+#elif defined(_WIN32)
 	#ifdef AnimLiveBridgeAPI_EXPORTS
 		#define LIBRARY_API __declspec(dllexport)
 	#else
 		#define LIBRARY_API __declspec(dllimport)
 	#endif
+#else
+	#define LIBRARY_API __attribute__((visibility("default")))
 #endif
 
 // TODO: start using namespace and make it compatible with a swig setup
@@ -48,12 +50,14 @@
 	enum class ECommunicationType
 	{
 		SharedMemory,
-		NetworkTCP
+		NetworkTCP,
+		NetworkUDP		// one way multicast fan-out from a server to many clients
 	};
 
 #ifdef SWIG
 	constexpr ECommunicationType SharedMemory = ECommunicationType::SharedMemory;
 	constexpr ECommunicationType NetworkTCP = ECommunicationType::NetworkTCP;
+	constexpr ECommunicationType NetworkUDP = ECommunicationType::NetworkUDP;
 #endif
 
 	enum ELiveSessionProperties
@@ -63,9 +67,70 @@
 		ELiveSessionProperty_IsServer,
 		ELiveSessionProperty_NetworkAddress,
 		ELiveSessionProperty_NetworkPort,
+		ELiveSessionProperty_ExchangeMode,
+		ELiveSessionProperty_PoseCodec,						// network transports encode joints with a quantized pose codec (server side)
+		ELiveSessionProperty_PoseCodecTranslationBits,		// bits per translation component, 0 for a default 16
+		ELiveSessionProperty_PoseCodecRotationBits,			// bits per rotation component, 0 for a default 12
+		ELiveSessionProperty_JointsCapacity,				// frame joints capacity, 0 for a default NUMBER_OF_JOINTS, a client gets it from a server
+		ELiveSessionProperty_PropsCapacity,					// frame properties capacity, 0 for a default NUMBER_OF_PROPERTIES
+		ELiveSessionProperty_EntitiesCapacity,				// frame entity blocks capacity, 0 for a single model frame (m_ModelNameHash)
+		ELiveSessionProperty_WaitStrategy,					// EWaitStrategy for HardwareWaitForFrame
+		ELiveSessionProperty_WaitSpinCount,					// busy poll iterations before yielding, 0 for a default 2000
+		ELiveSessionProperty_WaitYieldCount,				// yield iterations before blocking in a kernel, 0 for a default 50
+		ELiveSessionProperty_IOThread,						// 1 - a session worker thread exchanges frames, HardwareCommit never waits for a transport
+		ELiveSessionProperty_IOThreadAffinity,				// worker cpu bit mask, 0 for any cpu
+		ELiveSessionProperty_IOThreadPriority,				// worker priority, -1 below normal, 0 normal, 1 above normal, 2 highest, 3 time critical
+		ELiveSessionProperty_JitterBufferDelay,				// client jitter buffer delay in milliseconds, 0 to sample frames as they come
+		ELiveSessionProperty_JitterBufferInterpolation,		// EPoseInterpolation for jitter buffer rotations
+		ELiveSessionProperty_JointSchema,					// 1 - network server sends joint names, parents and flags once, frames carry transforms only
+		ELiveSessionProperty_ClockSync,						// 1 - tcp frames carry clock samples, a server stamps m_ServerPlayer.m_SystemTime (both sides)
 		ELiveSessionProperty_Count
 	};
 
+	enum EExchangeMode
+	{
+		EExchangeMode_PingPong,			// server and client take turns, commit returns -1 while another side holds a buffer
+		EExchangeMode_LatestValue		// writer never waits, reader gets the newest complete frame
+	};
+
+	enum EWaitStrategy
+	{
+		EWaitStrategy_Hybrid,			// spin, then yield, then block in a kernel until a frame or a timeout
+		EWaitStrategy_Spin,				// busy poll only, lowest latency and a full core
+		EWaitStrategy_Block				// block in a kernel right away, no cpu is used while idle
+	};
+
+	enum EPoseInterpolation
+	{
+		EPoseInterpolation_Nlerp,		// normalized linear blend, cheap and close to slerp for small steps between frames
+		EPoseInterpolation_Slerp		// constant angular velocity
+	};
+
+	enum EChannelType
+	{
+		EChannelType_Float,					// 4 bytes, one value
+		EChannelType_Vector3,				// 12 bytes, x y z
+		EChannelType_Quaternion,			// 16 bytes, x y z w
+		EChannelType_Int,					// 4 bytes, one value, exact in a float up to 2^24
+		EChannelType_Weight16,				// 2 bytes, one value in 0..1 range with 1/65535 steps
+		EChannelType_Count
+	};
+
+	enum ELiveBridgeLogMode
+	{
+		ELiveBridgeLogMode_Immediate,		// a message is formatted and passed to a logger on a calling thread
+		ELiveBridgeLogMode_Deferred,		// per frame messages are queued with raw arguments, DrainLiveBridgeLog formats them
+		ELiveBridgeLogMode_DeferredThread	// the same queue, a library thread drains it
+	};
+
+	enum ELiveSessionLatency
+	{
+		ELiveSessionLatency_Commit,			// HardwareCommit call duration
+		ELiveSessionLatency_Wait,			// HardwareWaitForFrame duration until a frame is ready
+		ELiveSessionLatency_Handoff,		// time between successful commits, a round trip for a ping pong pair
+		ELiveSessionLatency_Count
+	};
+
 	enum ELimits
 	{
 		NUMBER_OF_JOINTS			= 128,
@@ -96,8 +161,10 @@
 		unsigned int	m_ClientTag;
 		unsigned int	m_ModelsCount;
 		unsigned int	m_PropsCount;
-		unsigned int	m_ModelsOffset;
-		unsigned int	m_PropsOffset;
+		unsigned int	m_ModelsOffset;		// byte offset of joints from the beginning of a frame, 0 for a fixed SSharedModelData layout
+		unsigned int	m_PropsOffset;		// byte offset of properties from the beginning of a frame, 0 for a fixed SSharedModelData layout
+		unsigned int	m_EntitiesCount;	// number of entity blocks, 0 for a single model frame
+		unsigned int	m_EntitiesOffset;	// byte offset of entity blocks from the beginning of a frame, 0 if there is no entities capacity
 	};
 
 	struct SVector3
@@ -148,6 +215,52 @@
 		SPropertyData	m_Data[NUMBER_OF_PROPERTIES];
 	};
 
+	// session counters, see GetLiveSessionStats
+	struct SLiveSessionStats
+	{
+		unsigned long long	m_Commits;				// HardwareCommit calls
+		unsigned long long	m_CommitsMissed;		// commits which returned -1, a frame was not handed off
+		unsigned long long	m_CommitErrors;			// commits which returned any other error
+		unsigned long long	m_FramesSent;
+		unsigned long long	m_FramesReceived;
+		unsigned long long	m_FramesDropped;		// frames a reader never saw (replaced by a newer one, late or lost)
+		unsigned long long	m_BytesSent;
+		unsigned long long	m_BytesReceived;
+	};
+
+	// latency percentiles in microseconds, see GetLiveSessionLatency
+	struct SLatencySummary
+	{
+		unsigned long long	m_Count;
+		double				m_Min;
+		double				m_Mean;
+		double				m_P50;
+		double				m_P90;
+		double				m_P99;
+		double				m_P999;
+		double				m_Max;
+	};
+
+	// clock offset estimate of a session, see GetLiveSessionClock
+	struct SLiveSessionClock
+	{
+		double				m_Offset;				// remote clock minus a local clock in seconds, from a sample with a least round trip
+		double				m_RoundTrip;			// round trip of that sample in seconds, without a remote side hold time
+		double				m_Drift;				// remote clock rate relative to a local clock in parts per million
+		unsigned long long	m_Samples;				// number of received clock samples
+	};
+
+	// one character (model) in a multi-entity frame, owns a range of frame joints and properties
+	struct SEntityBlock
+	{
+		unsigned int		m_ModelNameHash;		// we bind to a specified model
+		unsigned int		m_ModelResourceHash;	// could be skeleton, geometry export resource
+		unsigned int		m_JointsStart;			// index of a first entity joint
+		unsigned int		m_JointsCount;
+		unsigned int		m_PropsStart;			// index of a first entity property
+		unsigned int		m_PropsCount;
+	}; // 24 bytes
+
 	struct SPlayerInfo
 	{
 		double		m_SystemTime;
@@ -179,6 +292,47 @@
 		SPropertyDataArray	m_Properties;	//< could be wrinkle map or anything else
 	};
 
+	////////////////////////////////////////////////////////////////////////////
+	// variable-length frame
+	//  a frame is SSharedModelData fields up to m_Joints, then joints and properties at m_ModelsOffset / m_PropsOffset
+	//  with a default capacity (NUMBER_OF_JOINTS, NUMBER_OF_PROPERTIES) offsets are the same as fixed m_Joints / m_Properties
+	//  use GetModelJoints / GetModelProperties instead of m_Joints / m_Properties when a session capacity is changed
+	//  a frame with entities capacity holds several models, every entity block points to a range of joints and properties
+
+	inline SJointData* GetModelJoints(SSharedModelData* data)
+	{
+		return (data->m_Header.m_ModelsOffset > 0)
+			? reinterpret_cast<SJointData*>(reinterpret_cast<char*>(data) + data->m_Header.m_ModelsOffset) : data->m_Joints.m_Data;
+	}
+
+	inline const SJointData* GetModelJoints(const SSharedModelData* data)
+	{
+		return GetModelJoints(const_cast<SSharedModelData*>(data));
+	}
+
+	inline SPropertyData* GetModelProperties(SSharedModelData* data)
+	{
+		return (data->m_Header.m_PropsOffset > 0)
+			? reinterpret_cast<SPropertyData*>(reinterpret_cast<char*>(data) + data->m_Header.m_PropsOffset) : data->m_Properties.m_Data;
+	}
+
+	inline const SPropertyData* GetModelProperties(const SSharedModelData* data)
+	{
+		return GetModelProperties(const_cast<SSharedModelData*>(data));
+	}
+
+	//! entity blocks follow properties, nullptr when a frame has no entities capacity
+	inline SEntityBlock* GetModelEntities(SSharedModelData* data)
+	{
+		return (data->m_Header.m_EntitiesOffset > 0)
+			? reinterpret_cast<SEntityBlock*>(reinterpret_cast<char*>(data) + data->m_Header.m_EntitiesOffset) : nullptr;
+	}
+
+	inline const SEntityBlock* GetModelEntities(const SSharedModelData* data)
+	{
+		return GetModelEntities(const_cast<SSharedModelData*>(data));
+	}
+
 	//////////////////////////////////////////////////////////////
 	// STimelineSyncManager
 	// LIBRARY_API
@@ -226,6 +380,66 @@
 	};
 
 
+	//////////////////////////////////////////////////////////////
+	// name hash, FNV-1a 32 bit, the same value with any compiler, standard library and platform
+
+	const unsigned int NAME_HASH_BASIS = 2166136261u;
+	const unsigned int NAME_HASH_PRIME = 16777619u;
+
+#ifndef SWIG
+	//! a name hash at compile time, the same value as HashPairName returns
+	/*!
+		constexpr unsigned int hips_hash = HashNameConst("Hips");
+		\param name a null terminated string
+		\param hash a hash of a previous part of a string, keep a default basis for a new name
+		\return a 32 bit name hash
+		\sa HashPairName
+	*/
+	constexpr unsigned int HashNameConst(const char* name, const unsigned int hash = NAME_HASH_BASIS)
+	{
+		return (*name != 0) ? HashNameConst(name + 1, (hash ^ static_cast<unsigned char>(*name)) * NAME_HASH_PRIME) : hash;
+	}
+#endif
+
+	//////////////////////////////////////////////////////////////
+	// CNameHashRegistry
+	//  hashes a joint set when it's loaded and reports names with the same 32 bit hash,
+	//  such joints can't be told apart in a stream, rename one of them
+	//  names are kept inside a library, no standard library type crosses a dll boundary
+	// LIBRARY_API
+	class LIBRARY_API CNameHashRegistry
+	{
+	public:
+
+		CNameHashRegistry();
+		~CNameHashRegistry();
+
+		CNameHashRegistry(const CNameHashRegistry&) = delete;
+		CNameHashRegistry& operator=(const CNameHashRegistry&) = delete;
+
+		//! hash a name and keep it, a collision is counted and logged when a different name has the same hash
+		/*!
+			\param name a joint or property name
+			\return a name hash, the same as HashPairName
+		*/
+		unsigned int Register(const char* name);
+
+		//! a registered name of a hash, nullptr for an unknown hash
+		const char* FindName(const unsigned int hash) const;
+
+		//! a number of registered names which have a hash of another name
+		int GetCollisionsCount() const;
+
+		void Clear();
+
+	protected:
+		struct SNames;
+
+		SNames*		m_Names{ nullptr };			//!< name hash -> name, defined in AnimLiveBridge.cpp
+		int			m_Collisions{ 0 };
+	};
+
+
 	// log LIBRARY_API
 	class  CLiveBridgeLogger
 	{
@@ -235,32 +449,67 @@
 		virtual void LogError(const char* info) { };
 	};
 
+	// called on a session io thread when a frame is exchanged, see ELiveSessionProperty_IOThread
+	typedef void(*LiveBridgeFrameCallback)(unsigned int session_id, void* user_data);
+
 //};
 
 extern "C"
 {
+	//! copy joints / properties into a frame, a copy is clamped to a frame capacity
+	/*!
+		NOTE: deprecated, use SetModelDataJoints / SetModelDataProperties with a session id. A frame header has no properties capacity,
+		so a frame with a session capacity and no entities has to be a MapModelData one, properties are not written otherwise
+	*/
 	void SetModelJointData(SSharedModelData* model_data, const std::vector<SJointData>& data);
 	void SetModelPropertyData(SSharedModelData* model_data, const std::vector<SPropertyData>& data);
 
 	//! utility function to generate a hash value for a string
 	/*!
-		Use this function to generate objects keys
+		Use this function to generate objects keys, it's FNV-1a and a value is stable between compilers and platforms.
+		Names known at compile time could be hashed with HashNameConst, check a loaded joint set with CNameHashRegistry
 		\param pair_name provide a string to generate a key out of it
-		\return a generated 32 bit unique hash value
+		\return a generated 32 bit hash value
+		\sa HashNameConst, CNameHashRegistry
 	*/
 	unsigned int HashPairName(const char* pair_name);
 
+	//! get an id of a frame joints layout
+	/*!
+		an id is a hash of joint name hashes, parents and flags, it's changed only when a streamed rig is changed.
+		Compare it with a last one to know when a joint remap should be built again
+		\param model_data a frame to check
+		\return a layout id, 0 if a frame has no joints
+		\sa BuildJointRemap, ELiveSessionProperty_JointSchema
+	*/
+	unsigned int GetJointSchemaId(const SSharedModelData* model_data);
+
+	//! find frame joints of local objects once, then read them by index
+	/*!
+		\param model_data a frame with a joints layout
+		\param name_hashes local object name hashes
+		\param count number of local objects
+		\param remap output, a frame joint index for every local object or -1 if an object is not streamed
+		\return number of found objects
+		\sa GetJointSchemaId
+	*/
+	int BuildJointRemap(const SSharedModelData* model_data, const unsigned int* name_hashes, const unsigned int count, int* remap);
+
 	//! open server or client (session is storing local properties, states and data that you can map and read/modify)
 	/*!
 		Everything should start with starting a new session, assigning properties and opening hardware
-		\return unique session id that you can use to get/set properties/data for the session 
+		A session id keeps a slot generation, an id of a freed session is never valid again. Sessions could be created, used and freed from any thread
+		\return unique session id that you can use to get/set properties/data for the session,
+			0 if all 65536 session slots are in use (slots are added by 256 when they are needed)
 	*/
 	unsigned int NewLiveSession();
 
 	//! close hardware and erase data associated with a session id
 	/*!
+		a free waits until calls of other threads on the same session return (a HardwareWaitForFrame up to its timeout),
+		later calls with this id fail. NOTE: don't free a session from a frame callback of that session
 		\param session_id specify a session id which you want to free
-		\return true if operation is successful
+		\return true if operation is successful, false for an unknown or an already freed session id
 	*/
 	bool FreeLiveSession(unsigned int session_id);
 
@@ -332,6 +581,268 @@ extern "C"
 	*/
 	bool SetModelDataProperties(unsigned int session_id, const std::vector<SPropertyData>& data);
 
+	//! assign local buffer entity blocks from a specified data array
+	/*!
+		every entity points to a range of frame joints and properties, all entities are sent with one commit.
+		Session should have ELiveSessionProperty_EntitiesCapacity assigned before HardwareOpen
+		\param session_id specify on which session you want to set a property
+		\param data - vector of entity blocks, sets m_EntitiesCount as well
+		\return false if session is not found or there is no entities capacity
+		\sa MapModelData, GetModelDataEntity
+	*/
+	bool SetModelDataEntities(unsigned int session_id, const std::vector<SEntityBlock>& data);
+
+	//! assign a range of local buffer joints from structure of arrays
+	/*!
+		values are converted and written straight into a frame, a producer with its own arrays skips an intermediate SJointData vector.
+		Any array could be nullptr, frame joints keep their values then. Flags and parents are not changed
+		\param session_id specify on which session you want to set a property
+		\param first index of a first frame joint to write
+		\param count number of joints in arrays
+		\param name_hashes count name hashes
+		\param translations count * 3 values, x y z
+		\param rotations count * 4 values, x y z w for a quaternion, or euler x y z and an unused w
+		\param scales count * 3 values, x y z
+		\return 0 if succeed, -3 if a session is not open, -5 if a range doesn't fit into a joints capacity
+		\sa SetModelDataJointsSoAd, SetModelDataPropertiesSoA, MapModelData
+	*/
+	int SetModelDataJointsSoA(unsigned int session_id, const unsigned int first, const unsigned int count,
+		const unsigned int* name_hashes, const float* translations, const float* rotations, const float* scales);
+
+	//! assign a range of local buffer joints from structure of arrays in double precision, values are rounded to float
+	/*!
+		\sa SetModelDataJointsSoA
+	*/
+	int SetModelDataJointsSoAd(unsigned int session_id, const unsigned int first, const unsigned int count,
+		const unsigned int* name_hashes, const double* translations, const double* rotations, const double* scales);
+
+	//! assign a range of local buffer properties from structure of arrays
+	/*!
+		\param session_id specify on which session you want to set a property
+		\param first index of a first frame property to write
+		\param count number of properties in arrays
+		\param name_hashes count name hashes, nullptr keeps frame hashes
+		\param values count values, nullptr keeps frame values
+		\return 0 if succeed, -3 if a session is not open, -5 if a range doesn't fit into a properties capacity
+		\sa SetModelDataPropertiesSoAd, SetModelDataJointsSoA
+	*/
+	int SetModelDataPropertiesSoA(unsigned int session_id, const unsigned int first, const unsigned int count,
+		const unsigned int* name_hashes, const float* values);
+
+	//! assign a range of local buffer properties from structure of arrays in double precision, values are rounded to float
+	/*!
+		\sa SetModelDataPropertiesSoA
+	*/
+	int SetModelDataPropertiesSoAd(unsigned int session_id, const unsigned int first, const unsigned int count,
+		const unsigned int* name_hashes, const double* values);
+
+	//! number of joints a local buffer could hold
+	/*!
+		a session capacity is known after HardwareOpen, a client gets it from a server
+		\param session_id specify on which session you want to get a capacity
+		\return joints capacity of a local buffer, -3 if a session is not open
+		\sa GetModelDataPropertiesCapacity, MapModelData, ELiveSessionProperty_JointsCapacity
+	*/
+	int GetModelDataJointsCapacity(unsigned int session_id);
+
+	//! number of properties a local buffer could hold
+	/*!
+		\param session_id specify on which session you want to get a capacity
+		\return properties capacity of a local buffer, -3 if a session is not open
+		\sa GetModelDataJointsCapacity, MapModelData, ELiveSessionProperty_PropsCapacity
+	*/
+	int GetModelDataPropertiesCapacity(unsigned int session_id);
+
+	//! keep a memory of a local buffer alive for an external view, like a python memoryview
+	/*!
+		a local buffer is reallocated when a capacity changes (a client gets a larger frame) and freed on a session free,
+		a retained memory stays valid until a release, writes to it are not seen by a session after a reallocation
+		\param session_id specify on which session you want to retain a local buffer
+		\return a token for ReleaseModelDataBuffer, nullptr if a session is not open
+		\sa MapModelData, ReleaseModelDataBuffer
+	*/
+	void* RetainModelDataBuffer(unsigned int session_id);
+
+	//! release a token of RetainModelDataBuffer, the memory is freed if a session doesn't use it anymore
+	void ReleaseModelDataBuffer(void* token);
+
+	//! assign a layout of typed property channels
+	/*!
+		channel values are packed contiguously without name hashes and are sent in place of frame properties, a layout is sent
+		with a first frame and repeated every 30 frames. A session needs ELiveSessionProperty_PropsCapacity for a block with a layout
+		(16 bytes, 8 bytes per channel and a payload in 8 byte property slots). Don't mix channels with SetModelDataProperties
+		\param session_id specify on which session you want to set a layout
+		\param name_hashes count channel name hashes
+		\param types count EChannelType values
+		\param count number of channels, 0 to stop sending channels
+		\return 0 if succeed, -1 for an unknown type, -3 if a session is not open, -5 if a block doesn't fit into a properties capacity
+		\sa SetModelDataChannelValues, ReadModelDataChannels, EChannelType
+	*/
+	int SetModelDataChannelLayout(unsigned int session_id, const unsigned int* name_hashes, const unsigned int* types, const unsigned int count);
+
+	//! assign values of a range of channels, a frame gets them on a next commit
+	/*!
+		\param session_id specify on which session you want to set values
+		\param first index of a first channel
+		\param count number of channels
+		\param values float values one after another, 1 for float, int and weight, 3 for a vector, 4 for a quaternion
+		\return 0 if succeed, -3 if a session is not open, -5 if a range is out of a layout
+		\sa SetModelDataChannelLayout
+	*/
+	int SetModelDataChannelValues(unsigned int session_id, const unsigned int first, const unsigned int count, const float* values);
+
+	//! read a channel block of a received frame
+	/*!
+		a layout is kept from a last frame which had it, values are kept until a next read
+		\param session_id specify on which session you want to read channels
+		\return number of channels, -1 if a frame has no channels or a layout is not received yet, -3 if a session is not open
+		\sa GetModelDataChannelValues, FindModelDataChannel, GetModelDataChannelType
+	*/
+	int ReadModelDataChannels(unsigned int session_id);
+
+	//! get values of a range of channels which were read by ReadModelDataChannels
+	/*!
+		\param values output, the same packing as SetModelDataChannelValues
+		\return number of written floats, -3 if a session is not open, -5 if a range is out of a layout
+		\sa ReadModelDataChannels
+	*/
+	int GetModelDataChannelValues(unsigned int session_id, const unsigned int first, const unsigned int count, float* values);
+
+	//! index of a channel with a name hash in a last read layout, -1 if it's not found, -3 if a session is not open
+	int FindModelDataChannel(unsigned int session_id, const unsigned int name_hash);
+
+	//! EChannelType of a channel in a last read layout, -1 if an index is out of a layout, -3 if a session is not open
+	int GetModelDataChannelType(unsigned int session_id, const unsigned int index);
+
+	//! read one entity block of a local buffer
+	/*!
+		\param session_id specify on which session you want to set a property
+		\param index entity index, should be less than m_Header.m_EntitiesCount
+		\param entity - output entity block
+		\return false if session is not found or index is out of range
+		\sa SetModelDataEntities
+	*/
+	bool GetModelDataEntity(unsigned int session_id, unsigned int index, SEntityBlock& entity);
+
+	//! encode joints with a quantized pose codec
+	/*!
+		translation and euler angles are quantized relative to a per-frame bound, quaternion is packed as smallest three components,
+		a default scale is omitted. Network transports use it when ELiveSessionProperty_PoseCodec is set
+		\param joints array of joints to encode
+		\param count number of joints in the array
+		\param translation_bits bits per translation component [4; 24], 0 for a default 16
+		\param rotation_bits bits per rotation component [4; 20], 0 for a default 12
+		\param buffer output buffer
+		\param buffer_size output buffer size, 60 + 46 bytes per joint is always enough
+		\return encoded size in bytes or 0 if the buffer is too small
+		\sa DecodePose, GetPoseErrorBound
+	*/
+	unsigned int EncodePose(const SJointData* joints, unsigned int count, unsigned int translation_bits, unsigned int rotation_bits, unsigned char* buffer, unsigned int buffer_size);
+
+	//! decode joints which were encoded with EncodePose
+	/*!
+		a decoded quaternion could have an opposite sign, it's the same rotation
+		\param buffer encoded data
+		\param size encoded data size
+		\param joints output array of joints
+		\param max_count capacity of the output array
+		\return number of decoded joints or -1 if the data is not valid
+		\sa EncodePose
+	*/
+	int DecodePose(const unsigned char* buffer, unsigned int size, SJointData* joints, unsigned int max_count);
+
+	//! max absolute error of a decoded component for an encoded pose
+	/*!
+		\param buffer encoded data
+		\param size encoded data size
+		\param translation_error max error per translation axis
+		\param euler_error max error per euler angle
+		\param quaternion_error max error of a quaternion component (up to a sign)
+		\return false if the data is not an encoded pose
+		\sa EncodePose
+	*/
+	bool GetPoseErrorBound(const unsigned char* buffer, unsigned int size, SVector3& translation_error, SVector3& euler_error, float& quaternion_error);
+
+	//! convert euler angles to quaternions for a batch of values
+	/*!
+		angles are in degrees, XYZ order - rotation around X, followed by Y and then Z.
+		Math functions run simd kernels (avx2 or sse2) over blocks of values, a scalar kernel handles a tail
+		\param euler count euler angles
+		\param quaternions output count quaternions, x y z w
+		\param count number of values
+		\sa QuaternionsToEuler, GetMathKernelName
+	*/
+	void EulerToQuaternions(const SVector3* euler, SVector4* quaternions, unsigned int count);
+
+	//! convert quaternions to euler angles in degrees, XYZ order
+	/*!
+		\sa EulerToQuaternions
+	*/
+	void QuaternionsToEuler(const SVector4* quaternions, SVector3* euler, unsigned int count);
+
+	//! multiply quaternions, result = a * b applies b first and then a
+	/*!
+		\param a count left quaternions
+		\param b count right quaternions
+		\param result output count quaternions, it could be a or b
+		\param count number of values
+	*/
+	void MultiplyQuaternions(const SVector4* a, const SVector4* b, SVector4* result, unsigned int count);
+
+	//! decompose matrices into translation, rotation quaternion and scale
+	/*!
+		a matrix is 16 doubles with X, Y, Z axis and translation rows, the same layout as FBMatrix and MMatrix.
+		A mirrored matrix is not supported
+		\param matrices count * 16 values
+		\param transforms output count transforms
+		\param count number of matrices
+		\sa TransformsToMatrices
+	*/
+	void MatricesToTransforms(const double* matrices, STransform* transforms, unsigned int count);
+
+	//! compose matrices from translation, rotation quaternion and scale
+	/*!
+		\sa MatricesToTransforms
+	*/
+	void TransformsToMatrices(const STransform* transforms, double* matrices, unsigned int count);
+
+	//! convert joint rotations to one type, joints of another type are converted and their flags are updated
+	/*!
+		\param joints array of joints
+		\param count number of joints
+		\param rotation_hint HINT_ROTATION_QUATERNION or HINT_ROTATION_EULERANGLES
+	*/
+	void ConvertJointRotations(SJointData* joints, unsigned int count, unsigned int rotation_hint);
+
+	//! convert joints between local and model space
+	/*!
+		joints are ordered by parent hashes once per joints layout (a layout is cached per calling thread), then a frame is converted
+		with one pass over contiguous matrices. A joint is in model space with HINT_TRANSFORM_MODEL, otherwise it's local to its parent,
+		a joint without a parent in the array is a root. Rotations keep their type, a space flag is replaced
+		\param joints array of joints
+		\param count number of joints
+		\param space_hint HINT_TRANSFORM_LOCAL or HINT_TRANSFORM_MODEL
+		\return 0 if succeed, -1 if joints have a parent cycle
+		\sa ConvertModelDataSpace
+	*/
+	int ConvertJointSpace(SJointData* joints, unsigned int count, unsigned int space_hint);
+
+	//! convert joints of a local buffer between local and model space
+	/*!
+		every entity block is converted separately, a joints order is kept by a session
+		\param session_id specify on which session you want to set a property
+		\param space_hint HINT_TRANSFORM_LOCAL or HINT_TRANSFORM_MODEL
+		\return 0 if succeed, -1 if joints have a parent cycle, -3 if a session is not open, -5 if an entity range is out of frame joints
+		\sa ConvertJointSpace, MapModelData
+	*/
+	int ConvertModelDataSpace(unsigned int session_id, unsigned int space_hint);
+
+	void ConvertDoublesToFloats(const double* src, float* dst, unsigned int count);
+	void ConvertFloatsToDoubles(const float* src, double* dst, unsigned int count);
+
+	//! a compiled math kernel - "avx2", "sse2" or "scalar"
+	const char* GetMathKernelName();
+
 	//! starts a communication
 	/*!
 		NOTE! you should have administrative rights for a shared memory communication!
@@ -357,11 +868,206 @@ extern "C"
 		updated shared memory with a local buffer data or send/receive packets via a network
 		\param session_id specify on which session you want to set a property
 		\param auto_finish_event do we want to automatically trigger that client is finished the update process and transfer a control
-		\return 0 if succeed, otherwise returns a error code
-		\sa SetFinishEvent
+		\return 0 if succeed, -1 if it's not our turn or there is no new frame, -4 if a torn frame was detected, -5 if a frame doesn't fit into a transport, otherwise returns a error code
+		\sa SetFinishEvent, EExchangeMode
 	*/
 	int HardwareCommit(unsigned int session_id, const bool auto_finish_event=true);
 
+	//! wait until a next HardwareCommit has a frame to exchange
+	/*!
+		a server waits for its turn, a client waits for a new server frame. A strategy is taken from ELiveSessionProperty_WaitStrategy,
+		a hybrid one spins ELiveSessionProperty_WaitSpinCount times, yields ELiveSessionProperty_WaitYieldCount times and then blocks
+		\param session_id specify on which session you want to set a property
+		\param timeout_ms max time to wait in milliseconds, 0 only checks a current state
+		\return 0 if a frame is ready, -1 if a timeout is expired, -3 if a session is not open
+		\sa HardwareCommit, EWaitStrategy
+	*/
+	int HardwareWaitForFrame(unsigned int session_id, unsigned int timeout_ms);
+
+	//! get a live bridge clock, a monotonic time in seconds which is used to timestamp received frames
+	double GetLiveBridgeTime();
+
+	//! sample a client jitter buffer at a caller evaluation time
+	/*!
+		a client with ELiveSessionProperty_JitterBufferDelay keeps received frames with a sender m_ServerPlayer.m_SystemTime which a server
+		session stamps on commit (an arrival time for an unstamped frame) and a pose is interpolated at a time minus a delay. Frames still have to be received with
+		HardwareCommit or AcquireReadView, an io thread receives them on its own
+		\param session_id specify on which session you want to sample a pose
+		\param time evaluation time from GetLiveBridgeTime, 0 for a current time
+		\return interpolated frame, valid until a next sample, nullptr if a jitter buffer is off, it's empty or session is not found
+		\sa ELiveSessionProperty_JitterBufferDelay, EPoseInterpolation
+	*/
+	const SSharedModelData* SampleModelData(unsigned int session_id, double time);
+
+	//! read session counters
+	/*!
+		counters are updated on a commit with relaxed atomics, so they could be read from any thread while a session is streaming
+		\param session_id specify on which session you want to read counters
+		\param stats - output counters
+		\return false if session is not found
+		\sa GetLiveSessionLatency, ResetLiveSessionStats
+	*/
+	bool GetLiveSessionStats(unsigned int session_id, SLiveSessionStats& stats);
+
+	//! read latency percentiles of a session histogram
+	/*!
+		histograms have a log-linear buckets with about 3% precision from a nanosecond up to several minutes
+		\param session_id specify on which session you want to read a histogram
+		\param latency_id - ELiveSessionLatency histogram
+		\param summary - output percentiles in microseconds
+		\return false if session is not found or latency_id is out of range
+		\sa GetLiveSessionStats, ELiveSessionLatency
+	*/
+	bool GetLiveSessionLatency(unsigned int session_id, unsigned int latency_id, SLatencySummary& summary);
+
+	//! zero all session counters and histograms
+	bool ResetLiveSessionStats(unsigned int session_id);
+
+	//! read a session clock offset estimate
+	/*!
+		with ELiveSessionProperty_ClockSync tcp frames and client feedback carry NTP style clock samples, every round gives an offset
+		and a round trip, an offset is taken from a sample with a least round trip of last 8 and a drift rate is a line fit over last
+		filtered offsets. Other transports keep a zero offset, a shared memory pair has a same clock
+		\param session_id specify on which session you want to read a clock
+		\param clock - output estimate, zero until a first complete round
+		\return false if session is not found
+		\sa GetLiveSessionClockTime, GetModelDataFrameAge
+	*/
+	bool GetLiveSessionClock(unsigned int session_id, SLiveSessionClock& clock);
+
+	//! get a shared session time base, a server GetLiveBridgeTime clock mapped with an offset and a drift rate on a client
+	/*!
+		\return time in seconds, -1.0 if a session is not found
+		\sa GetLiveSessionClock, GetLiveBridgeTime
+	*/
+	double GetLiveSessionClockTime(unsigned int session_id);
+
+	//! get an age of a current session frame, a shared time base now minus a frame m_ServerPlayer.m_SystemTime
+	/*!
+		a server session stamps m_ServerPlayer.m_SystemTime with GetLiveBridgeTime on every HardwareCommit, a synced tcp clock maps it to a client time base
+		\return age in seconds, -1.0 if a frame is not stamped or a session is not found
+		\sa GetLiveSessionClockTime
+	*/
+	double GetModelDataFrameAge(unsigned int session_id);
+
+	//! assign a frame ready callback for a session io thread
+	/*!
+		a callback is called on an io thread right after a frame is exchanged with a remote side and placed into a session mailbox,
+		a caller takes it with HardwareCommit. Keep a callback short, it delays a next exchange
+		\param session_id specify on which session you want to set a property
+		\param callback function to call or nullptr to remove it
+		\param user_data a value which is passed back to a callback
+		\return true if a session is found
+		\sa ELiveSessionProperty_IOThread, HardwareWaitForFrame
+	*/
+	bool SetFrameReadyCallback(unsigned int session_id, LiveBridgeFrameCallback callback, void* user_data);
+
+	//! get a handle which becomes readable when an io thread has a new frame
+	/*!
+		an eventfd on linux, a pipe on other posix systems and a socket on windows. Register it in an event loop (asyncio add_reader,
+		QSocketNotifier, select), take a frame with HardwareCommit and clear a handle with ResetFrameReadyHandle, nobody waits inside a library.
+		Only a session with ELiveSessionProperty_IOThread signals a handle. A handle is owned by a session, it's closed by FreeLiveSession
+		\param session_id specify on which session you want to get a handle
+		\return a handle, the same one for every call, -1 if it can't be created, -3 if session is not found
+		\sa ResetFrameReadyHandle, SetFrameReadyCallback, ELiveSessionProperty_IOThread
+	*/
+	long long GetFrameReadyHandle(unsigned int session_id);
+
+	//! clear a frame ready handle
+	/*!
+		\param session_id specify on which session you want to clear a handle
+		\return a number of frames which were signaled since a last reset, -3 if session is not found
+		\sa GetFrameReadyHandle
+	*/
+	int ResetFrameReadyHandle(unsigned int session_id);
+
+	//! start recording every committed frame of a session into a take file
+	/*!
+		a take is a memory-mapped file, frames are packed straight into a mapped view on a commit. A server records frames it sends,
+		a client records frames it receives
+		\param session_id specify on which session you want to record
+		\param file_name a take file, an existing file is overwritten
+		\return 0 if succeed, -1 on a file error, -3 if session is not found
+		\sa StopTakeRecording, StartTakeReplay
+	*/
+	int StartTakeRecording(unsigned int session_id, const char* file_name);
+
+	//! finish a take file
+	/*!
+		\param session_id specify on which session you want to stop recording
+		\return recorded frames count, -1 if session is not recording, -3 if session is not found
+		\sa StartTakeRecording
+	*/
+	int StopTakeRecording(unsigned int session_id);
+
+	//! replay a take into an opened server session
+	/*!
+		frames are committed from a replay thread with their recorded timing, don't commit a session from a caller while a replay is running.
+		A frame which is not taken by a client until a next frame is due is dropped
+		\param session_id specify on which server session you want to replay a take
+		\param file_name a take file
+		\param speed a multiple of a recorded timing, 0 to replay as fast as a client takes frames
+		\param loop start over after a last frame
+		\return 0 if succeed, -1 on a file error or if a session is not a server, -3 if session is not open, -5 if take frames don't fit a session capacity
+		\sa StopTakeReplay, SeekTakeReplay, GetTakeReplayPosition
+	*/
+	int StartTakeReplay(unsigned int session_id, const char* file_name, double speed, bool loop);
+
+	//! stop a replay thread and close a take
+	bool StopTakeReplay(unsigned int session_id);
+
+	//! get a next frame to replay
+	/*!
+		\param session_id specify on which session you are replaying a take
+		\return frame index, equal to take frames count when a replay is finished, -1 if there is no replay, -3 if session is not found
+		\sa StartTakeReplay, SeekTakeReplay
+	*/
+	int GetTakeReplayPosition(unsigned int session_id);
+
+	//! continue a running replay from a given frame
+	/*!
+		\return false if session is not found, a replay is not running or frame index is out of a take
+		\sa StartTakeReplay, GetTakeReplayPosition
+	*/
+	bool SeekTakeReplay(unsigned int session_id, unsigned int frame_index);
+
+	//! get a writable slot directly inside a transport buffer (zero-copy commit)
+	/*!
+		Producer (server) writes a frame straight into the shared region, no local session buffer is involved.
+		Client feedback (look at, client player) is already in the slot, don't overwrite it.
+		\param session_id specify on which session you want to set a property
+		\return pointer to a slot or nullptr if it's not our turn yet or session is not found
+		\sa PublishWriteSlot, HardwareCommit
+	*/
+	SSharedModelData* AcquireWriteSlot(unsigned int session_id);
+
+	//! publish a slot which was acquired by AcquireWriteSlot
+	/*!
+		\param session_id specify on which session you want to set a property
+		\param auto_finish_event do we want to automatically transfer a control to a client
+		\return 0 if succeed, otherwise returns a error code
+		\sa AcquireWriteSlot, SetFinishEvent
+	*/
+	int PublishWriteSlot(unsigned int session_id, const bool auto_finish_event=true);
+
+	//! get a read-only view of the last published slot (zero-copy commit)
+	/*!
+		Consumer (client) reads a frame straight from the shared region
+		\param session_id specify on which session you want to set a property
+		\return pointer to a view or nullptr if there is no new frame or session is not found
+		\sa ReleaseReadView, HardwareCommit
+	*/
+	const SSharedModelData* AcquireReadView(unsigned int session_id);
+
+	//! finish reading a view which was acquired by AcquireReadView and write client feedback
+	/*!
+		\param session_id specify on which session you want to set a property
+		\param auto_finish_event do we want to automatically transfer a control to a server
+		\return 0 if succeed, otherwise returns a error code
+		\sa AcquireReadView, SetFinishEvent
+	*/
+	int ReleaseReadView(unsigned int session_id, const bool auto_finish_event=true);
+
 	//! set an event to transfer a control
 	/*!
 		NOTE: use only if flush data is not doing auto finish event!
@@ -395,4 +1101,25 @@ extern "C"
 		\param logger pointer to a callback
 	*/
 	void SetLiveBridgeLogger(CLiveBridgeLogger* logger);
+
+	//! choose how diagnostics reach a logger
+	/*!
+		in deferred modes a commit path only stores a message id and numbers in a lock-free ring buffer, nothing is formatted or allocated.
+		A full ring drops messages and counts them, a drain reports a number of dropped ones. Messages with names (open, take files) are not deferred
+		A drain thread of ELiveBridgeLogMode_DeferredThread runs only while there are live sessions, a free of the last session
+		or a switch to another mode joins it on a calling thread. NOTE: free all sessions or switch to an immediate mode before a library unload
+		\param mode ELiveBridgeLogMode, switching back to an immediate mode drains a ring
+		\sa DrainLiveBridgeLog, GetLiveBridgeLogDropped
+	*/
+	void SetLiveBridgeLogMode(const int mode);
+
+	//! format queued messages and pass them to a logger on a calling thread
+	/*!
+		\return number of drained messages
+		\sa SetLiveBridgeLogMode
+	*/
+	int DrainLiveBridgeLog();
+
+	//! total number of messages which didn't fit into a log ring buffer
+	unsigned int GetLiveBridgeLogDropped();
 };
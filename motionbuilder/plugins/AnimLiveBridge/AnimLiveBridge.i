@@ -11,18 +11,369 @@
 
 %feature("autodoc", "1");
 
+// python buffer protocol views and bulk setters, a caller passes array.array, numpy arrays or any sequence of numbers
+%{
+	#include <vector>
+	#include <cstring>
+
+	static_assert(sizeof(SJointData) == 52, "JOINT_FORMAT should describe SJointData");
+	static_assert(sizeof(SPropertyData) == 8, "PROPERTY_FORMAT should describe SPropertyData");
+
+	template<typename T> struct SPyFormat;
+	template<> struct SPyFormat<float> { static const char* Codes() { return "f"; } };
+	template<> struct SPyFormat<double> { static const char* Codes() { return "d"; } };
+	template<> struct SPyFormat<unsigned int> { static const char* Codes() { return "IiLl"; } };
+
+	static bool IsBufferFormat(const Py_buffer& view, const char* codes, const Py_ssize_t itemsize)
+	{
+		const char* format = (view.format != nullptr) ? view.format : "B";
+		if (*format == '@' || *format == '=' || *format == '<')
+			++format;
+
+		return view.itemsize == itemsize && format[0] != 0 && format[1] == 0 && strchr(codes, format[0]) != nullptr;
+	}
+
+	// a contiguous buffer of a matching type is used in place, any other sequence of numbers is copied
+	template<typename T>
+	class CPyStream
+	{
+	public:
+		const T*		m_Data{ nullptr };
+		Py_ssize_t		m_Size{ 0 };
+
+		~CPyStream()
+		{
+			if (m_HasView)
+				PyBuffer_Release(&m_View);
+		}
+
+		//! None keeps m_Data as nullptr, returns false with a python error set
+		bool Acquire(PyObject* obj)
+		{
+			if (obj == nullptr || obj == Py_None)
+				return true;
+
+			if (PyObject_CheckBuffer(obj))
+			{
+				if (PyObject_GetBuffer(obj, &m_View, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) == 0)
+				{
+					if (IsBufferFormat(m_View, SPyFormat<T>::Codes(), sizeof(T)))
+					{
+						m_HasView = true;
+						m_Data = static_cast<const T*>(m_View.buf);
+						m_Size = m_View.len / static_cast<Py_ssize_t>(sizeof(T));
+						return true;
+					}
+					PyBuffer_Release(&m_View);
+				}
+				PyErr_Clear();
+			}
+
+			PyObject* sequence = PySequence_Fast(obj, "expected a buffer or a sequence of numbers");
+			if (sequence == nullptr)
+				return false;
+
+			m_Size = PySequence_Fast_GET_SIZE(sequence);
+			m_Copy.resize(static_cast<size_t>(m_Size));
+
+			PyObject** items = PySequence_Fast_ITEMS(sequence);
+			for (Py_ssize_t i = 0; i < m_Size; ++i)
+			{
+				m_Copy[i] = static_cast<T>(PyFloat_AsDouble(items[i]));
+			}
+			Py_DECREF(sequence);
+
+			if (PyErr_Occurred())
+				return false;
+
+			m_Data = m_Copy.data();
+			return true;
+		}
+
+	private:
+		Py_buffer		m_View;
+		bool			m_HasView{ false };
+		std::vector<T>	m_Copy;
+	};
+
+	// a number of elements comes from a first given array, other arrays should match it
+	static bool MatchStreamCount(Py_ssize_t& count, const void* data, const Py_ssize_t size, const Py_ssize_t stride)
+	{
+		if (data == nullptr)
+			return true;
+		if (size % stride != 0 || (count >= 0 && count != size / stride))
+			return false;
+
+		count = size / stride;
+		return true;
+	}
+
+	static bool IsDoubleBuffer(PyObject* obj)
+	{
+		if (obj == nullptr || obj == Py_None || !PyObject_CheckBuffer(obj))
+			return false;
+
+		Py_buffer view;
+		if (PyObject_GetBuffer(obj, &view, PyBUF_FORMAT) != 0)
+		{
+			PyErr_Clear();
+			return false;
+		}
+		const bool is_double = IsBufferFormat(view, "d", sizeof(double));
+		PyBuffer_Release(&view);
+		return is_double;
+	}
+
+	static int SetJointsSoA(unsigned int session_id, unsigned int first, unsigned int count,
+		const unsigned int* name_hashes, const float* translations, const float* rotations, const float* scales)
+	{
+		return SetModelDataJointsSoA(session_id, first, count, name_hashes, translations, rotations, scales);
+	}
+
+	static int SetJointsSoA(unsigned int session_id, unsigned int first, unsigned int count,
+		const unsigned int* name_hashes, const double* translations, const double* rotations, const double* scales)
+	{
+		return SetModelDataJointsSoAd(session_id, first, count, name_hashes, translations, rotations, scales);
+	}
+
+	static int SetPropertiesSoA(unsigned int session_id, unsigned int first, unsigned int count,
+		const unsigned int* name_hashes, const float* values)
+	{
+		return SetModelDataPropertiesSoA(session_id, first, count, name_hashes, values);
+	}
+
+	static int SetPropertiesSoA(unsigned int session_id, unsigned int first, unsigned int count,
+		const unsigned int* name_hashes, const double* values)
+	{
+		return SetModelDataPropertiesSoAd(session_id, first, count, name_hashes, values);
+	}
+
+	template<typename T>
+	static PyObject* SetJointsBuffer(unsigned int session_id, unsigned int first,
+		PyObject* name_hashes, PyObject* translations, PyObject* rotations, PyObject* scales)
+	{
+		CPyStream<unsigned int> hashes;
+		CPyStream<T> t, r, s;
+
+		if (!hashes.Acquire(name_hashes) || !t.Acquire(translations) || !r.Acquire(rotations) || !s.Acquire(scales))
+			return nullptr;
+
+		Py_ssize_t count = -1;
+		if (!MatchStreamCount(count, hashes.m_Data, hashes.m_Size, 1) || !MatchStreamCount(count, t.m_Data, t.m_Size, 3)
+			|| !MatchStreamCount(count, r.m_Data, r.m_Size, 4) || !MatchStreamCount(count, s.m_Data, s.m_Size, 3))
+		{
+			PyErr_SetString(PyExc_ValueError, "array lengths don't describe the same number of joints");
+			return nullptr;
+		}
+
+		const int result = (count > 0)
+			? SetJointsSoA(session_id, first, static_cast<unsigned int>(count), hashes.m_Data, t.m_Data, r.m_Data, s.m_Data) : 0;
+		return PyLong_FromLong(result);
+	}
+
+	template<typename T>
+	static PyObject* SetPropertiesBuffer(unsigned int session_id, unsigned int first, PyObject* name_hashes, PyObject* values)
+	{
+		CPyStream<unsigned int> hashes;
+		CPyStream<T> v;
+
+		if (!hashes.Acquire(name_hashes) || !v.Acquire(values))
+			return nullptr;
+
+		Py_ssize_t count = -1;
+		if (!MatchStreamCount(count, hashes.m_Data, hashes.m_Size, 1) || !MatchStreamCount(count, v.m_Data, v.m_Size, 1))
+		{
+			PyErr_SetString(PyExc_ValueError, "array lengths don't describe the same number of properties");
+			return nullptr;
+		}
+
+		const int result = (count > 0)
+			? SetPropertiesSoA(session_id, first, static_cast<unsigned int>(count), hashes.m_Data, v.m_Data) : 0;
+		return PyLong_FromLong(result);
+	}
+
+	// a buffer exporter of a local frame region, it retains a frame memory, so a memoryview never points to a freed one.
+	//  a new buffer is refused once a session frame is reallocated or closed, old views write to a retained memory then
+	enum EFrameViewRegion
+	{
+		EFrameViewRegion_Joints,
+		EFrameViewRegion_Properties
+	};
+
+	struct SPyFrameView
+	{
+		PyObject_HEAD
+		void*			m_Token;
+		unsigned int	m_SessionId;
+		int				m_Region;
+		void*			m_Data;
+		Py_ssize_t		m_Size;
+	};
+
+	static PyTypeObject g_FrameViewType = { PyVarObject_HEAD_INIT(nullptr, 0) };
+
+	static void* GetFrameViewData(const unsigned int session_id, const int region, Py_ssize_t& size)
+	{
+		SSharedModelData* data = MapModelData(session_id);
+		const int capacity = (region == EFrameViewRegion_Joints) ? GetModelDataJointsCapacity(session_id) : GetModelDataPropertiesCapacity(session_id);
+
+		if (data == nullptr || capacity < 0)
+			return nullptr;
+
+		if (region == EFrameViewRegion_Joints)
+		{
+			size = static_cast<Py_ssize_t>(sizeof(SJointData) * capacity);
+			return GetModelJoints(data);
+		}
+		size = static_cast<Py_ssize_t>(sizeof(SPropertyData) * capacity);
+		return GetModelProperties(data);
+	}
+
+	static int FrameViewGetBuffer(PyObject* obj, Py_buffer* view, int flags)
+	{
+		SPyFrameView* self = reinterpret_cast<SPyFrameView*>(obj);
+
+		Py_ssize_t size = 0;
+		if (GetFrameViewData(self->m_SessionId, self->m_Region, size) != self->m_Data || size != self->m_Size)
+		{
+			view->obj = nullptr;
+			PyErr_SetString(PyExc_BufferError, "a session frame is reallocated or closed, get a new view");
+			return -1;
+		}
+		return PyBuffer_FillInfo(view, obj, self->m_Data, self->m_Size, 0, flags);
+	}
+
+	static void FrameViewDealloc(PyObject* obj)
+	{
+		ReleaseModelDataBuffer(reinterpret_cast<SPyFrameView*>(obj)->m_Token);
+		PyObject_Del(obj);
+	}
+
+	static PyBufferProcs g_FrameViewBufferProcs;
+
+	static bool InitFrameViewType()
+	{
+		g_FrameViewBufferProcs.bf_getbuffer = FrameViewGetBuffer;
+
+		g_FrameViewType.tp_name = "AnimLiveBridge.FrameView";
+		g_FrameViewType.tp_basicsize = sizeof(SPyFrameView);
+		g_FrameViewType.tp_dealloc = FrameViewDealloc;
+		g_FrameViewType.tp_as_buffer = &g_FrameViewBufferProcs;
+#if PY_MAJOR_VERSION < 3
+		g_FrameViewType.tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_NEWBUFFER;
+#else
+		g_FrameViewType.tp_flags = Py_TPFLAGS_DEFAULT;
+#endif
+		return PyType_Ready(&g_FrameViewType) == 0;
+	}
+
+	static PyObject* MakeFrameView(const unsigned int session_id, const int region)
+	{
+		Py_ssize_t size = 0;
+		void* data = GetFrameViewData(session_id, region, size);
+		if (data == nullptr)
+			Py_RETURN_NONE;
+
+		SPyFrameView* self = PyObject_New(SPyFrameView, &g_FrameViewType);
+		if (self == nullptr)
+			return nullptr;
+
+		self->m_Token = RetainModelDataBuffer(session_id);
+		self->m_SessionId = session_id;
+		self->m_Region = region;
+		self->m_Data = data;
+		self->m_Size = size;
+
+		// a memoryview holds an exporter, so a retained memory lives as long as a view
+		PyObject* view = PyMemoryView_FromObject(reinterpret_cast<PyObject*>(self));
+		Py_DECREF(self);
+		return view;
+	}
+%}
+
+%init %{
+	if (!InitFrameViewType())
+	{
+#if PY_VERSION_HEX >= 0x03000000
+		return NULL;
+#else
+		return;
+#endif
+	}
+%}
+
 %include "std_vector.i"
 
 %template(SJointDataVector) std::vector<SJointData>;
 %template(SPropertyDataVector) std::vector<SPropertyData>;
+%template(SEntityBlockVector) std::vector<SEntityBlock>;
 
 %include <typemaps.i>
 %apply double& INOUT { double& remote_time };
 
+// transport calls wait for a remote side, a turn or a worker join, python threads and a host UI keep running meanwhile
+%define %release_gil(function)
+%exception function {
+	Py_BEGIN_ALLOW_THREADS
+	$action
+	Py_END_ALLOW_THREADS
+}
+%enddef
+
+%release_gil(FreeLiveSession);
+%release_gil(HardwareOpen);
+%release_gil(HardwareClose);
+%release_gil(HardwareCommit);
+%release_gil(HardwareWaitForFrame);
+%release_gil(PublishWriteSlot);
+%release_gil(ReleaseReadView);
+%release_gil(StartTakeRecording);
+%release_gil(StopTakeRecording);
+%release_gil(StartTakeReplay);
+%release_gil(StopTakeReplay);
+
 %include "AnimLiveBridge.h"
 %include "carrays.i"
 %array_class(float, FloatArray);
 %array_class(unsigned int, UIntArray);
+%array_class(int, IntArray);
+%array_class(double, DoubleArray);
+%array_class(SVector3, SVector3Array);
+%array_class(SVector4, SVector4Array);
+%array_class(STransform, STransformArray);
+
+%inline %{
+	//! writable memoryview over all local buffer joints, JOINT_FORMAT per joint
+	//!  a view is detached (writes are not seen by a session) when a frame is reallocated or a session is closed, get a new one then
+	PyObject* GetModelDataJointsView(unsigned int session_id)
+	{
+		return MakeFrameView(session_id, EFrameViewRegion_Joints);
+	}
+
+	//! writable memoryview over all local buffer properties, PROPERTY_FORMAT per property, detached the same way as a joints view
+	PyObject* GetModelDataPropertiesView(unsigned int session_id)
+	{
+		return MakeFrameView(session_id, EFrameViewRegion_Properties);
+	}
+
+	//! SetModelDataJointsSoA for python arrays, a number of joints comes from array lengths, None keeps frame values
+	PyObject* SetModelDataJointsBuffer(unsigned int session_id, unsigned int first,
+		PyObject* name_hashes, PyObject* translations, PyObject* rotations, PyObject* scales)
+	{
+		// double arrays are used in place, everything else is converted to float
+		if (IsDoubleBuffer(translations) || IsDoubleBuffer(rotations) || IsDoubleBuffer(scales))
+			return SetJointsBuffer<double>(session_id, first, name_hashes, translations, rotations, scales);
+		return SetJointsBuffer<float>(session_id, first, name_hashes, translations, rotations, scales);
+	}
+
+	//! SetModelDataPropertiesSoA for python arrays, a number of properties comes from array lengths, None keeps frame values
+	PyObject* SetModelDataPropertiesBuffer(unsigned int session_id, unsigned int first, PyObject* name_hashes, PyObject* values)
+	{
+		if (IsDoubleBuffer(values))
+			return SetPropertiesBuffer<double>(session_id, first, name_hashes, values);
+		return SetPropertiesBuffer<float>(session_id, first, name_hashes, values);
+	}
+%}
 
 %pythoncode %{
 import _AnimLiveBridge
@@ -33,6 +384,81 @@ for name in dir(_AnimLiveBridge):
 del name
 %}
 
+%pythoncode %{
+# struct layout of views, SJointData is name hash, parent hash, flags, translation, rotation, scale
+JOINT_FORMAT = '=3I10f'
+PROPERTY_FORMAT = '=If'
+
+JOINT_DTYPE = [('m_NameHash', 'u4'), ('m_ParentHash', 'u4'), ('m_Flags', 'u4'),
+               ('m_Translation', 'f4', (3,)), ('m_Rotation', 'f4', (4,)), ('m_Scale', 'f4', (3,))]
+PROPERTY_DTYPE = [('m_NameHash', 'u4'), ('m_Value', 'f4')]
+
+def GetModelDataJointsArray(session_id):
+    """numpy structured array over local buffer joints, no copy"""
+    import numpy
+    view = GetModelDataJointsView(session_id)
+    return None if view is None else numpy.frombuffer(view, dtype=numpy.dtype(JOINT_DTYPE))
+
+def GetModelDataPropertiesArray(session_id):
+    """numpy structured array over local buffer properties, no copy"""
+    import numpy
+    view = GetModelDataPropertiesView(session_id)
+    return None if view is None else numpy.frombuffer(view, dtype=numpy.dtype(PROPERTY_DTYPE))
+%}
+
+%pythoncode %{
+WAIT_FOR_FRAME_SLICE_MS = 100
+
+def WaitForFrameAsync(session_id, loop=None):
+    """asyncio future which is done when an io thread session has a new frame, take it with HardwareCommit
+    a loop without add_reader (a windows proactor loop) waits with HardwareWaitForFrame on an executor thread"""
+    import asyncio
+    loop = loop or asyncio.get_event_loop()
+    handle = GetFrameReadyHandle(session_id)
+    if handle < 0:
+        raise RuntimeError('frame ready handle is not available, error ' + str(handle))
+
+    future = loop.create_future()
+
+    def on_ready():
+        ResetFrameReadyHandle(session_id)
+        if not future.done():
+            future.set_result(True)
+
+    try:
+        loop.add_reader(handle, on_ready)
+    except NotImplementedError:
+        return _WaitForFrameInExecutor(session_id, loop, future)
+
+    future.add_done_callback(lambda f: loop.remove_reader(handle))
+    return future
+
+def _WaitForFrameInExecutor(session_id, loop, future):
+    # a wait is sliced, so a cancelled future releases an executor thread
+    def wait():
+        while not future.done():
+            result = HardwareWaitForFrame(session_id, WAIT_FOR_FRAME_SLICE_MS)
+            if result == 0:
+                return True
+            if result != -1:
+                raise RuntimeError('HardwareWaitForFrame failed, error ' + str(result))
+        return False
+
+    def on_wait_done(wait_future):
+        if future.done():
+            return
+        if wait_future.cancelled():
+            future.cancel()
+        elif wait_future.exception() is not None:
+            future.set_exception(wait_future.exception())
+        else:
+            ResetFrameReadyHandle(session_id)
+            future.set_result(True)
+
+    loop.run_in_executor(None, wait).add_done_callback(on_wait_done)
+    return future
+%}
+
 // set exception handling for __getitem__
 %exception SJointDataArray::__getitem__ {
   assert(!lastErr);
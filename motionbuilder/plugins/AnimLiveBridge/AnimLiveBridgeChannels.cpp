@@ -0,0 +1,260 @@
+/*
+#
+# Copyright(c) 2021 Avalanche Studios.All rights reserved.
+# Licensed under the MIT License.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files(the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions :
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE
+#
+*/
+
+
+
+#include "AnimLiveBridgeChannels.h"
+#include "AnimLiveBridgeSession.h"
+#include <cstring>
+#include <cmath>
+
+unsigned int GetChannelTypeSize(const unsigned int type)
+{
+	switch (type)
+	{
+	case EChannelType_Float: return sizeof(float);
+	case EChannelType_Vector3: return sizeof(float) * 3;
+	case EChannelType_Quaternion: return sizeof(float) * 4;
+	case EChannelType_Int: return sizeof(int);
+	case EChannelType_Weight16: return sizeof(unsigned short);
+	}
+	return 0;
+}
+
+unsigned int GetChannelTypeComponents(const unsigned int type)
+{
+	switch (type)
+	{
+	case EChannelType_Vector3: return 3;
+	case EChannelType_Quaternion: return 4;
+	case EChannelType_Float:
+	case EChannelType_Int:
+	case EChannelType_Weight16: return 1;
+	}
+	return 0;
+}
+
+bool IsChannelBlock(const SSharedModelData* data)
+{
+	return data->m_Header.m_PropsCount >= 2 && GetModelProperties(data)[0].m_NameHash == CHANNEL_BLOCK_HASH;
+}
+
+static unsigned int HashLayout(const std::vector<SChannelLayoutEntry>& layout)
+{
+	unsigned int hash = NAME_HASH_BASIS;
+	const unsigned char* bytes = reinterpret_cast<const unsigned char*>(layout.data());
+
+	for (size_t i = 0, size = sizeof(SChannelLayoutEntry) * layout.size(); i < size; ++i)
+	{
+		hash = (hash ^ bytes[i]) * NAME_HASH_PRIME;
+	}
+	return hash;
+}
+
+///////////////////////////////////////////////////////////////////////////
+// CPropertyChannels
+
+void CPropertyChannels::UpdateOffsets()
+{
+	m_Offsets.resize(m_Layout.size());
+
+	unsigned int offset = 0;
+	for (size_t i = 0; i < m_Layout.size(); ++i)
+	{
+		m_Offsets[i] = offset;
+		offset += GetChannelTypeSize(m_Layout[i].m_Type);
+	}
+	m_Payload.assign(offset, 0);
+	m_LayoutId = HashLayout(m_Layout);
+}
+
+int CPropertyChannels::SetLayout(const unsigned int* name_hashes, const unsigned int* types, const unsigned int count)
+{
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		if (GetChannelTypeSize(types[i]) == 0)
+			return -1;
+	}
+
+	m_Layout.resize(count);
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		m_Layout[i].m_NameHash = name_hashes[i];
+		m_Layout[i].m_Type = types[i];
+	}
+
+	UpdateOffsets();
+	return 0;
+}
+
+int CPropertyChannels::SetValues(const unsigned int first, const unsigned int count, const float* values)
+{
+	if (static_cast<unsigned long long>(first) + count > m_Layout.size())
+		return -5;
+
+	for (unsigned int i = first; i < first + count; ++i)
+	{
+		char* dst = m_Payload.data() + m_Offsets[i];
+
+		switch (m_Layout[i].m_Type)
+		{
+		case EChannelType_Int:
+		{
+			const int value = static_cast<int>(std::lround(*values));
+			memcpy(dst, &value, sizeof(int));
+		} break;
+
+		case EChannelType_Weight16:
+		{
+			const float weight = (*values < 0.0f) ? 0.0f : (*values > 1.0f) ? 1.0f : *values;
+			const unsigned short value = static_cast<unsigned short>(weight * 65535.0f + 0.5f);
+			memcpy(dst, &value, sizeof(unsigned short));
+		} break;
+
+		default:
+			memcpy(dst, values, GetChannelTypeSize(m_Layout[i].m_Type));
+		}
+		values += GetChannelTypeComponents(m_Layout[i].m_Type);
+	}
+	return 0;
+}
+
+int CPropertyChannels::GetValues(const unsigned int first, const unsigned int count, float* values) const
+{
+	if (static_cast<unsigned long long>(first) + count > m_Layout.size())
+		return -5;
+
+	float* start = values;
+	for (unsigned int i = first; i < first + count; ++i)
+	{
+		const char* src = m_Payload.data() + m_Offsets[i];
+
+		switch (m_Layout[i].m_Type)
+		{
+		case EChannelType_Int:
+		{
+			int value = 0;
+			memcpy(&value, src, sizeof(int));
+			*values = static_cast<float>(value);
+		} break;
+
+		case EChannelType_Weight16:
+		{
+			unsigned short value = 0;
+			memcpy(&value, src, sizeof(unsigned short));
+			*values = static_cast<float>(value) / 65535.0f;
+		} break;
+
+		default:
+			memcpy(values, src, GetChannelTypeSize(m_Layout[i].m_Type));
+		}
+		values += GetChannelTypeComponents(m_Layout[i].m_Type);
+	}
+	return static_cast<int>(values - start);
+}
+
+int CPropertyChannels::Find(const unsigned int name_hash) const
+{
+	for (size_t i = 0; i < m_Layout.size(); ++i)
+	{
+		if (m_Layout[i].m_NameHash == name_hash)
+			return static_cast<int>(i);
+	}
+	return -1;
+}
+
+size_t CPropertyChannels::GetBlockSize(const bool include_layout) const
+{
+	return sizeof(SChannelBlockHeader) + ((include_layout) ? sizeof(SChannelLayoutEntry) * m_Layout.size() : 0) + m_Payload.size();
+}
+
+int CPropertyChannels::WriteBlock(SFrameBuffer& frame, const bool include_layout) const
+{
+	const size_t size = GetBlockSize(include_layout);
+	const size_t props_count = (size + sizeof(SPropertyData) - 1) / sizeof(SPropertyData);
+
+	if (props_count > frame.m_PropsCapacity)
+		return -5;
+
+	SChannelBlockHeader header;
+	header.m_Magic = CHANNEL_BLOCK_HASH;
+	header.m_LayoutId = m_LayoutId;
+	header.m_ChannelsCount = static_cast<unsigned int>(m_Layout.size());
+	header.m_LayoutSize = (include_layout) ? static_cast<unsigned int>(sizeof(SChannelLayoutEntry) * m_Layout.size()) : 0;
+
+	char* dst = reinterpret_cast<char*>(GetModelProperties(frame.m_Data));
+
+	memcpy(dst, &header, sizeof(SChannelBlockHeader));
+	dst += sizeof(SChannelBlockHeader);
+
+	if (include_layout)
+	{
+		memcpy(dst, m_Layout.data(), header.m_LayoutSize);
+		dst += header.m_LayoutSize;
+	}
+	memcpy(dst, m_Payload.data(), m_Payload.size());
+
+	// a tail of a last property slot is zeroed, so a frame is the same for the same values
+	const size_t tail = props_count * sizeof(SPropertyData) - size;
+	memset(dst + m_Payload.size(), 0, tail);
+
+	frame.m_Data->m_Header.m_PropsCount = static_cast<unsigned int>(props_count);
+	return 0;
+}
+
+int CPropertyChannels::ReadBlock(const SSharedModelData* data)
+{
+	if (!IsChannelBlock(data))
+		return -1;
+
+	const char* src = reinterpret_cast<const char*>(GetModelProperties(data));
+	const size_t size = sizeof(SPropertyData) * data->m_Header.m_PropsCount;
+
+	SChannelBlockHeader header;
+	memcpy(&header, src, sizeof(SChannelBlockHeader));
+
+	size_t offset = sizeof(SChannelBlockHeader);
+
+	if (header.m_LayoutSize > 0)
+	{
+		if (header.m_LayoutSize != sizeof(SChannelLayoutEntry) * header.m_ChannelsCount || offset + header.m_LayoutSize > size)
+			return -1;
+
+		if (header.m_LayoutId != m_LayoutId || m_Layout.size() != header.m_ChannelsCount)
+		{
+			m_Layout.resize(header.m_ChannelsCount);
+			memcpy(m_Layout.data(), src + offset, header.m_LayoutSize);
+			UpdateOffsets();
+		}
+		offset += header.m_LayoutSize;
+	}
+
+	// a layout is repeated only every CHANNEL_LAYOUT_INTERVAL frames, values of an unknown layout can't be read
+	if (header.m_LayoutId != m_LayoutId || header.m_ChannelsCount != m_Layout.size() || offset + m_Payload.size() > size)
+		return -1;
+
+	memcpy(m_Payload.data(), src + offset, m_Payload.size());
+	return static_cast<int>(m_Layout.size());
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+/*
+#
+# Copyright(c) 2021 Avalanche Studios.All rights reserved.
+# Licensed under the MIT License.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files(the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions :
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE
+#
+*/
+
+
+#include "AnimLiveBridge.h"
+#include <vector>
+#include <cstddef>
+
+struct SFrameBuffer;
+
+// a channel block takes a place of frame properties, a first property name hash marks it
+const unsigned int CHANNEL_BLOCK_HASH = HashNameConst("AnimLiveBridgeChannels");
+// a writer repeats a layout every N committed frames, a late reader waits for it
+const unsigned int CHANNEL_LAYOUT_INTERVAL = 30;
+
+struct SChannelBlockHeader
+{
+	unsigned int	m_Magic;			// CHANNEL_BLOCK_HASH
+	unsigned int	m_LayoutId;
+	unsigned int	m_ChannelsCount;
+	unsigned int	m_LayoutSize;		// bytes of layout entries which follow a header, 0 when a layout is not repeated in a frame
+}; // 16 bytes, two property slots
+
+struct SChannelLayoutEntry
+{
+	unsigned int	m_NameHash;
+	unsigned int	m_Type;				// EChannelType
+};
+
+//! payload bytes of a channel type, 0 for an unknown type
+unsigned int GetChannelTypeSize(const unsigned int type);
+//! float values a channel type is read and written with, 0 for an unknown type
+unsigned int GetChannelTypeComponents(const unsigned int type);
+
+//! true if frame properties hold a channel block
+bool IsChannelBlock(const SSharedModelData* data);
+
+////////////////////////////////////////////////////////////
+// CPropertyChannels
+//  typed channels are packed contiguously without name hashes, a layout (hashes and types) is set once
+//  a writer keeps a packed payload and puts a block into frame properties on a commit,
+//  a reader keeps a last received layout and payload of a block
+
+class CPropertyChannels
+{
+public:
+
+	//! returns 0 if succeed, -1 for an unknown channel type
+	int SetLayout(const unsigned int* name_hashes, const unsigned int* types, const unsigned int count);
+	//! values are converted per channel type, returns 0 if succeed, -5 if a range is out of a layout
+	int SetValues(const unsigned int first, const unsigned int count, const float* values);
+
+	//! block size in bytes with or without a layout
+	size_t GetBlockSize(const bool include_layout) const;
+	//! write a block into frame properties, returns 0 if succeed, -5 if it doesn't fit into a properties capacity
+	int WriteBlock(SFrameBuffer& frame, const bool include_layout) const;
+	//! returns a number of channels, -1 if there is no block or a layout is not received yet
+	int ReadBlock(const SSharedModelData* data);
+
+	//! returns a number of written floats, -5 if a range is out of a layout
+	int GetValues(const unsigned int first, const unsigned int count, float* values) const;
+	//! returns a channel index or -1
+	int Find(const unsigned int name_hash) const;
+
+	unsigned int GetCount() const { return static_cast<unsigned int>(m_Layout.size()); }
+	unsigned int GetLayoutId() const { return m_LayoutId; }
+	const SChannelLayoutEntry& GetEntry(const unsigned int index) const { return m_Layout[index]; }
+
+	bool HasLayout() const { return !m_Layout.empty(); }
+
+protected:
+
+	std::vector<SChannelLayoutEntry>	m_Layout;
+	std::vector<unsigned int>			m_Offsets;		// payload byte offset per channel
+	std::vector<char>					m_Payload;
+	unsigned int						m_LayoutId{ 0 };
+
+	void UpdateOffsets();
+};
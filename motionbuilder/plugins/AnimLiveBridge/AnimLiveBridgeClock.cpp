@@ -0,0 +1,172 @@
+/*
+#
+# Copyright(c) 2021 Avalanche Studios.All rights reserved.
+# Licensed under the MIT License.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files(the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions :
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE
+#
+*/
+
+
+#include "AnimLiveBridgeClock.h"
+
+////////////////////////////////////////////////////////////
+// CClockSync
+
+void CClockSync::Reset()
+{
+	std::lock_guard<std::mutex> lock(m_Lock);
+
+	m_PeerTransmitTime = 0.0;
+	m_PeerReceiveTime = 0.0;
+	m_FilterHead = 0;
+	m_FilterCount = 0;
+	m_DriftHead = 0;
+	m_DriftCount = 0;
+	m_Estimate = SOffsetSample();
+	m_DriftRate = 0.0;
+	m_Samples = 0;
+}
+
+void CClockSync::WriteSample(SClockSample& sample, const double now)
+{
+	std::lock_guard<std::mutex> lock(m_Lock);
+
+	sample.m_OriginTime = m_PeerTransmitTime;
+	sample.m_ReceiveTime = m_PeerReceiveTime;
+	sample.m_TransmitTime = now;
+}
+
+void CClockSync::ReadSample(const SClockSample& sample, const double receive_time)
+{
+	std::lock_guard<std::mutex> lock(m_Lock);
+
+	m_PeerTransmitTime = sample.m_TransmitTime;
+	m_PeerReceiveTime = receive_time;
+
+	// a peer has not received our sample yet
+	if (sample.m_OriginTime <= 0.0)
+		return;
+
+	// t1 - our transmit, t2 - peer receive, t3 - peer transmit, t4 - our receive
+	const double t1 = sample.m_OriginTime;
+	const double t2 = sample.m_ReceiveTime;
+	const double t3 = sample.m_TransmitTime;
+	const double t4 = receive_time;
+
+	SOffsetSample& offset_sample = m_Filter[m_FilterHead];
+	offset_sample.m_Time = 0.5 * (t1 + t4);
+	offset_sample.m_Offset = 0.5 * ((t2 - t1) + (t3 - t4));
+	offset_sample.m_RoundTrip = (t4 - t1) - (t3 - t2);
+	if (offset_sample.m_RoundTrip < 0.0)
+		offset_sample.m_RoundTrip = 0.0;
+
+	m_FilterHead = (m_FilterHead + 1) % CLOCK_FILTER_SAMPLES;
+	if (m_FilterCount < CLOCK_FILTER_SAMPLES)
+		++m_FilterCount;
+	++m_Samples;
+
+	// a least round trip has a least queueing delay, its offset has a least asymmetry error
+	const SOffsetSample* best = &m_Filter[0];
+	for (unsigned int i = 1; i < m_FilterCount; ++i)
+	{
+		best = (m_Filter[i].m_RoundTrip < best->m_RoundTrip) ? &m_Filter[i] : best;
+	}
+
+	if (best->m_Time > m_Estimate.m_Time)
+		m_Estimate = *best;
+
+	// one point of a drift line per a full filter window, a line covers a longer time with a same number of points
+	if (m_FilterHead == 0)
+	{
+		m_Drift[m_DriftHead] = *best;
+		m_DriftHead = (m_DriftHead + 1) % CLOCK_DRIFT_SAMPLES;
+		if (m_DriftCount < CLOCK_DRIFT_SAMPLES)
+			++m_DriftCount;
+
+		UpdateDriftRate();
+	}
+}
+
+void CClockSync::UpdateDriftRate()
+{
+	const SOffsetSample& oldest = m_Drift[(m_DriftHead + CLOCK_DRIFT_SAMPLES - m_DriftCount) % CLOCK_DRIFT_SAMPLES];
+	const SOffsetSample& newest = m_Drift[(m_DriftHead + CLOCK_DRIFT_SAMPLES - 1) % CLOCK_DRIFT_SAMPLES];
+	if (m_DriftCount < 4 || newest.m_Time - oldest.m_Time < CLOCK_DRIFT_MIN_SPAN)
+		return;
+
+	// least squares slope, times are relative to a last point to keep a double precision
+	double mean_time = 0.0;
+	double mean_offset = 0.0;
+	for (unsigned int i = 0; i < m_DriftCount; ++i)
+	{
+		mean_time += m_Drift[i].m_Time - newest.m_Time;
+		mean_offset += m_Drift[i].m_Offset;
+	}
+	mean_time /= m_DriftCount;
+	mean_offset /= m_DriftCount;
+
+	double covariance = 0.0;
+	double variance = 0.0;
+	for (unsigned int i = 0; i < m_DriftCount; ++i)
+	{
+		const double dt = m_Drift[i].m_Time - newest.m_Time - mean_time;
+		covariance += dt * (m_Drift[i].m_Offset - mean_offset);
+		variance += dt * dt;
+	}
+
+	if (variance > 0.0)
+		m_DriftRate = covariance / variance;
+}
+
+double CClockSync::GetOffset(const double local_time) const
+{
+	return (m_Samples > 0) ? m_Estimate.m_Offset + m_DriftRate * (local_time - m_Estimate.m_Time) : 0.0;
+}
+
+bool CClockSync::IsSynced() const
+{
+	std::lock_guard<std::mutex> lock(m_Lock);
+	return m_Samples > 0;
+}
+
+double CClockSync::ToPeerTime(const double local_time) const
+{
+	std::lock_guard<std::mutex> lock(m_Lock);
+	return local_time + GetOffset(local_time);
+}
+
+double CClockSync::ToLocalTime(const double peer_time) const
+{
+	std::lock_guard<std::mutex> lock(m_Lock);
+
+	// an offset changes by a drift rate only, one step is enough
+	const double local_time = peer_time - GetOffset(peer_time);
+	return peer_time - GetOffset(local_time);
+}
+
+void CClockSync::GetState(SLiveSessionClock& state) const
+{
+	std::lock_guard<std::mutex> lock(m_Lock);
+
+	state.m_Offset = m_Estimate.m_Offset;
+	state.m_RoundTrip = m_Estimate.m_RoundTrip;
+	state.m_Drift = m_DriftRate * 1e6;
+	state.m_Samples = m_Samples;
+}
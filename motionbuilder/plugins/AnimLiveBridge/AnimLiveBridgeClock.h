@@ -0,0 +1,98 @@
+#pragma once
+
+/*
+#
+# Copyright(c) 2021 Avalanche Studios.All rights reserved.
+# Licensed under the MIT License.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files(the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions :
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE
+#
+*/
+
+
+#include "AnimLiveBridge.h"
+#include <mutex>
+
+const int CLOCK_FILTER_SAMPLES = 8;			// an offset is taken from a sample with a least round trip over last samples
+const int CLOCK_DRIFT_SAMPLES = 32;			// a drift rate is a line fit over filtered offsets of last windows
+const double CLOCK_DRIFT_MIN_SPAN = 1.0;	// seconds of filtered offsets before a drift rate is estimated
+
+//! clock sample which goes with a frame, times are in seconds of a sender clock except an echoed origin one
+struct SClockSample
+{
+	double		m_OriginTime;		// a last received peer transmit time, echoed back, 0 before a first peer sample
+	double		m_ReceiveTime;		// a local arrival time of that peer sample
+	double		m_TransmitTime;		// a local time when this sample is sent
+}; // 24 bytes
+
+////////////////////////////////////////////////////////////
+// CClockSync
+//  NTP style symmetric exchange, every frame carries a clock sample and every received one gives an offset and a round trip
+//  an offset is a peer clock minus a local clock, a drift rate is a change of an offset per second of a local clock
+//  a transport thread writes and reads samples, a caller thread could read an estimate at any time
+
+class CClockSync
+{
+public:
+
+	void Reset();
+
+	//! fill a sample to send, now is a local clock time
+	void WriteSample(SClockSample& sample, const double now);
+	//! take a peer sample, receive_time is a local arrival time of it
+	void ReadSample(const SClockSample& sample, const double receive_time);
+
+	bool IsSynced() const;
+
+	//! a peer clock time for a local one, a local clock time is returned as is until a first estimate
+	double ToPeerTime(const double local_time) const;
+	//! a local clock time for a peer one
+	double ToLocalTime(const double peer_time) const;
+
+	void GetState(SLiveSessionClock& state) const;
+
+protected:
+
+	struct SOffsetSample
+	{
+		double		m_Time{ 0.0 };			// local time of a sample, a middle of a round trip
+		double		m_Offset{ 0.0 };
+		double		m_RoundTrip{ 0.0 };
+	};
+
+	mutable std::mutex	m_Lock;
+
+	double			m_PeerTransmitTime{ 0.0 };
+	double			m_PeerReceiveTime{ 0.0 };
+
+	SOffsetSample	m_Filter[CLOCK_FILTER_SAMPLES];
+	unsigned int	m_FilterHead{ 0 };
+	unsigned int	m_FilterCount{ 0 };
+
+	SOffsetSample	m_Drift[CLOCK_DRIFT_SAMPLES];
+	unsigned int	m_DriftHead{ 0 };
+	unsigned int	m_DriftCount{ 0 };
+
+	SOffsetSample		m_Estimate;				// a filtered sample, an offset is extrapolated from it with a drift rate
+	double				m_DriftRate{ 0.0 };
+	unsigned long long	m_Samples{ 0 };
+
+	double GetOffset(const double local_time) const;
+	void UpdateDriftRate();
+};
@@ -0,0 +1,541 @@
+
+/*
+#
+# Copyright(c) 2021 Avalanche Studios.All rights reserved.
+# Licensed under the MIT License.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files(the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions :
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE
+#
+*/
+
+#include "AnimLiveBridgeCodec.h"
+#include <cstring>
+#include <cmath>
+#include <cfloat>
+
+const unsigned int MIN_TRANSLATION_BITS = 4;
+const unsigned int MAX_TRANSLATION_BITS = 24;
+const unsigned int MIN_ROTATION_BITS = 4;
+const unsigned int MAX_ROTATION_BITS = 20;
+
+const float SMALLEST_THREE_RANGE = 0.70710678f;	// 1/sqrt(2), the largest possible value of a not largest component
+
+// joint parent mode
+enum EParentMode
+{
+	EParentMode_None,
+	EParentMode_Index,
+	EParentMode_Hash
+};
+
+// worst case bits per joint - hash, parent hash, raw flags, translation, raw quaternion, raw scale
+const size_t MAX_JOINT_BITS = 32 + 2 + 32 + 1 + 3 * MAX_TRANSLATION_BITS + 1 + 4 * 32 + 1 + 3 * 32;
+// least bits per joint - hash, no parent, short flags, translation, euler rotation, default scale
+const size_t MIN_JOINT_BITS = 32 + 2 + 1 + 4 + 3 * MIN_TRANSLATION_BITS + 3 * MIN_ROTATION_BITS + 1;
+
+////////////////////////////////////////////////////////////////
+// bit stream
+
+class CBitWriter
+{
+public:
+	CBitWriter(unsigned char* buffer, const size_t size)
+		: m_Buffer(buffer)
+		, m_Size(size)
+	{}
+
+	void Write(const unsigned int value, const unsigned int bits)
+	{
+		m_Accum |= static_cast<unsigned long long>(value & Mask(bits)) << m_AccumBits;
+		m_AccumBits += bits;
+
+		while (m_AccumBits >= 8)
+		{
+			Put(static_cast<unsigned char>(m_Accum & 0xFF));
+			m_Accum >>= 8;
+			m_AccumBits -= 8;
+		}
+	}
+
+	void WriteFloat(const float value)
+	{
+		unsigned int bits;
+		memcpy(&bits, &value, sizeof(bits));
+		Write(bits, 32);
+	}
+
+	//! flush a partial byte, returns false on overflow
+	bool Finish()
+	{
+		if (m_AccumBits > 0)
+		{
+			Put(static_cast<unsigned char>(m_Accum & 0xFF));
+			m_Accum = 0;
+			m_AccumBits = 0;
+		}
+		return !m_Overflow;
+	}
+
+	size_t GetOffset() const { return m_Offset; }
+
+	static unsigned int Mask(const unsigned int bits) { return (bits >= 32) ? 0xFFFFFFFFu : ((1u << bits) - 1u); }
+
+private:
+	unsigned char*		m_Buffer;
+	size_t				m_Size;
+	size_t				m_Offset{ 0 };
+	unsigned long long	m_Accum{ 0 };
+	unsigned int		m_AccumBits{ 0 };
+	bool				m_Overflow{ false };
+
+	void Put(const unsigned char value)
+	{
+		if (m_Offset < m_Size)
+			m_Buffer[m_Offset++] = value;
+		else
+			m_Overflow = true;
+	}
+};
+
+class CBitReader
+{
+public:
+	CBitReader(const unsigned char* buffer, const size_t size)
+		: m_Buffer(buffer)
+		, m_Size(size)
+	{}
+
+	unsigned int Read(const unsigned int bits)
+	{
+		while (m_AccumBits < bits)
+		{
+			const unsigned long long value = (m_Offset < m_Size) ? m_Buffer[m_Offset++] : 0;
+			m_Accum |= value << m_AccumBits;
+			m_AccumBits += 8;
+		}
+
+		const unsigned int value = static_cast<unsigned int>(m_Accum) & CBitWriter::Mask(bits);
+		m_Accum >>= bits;
+		m_AccumBits -= bits;
+		m_ReadBits += bits;
+		return value;
+	}
+
+	float ReadFloat()
+	{
+		const unsigned int bits = Read(32);
+		float value;
+		memcpy(&value, &bits, sizeof(value));
+		return value;
+	}
+
+	//! true if more bits were read than a buffer has
+	bool IsOverflow() const { return m_ReadBits > m_Size * 8; }
+
+private:
+	const unsigned char*	m_Buffer;
+	size_t					m_Size;
+	size_t					m_Offset{ 0 };
+	size_t					m_ReadBits{ 0 };
+	unsigned long long		m_Accum{ 0 };
+	unsigned int			m_AccumBits{ 0 };
+};
+
+////////////////////////////////////////////////////////////////
+// quantization
+
+static unsigned int Clamp(const unsigned int value, const unsigned int min_value, const unsigned int max_value)
+{
+	return (value < min_value) ? min_value : ((value > max_value) ? max_value : value);
+}
+
+static unsigned int Quantize(const float value, const float min_value, const float max_value, const unsigned int bits)
+{
+	const float range = max_value - min_value;
+	if (range <= 0.0f)
+		return 0;
+
+	const unsigned int max_code = CBitWriter::Mask(bits);
+	const float normalized = (value - min_value) / range;
+	const float code = std::floor(normalized * static_cast<float>(max_code) + 0.5f);
+
+	return (code <= 0.0f) ? 0 : ((code >= static_cast<float>(max_code)) ? max_code : static_cast<unsigned int>(code));
+}
+
+static float Dequantize(const unsigned int code, const float min_value, const float max_value, const unsigned int bits)
+{
+	const float range = max_value - min_value;
+	if (range <= 0.0f)
+		return min_value;
+
+	return min_value + range * static_cast<float>(code) / static_cast<float>(CBitWriter::Mask(bits));
+}
+
+static bool IsEulerRotation(const SJointData& joint)
+{
+	return (joint.m_Flags & HINT_ROTATION_EULERANGLES) != 0;
+}
+
+static bool IsDefaultScale(const SVector3& scale)
+{
+	return scale.m_X == 1.0f && scale.m_Y == 1.0f && scale.m_Z == 1.0f;
+}
+
+static void ComputeBound(const SJointData* joints, const unsigned int joints_count, const bool euler, float* min_value, float* max_value)
+{
+	for (int k = 0; k < 3; ++k)
+	{
+		min_value[k] = 0.0f;
+		max_value[k] = 0.0f;
+	}
+
+	bool is_first = true;
+
+	for (unsigned int i = 0; i < joints_count; ++i)
+	{
+		if (euler && !IsEulerRotation(joints[i]))
+			continue;
+
+		const float* values = (euler) ? &joints[i].m_Transform.m_Rotation.m_X : &joints[i].m_Transform.m_Translation.m_X;
+
+		for (int k = 0; k < 3; ++k)
+		{
+			if (is_first || values[k] < min_value[k])
+				min_value[k] = values[k];
+			if (is_first || values[k] > max_value[k])
+				max_value[k] = values[k];
+		}
+		is_first = false;
+	}
+}
+
+static unsigned int GetIndexBits(const unsigned int joints_count)
+{
+	unsigned int bits = 1;
+	while (bits < 32 && (1u << bits) < joints_count)
+		++bits;
+	return bits;
+}
+
+////////////////////////////////////////////////////////////////
+// quaternion smallest three
+
+static bool WriteQuaternion(CBitWriter& writer, const SVector4& rotation, const unsigned int bits)
+{
+	float q[4] = { rotation.m_X, rotation.m_Y, rotation.m_Z, rotation.m_W };
+
+	const float length = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+
+	// not a rotation, keep values as is
+	if (!(length > 0.9f && length < 1.1f))
+	{
+		writer.Write(1, 1);
+		for (int k = 0; k < 4; ++k)
+			writer.WriteFloat(q[k]);
+		return false;
+	}
+
+	unsigned int largest = 0;
+	for (unsigned int k = 0; k < 4; ++k)
+	{
+		q[k] /= length;
+		if (std::fabs(q[k]) > std::fabs(q[largest]))
+			largest = k;
+	}
+
+	// q and -q is the same rotation, make the omitted component positive
+	const float sign = (q[largest] < 0.0f) ? -1.0f : 1.0f;
+
+	writer.Write(0, 1);
+	writer.Write(largest, 2);
+
+	for (unsigned int k = 0; k < 4; ++k)
+	{
+		if (k != largest)
+			writer.Write(Quantize(sign * q[k], -SMALLEST_THREE_RANGE, SMALLEST_THREE_RANGE, bits), bits);
+	}
+	return true;
+}
+
+static void ReadQuaternion(CBitReader& reader, SVector4& rotation, const unsigned int bits)
+{
+	float q[4];
+
+	if (reader.Read(1) != 0)
+	{
+		for (int k = 0; k < 4; ++k)
+			q[k] = reader.ReadFloat();
+	}
+	else
+	{
+		const unsigned int largest = reader.Read(2);
+		float sum = 0.0f;
+
+		for (unsigned int k = 0; k < 4; ++k)
+		{
+			if (k != largest)
+			{
+				q[k] = Dequantize(reader.Read(bits), -SMALLEST_THREE_RANGE, SMALLEST_THREE_RANGE, bits);
+				sum += q[k] * q[k];
+			}
+		}
+		q[largest] = std::sqrt((sum < 1.0f) ? 1.0f - sum : 0.0f);
+	}
+
+	rotation.m_X = q[0];
+	rotation.m_Y = q[1];
+	rotation.m_Z = q[2];
+	rotation.m_W = q[3];
+}
+
+////////////////////////////////////////////////////////////////
+// pose codec
+
+size_t GetMaxEncodedPoseSize(const unsigned int joints_count)
+{
+	return sizeof(SPoseCodecHeader) + (MAX_JOINT_BITS * joints_count + 7) / 8;
+}
+
+size_t GetMinEncodedPoseSize(const unsigned int joints_count)
+{
+	return sizeof(SPoseCodecHeader) + (MIN_JOINT_BITS * static_cast<size_t>(joints_count) + 7) / 8;
+}
+
+size_t EncodePoseData(const SJointData* joints, const unsigned int joints_count, const SPoseCodecSettings& settings, unsigned char* buffer, const size_t buffer_size)
+{
+	if (buffer_size < sizeof(SPoseCodecHeader))
+		return 0;
+
+	SPoseCodecHeader header;
+	memset(&header, 0, sizeof(SPoseCodecHeader));
+
+	header.m_Version = POSE_CODEC_VERSION;
+	header.m_TranslationBits = static_cast<unsigned char>(Clamp(settings.m_TranslationBits, MIN_TRANSLATION_BITS, MAX_TRANSLATION_BITS));
+	header.m_RotationBits = static_cast<unsigned char>(Clamp(settings.m_RotationBits, MIN_ROTATION_BITS, MAX_ROTATION_BITS));
+	header.m_JointsCount = joints_count;
+
+	ComputeBound(joints, joints_count, false, header.m_TranslationMin, header.m_TranslationMax);
+	ComputeBound(joints, joints_count, true, header.m_EulerMin, header.m_EulerMax);
+
+	const unsigned int translation_bits = header.m_TranslationBits;
+	const unsigned int rotation_bits = header.m_RotationBits;
+	const unsigned int index_bits = GetIndexBits(joints_count);
+
+	CBitWriter writer(buffer + sizeof(SPoseCodecHeader), buffer_size - sizeof(SPoseCodecHeader));
+
+	for (unsigned int i = 0; i < joints_count; ++i)
+	{
+		const SJointData& joint = joints[i];
+
+		writer.Write(joint.m_NameHash, 32);
+
+		// parent is usually one of previous joints in a hierarchy order
+		unsigned int parent_index = joints_count;
+		if (joint.m_ParentHash != 0)
+		{
+			for (unsigned int j = 0; j < i; ++j)
+			{
+				if (joints[j].m_NameHash == joint.m_ParentHash)
+				{
+					parent_index = j;
+					break;
+				}
+			}
+		}
+
+		if (joint.m_ParentHash == 0)
+		{
+			writer.Write(EParentMode_None, 2);
+		}
+		else if (parent_index < i)
+		{
+			writer.Write(EParentMode_Index, 2);
+			writer.Write(parent_index, index_bits);
+		}
+		else
+		{
+			writer.Write(EParentMode_Hash, 2);
+			writer.Write(joint.m_ParentHash, 32);
+		}
+
+		// known hints fit into 4 bits
+		if (joint.m_Flags < 16)
+		{
+			writer.Write(0, 1);
+			writer.Write(joint.m_Flags, 4);
+		}
+		else
+		{
+			writer.Write(1, 1);
+			writer.Write(joint.m_Flags, 32);
+		}
+
+		const float* translation = &joint.m_Transform.m_Translation.m_X;
+		for (int k = 0; k < 3; ++k)
+		{
+			writer.Write(Quantize(translation[k], header.m_TranslationMin[k], header.m_TranslationMax[k], translation_bits), translation_bits);
+		}
+
+		if (IsEulerRotation(joint))
+		{
+			const float* rotation = &joint.m_Transform.m_Rotation.m_X;
+			for (int k = 0; k < 3; ++k)
+			{
+				writer.Write(Quantize(rotation[k], header.m_EulerMin[k], header.m_EulerMax[k], rotation_bits), rotation_bits);
+			}
+		}
+		else
+		{
+			WriteQuaternion(writer, joint.m_Transform.m_Rotation, rotation_bits);
+		}
+
+		if (IsDefaultScale(joint.m_Transform.m_Scale))
+		{
+			writer.Write(1, 1);
+		}
+		else
+		{
+			writer.Write(0, 1);
+			writer.WriteFloat(joint.m_Transform.m_Scale.m_X);
+			writer.WriteFloat(joint.m_Transform.m_Scale.m_Y);
+			writer.WriteFloat(joint.m_Transform.m_Scale.m_Z);
+		}
+	}
+
+	if (!writer.Finish())
+		return 0;
+
+	header.m_Size = static_cast<unsigned int>(sizeof(SPoseCodecHeader) + writer.GetOffset());
+	memcpy(buffer, &header, sizeof(SPoseCodecHeader));
+
+	return header.m_Size;
+}
+
+int DecodePoseData(const unsigned char* buffer, const size_t size, SJointData* joints, const unsigned int max_count)
+{
+	if (size < sizeof(SPoseCodecHeader))
+		return -1;
+
+	SPoseCodecHeader header;
+	memcpy(&header, buffer, sizeof(SPoseCodecHeader));
+
+	if (header.m_Version != POSE_CODEC_VERSION
+		|| header.m_Size < sizeof(SPoseCodecHeader) || header.m_Size > size
+		|| header.m_JointsCount > max_count
+		|| header.m_TranslationBits < MIN_TRANSLATION_BITS || header.m_TranslationBits > MAX_TRANSLATION_BITS
+		|| header.m_RotationBits < MIN_ROTATION_BITS || header.m_RotationBits > MAX_ROTATION_BITS)
+	{
+		return -1;
+	}
+
+	const unsigned int joints_count = header.m_JointsCount;
+	const unsigned int translation_bits = header.m_TranslationBits;
+	const unsigned int rotation_bits = header.m_RotationBits;
+	const unsigned int index_bits = GetIndexBits(joints_count);
+
+	CBitReader reader(buffer + sizeof(SPoseCodecHeader), header.m_Size - sizeof(SPoseCodecHeader));
+
+	for (unsigned int i = 0; i < joints_count; ++i)
+	{
+		SJointData& joint = joints[i];
+
+		joint.m_NameHash = reader.Read(32);
+
+		switch (reader.Read(2))
+		{
+		case EParentMode_None:
+			joint.m_ParentHash = 0;
+			break;
+		case EParentMode_Index:
+		{
+			const unsigned int parent_index = reader.Read(index_bits);
+			if (parent_index >= i)
+				return -1;
+			joint.m_ParentHash = joints[parent_index].m_NameHash;
+		} break;
+		case EParentMode_Hash:
+			joint.m_ParentHash = reader.Read(32);
+			break;
+		default:
+			return -1;
+		}
+
+		joint.m_Flags = (reader.Read(1) == 0) ? reader.Read(4) : reader.Read(32);
+
+		float* translation = &joint.m_Transform.m_Translation.m_X;
+		for (int k = 0; k < 3; ++k)
+		{
+			translation[k] = Dequantize(reader.Read(translation_bits), header.m_TranslationMin[k], header.m_TranslationMax[k], translation_bits);
+		}
+
+		if (IsEulerRotation(joint))
+		{
+			float* rotation = &joint.m_Transform.m_Rotation.m_X;
+			for (int k = 0; k < 3; ++k)
+			{
+				rotation[k] = Dequantize(reader.Read(rotation_bits), header.m_EulerMin[k], header.m_EulerMax[k], rotation_bits);
+			}
+			rotation[3] = 0.0f;
+		}
+		else
+		{
+			ReadQuaternion(reader, joint.m_Transform.m_Rotation, rotation_bits);
+		}
+
+		if (reader.Read(1) != 0)
+		{
+			joint.m_Transform.m_Scale.m_X = joint.m_Transform.m_Scale.m_Y = joint.m_Transform.m_Scale.m_Z = 1.0f;
+		}
+		else
+		{
+			joint.m_Transform.m_Scale.m_X = reader.ReadFloat();
+			joint.m_Transform.m_Scale.m_Y = reader.ReadFloat();
+			joint.m_Transform.m_Scale.m_Z = reader.ReadFloat();
+		}
+
+		if (reader.IsOverflow())
+			return -1;
+	}
+
+	return static_cast<int>(joints_count);
+}
+
+void GetPoseDataErrorBound(const SPoseCodecHeader& header, SVector3& translation_error, SVector3& euler_error, float& quaternion_error)
+{
+	float* translation = &translation_error.m_X;
+	float* euler = &euler_error.m_X;
+
+	const float translation_codes = static_cast<float>(CBitWriter::Mask(header.m_TranslationBits));
+	const float rotation_codes = static_cast<float>(CBitWriter::Mask(header.m_RotationBits));
+
+	// half a quantization step plus a float rounding of a reconstructed value
+	for (int k = 0; k < 3; ++k)
+	{
+		const float translation_magnitude = std::fmax(std::fabs(header.m_TranslationMin[k]), std::fabs(header.m_TranslationMax[k]));
+		translation[k] = 0.5f * (header.m_TranslationMax[k] - header.m_TranslationMin[k]) / translation_codes + 4.0f * FLT_EPSILON * translation_magnitude;
+
+		const float euler_magnitude = std::fmax(std::fabs(header.m_EulerMin[k]), std::fabs(header.m_EulerMax[k]));
+		euler[k] = 0.5f * (header.m_EulerMax[k] - header.m_EulerMin[k]) / rotation_codes + 4.0f * FLT_EPSILON * euler_magnitude;
+	}
+
+	// three components are off by a half step at most, the omitted one is >= 0.5 and gets
+	//  an error of sum(2 * |q| * h + h * h) <= 3 * h + 3 * h * h
+	const float h = 0.5f * 2.0f * SMALLEST_THREE_RANGE / rotation_codes;
+	quaternion_error = 3.0f * h * (1.0f + h) + 4.0f * FLT_EPSILON;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+/*
+#
+# Copyright(c) 2021 Avalanche Studios.All rights reserved.
+# Licensed under the MIT License.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files(the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions :
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE
+#
+*/
+
+#include "AnimLiveBridge.h"
+#include <cstddef>
+
+const unsigned int DEFAULT_TRANSLATION_BITS = 16;
+const unsigned int DEFAULT_ROTATION_BITS = 12;
+
+const unsigned int POSE_CODEC_VERSION = 1;
+
+///////////////////////////////////////////////////////////////////////////
+// quantized pose codec
+//  translation and euler angles are fixed-point values relative to a per-frame bound stored in a header
+//  quaternion is packed as smallest three components, scale is omitted when it's a default one
+//  joint hashes and flags are kept, a parent hash is replaced with a joint index when the parent is in the same frame
+
+struct SPoseCodecSettings
+{
+	unsigned int		m_TranslationBits{ DEFAULT_TRANSLATION_BITS };	//!< [4; 24] bits per translation component
+	unsigned int		m_RotationBits{ DEFAULT_ROTATION_BITS };		//!< [4; 20] bits per rotation component
+};
+
+struct SPoseCodecHeader
+{
+	unsigned char		m_Version;
+	unsigned char		m_TranslationBits;
+	unsigned char		m_RotationBits;
+	unsigned char		m_Reserved;
+	unsigned int		m_JointsCount;
+	unsigned int		m_Size;				//!< encoded size in bytes, including a header
+
+	float				m_TranslationMin[3];
+	float				m_TranslationMax[3];
+	float				m_EulerMin[3];
+	float				m_EulerMax[3];
+}; // 60 bytes
+
+//! worst case size of an encoded pose
+size_t GetMaxEncodedPoseSize(const unsigned int joints_count);
+//! least size of an encoded pose, a received joints count has to fit a payload
+size_t GetMinEncodedPoseSize(const unsigned int joints_count);
+
+//! encode joints, returns an encoded size or 0 if a buffer is too small
+size_t EncodePoseData(const SJointData* joints, const unsigned int joints_count, const SPoseCodecSettings& settings, unsigned char* buffer, const size_t buffer_size);
+
+//! decode joints, returns a number of decoded joints or -1 if data is not valid
+/*!
+	decoded quaternion could have an opposite sign, it's the same rotation
+*/
+int DecodePoseData(const unsigned char* buffer, const size_t size, SJointData* joints, const unsigned int max_count);
+
+//! max absolute error of a decoded component
+void GetPoseDataErrorBound(const SPoseCodecHeader& header, SVector3& translation_error, SVector3& euler_error, float& quaternion_error);
@@ -0,0 +1,157 @@
+/*
+#
+# Copyright(c) 2021 Avalanche Studios.All rights reserved.
+# Licensed under the MIT License.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files(the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions :
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE
+#
+*/
+
+#include "AnimLiveBridgeFrameEvent.h"
+#include "AnimLiveBridgeNetwork.h"
+#include <cstdint>
+#include <cstring>
+
+#ifdef _WIN32
+	#include <winsock2.h>
+	#include <ws2tcpip.h>
+#else
+	#include <unistd.h>
+	#include <fcntl.h>
+	#ifdef __linux__
+		#include <sys/eventfd.h>
+	#endif
+#endif
+
+//////////////////////////////////////////////////////////////////////////////////
+// CFrameReadyEvent
+
+long long CFrameReadyEvent::Open()
+{
+	if (m_Handle != -1)
+		return m_Handle;
+
+#if defined(_WIN32)
+	// a socket connected to itself, a datagram makes it readable for select based loops
+	if (!NetworkStartup())
+		return -1;
+
+	LiveBridgeSocket s = static_cast<LiveBridgeSocket>(socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP));
+	if (s == INVALID_LIVEBRIDGE_SOCKET)
+		return -1;
+
+	sockaddr_in addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	int addr_len = sizeof(addr);
+
+	if (bind(static_cast<SOCKET>(s), reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0
+		|| getsockname(static_cast<SOCKET>(s), reinterpret_cast<sockaddr*>(&addr), &addr_len) != 0
+		|| connect(static_cast<SOCKET>(s), reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0
+		|| !SetSocketNonBlocking(s))
+	{
+		CloseSocket(s);
+		return -1;
+	}
+	m_Handle = m_WriteHandle = static_cast<long long>(s);
+#elif defined(__linux__)
+	const int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (fd < 0)
+		return -1;
+
+	m_Handle = m_WriteHandle = fd;
+#else
+	int fds[2];
+	if (pipe(fds) != 0)
+		return -1;
+
+	SetSocketNonBlocking(fds[0]);
+	SetSocketNonBlocking(fds[1]);
+
+	m_Handle = fds[0];
+	m_WriteHandle = fds[1];
+#endif
+	return m_Handle;
+}
+
+void CFrameReadyEvent::Close()
+{
+	if (m_Handle == -1)
+		return;
+
+	LiveBridgeSocket handle = static_cast<LiveBridgeSocket>(m_Handle);
+	LiveBridgeSocket write_handle = static_cast<LiveBridgeSocket>(m_WriteHandle);
+
+	if (write_handle != handle)
+		CloseSocket(write_handle);
+	CloseSocket(handle);
+
+	m_Handle = m_WriteHandle = -1;
+}
+
+void CFrameReadyEvent::Signal()
+{
+	if (m_WriteHandle == -1)
+		return;
+
+	// a full buffer means a reader has not reset it yet, a handle stays readable anyway
+#if defined(_WIN32)
+	const char value = 1;
+	send(static_cast<SOCKET>(m_WriteHandle), &value, 1, 0);
+#elif defined(__linux__)
+	const uint64_t value = 1;
+	const ssize_t written = write(static_cast<int>(m_WriteHandle), &value, sizeof(value));
+	(void)written;
+#else
+	const char value = 1;
+	const ssize_t written = write(static_cast<int>(m_WriteHandle), &value, 1);
+	(void)written;
+#endif
+}
+
+int CFrameReadyEvent::Reset()
+{
+	if (m_Handle == -1)
+		return 0;
+
+#if defined(__linux__)
+	uint64_t value = 0;
+	return (read(static_cast<int>(m_Handle), &value, sizeof(value)) == sizeof(value)) ? static_cast<int>(value) : 0;
+#else
+	int count = 0;
+	char buffer[64];
+
+	while (true)
+	{
+#if defined(_WIN32)
+		// one datagram is one signal
+		if (recv(static_cast<SOCKET>(m_Handle), buffer, sizeof(buffer), 0) <= 0)
+			break;
+		++count;
+#else
+		const ssize_t size = read(static_cast<int>(m_Handle), buffer, sizeof(buffer));
+		if (size <= 0)
+			break;
+		count += static_cast<int>(size);
+#endif
+	}
+	return count;
+#endif
+}
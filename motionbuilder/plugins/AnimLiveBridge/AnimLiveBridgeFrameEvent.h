@@ -0,0 +1,52 @@
+#pragma once
+
+/*
+#
+# Copyright(c) 2021 Avalanche Studios.All rights reserved.
+# Licensed under the MIT License.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files(the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions :
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE
+#
+*/
+
+///////////////////////////////////////////////////////////////////////////
+// CFrameReadyEvent
+//  a handle which an event loop (asyncio, Qt, select) could wait on, it's readable after Signal until Reset
+//  eventfd on linux, a pipe on other posix systems and a loopback udp socket on windows
+
+class CFrameReadyEvent
+{
+public:
+	~CFrameReadyEvent() { Close(); }
+
+	//! create a handle once, returns -1 if it can't be created
+	long long Open();
+	void Close();
+
+	bool IsOpen() const { return m_Handle != -1; }
+	long long GetHandle() const { return m_Handle; }
+
+	void Signal();
+	//! read all pending signals, returns a number of them
+	int Reset();
+
+protected:
+	long long		m_Handle{ -1 };
+	long long		m_WriteHandle{ -1 };
+};
@@ -0,0 +1,273 @@
+
+/*
+#
+# Copyright(c) 2021 Avalanche Studios.All rights reserved.
+# Licensed under the MIT License.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files(the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions :
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE
+#
+*/
+
+#include "AnimLiveBridgeHierarchy.h"
+#include "AnimLiveBridgeMath.h"
+#include <algorithm>
+#include <cstring>
+
+// a hash of names and parents only, flags are changed by a conversion
+static unsigned int ComputeHierarchyId(const SJointData* joints, const unsigned int count)
+{
+	unsigned int hash = NAME_HASH_BASIS;
+
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		const unsigned int values[2] = { joints[i].m_NameHash, joints[i].m_ParentHash };
+		const unsigned char* bytes = reinterpret_cast<const unsigned char*>(values);
+
+		for (size_t k = 0; k < sizeof(values); ++k)
+			hash = (hash ^ bytes[k]) * NAME_HASH_PRIME;
+	}
+	return hash ^ count;
+}
+
+// row vector matrices, result = a * b, result could be a
+static inline void MultiplyMatrix(const double* a, const double* b, double* result)
+{
+	double m[16];
+
+	for (int r = 0; r < 4; ++r)
+	{
+		for (int c = 0; c < 4; ++c)
+		{
+			m[r * 4 + c] = a[r * 4] * b[c] + a[r * 4 + 1] * b[4 + c] + a[r * 4 + 2] * b[8 + c] + a[r * 4 + 3] * b[12 + c];
+		}
+	}
+	memcpy(result, m, sizeof(double) * 16);
+}
+
+// inverse of an affine matrix, a last column is 0 0 0 1
+static inline void InverseMatrix(const double* m, double* result)
+{
+	const double c00 = m[5] * m[10] - m[6] * m[9];
+	const double c01 = m[6] * m[8] - m[4] * m[10];
+	const double c02 = m[4] * m[9] - m[5] * m[8];
+
+	const double det = m[0] * c00 + m[1] * c01 + m[2] * c02;
+	const double inv_det = (det != 0.0) ? 1.0 / det : 0.0;
+
+	double r[16];
+	r[0] = c00 * inv_det;
+	r[1] = (m[2] * m[9] - m[1] * m[10]) * inv_det;
+	r[2] = (m[1] * m[6] - m[2] * m[5]) * inv_det;
+	r[4] = c01 * inv_det;
+	r[5] = (m[0] * m[10] - m[2] * m[8]) * inv_det;
+	r[6] = (m[2] * m[4] - m[0] * m[6]) * inv_det;
+	r[8] = c02 * inv_det;
+	r[9] = (m[1] * m[8] - m[0] * m[9]) * inv_det;
+	r[10] = (m[0] * m[5] - m[1] * m[4]) * inv_det;
+
+	// translation row, -t * inverse rotation
+	for (int c = 0; c < 3; ++c)
+	{
+		r[12 + c] = -(m[12] * r[c] + m[13] * r[4 + c] + m[14] * r[8 + c]);
+	}
+	r[3] = r[7] = r[11] = 0.0;
+	r[15] = 1.0;
+
+	memcpy(result, r, sizeof(double) * 16);
+}
+
+////////////////////////////////////////////////////////////
+// CJointHierarchy
+
+bool CJointHierarchy::Update(const SJointData* joints, const unsigned int count)
+{
+	const unsigned int layout_id = ComputeHierarchyId(joints, count);
+	if (layout_id == m_LayoutId && m_Order.size() == count)
+		return m_IsValid;
+
+	m_LayoutId = layout_id;
+	m_IsValid = true;
+
+	// joints by a name hash, a first joint wins for a duplicated name
+	std::vector<std::pair<unsigned int, unsigned int>> sorted_joints(count);
+	for (unsigned int i = 0; i < count; ++i)
+		sorted_joints[i] = { joints[i].m_NameHash, i };
+	std::stable_sort(sorted_joints.begin(), sorted_joints.end(),
+		[](const std::pair<unsigned int, unsigned int>& a, const std::pair<unsigned int, unsigned int>& b) { return a.first < b.first; });
+
+	std::vector<int> frame_parents(count, -1);
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		const unsigned int parent_hash = joints[i].m_ParentHash;
+		if (parent_hash == 0)
+			continue;
+
+		auto iter = std::lower_bound(sorted_joints.begin(), sorted_joints.end(), std::make_pair(parent_hash, 0u));
+		if (iter != sorted_joints.end() && iter->first == parent_hash && iter->second != i)
+			frame_parents[i] = static_cast<int>(iter->second);
+	}
+
+	// a depth of every joint, a walk longer than a joints count is a cycle
+	std::vector<int> depths(count, -1);
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		int depth = 0;
+		int joint = static_cast<int>(i);
+
+		while (joint >= 0 && depths[joint] < 0 && depth <= static_cast<int>(count))
+		{
+			joint = frame_parents[joint];
+			++depth;
+		}
+
+		if (depth > static_cast<int>(count))
+		{
+			m_IsValid = false;
+			break;
+		}
+
+		// a known depth of an ancestor, or -1 past a root
+		int known = (joint >= 0) ? depths[joint] : -1;
+		int path_depth = known + depth;
+
+		for (joint = static_cast<int>(i); joint >= 0 && depths[joint] < 0; joint = frame_parents[joint])
+			depths[joint] = path_depth--;
+	}
+
+	m_Order.resize(count);
+	m_Parents.assign(count, -1);
+
+	if (!m_IsValid)
+		return false;
+
+	for (unsigned int i = 0; i < count; ++i)
+		m_Order[i] = i;
+	std::stable_sort(m_Order.begin(), m_Order.end(), [&depths](const unsigned int a, const unsigned int b) { return depths[a] < depths[b]; });
+
+	std::vector<int> ordered_index(count);
+	for (unsigned int k = 0; k < count; ++k)
+		ordered_index[m_Order[k]] = static_cast<int>(k);
+
+	for (unsigned int k = 0; k < count; ++k)
+	{
+		const int parent = frame_parents[m_Order[k]];
+		m_Parents[k] = (parent >= 0) ? ordered_index[parent] : -1;
+	}
+	return true;
+}
+
+int CJointHierarchy::Convert(SJointData* joints, const unsigned int count, const unsigned int space_hint)
+{
+	if (!Update(joints, count))
+		return -1;
+
+	m_Transforms.resize(count);
+	m_Matrices.resize(static_cast<size_t>(count) * 16);
+	m_ModelMatrices.resize(static_cast<size_t>(count) * 16);
+
+	// gather in order, euler rotations are converted with one batch
+	m_EulerJoints.clear();
+	for (unsigned int k = 0; k < count; ++k)
+	{
+		const SJointData& joint = joints[m_Order[k]];
+		m_Transforms[k] = joint.m_Transform;
+
+		if (joint.m_Flags & HINT_ROTATION_EULERANGLES)
+			m_EulerJoints.push_back(k);
+	}
+
+	const unsigned int euler_count = static_cast<unsigned int>(m_EulerJoints.size());
+	m_Euler.resize(euler_count);
+	m_Quaternions.resize(euler_count);
+
+	for (unsigned int e = 0; e < euler_count; ++e)
+	{
+		const SVector4& r = m_Transforms[m_EulerJoints[e]].m_Rotation;
+		m_Euler[e] = { r.m_X, r.m_Y, r.m_Z };
+	}
+	EulerToQuaternionData(m_Euler.data(), m_Quaternions.data(), euler_count);
+	for (unsigned int e = 0; e < euler_count; ++e)
+		m_Transforms[m_EulerJoints[e]].m_Rotation = m_Quaternions[e];
+
+	TransformToMatrixData(m_Transforms.data(), m_Matrices.data(), count);
+
+	// a parent model matrix is always computed before its children
+	double* matrices = m_Matrices.data();
+	double* model = m_ModelMatrices.data();
+
+	for (unsigned int k = 0; k < count; ++k)
+	{
+		const int parent = m_Parents[k];
+		const bool is_model = (joints[m_Order[k]].m_Flags & HINT_TRANSFORM_MODEL) != 0;
+
+		if (parent < 0 || is_model)
+			memcpy(model + k * 16, matrices + k * 16, sizeof(double) * 16);
+		else
+			MultiplyMatrix(matrices + k * 16, model + parent * 16, model + k * 16);
+	}
+
+	const bool to_model = (space_hint & HINT_TRANSFORM_MODEL) != 0;
+	const double* result = model;
+
+	if (!to_model)
+	{
+		// local = model * inverse(parent model), matrices are reused for a result
+		double inverse[16];
+
+		for (unsigned int k = 0; k < count; ++k)
+		{
+			const int parent = m_Parents[k];
+
+			if (parent < 0)
+			{
+				memcpy(matrices + k * 16, model + k * 16, sizeof(double) * 16);
+			}
+			else
+			{
+				InverseMatrix(model + parent * 16, inverse);
+				MultiplyMatrix(model + k * 16, inverse, matrices + k * 16);
+			}
+		}
+		result = matrices;
+	}
+
+	MatrixToTransformData(result, m_Transforms.data(), count);
+
+	for (unsigned int e = 0; e < euler_count; ++e)
+		m_Quaternions[e] = m_Transforms[m_EulerJoints[e]].m_Rotation;
+	QuaternionToEulerData(m_Quaternions.data(), m_Euler.data(), euler_count);
+	for (unsigned int e = 0; e < euler_count; ++e)
+		m_Transforms[m_EulerJoints[e]].m_Rotation = { m_Euler[e].m_X, m_Euler[e].m_Y, m_Euler[e].m_Z, 0.0f };
+
+	// scatter back, a space flag is replaced
+	const unsigned int space_flag = (to_model) ? HINT_TRANSFORM_MODEL : HINT_TRANSFORM_LOCAL;
+
+	for (unsigned int k = 0; k < count; ++k)
+	{
+		SJointData& joint = joints[m_Order[k]];
+		const bool is_model = (joint.m_Flags & HINT_TRANSFORM_MODEL) != 0;
+
+		// a joint already in a requested space keeps its values, no round trip error or another euler branch
+		if (m_Parents[k] >= 0 && is_model != to_model)
+			joint.m_Transform = m_Transforms[k];
+
+		joint.m_Flags = (joint.m_Flags & ~(HINT_TRANSFORM_LOCAL | HINT_TRANSFORM_MODEL)) | space_flag;
+	}
+	return 0;
+}
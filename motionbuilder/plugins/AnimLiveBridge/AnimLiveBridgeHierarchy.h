@@ -0,0 +1,68 @@
+#pragma once
+
+/*
+#
+# Copyright(c) 2021 Avalanche Studios.All rights reserved.
+# Licensed under the MIT License.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files(the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions :
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE
+#
+*/
+
+#include "AnimLiveBridge.h"
+#include <vector>
+
+////////////////////////////////////////////////////////////
+// CJointHierarchy
+//  joints are ordered by parents once per joints layout, a parent always goes before its children,
+//  a frame is converted between local and model space with one pass over contiguous matrices in that order
+//  a joint is in model space when it has HINT_TRANSFORM_MODEL, otherwise it's local to a parent,
+//  a joint without a parent in a frame is a root and both spaces are the same for it
+//  NOTE: a model space scale is taken per axis, a shear of a non uniform parent scale is dropped
+
+class CJointHierarchy
+{
+public:
+
+	//! order joints when names or parents are changed, returns false if a parent cycle is found
+	bool Update(const SJointData* joints, const unsigned int count);
+
+	//! convert joints to HINT_TRANSFORM_LOCAL or HINT_TRANSFORM_MODEL space, rotations keep their type
+	/*!
+		\return 0 if succeed, -1 if joints have a parent cycle
+	*/
+	int Convert(SJointData* joints, const unsigned int count, const unsigned int space_hint);
+
+	unsigned int GetLayoutId() const { return m_LayoutId; }
+
+protected:
+	unsigned int				m_LayoutId{ 0 };
+	bool						m_IsValid{ false };
+
+	std::vector<unsigned int>	m_Order;				//!< ordered index -> frame joint index
+	std::vector<int>			m_Parents;				//!< ordered index -> ordered parent index, -1 for a root
+
+	// scratch buffers, they are kept between frames
+	std::vector<STransform>		m_Transforms;
+	std::vector<double>			m_Matrices;				//!< 16 values per ordered joint
+	std::vector<double>			m_ModelMatrices;
+	std::vector<unsigned int>	m_EulerJoints;
+	std::vector<SVector3>		m_Euler;
+	std::vector<SVector4>		m_Quaternions;
+};
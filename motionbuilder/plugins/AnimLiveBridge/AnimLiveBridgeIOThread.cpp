@@ -0,0 +1,279 @@
+/*
+#
+# Copyright(c) 2021 Avalanche Studios.All rights reserved.
+# Licensed under the MIT License.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files(the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions :
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE
+#
+*/
+
+
+#include "AnimLiveBridgeIOThread.h"
+#include <string>
+#include <cstring>
+#include <chrono>
+
+#ifdef _WIN32
+	#include <windows.h>
+#else
+	#include <pthread.h>
+	#include <sched.h>
+#endif
+
+static void ApplyThreadSettings(std::thread& thread, const int affinity_mask, const int priority)
+{
+	bool succeed = true;
+
+#ifdef _WIN32
+	HANDLE handle = static_cast<HANDLE>(thread.native_handle());
+
+	if (affinity_mask != 0)
+	{
+		succeed &= SetThreadAffinityMask(handle, static_cast<DWORD_PTR>(static_cast<unsigned int>(affinity_mask))) != 0;
+	}
+	if (priority != 0)
+	{
+		int value = THREAD_PRIORITY_NORMAL;
+		switch (priority)
+		{
+		case 1: value = THREAD_PRIORITY_ABOVE_NORMAL; break;
+		case 2: value = THREAD_PRIORITY_HIGHEST; break;
+		case 3: value = THREAD_PRIORITY_TIME_CRITICAL; break;
+		default: value = (priority < 0) ? THREAD_PRIORITY_BELOW_NORMAL : THREAD_PRIORITY_TIME_CRITICAL;
+		}
+		succeed &= SetThreadPriority(handle, value) != FALSE;
+	}
+#else
+	pthread_t handle = thread.native_handle();
+
+#ifdef __linux__
+	if (affinity_mask != 0)
+	{
+		cpu_set_t cpu_set;
+		CPU_ZERO(&cpu_set);
+
+		for (int i = 0; i < 32; ++i)
+		{
+			if (static_cast<unsigned int>(affinity_mask) & (1u << i))
+				CPU_SET(i, &cpu_set);
+		}
+		succeed &= pthread_setaffinity_np(handle, sizeof(cpu_set), &cpu_set) == 0;
+	}
+#endif
+	// a real-time policy needs privileges, a normal priority is kept otherwise
+	if (priority > 0)
+	{
+		sched_param param;
+		param.sched_priority = sched_get_priority_min(SCHED_FIFO) + priority;
+		succeed &= pthread_setschedparam(handle, SCHED_FIFO, &param) == 0;
+	}
+#endif
+
+	if (!succeed && g_VerboseLevel && g_Logger)
+	{
+		std::string info("[HardwareOpen] Failed to apply io thread affinity / priority, affinity - ");
+		info += std::to_string(affinity_mask);
+		info += ", priority - ";
+		info += std::to_string(priority);
+
+		g_Logger->LogWarning(info.c_str());
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////
+// CAnimLiveBridgeIOThread
+
+CAnimLiveBridgeIOThread::CAnimLiveBridgeIOThread(CAnimLiveBridgeSession* session, CAnimLiveBridgeHardware* hardware)
+	: m_Session(session)
+	, m_Hardware(hardware)
+{}
+
+CAnimLiveBridgeIOThread::~CAnimLiveBridgeIOThread()
+{
+	Stop();
+}
+
+bool CAnimLiveBridgeIOThread::Start(const bool is_server, const int affinity_mask, const int priority)
+{
+	if (m_Running.load())
+		return false;
+
+	m_IsServer = is_server;
+
+	// a caller starts with a session frame, a capacity is known after a hardware open
+	m_UserFrame.CopyFrom(m_Session->GetFrame());
+
+	for (int i = 0; i < 3; ++i)
+	{
+		m_Outbox[i].CopyFrom(m_UserFrame);
+		m_Inbox[i].CopyFrom(m_UserFrame);
+	}
+	m_OutboxState.Initialize();
+	m_InboxState.Initialize();
+
+	m_Running.store(true);
+	m_Thread = std::thread(&CAnimLiveBridgeIOThread::Run, this);
+
+	if (affinity_mask != 0 || priority != 0)
+	{
+		ApplyThreadSettings(m_Thread, affinity_mask, priority);
+	}
+	return true;
+}
+
+void CAnimLiveBridgeIOThread::Stop()
+{
+	if (!m_Thread.joinable())
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(m_WakeLock);
+		m_Running.store(false);
+	}
+	m_WakeCondition.notify_all();
+	m_Thread.join();
+}
+
+void CAnimLiveBridgeIOThread::Run()
+{
+	while (m_Running.load())
+	{
+		// handshake and a turn are handled by a hardware wait, server turn or a new server frame
+		if (m_Hardware->WaitForFrame(IO_THREAD_WAIT_MS) != 0)
+			continue;
+
+		if (m_IsServer)
+		{
+			std::unique_lock<std::mutex> lock(m_WakeLock);
+			m_WakeCondition.wait_for(lock, std::chrono::milliseconds(IO_THREAD_WAIT_MS),
+				[this]() { return m_OutboxState.HasNewData() || !m_Running.load(); });
+
+			if (!m_OutboxState.HasNewData())
+				continue;
+		}
+
+		Exchange();
+	}
+}
+
+void CAnimLiveBridgeIOThread::Exchange()
+{
+	int result = -1;
+	{
+		// timeline, look at and sync values are shared with a caller thread
+		std::lock_guard<std::mutex> lock(m_Session->GetStateLock());
+
+		SSharedModelData* session_data = m_Session->GetDataPtr();
+
+		if (m_OutboxState.Acquire())
+		{
+			const SFrameBuffer& outbox = m_Outbox[m_OutboxState.m_ReadIndex];
+
+			if (m_IsServer)
+			{
+				// a server capacity is fixed by a hardware open, a caller frame has the same one
+				const SFrameBuffer& frame = m_Session->GetFrame();
+				CopyFrameData(session_data, outbox.m_Data, frame.m_JointsCapacity, frame.m_PropsCapacity, frame.m_EntitiesCapacity);
+			}
+			else
+			{
+				// a client sends back only a feedback, a received frame is kept
+				session_data->m_Header.m_ClientTag = outbox.m_Data->m_Header.m_ClientTag;
+			}
+		}
+
+		result = m_Hardware->Commit(true);
+
+		if (result == 0)
+		{
+			m_Inbox[m_InboxState.m_WriteIndex].CopyFrom(m_Session->GetFrame());
+			m_InboxState.Publish();
+
+			if (!m_IsServer)
+				m_Session->OnFrameReceived(*m_Session->GetFrame().m_Data);
+		}
+	}
+
+	if (result != 0)
+		return;
+
+	{
+		// an empty section, a caller can't miss a notification between a check and a wait
+		std::lock_guard<std::mutex> lock(m_FrameLock);
+	}
+	m_FrameCondition.notify_all();
+
+	m_Session->NotifyFrameReady();
+}
+
+int CAnimLiveBridgeIOThread::Commit()
+{
+	SSharedModelData* user_data = m_UserFrame.m_Data;
+	ValidateFrameLayout(*user_data, m_UserFrame.m_JointsCapacity, m_UserFrame.m_PropsCapacity, m_UserFrame.m_EntitiesCapacity);
+
+	SFrameBuffer& outbox = m_Outbox[m_OutboxState.m_WriteIndex];
+
+	if (m_IsServer)
+	{
+		outbox.CopyFrom(m_UserFrame);
+		m_OutboxState.Publish();
+
+		{
+			std::lock_guard<std::mutex> lock(m_WakeLock);
+		}
+		m_WakeCondition.notify_one();
+
+		// client feedback from a last exchange
+		if (m_InboxState.Acquire())
+		{
+			const SSharedModelData* inbox_data = m_Inbox[m_InboxState.m_ReadIndex].m_Data;
+
+			user_data->m_Header.m_ClientTag = inbox_data->m_Header.m_ClientTag;
+			memcpy(user_data->m_LookAtRoot, inbox_data->m_LookAtRoot, sizeof(float) * 4);
+			memcpy(user_data->m_LookAtLeft, inbox_data->m_LookAtLeft, sizeof(float) * 4);
+			memcpy(user_data->m_LookAtRight, inbox_data->m_LookAtRight, sizeof(float) * 4);
+		}
+		return 0;
+	}
+
+	// a worker takes only a client tag from a client frame
+	outbox.m_Data->m_Header.m_ClientTag = user_data->m_Header.m_ClientTag;
+	m_OutboxState.Publish();
+
+	if (!m_InboxState.Acquire())
+		return -1;
+
+	const unsigned int client_tag = user_data->m_Header.m_ClientTag;
+
+	m_UserFrame.CopyFrom(m_Inbox[m_InboxState.m_ReadIndex]);
+	m_UserFrame.m_Data->m_Header.m_ClientTag = client_tag;
+	return 0;
+}
+
+int CAnimLiveBridgeIOThread::WaitForFrame(const unsigned int timeout_ms)
+{
+	if (m_IsServer || m_InboxState.HasNewData())
+		return 0;
+
+	std::unique_lock<std::mutex> lock(m_FrameLock);
+	const bool has_frame = m_FrameCondition.wait_for(lock, std::chrono::milliseconds(timeout_ms),
+		[this]() { return m_InboxState.HasNewData(); });
+
+	return (has_frame) ? 0 : -1;
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+/*
+#
+# Copyright(c) 2021 Avalanche Studios.All rights reserved.
+# Licensed under the MIT License.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files(the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions :
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE
+#
+*/
+
+
+#include "AnimLiveBridgeSession.h"
+#include "AnimLiveBridgeTripleBuffer.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+// how long a worker blocks before it checks a stop request
+const unsigned int IO_THREAD_WAIT_MS = 10;
+
+///////////////////////////////////////////////////////////////////////////
+// CAnimLiveBridgeIOThread
+//  optional session worker, it owns a hardware exchange (handshake, waits and commits) on its own thread
+//  a caller thread exchanges frames with it through two latest value mailboxes and never waits for a transport
+//  outbox - caller frames going to a hardware, inbox - session frames after a successful hardware commit
+
+class CAnimLiveBridgeIOThread
+{
+public:
+	//! a constructor
+	CAnimLiveBridgeIOThread(CAnimLiveBridgeSession* session, CAnimLiveBridgeHardware* hardware);
+	~CAnimLiveBridgeIOThread();
+
+	//! start a worker, affinity is a cpu bit mask (0 - any cpu), priority is from -1 (below normal) to 3 (time critical)
+	bool Start(const bool is_server, const int affinity_mask, const int priority);
+	void Stop();
+
+	//! caller frame, it's mapped instead of a session frame while a worker is running
+	SFrameBuffer& GetUserFrame() { return m_UserFrame; }
+
+	//! caller side commit, server queues a frame and returns 0, client takes a newest received frame or returns -1
+	int Commit();
+	//! caller side wait, a server never waits, a client waits for a new inbox frame
+	int WaitForFrame(const unsigned int timeout_ms);
+
+protected:
+
+	CAnimLiveBridgeSession*		m_Session{ nullptr };
+	CAnimLiveBridgeHardware*	m_Hardware{ nullptr };
+
+	std::thread					m_Thread;
+	std::atomic<bool>			m_Running{ false };
+	bool						m_IsServer{ true };
+
+	SFrameBuffer				m_UserFrame;
+
+	// mailbox slots are indexed by a triple buffer state, a writer owns a back slot, a reader owns a front slot
+	SFrameBuffer				m_Outbox[3];
+	SFrameBuffer				m_Inbox[3];
+	STripleBufferState			m_OutboxState;
+	STripleBufferState			m_InboxState;
+
+	// a worker is parked here while a server has no new caller frame
+	std::mutex					m_WakeLock;
+	std::condition_variable		m_WakeCondition;
+
+	// a caller is parked here while a client has no new inbox frame
+	std::mutex					m_FrameLock;
+	std::condition_variable		m_FrameCondition;
+
+	void Run();
+	void Exchange();
+};
@@ -0,0 +1,241 @@
+/*
+#
+# Copyright(c) 2021 Avalanche Studios.All rights reserved.
+# Licensed under the MIT License.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files(the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions :
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE
+#
+*/
+
+#include "AnimLiveBridgeJitterBuffer.h"
+#include <cmath>
+#include <cstring>
+
+static inline float Lerp(const float a, const float b, const float t)
+{
+	return a + (b - a) * t;
+}
+
+// shortest way between two angles in degrees
+static inline float LerpAngle(const float a, const float b, const float t)
+{
+	float delta = std::fmod(b - a, 360.0f);
+	if (delta > 180.0f)
+		delta -= 360.0f;
+	else if (delta < -180.0f)
+		delta += 360.0f;
+
+	return a + delta * t;
+}
+
+static void LerpQuaternion(SVector4& result, const SVector4& a, const SVector4& b, const float t, const int interpolation)
+{
+	float dot = a.m_X * b.m_X + a.m_Y * b.m_Y + a.m_Z * b.m_Z + a.m_W * b.m_W;
+
+	// q and -q are the same rotation, take a shortest arc
+	const float sign = (dot < 0.0f) ? -1.0f : 1.0f;
+	dot *= sign;
+
+	float wa = 1.0f - t;
+	float wb = t * sign;
+
+	if (interpolation == EPoseInterpolation_Slerp && dot < 0.9995f)
+	{
+		const float angle = std::acos(dot);
+		const float inv_sin = 1.0f / std::sin(angle);
+
+		wa = std::sin(wa * angle) * inv_sin;
+		wb = std::sin(t * angle) * inv_sin * sign;
+	}
+
+	result.m_X = a.m_X * wa + b.m_X * wb;
+	result.m_Y = a.m_Y * wa + b.m_Y * wb;
+	result.m_Z = a.m_Z * wa + b.m_Z * wb;
+	result.m_W = a.m_W * wa + b.m_W * wb;
+
+	// nlerp is normalized, slerp only drifts by a float error
+	const float length = std::sqrt(result.m_X * result.m_X + result.m_Y * result.m_Y + result.m_Z * result.m_Z + result.m_W * result.m_W);
+	if (length > 0.0f)
+	{
+		const float inv_length = 1.0f / length;
+		result.m_X *= inv_length;
+		result.m_Y *= inv_length;
+		result.m_Z *= inv_length;
+		result.m_W *= inv_length;
+	}
+}
+
+////////////////////////////////////////////////////////////////
+// CAnimLiveBridgeJitterBuffer
+
+void CAnimLiveBridgeJitterBuffer::Configure(const double delay, const int interpolation)
+{
+	std::lock_guard<std::mutex> lock(m_Lock);
+
+	m_Delay = (delay > 0.0) ? delay : 0.0;
+	m_Interpolation = interpolation;
+}
+
+void CAnimLiveBridgeJitterBuffer::Clear()
+{
+	std::lock_guard<std::mutex> lock(m_Lock);
+
+	m_Head = 0;
+	m_Count = 0;
+	m_OffsetHead = 0;
+	m_OffsetCount = 0;
+}
+
+double CAnimLiveBridgeJitterBuffer::MapSenderTime(const double sender_time, const double arrival_time)
+{
+	// a fastest frame of a window has a least queueing delay, its offset is closest to a clocks difference
+	m_OffsetSamples[m_OffsetHead] = arrival_time - sender_time;
+	m_OffsetHead = (m_OffsetHead + 1) % JITTER_OFFSET_SAMPLES;
+	if (m_OffsetCount < JITTER_OFFSET_SAMPLES)
+		++m_OffsetCount;
+
+	double offset = m_OffsetSamples[0];
+	for (unsigned int i = 1; i < m_OffsetCount; ++i)
+	{
+		offset = (m_OffsetSamples[i] < offset) ? m_OffsetSamples[i] : offset;
+	}
+	return sender_time + offset;
+}
+
+void CAnimLiveBridgeJitterBuffer::Push(const SSharedModelData& data, const unsigned int joints_capacity, const unsigned int props_capacity,
+	const unsigned int entities_capacity, const double arrival_time, const double send_time)
+{
+	std::lock_guard<std::mutex> lock(m_Lock);
+
+	const double sender_time = data.m_ServerPlayer.m_SystemTime;
+	const double time = (send_time > 0.0) ? send_time
+		: (sender_time > 0.0) ? MapSenderTime(sender_time, arrival_time) : arrival_time;
+
+	// a repeated or reordered frame doesn't move a pose forward
+	if (m_Count > 0 && time <= GetFrame(0).m_Time)
+		return;
+
+	STimedFrame& timed_frame = m_Frames[m_Head];
+	SFrameBuffer& frame = timed_frame.m_Frame;
+
+	// a client capacity comes from a server on open, a ring follows it
+	frame.Resize(joints_capacity, props_capacity, entities_capacity);
+	CopyFrameData(frame.m_Data, &data, joints_capacity, props_capacity, entities_capacity);
+	timed_frame.m_Time = time;
+
+	m_Head = (m_Head + 1) % JITTER_BUFFER_FRAMES;
+	if (m_Count < JITTER_BUFFER_FRAMES)
+		++m_Count;
+}
+
+const SSharedModelData* CAnimLiveBridgeJitterBuffer::Sample(const double time)
+{
+	std::lock_guard<std::mutex> lock(m_Lock);
+
+	if (m_Count == 0)
+		return nullptr;
+
+	const double sample_time = time - m_Delay;
+
+	// no extrapolation, a pose holds on a newest frame until a next one comes
+	const STimedFrame& newest = GetFrame(0);
+	if (m_Count == 1 || sample_time >= newest.m_Time)
+	{
+		m_Sample.CopyFrom(newest.m_Frame);
+		return m_Sample.m_Data;
+	}
+
+	for (unsigned int age = 1; age < m_Count; ++age)
+	{
+		const STimedFrame& older = GetFrame(age);
+
+		if (sample_time >= older.m_Time)
+		{
+			const STimedFrame& newer = GetFrame(age - 1);
+			const float t = static_cast<float>((sample_time - older.m_Time) / (newer.m_Time - older.m_Time));
+
+			Interpolate(older.m_Frame, newer.m_Frame, t);
+			return m_Sample.m_Data;
+		}
+	}
+
+	// a delay is longer than a ring, an oldest frame is a closest one
+	m_Sample.CopyFrom(GetFrame(m_Count - 1).m_Frame);
+	return m_Sample.m_Data;
+}
+
+void CAnimLiveBridgeJitterBuffer::Interpolate(const SFrameBuffer& a, const SFrameBuffer& b, const float t)
+{
+	// header, player info, look at and entities come from a newer frame, a timeline could jump so it's not blended
+	m_Sample.CopyFrom(b);
+
+	const SSharedModelData* data_a = a.m_Data;
+	SSharedModelData* data = m_Sample.m_Data;
+
+	const unsigned int joints_count = (data_a->m_Header.m_ModelsCount < data->m_Header.m_ModelsCount) ? data_a->m_Header.m_ModelsCount : data->m_Header.m_ModelsCount;
+	const SJointData* joints_a = GetModelJoints(data_a);
+	SJointData* joints = GetModelJoints(data);
+
+	for (unsigned int i = 0; i < joints_count; ++i)
+	{
+		// a rig is changed between frames, a joint snaps to a newer one
+		if (joints_a[i].m_NameHash != joints[i].m_NameHash || joints_a[i].m_Flags != joints[i].m_Flags)
+			continue;
+
+		const STransform& from = joints_a[i].m_Transform;
+		STransform& to = joints[i].m_Transform;
+
+		to.m_Translation.m_X = Lerp(from.m_Translation.m_X, to.m_Translation.m_X, t);
+		to.m_Translation.m_Y = Lerp(from.m_Translation.m_Y, to.m_Translation.m_Y, t);
+		to.m_Translation.m_Z = Lerp(from.m_Translation.m_Z, to.m_Translation.m_Z, t);
+
+		to.m_Scale.m_X = Lerp(from.m_Scale.m_X, to.m_Scale.m_X, t);
+		to.m_Scale.m_Y = Lerp(from.m_Scale.m_Y, to.m_Scale.m_Y, t);
+		to.m_Scale.m_Z = Lerp(from.m_Scale.m_Z, to.m_Scale.m_Z, t);
+
+		if (joints[i].m_Flags & HINT_ROTATION_EULERANGLES)
+		{
+			to.m_Rotation.m_X = LerpAngle(from.m_Rotation.m_X, to.m_Rotation.m_X, t);
+			to.m_Rotation.m_Y = LerpAngle(from.m_Rotation.m_Y, to.m_Rotation.m_Y, t);
+			to.m_Rotation.m_Z = LerpAngle(from.m_Rotation.m_Z, to.m_Rotation.m_Z, t);
+		}
+		else
+		{
+			const SVector4 rotation = to.m_Rotation;
+			LerpQuaternion(to.m_Rotation, from.m_Rotation, rotation, t, m_Interpolation);
+		}
+	}
+
+	// packed channels are not name / value pairs, they snap to a newer frame
+	if (IsChannelBlock(data_a) || IsChannelBlock(data))
+		return;
+
+	const unsigned int props_count = (data_a->m_Header.m_PropsCount < data->m_Header.m_PropsCount) ? data_a->m_Header.m_PropsCount : data->m_Header.m_PropsCount;
+	const SPropertyData* props_a = GetModelProperties(data_a);
+	SPropertyData* props = GetModelProperties(data);
+
+	for (unsigned int i = 0; i < props_count; ++i)
+	{
+		if (props_a[i].m_NameHash == props[i].m_NameHash)
+		{
+			props[i].m_Value = Lerp(props_a[i].m_Value, props[i].m_Value, t);
+		}
+	}
+
+}
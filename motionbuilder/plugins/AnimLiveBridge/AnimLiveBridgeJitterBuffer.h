@@ -0,0 +1,85 @@
+#pragma once
+
+/*
+#
+# Copyright(c) 2021 Avalanche Studios.All rights reserved.
+# Licensed under the MIT License.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files(the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions :
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE
+#
+*/
+
+
+#include "AnimLiveBridgeSession.h"
+#include <mutex>
+
+const int JITTER_BUFFER_FRAMES = 16;			// a ring of received frames, it covers a delay of 16 server frames
+const int JITTER_OFFSET_SAMPLES = 64;			// sender to local clock offset is a minimum over last samples
+
+////////////////////////////////////////////////////////////////
+// CAnimLiveBridgeJitterBuffer
+//  client side ring of timestamped frames, a pose is sampled at a caller evaluation time minus a fixed delay
+//  translation, scale and properties are interpolated linearly, rotations with nlerp or slerp
+
+class CAnimLiveBridgeJitterBuffer
+{
+public:
+
+	//! delay in seconds, a sample time is shifted back by it to have a frame on both sides
+	void Configure(const double delay, const int interpolation);
+	void Clear();
+
+	//! store a received frame, a frame time is a sender m_ServerPlayer.m_SystemTime if it's stamped, otherwise an arrival time
+	//!  send_time is a sender stamp already mapped to a local clock by a clock sync, 0 to estimate a mapping from arrival times
+	void Push(const SSharedModelData& data, const unsigned int joints_capacity, const unsigned int props_capacity,
+		const unsigned int entities_capacity, const double arrival_time, const double send_time = 0.0);
+
+	//! interpolate a frame at a given local time, nullptr if there is no frame yet. NOTE: a pointer is valid until a next sample
+	const SSharedModelData* Sample(const double time);
+
+	unsigned int GetFramesCount() const { return m_Count; }
+
+protected:
+
+	struct STimedFrame
+	{
+		SFrameBuffer	m_Frame;
+		double			m_Time{ 0.0 };
+	};
+
+	std::mutex		m_Lock;
+
+	double			m_Delay{ 0.0 };
+	int				m_Interpolation{ 0 };
+
+	STimedFrame		m_Frames[JITTER_BUFFER_FRAMES];
+	unsigned int	m_Head{ 0 };				// next frame to write
+	unsigned int	m_Count{ 0 };
+
+	double			m_OffsetSamples[JITTER_OFFSET_SAMPLES]{ 0.0 };
+	unsigned int	m_OffsetHead{ 0 };
+	unsigned int	m_OffsetCount{ 0 };
+
+	SFrameBuffer	m_Sample;
+
+	const STimedFrame& GetFrame(const unsigned int age) const { return m_Frames[(m_Head + JITTER_BUFFER_FRAMES - 1 - age) % JITTER_BUFFER_FRAMES]; }
+
+	double MapSenderTime(const double sender_time, const double arrival_time);
+	void Interpolate(const SFrameBuffer& a, const SFrameBuffer& b, const float t);
+};
@@ -0,0 +1,336 @@
+/*
+#
+# Copyright(c) 2021 Avalanche Studios.All rights reserved.
+# Licensed under the MIT License.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files(the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions :
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE
+#
+*/
+
+
+
+#include "AnimLiveBridgeLog.h"
+#include "AnimLiveBridgeSession.h"
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <chrono>
+
+struct SLogMessageFormat
+{
+	ELogLevel		m_Level;
+	const char*		m_Format;		// up to LOG_RECORD_ARGS %lld arguments
+};
+
+static const SLogMessageFormat LOG_MESSAGE_FORMATS[ELogMessage_Count] =
+{
+	{ ELogLevel_Info, "NewLiveSession %lld" },
+	{ ELogLevel_Error, "[NewLiveSession] all session slots are in use %lld" },
+	{ ELogLevel_Error, "[EraseLiveSession] session id is not found %lld" },
+	{ ELogLevel_Info, "[EraseLiveSession] closing map file handle for session id %lld" },
+	{ ELogLevel_Warning, "[EraseLiveSession] map file is already closed for session id %lld" },
+	{ ELogLevel_Error, "[HardwareOpen] session id is not found %lld" },
+	{ ELogLevel_Info, "[HardwareClose] closing map file handle for session id %lld" },
+	{ ELogLevel_Info, "[SetServerFinishEvent] SetEvent eventToClient" },
+	{ ELogLevel_Error, "[SetServerFinishEvent] Failed to SetEvent eventToClient" },
+	{ ELogLevel_Info, "[SetClientFinishEvent] SetEvent eventFromClient" },
+	{ ELogLevel_Info, "[SetClientFinishEvent] Failed to SetEvent eventFromClient" },
+	{ ELogLevel_Warning, "[CommitServer] torn client feedback is skipped" },
+	{ ELogLevel_Warning, "[CommitClient] torn frame is detected" },
+	{ ELogLevel_Warning, "[ReleaseReadView] torn frame is detected" },
+	{ ELogLevel_Warning, "[HardwareCommit] network connection is closed" },
+	{ ELogLevel_Error, "[HardwareCommit] client pair name doesn't match a server one" },
+	{ ELogLevel_Error, "[HardwareCommit] Frame doesn't fit into a datagram, joints count - %lld" },
+	{ ELogLevel_Error, "[HardwareCommit] Frame doesn't fit into a send buffer, joints count - %lld" },
+	{ ELogLevel_Warning, "[LiveBridgeLog] log ring buffer is full, dropped messages - %lld" }
+};
+
+static CLogRing								g_LogRing;
+static std::atomic<int>						g_LogMode{ ELiveBridgeLogMode_Immediate };
+static std::atomic<unsigned long long>		g_LogDroppedReported{ 0 };
+// drains go one at a time, so messages reach a logger in a queue order
+static std::mutex							g_LogDrainLock;
+
+///////////////////////////////////////////////////////////////////////////
+// CLogRing
+
+CLogRing::CLogRing()
+{
+	for (unsigned int i = 0; i < LOG_RING_SIZE; ++i)
+	{
+		m_Records[i].m_Sequence.store(i, std::memory_order_relaxed);
+	}
+}
+
+bool CLogRing::Push(const ELogMessage message, const long long arg0, const long long arg1, const long long arg2)
+{
+	unsigned long long pos = m_WritePos.load(std::memory_order_relaxed);
+	SRecord* record = nullptr;
+
+	while (true)
+	{
+		record = &m_Records[pos & (LOG_RING_SIZE - 1)];
+		const unsigned long long sequence = record->m_Sequence.load(std::memory_order_acquire);
+		const long long diff = static_cast<long long>(sequence - pos);
+
+		if (diff == 0)
+		{
+			if (m_WritePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				break;
+		}
+		else if (diff < 0)
+		{
+			// a slot is not read yet, a ring is full
+			m_Dropped.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		else
+		{
+			pos = m_WritePos.load(std::memory_order_relaxed);
+		}
+	}
+
+	record->m_Message = message;
+	record->m_Args[0] = arg0;
+	record->m_Args[1] = arg1;
+	record->m_Args[2] = arg2;
+	record->m_Sequence.store(pos + 1, std::memory_order_release);
+	return true;
+}
+
+bool CLogRing::Pop(ELogMessage& message, long long args[LOG_RECORD_ARGS])
+{
+	unsigned long long pos = m_ReadPos.load(std::memory_order_relaxed);
+	SRecord* record = nullptr;
+
+	while (true)
+	{
+		record = &m_Records[pos & (LOG_RING_SIZE - 1)];
+		const unsigned long long sequence = record->m_Sequence.load(std::memory_order_acquire);
+		const long long diff = static_cast<long long>(sequence - (pos + 1));
+
+		if (diff == 0)
+		{
+			if (m_ReadPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				break;
+		}
+		else if (diff < 0)
+		{
+			return false;
+		}
+		else
+		{
+			pos = m_ReadPos.load(std::memory_order_relaxed);
+		}
+	}
+
+	message = record->m_Message;
+	for (unsigned int i = 0; i < LOG_RECORD_ARGS; ++i)
+	{
+		args[i] = record->m_Args[i];
+	}
+	// a slot is free for a writer one lap later
+	record->m_Sequence.store(pos + LOG_RING_SIZE, std::memory_order_release);
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////
+// formatting
+
+static void WriteLogMessage(const ELogMessage message, const long long args[LOG_RECORD_ARGS])
+{
+	CLiveBridgeLogger* logger = g_Logger;
+	if (logger == nullptr || message >= ELogMessage_Count)
+		return;
+
+	const SLogMessageFormat& format = LOG_MESSAGE_FORMATS[message];
+
+	char info[256];
+	snprintf(info, sizeof(info), format.m_Format, args[0], args[1], args[2]);
+
+	switch (format.m_Level)
+	{
+	case ELogLevel_Info: logger->LogInfo(info); break;
+	case ELogLevel_Warning: logger->LogWarning(info); break;
+	default: logger->LogError(info);
+	}
+}
+
+void LogMessage(const ELogMessage message, const long long arg0, const long long arg1, const long long arg2)
+{
+	if (g_LogMode.load(std::memory_order_relaxed) != ELiveBridgeLogMode_Immediate)
+	{
+		g_LogRing.Push(message, arg0, arg1, arg2);
+		return;
+	}
+
+	const long long args[LOG_RECORD_ARGS] = { arg0, arg1, arg2 };
+	WriteLogMessage(message, args);
+}
+
+static int DrainLogRing()
+{
+	std::lock_guard<std::mutex> lock(g_LogDrainLock);
+
+	int count = 0;
+	ELogMessage message;
+	long long args[LOG_RECORD_ARGS];
+
+	while (g_LogRing.Pop(message, args))
+	{
+		WriteLogMessage(message, args);
+		++count;
+	}
+
+	// dropped messages are reported once per drain, after the ones which were kept
+	const unsigned long long dropped = g_LogRing.GetDropped();
+	const unsigned long long reported = g_LogDroppedReported.exchange(dropped);
+
+	if (dropped > reported)
+	{
+		const long long dropped_args[LOG_RECORD_ARGS] = { static_cast<long long>(dropped - reported), 0, 0 };
+		WriteLogMessage(ELogMessage_Dropped, dropped_args);
+	}
+	return count;
+}
+
+///////////////////////////////////////////////////////////////////////////
+// CLogDrainThread
+//  a library thread for ELiveBridgeLogMode_DeferredThread, it runs only while the mode is set and there are live sessions,
+//  a mode change or a free of the last session joins it on a calling thread
+
+const unsigned int LOG_DRAIN_INTERVAL_MS = 10;
+
+class CLogDrainThread
+{
+public:
+
+	void SetEnabled(const bool enabled)
+	{
+		std::lock_guard<std::mutex> lock(m_StartLock);
+		m_Enabled = enabled;
+		Update();
+	}
+
+	void AddSession()
+	{
+		std::lock_guard<std::mutex> lock(m_StartLock);
+		++m_Sessions;
+		Update();
+	}
+
+	void RemoveSession()
+	{
+		std::lock_guard<std::mutex> lock(m_StartLock);
+		if (m_Sessions > 0)
+			--m_Sessions;
+		Update();
+	}
+
+protected:
+
+	void Update()
+	{
+		const bool run = m_Enabled && m_Sessions > 0;
+
+		if (run && !m_Thread.joinable())
+		{
+			m_Running = true;
+			m_Thread = std::thread(&CLogDrainThread::Run, this);
+		}
+		else if (!run && m_Thread.joinable())
+		{
+			{
+				std::lock_guard<std::mutex> wake_lock(m_WakeLock);
+				m_Running = false;
+			}
+			m_WakeCondition.notify_all();
+			m_Thread.join();
+
+			// messages of a last freed session are not left in a ring
+			DrainLogRing();
+		}
+	}
+
+	void Run()
+	{
+		std::unique_lock<std::mutex> lock(m_WakeLock);
+
+		while (m_Running)
+		{
+			m_WakeCondition.wait_for(lock, std::chrono::milliseconds(LOG_DRAIN_INTERVAL_MS), [this]() { return !m_Running; });
+
+			lock.unlock();
+			DrainLogRing();
+			lock.lock();
+		}
+	}
+
+	std::mutex					m_StartLock;
+	std::mutex					m_WakeLock;
+	std::condition_variable		m_WakeCondition;
+	std::thread					m_Thread;
+	bool						m_Running{ false };
+	bool						m_Enabled{ false };
+	unsigned int				m_Sessions{ 0 };
+};
+
+// never destroyed, a static destructor runs under a loader lock on a library unload and must not join a thread,
+//  the thread is already joined by then when a host frees its sessions or switches to an immediate mode
+static CLogDrainThread&						g_LogDrainThread = *new CLogDrainThread();
+
+///////////////////////////////////////////////////////////////////////////
+// log mode
+
+void SetLogMode(const int mode)
+{
+	if (mode == ELiveBridgeLogMode_DeferredThread)
+	{
+		g_LogMode.store(mode);
+		g_LogDrainThread.SetEnabled(true);
+		return;
+	}
+
+	g_LogDrainThread.SetEnabled(false);
+	g_LogMode.store((mode == ELiveBridgeLogMode_Deferred) ? mode : ELiveBridgeLogMode_Immediate);
+
+	if (mode != ELiveBridgeLogMode_Deferred)
+		DrainLogRing();
+}
+
+void AddLogSession()
+{
+	g_LogDrainThread.AddSession();
+}
+
+void RemoveLogSession()
+{
+	g_LogDrainThread.RemoveSession();
+}
+
+int DrainLogMessages()
+{
+	return DrainLogRing();
+}
+
+unsigned long long GetLogDroppedCount()
+{
+	return g_LogRing.GetDropped();
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+/*
+#
+# Copyright(c) 2021 Avalanche Studios.All rights reserved.
+# Licensed under the MIT License.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files(the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions :
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE
+#
+*/
+
+
+#include "AnimLiveBridge.h"
+#include <atomic>
+
+enum ELogLevel
+{
+	ELogLevel_Info,
+	ELogLevel_Warning,
+	ELogLevel_Error
+};
+
+// messages with numbers only, so they could be queued without formatting, see LOG_MESSAGE_FORMATS
+enum ELogMessage
+{
+	ELogMessage_NewSession,
+	ELogMessage_SessionSlotsInUse,
+	ELogMessage_FreeSessionNotFound,
+	ELogMessage_FreeSessionClose,
+	ELogMessage_FreeSessionClosed,
+	ELogMessage_OpenSessionNotFound,
+	ELogMessage_HardwareClose,
+	ELogMessage_ServerFinishEvent,
+	ELogMessage_ServerFinishEventFailed,
+	ELogMessage_ClientFinishEvent,
+	ELogMessage_ClientFinishEventFailed,
+	ELogMessage_TornClientFeedback,
+	ELogMessage_TornFrame,
+	ELogMessage_TornReadView,
+	ELogMessage_NetworkClosed,
+	ELogMessage_NetworkPairMismatch,
+	ELogMessage_DatagramOverflow,
+	ELogMessage_FrameOverflow,
+	ELogMessage_Dropped,
+	ELogMessage_Count
+};
+
+const unsigned int LOG_RING_SIZE = 1024;		// power of two
+const unsigned int LOG_RECORD_ARGS = 3;
+
+////////////////////////////////////////////////////////////
+// CLogRing
+//  bounded multi producer queue of log records (a cell sequence per slot), a commit thread, an io thread
+//  and a replay thread push without locks or allocations, a full ring counts a dropped record
+
+class CLogRing
+{
+public:
+
+	CLogRing();
+
+	//! returns false and counts a dropped record if a ring is full
+	bool Push(const ELogMessage message, const long long arg0, const long long arg1, const long long arg2);
+	//! returns false if a ring is empty
+	bool Pop(ELogMessage& message, long long args[LOG_RECORD_ARGS]);
+
+	unsigned long long GetDropped() const { return m_Dropped.load(std::memory_order_relaxed); }
+
+protected:
+
+	struct SRecord
+	{
+		std::atomic<unsigned long long>	m_Sequence;
+		ELogMessage						m_Message;
+		long long						m_Args[LOG_RECORD_ARGS];
+	};
+
+	SRecord								m_Records[LOG_RING_SIZE];
+
+	alignas(64) std::atomic<unsigned long long>	m_WritePos{ 0 };
+	alignas(64) std::atomic<unsigned long long>	m_ReadPos{ 0 };
+	std::atomic<unsigned long long>				m_Dropped{ 0 };
+};
+
+//! pass a message to g_Logger or queue it in a deferred log mode, a caller checks g_VerboseLevel and g_Logger first
+void LogMessage(const ELogMessage message, const long long arg0 = 0, const long long arg1 = 0, const long long arg2 = 0);
+
+//! ELiveBridgeLogMode, a drain thread is started or stopped, an immediate mode drains a ring
+void SetLogMode(const int mode);
+//! a live session count for a drain thread, a free of a last session stops it and drains a ring
+void AddLogSession();
+void RemoveLogSession();
+//! format queued messages into g_Logger, returns a number of them
+int DrainLogMessages();
+unsigned long long GetLogDroppedCount();
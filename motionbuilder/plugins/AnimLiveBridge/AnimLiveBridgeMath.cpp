@@ -0,0 +1,682 @@
+
+/*
+#
+# Copyright(c) 2021 Avalanche Studios.All rights reserved.
+# Licensed under the MIT License.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files(the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions :
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE
+#
+*/
+
+#include "AnimLiveBridgeMath.h"
+#include <cmath>
+
+#if defined(__AVX2__)
+	#include <immintrin.h>
+	#define LIVEBRIDGE_MATH_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define LIVEBRIDGE_MATH_SSE2
+#endif
+
+const unsigned int MATH_BLOCK_SIZE = 64;		// joints per gathered block
+const unsigned int MATH_BLOCK_ROWS = 24;		// max input and output components of a kernel
+
+const float MATH_PI = 3.14159265358979f;
+const float MATH_HALF_PI = 1.57079632679490f;
+const float MATH_DEG_TO_RAD = MATH_PI / 180.0f;
+const float MATH_RAD_TO_DEG = 180.0f / MATH_PI;
+const float MATH_TINY = 1e-30f;
+
+// a block of components, a row is one component of all joints in a block
+struct alignas(32) SMathBlock
+{
+	float	m_Rows[MATH_BLOCK_ROWS][MATH_BLOCK_SIZE];
+};
+
+////////////////////////////////////////////////////////////////
+// lane operations
+
+struct SScalarOps
+{
+	typedef float V;
+	typedef bool M;
+	static const unsigned int WIDTH = 1;
+
+	static V Load(const float* p) { return *p; }
+	static void Store(float* p, const V v) { *p = v; }
+	static V Set(const float v) { return v; }
+
+	static V Add(const V a, const V b) { return a + b; }
+	static V Sub(const V a, const V b) { return a - b; }
+	static V Mul(const V a, const V b) { return a * b; }
+	static V Div(const V a, const V b) { return a / b; }
+	static V Sqrt(const V a) { return std::sqrt(a); }
+	static V Min(const V a, const V b) { return (a < b) ? a : b; }
+	static V Max(const V a, const V b) { return (a > b) ? a : b; }
+	static V Abs(const V a) { return std::fabs(a); }
+	static V Neg(const V a) { return -a; }
+	static V Round(const V a) { return std::nearbyint(a); }
+
+	static M Less(const V a, const V b) { return a < b; }
+	static M Greater(const V a, const V b) { return a > b; }
+	static M GreaterEqual(const V a, const V b) { return a >= b; }
+	static M And(const M a, const M b) { return a && b; }
+	static M Or(const M a, const M b) { return a || b; }
+	static V Select(const M m, const V a, const V b) { return (m) ? a : b; }
+};
+
+#if defined(LIVEBRIDGE_MATH_AVX2)
+
+struct SSimdOps
+{
+	typedef __m256 V;
+	typedef __m256 M;
+	static const unsigned int WIDTH = 8;
+
+	static V Load(const float* p) { return _mm256_loadu_ps(p); }
+	static void Store(float* p, const V v) { _mm256_storeu_ps(p, v); }
+	static V Set(const float v) { return _mm256_set1_ps(v); }
+
+	static V Add(const V a, const V b) { return _mm256_add_ps(a, b); }
+	static V Sub(const V a, const V b) { return _mm256_sub_ps(a, b); }
+	static V Mul(const V a, const V b) { return _mm256_mul_ps(a, b); }
+	static V Div(const V a, const V b) { return _mm256_div_ps(a, b); }
+	static V Sqrt(const V a) { return _mm256_sqrt_ps(a); }
+	static V Min(const V a, const V b) { return _mm256_min_ps(a, b); }
+	static V Max(const V a, const V b) { return _mm256_max_ps(a, b); }
+	static V Abs(const V a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+	static V Neg(const V a) { return _mm256_xor_ps(_mm256_set1_ps(-0.0f), a); }
+	static V Round(const V a) { return _mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+
+	static M Less(const V a, const V b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+	static M Greater(const V a, const V b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+	static M GreaterEqual(const V a, const V b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+	static M And(const M a, const M b) { return _mm256_and_ps(a, b); }
+	static M Or(const M a, const M b) { return _mm256_or_ps(a, b); }
+	static V Select(const M m, const V a, const V b) { return _mm256_blendv_ps(b, a, m); }
+};
+
+#elif defined(LIVEBRIDGE_MATH_SSE2)
+
+struct SSimdOps
+{
+	typedef __m128 V;
+	typedef __m128 M;
+	static const unsigned int WIDTH = 4;
+
+	static V Load(const float* p) { return _mm_loadu_ps(p); }
+	static void Store(float* p, const V v) { _mm_storeu_ps(p, v); }
+	static V Set(const float v) { return _mm_set1_ps(v); }
+
+	static V Add(const V a, const V b) { return _mm_add_ps(a, b); }
+	static V Sub(const V a, const V b) { return _mm_sub_ps(a, b); }
+	static V Mul(const V a, const V b) { return _mm_mul_ps(a, b); }
+	static V Div(const V a, const V b) { return _mm_div_ps(a, b); }
+	static V Sqrt(const V a) { return _mm_sqrt_ps(a); }
+	static V Min(const V a, const V b) { return _mm_min_ps(a, b); }
+	static V Max(const V a, const V b) { return _mm_max_ps(a, b); }
+	static V Abs(const V a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+	static V Neg(const V a) { return _mm_xor_ps(_mm_set1_ps(-0.0f), a); }
+	// a current rounding mode is to nearest, angles are far below an int range
+	static V Round(const V a) { return _mm_cvtepi32_ps(_mm_cvtps_epi32(a)); }
+
+	static M Less(const V a, const V b) { return _mm_cmplt_ps(a, b); }
+	static M Greater(const V a, const V b) { return _mm_cmpgt_ps(a, b); }
+	static M GreaterEqual(const V a, const V b) { return _mm_cmpge_ps(a, b); }
+	static M And(const M a, const M b) { return _mm_and_ps(a, b); }
+	static M Or(const M a, const M b) { return _mm_or_ps(a, b); }
+	static V Select(const M m, const V a, const V b) { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+};
+
+#endif
+
+////////////////////////////////////////////////////////////////
+// lane functions, float precision polynomials (cephes sinf, cosf, atanf)
+
+template<typename Ops>
+static inline typename Ops::V MulAdd(const typename Ops::V a, const typename Ops::V b, const typename Ops::V c)
+{
+	return Ops::Add(Ops::Mul(a, b), c);
+}
+
+template<typename Ops>
+static inline void SinCos(const typename Ops::V x, typename Ops::V& s, typename Ops::V& c)
+{
+	typedef typename Ops::V V;
+
+	// x = j * pi/2 + r, pi/2 is split into three parts to keep r precise
+	const V j = Ops::Round(Ops::Mul(x, Ops::Set(2.0f / MATH_PI)));
+	V r = Ops::Sub(x, Ops::Mul(j, Ops::Set(1.5703125f)));
+	r = Ops::Sub(r, Ops::Mul(j, Ops::Set(4.837512969970703125e-4f)));
+	r = Ops::Sub(r, Ops::Mul(j, Ops::Set(7.54978995489188216e-8f)));
+
+	const V r2 = Ops::Mul(r, r);
+
+	V sin_r = MulAdd<Ops>(r2, Ops::Set(-1.9515295891e-4f), Ops::Set(8.3321608736e-3f));
+	sin_r = MulAdd<Ops>(r2, sin_r, Ops::Set(-1.6666654611e-1f));
+	sin_r = MulAdd<Ops>(Ops::Mul(r2, r), sin_r, r);
+
+	V cos_r = MulAdd<Ops>(r2, Ops::Set(2.443315711809948e-5f), Ops::Set(-1.388731625493765e-3f));
+	cos_r = MulAdd<Ops>(r2, cos_r, Ops::Set(4.166664568298827e-2f));
+	cos_r = MulAdd<Ops>(Ops::Mul(r2, r2), cos_r, Ops::Sub(Ops::Set(1.0f), Ops::Mul(r2, Ops::Set(0.5f))));
+
+	// quadrant 0..3
+	const V t = Ops::Mul(j, Ops::Set(0.25f));
+	V f = Ops::Round(t);
+	f = Ops::Select(Ops::Greater(f, t), Ops::Sub(f, Ops::Set(1.0f)), f);
+	const V q = Ops::Sub(j, Ops::Mul(f, Ops::Set(4.0f)));
+
+	const typename Ops::M q1 = Ops::And(Ops::Greater(q, Ops::Set(0.5f)), Ops::Less(q, Ops::Set(1.5f)));
+	const typename Ops::M q2 = Ops::And(Ops::Greater(q, Ops::Set(1.5f)), Ops::Less(q, Ops::Set(2.5f)));
+	const typename Ops::M q3 = Ops::Greater(q, Ops::Set(2.5f));
+
+	const typename Ops::M swap = Ops::Or(q1, q3);
+	const V s0 = Ops::Select(swap, cos_r, sin_r);
+	const V c0 = Ops::Select(swap, sin_r, cos_r);
+
+	s = Ops::Select(Ops::Or(q2, q3), Ops::Neg(s0), s0);
+	c = Ops::Select(Ops::Or(q1, q2), Ops::Neg(c0), c0);
+}
+
+// atan of a not negative value
+template<typename Ops>
+static inline typename Ops::V AtanPositive(const typename Ops::V x)
+{
+	typedef typename Ops::V V;
+
+	const typename Ops::M big = Ops::Greater(x, Ops::Set(2.414213562373095f));		// tan(3pi/8)
+	const typename Ops::M mid = Ops::Greater(x, Ops::Set(0.4142135623730950f));		// tan(pi/8)
+
+	const V one = Ops::Set(1.0f);
+	const V x_big = Ops::Neg(Ops::Div(one, Ops::Max(x, Ops::Set(MATH_TINY))));
+	const V x_mid = Ops::Div(Ops::Sub(x, one), Ops::Add(x, one));
+
+	const V xr = Ops::Select(big, x_big, Ops::Select(mid, x_mid, x));
+	const V y0 = Ops::Select(big, Ops::Set(MATH_HALF_PI), Ops::Select(mid, Ops::Set(0.25f * MATH_PI), Ops::Set(0.0f)));
+
+	const V z = Ops::Mul(xr, xr);
+	V p = MulAdd<Ops>(z, Ops::Set(8.05374449538e-2f), Ops::Set(-1.38776856032e-1f));
+	p = MulAdd<Ops>(z, p, Ops::Set(1.99777106478e-1f));
+	p = MulAdd<Ops>(z, p, Ops::Set(-3.33329491539e-1f));
+	p = MulAdd<Ops>(Ops::Mul(z, xr), p, xr);
+
+	return Ops::Add(y0, p);
+}
+
+template<typename Ops>
+static inline typename Ops::V Atan2(const typename Ops::V y, const typename Ops::V x)
+{
+	typedef typename Ops::V V;
+
+	const V ax = Ops::Abs(x);
+	const V ay = Ops::Abs(y);
+	const V ratio = Ops::Div(Ops::Min(ax, ay), Ops::Max(Ops::Max(ax, ay), Ops::Set(MATH_TINY)));
+
+	V a = AtanPositive<Ops>(ratio);
+	a = Ops::Select(Ops::Greater(ay, ax), Ops::Sub(Ops::Set(MATH_HALF_PI), a), a);
+	a = Ops::Select(Ops::Less(x, Ops::Set(0.0f)), Ops::Sub(Ops::Set(MATH_PI), a), a);
+	return Ops::Select(Ops::Less(y, Ops::Set(0.0f)), Ops::Neg(a), a);
+}
+
+template<typename Ops>
+static inline typename Ops::V Asin(const typename Ops::V x)
+{
+	const typename Ops::V one = Ops::Set(1.0f);
+	const typename Ops::V v = Ops::Min(Ops::Max(x, Ops::Neg(one)), one);
+	const typename Ops::V c = Ops::Sqrt(Ops::Max(Ops::Sub(one, Ops::Mul(v, v)), Ops::Set(0.0f)));
+	return Atan2<Ops>(v, c);
+}
+
+////////////////////////////////////////////////////////////////
+// kernels, every kernel processes lanes from begin while a full lane fits and returns a next index
+
+// rows 0-2 euler, rows 3-6 quaternion
+template<typename Ops>
+static unsigned int EulerToQuaternionKernel(SMathBlock& block, unsigned int i, const unsigned int count)
+{
+	typedef typename Ops::V V;
+	float (*rows)[MATH_BLOCK_SIZE] = block.m_Rows;
+
+	const V half = Ops::Set(0.5f * MATH_DEG_TO_RAD);
+
+	for (; i + Ops::WIDTH <= count; i += Ops::WIDTH)
+	{
+		V sx, cx, sy, cy, sz, cz;
+		SinCos<Ops>(Ops::Mul(Ops::Load(rows[0] + i), half), sx, cx);
+		SinCos<Ops>(Ops::Mul(Ops::Load(rows[1] + i), half), sy, cy);
+		SinCos<Ops>(Ops::Mul(Ops::Load(rows[2] + i), half), sz, cz);
+
+		// q = qz * qy * qx
+		const V cycz = Ops::Mul(cy, cz);
+		const V sysz = Ops::Mul(sy, sz);
+		const V sycz = Ops::Mul(sy, cz);
+		const V cysz = Ops::Mul(cy, sz);
+
+		Ops::Store(rows[3] + i, Ops::Sub(Ops::Mul(sx, cycz), Ops::Mul(cx, sysz)));
+		Ops::Store(rows[4] + i, Ops::Add(Ops::Mul(cx, sycz), Ops::Mul(sx, cysz)));
+		Ops::Store(rows[5] + i, Ops::Sub(Ops::Mul(cx, cysz), Ops::Mul(sx, sycz)));
+		Ops::Store(rows[6] + i, Ops::Add(Ops::Mul(cx, cycz), Ops::Mul(sx, sysz)));
+	}
+	return i;
+}
+
+// rows 0-3 quaternion, rows 4-6 euler
+template<typename Ops>
+static unsigned int QuaternionToEulerKernel(SMathBlock& block, unsigned int i, const unsigned int count)
+{
+	typedef typename Ops::V V;
+	float (*rows)[MATH_BLOCK_SIZE] = block.m_Rows;
+
+	const V one = Ops::Set(1.0f);
+	const V two = Ops::Set(2.0f);
+	const V to_deg = Ops::Set(MATH_RAD_TO_DEG);
+
+	for (; i + Ops::WIDTH <= count; i += Ops::WIDTH)
+	{
+		const V x = Ops::Load(rows[0] + i);
+		const V y = Ops::Load(rows[1] + i);
+		const V z = Ops::Load(rows[2] + i);
+		const V w = Ops::Load(rows[3] + i);
+
+		const V r21 = Ops::Mul(two, Ops::Add(Ops::Mul(y, z), Ops::Mul(w, x)));
+		const V r22 = Ops::Sub(one, Ops::Mul(two, Ops::Add(Ops::Mul(x, x), Ops::Mul(y, y))));
+		const V r20 = Ops::Mul(two, Ops::Sub(Ops::Mul(x, z), Ops::Mul(w, y)));
+		const V r10 = Ops::Mul(two, Ops::Add(Ops::Mul(x, y), Ops::Mul(w, z)));
+		const V r00 = Ops::Sub(one, Ops::Mul(two, Ops::Add(Ops::Mul(y, y), Ops::Mul(z, z))));
+
+		Ops::Store(rows[4] + i, Ops::Mul(Atan2<Ops>(r21, r22), to_deg));
+		Ops::Store(rows[5] + i, Ops::Mul(Asin<Ops>(Ops::Neg(r20)), to_deg));
+		Ops::Store(rows[6] + i, Ops::Mul(Atan2<Ops>(r10, r00), to_deg));
+	}
+	return i;
+}
+
+// rows 0-3 a, rows 4-7 b, rows 8-11 a * b
+template<typename Ops>
+static unsigned int MultiplyQuaternionKernel(SMathBlock& block, unsigned int i, const unsigned int count)
+{
+	typedef typename Ops::V V;
+	float (*rows)[MATH_BLOCK_SIZE] = block.m_Rows;
+
+	for (; i + Ops::WIDTH <= count; i += Ops::WIDTH)
+	{
+		const V ax = Ops::Load(rows[0] + i), ay = Ops::Load(rows[1] + i), az = Ops::Load(rows[2] + i), aw = Ops::Load(rows[3] + i);
+		const V bx = Ops::Load(rows[4] + i), by = Ops::Load(rows[5] + i), bz = Ops::Load(rows[6] + i), bw = Ops::Load(rows[7] + i);
+
+		V x = Ops::Add(Ops::Mul(aw, bx), Ops::Mul(ax, bw));
+		x = Ops::Add(x, Ops::Sub(Ops::Mul(ay, bz), Ops::Mul(az, by)));
+
+		V y = Ops::Add(Ops::Mul(aw, by), Ops::Mul(ay, bw));
+		y = Ops::Add(y, Ops::Sub(Ops::Mul(az, bx), Ops::Mul(ax, bz)));
+
+		V z = Ops::Add(Ops::Mul(aw, bz), Ops::Mul(az, bw));
+		z = Ops::Add(z, Ops::Sub(Ops::Mul(ax, by), Ops::Mul(ay, bx)));
+
+		V w = Ops::Sub(Ops::Mul(aw, bw), Ops::Mul(ax, bx));
+		w = Ops::Sub(w, Ops::Add(Ops::Mul(ay, by), Ops::Mul(az, bz)));
+
+		Ops::Store(rows[8] + i, x);
+		Ops::Store(rows[9] + i, y);
+		Ops::Store(rows[10] + i, z);
+		Ops::Store(rows[11] + i, w);
+	}
+	return i;
+}
+
+// rows 0-8 X, Y, Z axis, rows 9-11 translation, rows 12-14 translation, rows 15-18 quaternion, rows 19-21 scale
+template<typename Ops>
+static unsigned int MatrixToTransformKernel(SMathBlock& block, unsigned int i, const unsigned int count)
+{
+	typedef typename Ops::V V;
+	float (*rows)[MATH_BLOCK_SIZE] = block.m_Rows;
+
+	const V one = Ops::Set(1.0f);
+	const V tiny = Ops::Set(MATH_TINY);
+
+	for (; i + Ops::WIDTH <= count; i += Ops::WIDTH)
+	{
+		V axis[9];
+		for (int k = 0; k < 9; ++k)
+			axis[k] = Ops::Load(rows[k] + i);
+
+		V scale[3];
+		for (int k = 0; k < 3; ++k)
+		{
+			const V* a = axis + k * 3;
+			scale[k] = Ops::Sqrt(Ops::Add(Ops::Mul(a[0], a[0]), Ops::Add(Ops::Mul(a[1], a[1]), Ops::Mul(a[2], a[2]))));
+
+			const V inv = Ops::Div(one, Ops::Max(scale[k], tiny));
+			axis[k * 3] = Ops::Mul(a[0], inv);
+			axis[k * 3 + 1] = Ops::Mul(a[1], inv);
+			axis[k * 3 + 2] = Ops::Mul(a[2], inv);
+		}
+
+		// rotation matrix element r[row][column], a column is an axis
+		const V r00 = axis[0], r10 = axis[1], r20 = axis[2];
+		const V r01 = axis[3], r11 = axis[4], r21 = axis[5];
+		const V r02 = axis[6], r12 = axis[7], r22 = axis[8];
+
+		// a largest component is taken from a diagonal, all four candidates are computed and selected
+		const V t0 = Ops::Add(one, Ops::Add(r00, Ops::Add(r11, r22)));
+		const V t1 = Ops::Add(one, Ops::Sub(r00, Ops::Add(r11, r22)));
+		const V t2 = Ops::Add(one, Ops::Sub(r11, Ops::Add(r00, r22)));
+		const V t3 = Ops::Add(one, Ops::Sub(r22, Ops::Add(r00, r11)));
+		const V t_max = Ops::Max(Ops::Max(t0, t1), Ops::Max(t2, t3));
+
+		const V d_x = Ops::Sub(r21, r12);
+		const V d_y = Ops::Sub(r02, r20);
+		const V d_z = Ops::Sub(r10, r01);
+		const V s_xy = Ops::Add(r01, r10);
+		const V s_xz = Ops::Add(r02, r20);
+		const V s_yz = Ops::Add(r12, r21);
+
+		const typename Ops::M is0 = Ops::GreaterEqual(t0, t_max);
+		const typename Ops::M is1 = Ops::GreaterEqual(t1, t_max);
+		const typename Ops::M is2 = Ops::GreaterEqual(t2, t_max);
+
+		V x = Ops::Select(is0, d_x, Ops::Select(is1, t1, Ops::Select(is2, s_xy, s_xz)));
+		V y = Ops::Select(is0, d_y, Ops::Select(is1, s_xy, Ops::Select(is2, t2, s_yz)));
+		V z = Ops::Select(is0, d_z, Ops::Select(is1, s_xz, Ops::Select(is2, s_yz, t3)));
+		V w = Ops::Select(is0, t0, Ops::Select(is1, d_x, Ops::Select(is2, d_y, d_z)));
+
+		const V s = Ops::Div(Ops::Set(0.5f), Ops::Sqrt(Ops::Max(t_max, tiny)));
+
+		for (int k = 0; k < 3; ++k)
+		{
+			Ops::Store(rows[12 + k] + i, Ops::Load(rows[9 + k] + i));
+			Ops::Store(rows[19 + k] + i, scale[k]);
+		}
+		Ops::Store(rows[15] + i, Ops::Mul(x, s));
+		Ops::Store(rows[16] + i, Ops::Mul(y, s));
+		Ops::Store(rows[17] + i, Ops::Mul(z, s));
+		Ops::Store(rows[18] + i, Ops::Mul(w, s));
+	}
+	return i;
+}
+
+// rows 0-2 translation, rows 3-6 quaternion, rows 7-9 scale, rows 10-18 X, Y, Z axis, rows 19-21 translation
+template<typename Ops>
+static unsigned int TransformToMatrixKernel(SMathBlock& block, unsigned int i, const unsigned int count)
+{
+	typedef typename Ops::V V;
+	float (*rows)[MATH_BLOCK_SIZE] = block.m_Rows;
+
+	const V one = Ops::Set(1.0f);
+	const V two = Ops::Set(2.0f);
+
+	for (; i + Ops::WIDTH <= count; i += Ops::WIDTH)
+	{
+		const V x = Ops::Load(rows[3] + i), y = Ops::Load(rows[4] + i), z = Ops::Load(rows[5] + i), w = Ops::Load(rows[6] + i);
+		const V sx = Ops::Load(rows[7] + i), sy = Ops::Load(rows[8] + i), sz = Ops::Load(rows[9] + i);
+
+		const V xx = Ops::Mul(x, x), yy = Ops::Mul(y, y), zz = Ops::Mul(z, z);
+		const V xy = Ops::Mul(x, y), xz = Ops::Mul(x, z), yz = Ops::Mul(y, z);
+		const V wx = Ops::Mul(w, x), wy = Ops::Mul(w, y), wz = Ops::Mul(w, z);
+
+		// X axis
+		Ops::Store(rows[10] + i, Ops::Mul(sx, Ops::Sub(one, Ops::Mul(two, Ops::Add(yy, zz)))));
+		Ops::Store(rows[11] + i, Ops::Mul(sx, Ops::Mul(two, Ops::Add(xy, wz))));
+		Ops::Store(rows[12] + i, Ops::Mul(sx, Ops::Mul(two, Ops::Sub(xz, wy))));
+		// Y axis
+		Ops::Store(rows[13] + i, Ops::Mul(sy, Ops::Mul(two, Ops::Sub(xy, wz))));
+		Ops::Store(rows[14] + i, Ops::Mul(sy, Ops::Sub(one, Ops::Mul(two, Ops::Add(xx, zz)))));
+		Ops::Store(rows[15] + i, Ops::Mul(sy, Ops::Mul(two, Ops::Add(yz, wx))));
+		// Z axis
+		Ops::Store(rows[16] + i, Ops::Mul(sz, Ops::Mul(two, Ops::Add(xz, wy))));
+		Ops::Store(rows[17] + i, Ops::Mul(sz, Ops::Mul(two, Ops::Sub(yz, wx))));
+		Ops::Store(rows[18] + i, Ops::Mul(sz, Ops::Sub(one, Ops::Mul(two, Ops::Add(xx, yy)))));
+
+		for (int k = 0; k < 3; ++k)
+			Ops::Store(rows[19 + k] + i, Ops::Load(rows[k] + i));
+	}
+	return i;
+}
+
+////////////////////////////////////////////////////////////////
+// a block is processed by simd lanes and a tail by a scalar kernel
+
+template<template<typename> class Kernel>
+static void RunKernel(SMathBlock& block, const unsigned int count)
+{
+	unsigned int i = 0;
+#if defined(LIVEBRIDGE_MATH_AVX2) || defined(LIVEBRIDGE_MATH_SSE2)
+	i = Kernel<SSimdOps>::Run(block, i, count);
+#endif
+	Kernel<SScalarOps>::Run(block, i, count);
+}
+
+template<typename Ops> struct SEulerToQuaternion { static unsigned int Run(SMathBlock& b, unsigned int i, unsigned int n) { return EulerToQuaternionKernel<Ops>(b, i, n); } };
+template<typename Ops> struct SQuaternionToEuler { static unsigned int Run(SMathBlock& b, unsigned int i, unsigned int n) { return QuaternionToEulerKernel<Ops>(b, i, n); } };
+template<typename Ops> struct SMultiplyQuaternion { static unsigned int Run(SMathBlock& b, unsigned int i, unsigned int n) { return MultiplyQuaternionKernel<Ops>(b, i, n); } };
+template<typename Ops> struct SMatrixToTransform { static unsigned int Run(SMathBlock& b, unsigned int i, unsigned int n) { return MatrixToTransformKernel<Ops>(b, i, n); } };
+template<typename Ops> struct STransformToMatrix { static unsigned int Run(SMathBlock& b, unsigned int i, unsigned int n) { return TransformToMatrixKernel<Ops>(b, i, n); } };
+
+// gather and scatter of float components, a vector is a plain array of floats
+static inline void GatherRows(SMathBlock& block, const unsigned int row, const float* src, const size_t stride, const unsigned int components, const unsigned int count)
+{
+	for (unsigned int i = 0; i < count; ++i, src += stride)
+	{
+		for (unsigned int k = 0; k < components; ++k)
+			block.m_Rows[row + k][i] = src[k];
+	}
+}
+
+static inline void ScatterRows(const SMathBlock& block, const unsigned int row, float* dst, const size_t stride, const unsigned int components, const unsigned int count)
+{
+	for (unsigned int i = 0; i < count; ++i, dst += stride)
+	{
+		for (unsigned int k = 0; k < components; ++k)
+			dst[k] = block.m_Rows[row + k][i];
+	}
+}
+
+template<typename T>
+static inline const float* FloatsOf(const T* v) { return reinterpret_cast<const float*>(v); }
+template<typename T>
+static inline float* FloatsOf(T* v) { return reinterpret_cast<float*>(v); }
+
+const size_t VECTOR3_STRIDE = sizeof(SVector3) / sizeof(float);
+const size_t VECTOR4_STRIDE = sizeof(SVector4) / sizeof(float);
+const size_t TRANSFORM_STRIDE = sizeof(STransform) / sizeof(float);
+
+////////////////////////////////////////////////////////////////
+//
+
+const char* GetMathKernelType()
+{
+#if defined(LIVEBRIDGE_MATH_AVX2)
+	return "avx2";
+#elif defined(LIVEBRIDGE_MATH_SSE2)
+	return "sse2";
+#else
+	return "scalar";
+#endif
+}
+
+void EulerToQuaternionData(const SVector3* euler, SVector4* quaternions, const unsigned int count)
+{
+	SMathBlock block;
+
+	for (unsigned int first = 0; first < count; first += MATH_BLOCK_SIZE)
+	{
+		const unsigned int n = (count - first < MATH_BLOCK_SIZE) ? count - first : MATH_BLOCK_SIZE;
+
+		GatherRows(block, 0, FloatsOf(euler + first), VECTOR3_STRIDE, 3, n);
+		RunKernel<SEulerToQuaternion>(block, n);
+		ScatterRows(block, 3, FloatsOf(quaternions + first), VECTOR4_STRIDE, 4, n);
+	}
+}
+
+void QuaternionToEulerData(const SVector4* quaternions, SVector3* euler, const unsigned int count)
+{
+	SMathBlock block;
+
+	for (unsigned int first = 0; first < count; first += MATH_BLOCK_SIZE)
+	{
+		const unsigned int n = (count - first < MATH_BLOCK_SIZE) ? count - first : MATH_BLOCK_SIZE;
+
+		GatherRows(block, 0, FloatsOf(quaternions + first), VECTOR4_STRIDE, 4, n);
+		RunKernel<SQuaternionToEuler>(block, n);
+		ScatterRows(block, 4, FloatsOf(euler + first), VECTOR3_STRIDE, 3, n);
+	}
+}
+
+void MultiplyQuaternionData(const SVector4* a, const SVector4* b, SVector4* result, const unsigned int count)
+{
+	SMathBlock block;
+
+	for (unsigned int first = 0; first < count; first += MATH_BLOCK_SIZE)
+	{
+		const unsigned int n = (count - first < MATH_BLOCK_SIZE) ? count - first : MATH_BLOCK_SIZE;
+
+		GatherRows(block, 0, FloatsOf(a + first), VECTOR4_STRIDE, 4, n);
+		GatherRows(block, 4, FloatsOf(b + first), VECTOR4_STRIDE, 4, n);
+		RunKernel<SMultiplyQuaternion>(block, n);
+		ScatterRows(block, 8, FloatsOf(result + first), VECTOR4_STRIDE, 4, n);
+	}
+}
+
+void MatrixToTransformData(const double* matrices, STransform* transforms, const unsigned int count)
+{
+	SMathBlock block;
+
+	for (unsigned int first = 0; first < count; first += MATH_BLOCK_SIZE)
+	{
+		const unsigned int n = (count - first < MATH_BLOCK_SIZE) ? count - first : MATH_BLOCK_SIZE;
+
+		// X, Y, Z axis and translation, a last column is skipped
+		const double* m = matrices + static_cast<size_t>(first) * 16;
+		for (unsigned int i = 0; i < n; ++i, m += 16)
+		{
+			for (unsigned int k = 0; k < 12; ++k)
+				block.m_Rows[k][i] = static_cast<float>(m[(k / 3) * 4 + k % 3]);
+		}
+
+		RunKernel<SMatrixToTransform>(block, n);
+		ScatterRows(block, 12, FloatsOf(transforms + first), TRANSFORM_STRIDE, 10, n);
+	}
+}
+
+void TransformToMatrixData(const STransform* transforms, double* matrices, const unsigned int count)
+{
+	SMathBlock block;
+
+	for (unsigned int first = 0; first < count; first += MATH_BLOCK_SIZE)
+	{
+		const unsigned int n = (count - first < MATH_BLOCK_SIZE) ? count - first : MATH_BLOCK_SIZE;
+
+		GatherRows(block, 0, FloatsOf(transforms + first), TRANSFORM_STRIDE, 10, n);
+		RunKernel<STransformToMatrix>(block, n);
+
+		double* m = matrices + static_cast<size_t>(first) * 16;
+		for (unsigned int i = 0; i < n; ++i, m += 16)
+		{
+			for (unsigned int k = 0; k < 12; ++k)
+				m[(k / 3) * 4 + k % 3] = static_cast<double>(block.m_Rows[10 + k][i]);
+
+			m[3] = m[7] = m[11] = 0.0;
+			m[15] = 1.0;
+		}
+	}
+}
+
+void ConvertJointRotationData(SJointData* joints, const unsigned int count, const unsigned int rotation_hint)
+{
+	const bool to_quaternion = (rotation_hint & HINT_ROTATION_QUATERNION) != 0;
+	const unsigned int from_flag = (to_quaternion) ? HINT_ROTATION_EULERANGLES : HINT_ROTATION_QUATERNION;
+	const unsigned int to_flag = (to_quaternion) ? HINT_ROTATION_QUATERNION : HINT_ROTATION_EULERANGLES;
+
+	SMathBlock block;
+	unsigned int indices[MATH_BLOCK_SIZE];
+	unsigned int i = 0;
+
+	while (i < count)
+	{
+		// joints of another rotation type are gathered, the rest are kept
+		unsigned int n = 0;
+		for (; i < count && n < MATH_BLOCK_SIZE; ++i)
+		{
+			if (joints[i].m_Flags & from_flag)
+				indices[n++] = i;
+		}
+		if (n == 0)
+			break;
+
+		for (unsigned int k = 0; k < n; ++k)
+		{
+			const float* rotation = &joints[indices[k]].m_Transform.m_Rotation.m_X;
+			for (unsigned int c = 0; c < 4; ++c)
+				block.m_Rows[c][k] = rotation[c];
+		}
+
+		if (to_quaternion)
+			RunKernel<SEulerToQuaternion>(block, n);
+		else
+			RunKernel<SQuaternionToEuler>(block, n);
+
+		const unsigned int row = (to_quaternion) ? 3 : 4;
+		const unsigned int components = (to_quaternion) ? 4 : 3;
+
+		for (unsigned int k = 0; k < n; ++k)
+		{
+			SJointData& joint = joints[indices[k]];
+			float* rotation = &joint.m_Transform.m_Rotation.m_X;
+
+			for (unsigned int c = 0; c < components; ++c)
+				rotation[c] = block.m_Rows[row + c][k];
+			if (!to_quaternion)
+				rotation[3] = 0.0f;
+
+			joint.m_Flags = (joint.m_Flags & ~from_flag) | to_flag;
+		}
+	}
+}
+
+void DoubleToFloatData(const double* src, float* dst, const unsigned int count)
+{
+	unsigned int i = 0;
+#if defined(LIVEBRIDGE_MATH_AVX2)
+	for (; i + 4 <= count; i += 4)
+		_mm_storeu_ps(dst + i, _mm256_cvtpd_ps(_mm256_loadu_pd(src + i)));
+#elif defined(LIVEBRIDGE_MATH_SSE2)
+	for (; i + 4 <= count; i += 4)
+		_mm_storeu_ps(dst + i, _mm_movelh_ps(_mm_cvtpd_ps(_mm_loadu_pd(src + i)), _mm_cvtpd_ps(_mm_loadu_pd(src + i + 2))));
+#endif
+	for (; i < count; ++i)
+		dst[i] = static_cast<float>(src[i]);
+}
+
+void FloatToDoubleData(const float* src, double* dst, const unsigned int count)
+{
+	unsigned int i = 0;
+#if defined(LIVEBRIDGE_MATH_AVX2)
+	for (; i + 4 <= count; i += 4)
+		_mm256_storeu_pd(dst + i, _mm256_cvtps_pd(_mm_loadu_ps(src + i)));
+#elif defined(LIVEBRIDGE_MATH_SSE2)
+	for (; i + 4 <= count; i += 4)
+	{
+		const __m128 v = _mm_loadu_ps(src + i);
+		_mm_storeu_pd(dst + i, _mm_cvtps_pd(v));
+		_mm_storeu_pd(dst + i + 2, _mm_cvtps_pd(_mm_movehl_ps(v, v)));
+	}
+#endif
+	for (; i < count; ++i)
+		dst[i] = static_cast<double>(src[i]);
+}
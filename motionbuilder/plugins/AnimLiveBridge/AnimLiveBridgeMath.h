@@ -0,0 +1,54 @@
+#pragma once
+
+/*
+#
+# Copyright(c) 2021 Avalanche Studios.All rights reserved.
+# Licensed under the MIT License.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files(the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions :
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE
+#
+*/
+
+#include "AnimLiveBridge.h"
+
+///////////////////////////////////////////////////////////////////////////
+// transform math kernels
+//  joints are gathered into blocks of structure of arrays and processed by simd lanes (avx2 or sse2),
+//  a scalar kernel with the same code handles a tail and platforms without simd
+//  euler angles are in degrees, XYZ order - rotation around X, followed by Y and then Z
+//  a matrix is 16 doubles, X, Y, Z axis and translation rows, the same layout as FBMatrix and MMatrix
+
+//! a compiled kernel type - "avx2", "sse2" or "scalar"
+const char* GetMathKernelType();
+
+void EulerToQuaternionData(const SVector3* euler, SVector4* quaternions, const unsigned int count);
+void QuaternionToEulerData(const SVector4* quaternions, SVector3* euler, const unsigned int count);
+
+//! a Hamilton product, result = a * b applies b first and then a, result could be one of inputs
+void MultiplyQuaternionData(const SVector4* a, const SVector4* b, SVector4* result, const unsigned int count);
+
+//! a rotation is taken from normalized axes, a mirrored matrix is not supported
+void MatrixToTransformData(const double* matrices, STransform* transforms, const unsigned int count);
+void TransformToMatrixData(const STransform* transforms, double* matrices, const unsigned int count);
+
+//! convert joint rotations to a given hint, HINT_ROTATION_QUATERNION or HINT_ROTATION_EULERANGLES, flags are updated
+void ConvertJointRotationData(SJointData* joints, const unsigned int count, const unsigned int rotation_hint);
+
+void DoubleToFloatData(const double* src, float* dst, const unsigned int count);
+void FloatToDoubleData(const float* src, double* dst, const unsigned int count);
@@ -0,0 +1,420 @@
+
+/*
+#
+# Copyright(c) 2021 Avalanche Studios.All rights reserved.
+# Licensed under the MIT License.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files(the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions :
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE
+#
+*/
+
+#include "AnimLiveBridgeMulticast.h"
+#include "AnimLiveBridgeLog.h"
+#include <string>
+#include <cstring>
+#include <random>
+
+#ifdef _WIN32
+	#include <winsock2.h>
+	#include <ws2tcpip.h>
+#else
+	#include <sys/types.h>
+	#include <sys/socket.h>
+	#include <netinet/in.h>
+	#include <arpa/inet.h>
+	#include <sys/select.h>
+#endif
+
+static bool IsMulticastAddress(const sockaddr_in& addr)
+{
+	return (ntohl(addr.sin_addr.s_addr) & 0xF0000000) == 0xE0000000;
+}
+
+static void SetSocketOption(LiveBridgeSocket s, const int level, const int name, const int value)
+{
+	setsockopt(static_cast<int>(s), level, name, reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+//////////////////////////////////////////////////////////////////////////////////
+// CAnimLiveBridgeMulticast
+
+CAnimLiveBridgeMulticast::CAnimLiveBridgeMulticast(CAnimLiveBridgeSession* session)
+	: CAnimLiveBridgeHardware(session)
+	, m_Socket(INVALID_LIVEBRIDGE_SOCKET)
+{
+	m_Buffer.resize(MAX_MULTICAST_DATAGRAM);
+	m_TargetAddress.resize(sizeof(sockaddr_in));
+}
+
+CAnimLiveBridgeMulticast::~CAnimLiveBridgeMulticast()
+{
+	Close();
+}
+
+bool CAnimLiveBridgeMulticast::IsOpen() const
+{
+	return m_IsOpen;
+}
+
+int CAnimLiveBridgeMulticast::Open(const char* pair_name, const bool is_server)
+{
+	if (IsOpen())
+		return 1;
+
+	if (!NetworkStartup())
+		return -1;
+
+	strncpy(m_PairName, pair_name, NAME_SIZE - 1);
+	m_PairName[NAME_SIZE - 1] = 0;
+	m_PairHash = HashPairName(m_PairName);
+
+	CAnimLiveBridgeSession* session = GetSessionPtr();
+	m_Address = session->GetPropertyString(ELiveSessionProperty_NetworkAddress);
+	m_Port = session->GetPropertyInt(ELiveSessionProperty_NetworkPort);
+
+	if (m_Port <= 0)
+		m_Port = DEFAULT_NETWORK_PORT;
+	if (m_Address.empty())
+		m_Address = DEFAULT_MULTICAST_GROUP;
+
+	if (g_VerboseLevel && g_Logger)
+	{
+		std::string info("[HardwareOpen] Open network udp ");
+		info += (is_server) ? "server to " : "client on ";
+		info += m_Address;
+		info += ":";
+		info += std::to_string(m_Port);
+
+		g_Logger->LogInfo(info.c_str());
+	}
+
+	m_IsServer = is_server;
+	m_Sequence = 0;
+	m_Epoch = (is_server) ? static_cast<unsigned int>(std::random_device()() ^ CLiveSessionStats::Now()) : 0;
+	m_HasLastSequence = false;
+	m_HasNewFrame = false;
+	m_DroppedFrames = 0;
+	m_UsePoseCodec = GetPoseCodecSettings(session, m_PoseCodec);
+	m_UseJointSchema = session->GetPropertyInt(ELiveSessionProperty_JointSchema) != 0;
+	m_FramesSinceSchema = 0;
+	m_Schema.Clear();
+
+	const int err = (is_server) ? OpenServer() : OpenClient();
+	if (err != 0)
+	{
+		if (g_VerboseLevel && g_Logger)
+		{
+			std::string info("[HardwareOpen] Failed to open a udp socket, error - ");
+			info += std::to_string(err);
+
+			g_Logger->LogError(info.c_str());
+		}
+		Close();
+		return err;
+	}
+
+	m_IsOpen = true;
+	return 0;
+}
+
+int CAnimLiveBridgeMulticast::OpenServer()
+{
+	sockaddr_in* target = reinterpret_cast<sockaddr_in*>(m_TargetAddress.data());
+	if (!ResolveAddress(m_Address.c_str(), m_Port, target))
+		return -1;
+
+	m_Socket = static_cast<LiveBridgeSocket>(socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP));
+	if (m_Socket == INVALID_LIVEBRIDGE_SOCKET)
+		return GetLastSocketError();
+
+	if (IsMulticastAddress(*target))
+	{
+		// stay in a local network and let viewers on the same machine get the frames too
+		SetSocketOption(m_Socket, IPPROTO_IP, IP_MULTICAST_TTL, 1);
+		SetSocketOption(m_Socket, IPPROTO_IP, IP_MULTICAST_LOOP, 1);
+	}
+	else
+	{
+		SetSocketOption(m_Socket, SOL_SOCKET, SO_BROADCAST, 1);
+	}
+
+	if (!SetSocketNonBlocking(m_Socket))
+		return GetLastSocketError();
+
+	return 0;
+}
+
+int CAnimLiveBridgeMulticast::OpenClient()
+{
+	sockaddr_in group;
+	if (!ResolveAddress(m_Address.c_str(), m_Port, &group))
+		return -1;
+
+	m_Socket = static_cast<LiveBridgeSocket>(socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP));
+	if (m_Socket == INVALID_LIVEBRIDGE_SOCKET)
+		return GetLastSocketError();
+
+	// several viewers could listen on the same machine
+	SetSocketOption(m_Socket, SOL_SOCKET, SO_REUSEADDR, 1);
+#ifdef SO_REUSEPORT
+	if (IsMulticastAddress(group))
+	{
+		SetSocketOption(m_Socket, SOL_SOCKET, SO_REUSEPORT, 1);
+	}
+#endif
+	SetSocketOption(m_Socket, SOL_SOCKET, SO_RCVBUF, static_cast<int>(64 * MAX_MULTICAST_DATAGRAM));
+
+	sockaddr_in local;
+	ResolveAddress(nullptr, m_Port, &local);
+
+	if (bind(m_Socket, reinterpret_cast<sockaddr*>(&local), sizeof(local)) != 0)
+		return GetLastSocketError();
+
+	if (IsMulticastAddress(group))
+	{
+		ip_mreq membership;
+		memset(&membership, 0, sizeof(membership));
+		membership.imr_multiaddr = group.sin_addr;
+		membership.imr_interface.s_addr = htonl(INADDR_ANY);
+
+		if (setsockopt(static_cast<int>(m_Socket), IPPROTO_IP, IP_ADD_MEMBERSHIP, reinterpret_cast<const char*>(&membership), sizeof(membership)) != 0)
+			return GetLastSocketError();
+	}
+
+	if (!SetSocketNonBlocking(m_Socket))
+		return GetLastSocketError();
+
+	return 0;
+}
+
+int CAnimLiveBridgeMulticast::Close()
+{
+	CloseSocket(m_Socket);
+
+	m_IsOpen = false;
+	m_SendSize = 0;
+	return 0;
+}
+
+int CAnimLiveBridgeMulticast::Commit(const bool auto_finish_event)
+{
+	if (!IsOpen())
+		return -3;
+
+	return (m_IsServer) ? CommitServer(auto_finish_event) : CommitClient();
+}
+
+int CAnimLiveBridgeMulticast::CommitServer(const bool auto_finish_event)
+{
+	CAnimLiveBridgeSession* session = GetSessionPtr();
+	SSharedModelData* local_data = session->GetDataPtr();
+
+	session->GetTimelinePtr()->WriteToData(true, *local_data);
+
+	if (session->m_SyncSaved)
+	{
+		local_data->m_LookAtRoot[3] = 2.0f;
+		session->m_SyncSaved = false;
+	}
+
+	const CJointSchema* schema = nullptr;
+	bool write_schema = false;
+
+	if (m_UseJointSchema && !m_UsePoseCodec)
+	{
+		const bool changed = m_Schema.Update(GetModelJoints(local_data), local_data->m_Header.m_ModelsCount);
+
+		write_schema = changed || m_FramesSinceSchema == 0;
+		m_FramesSinceSchema = (write_schema) ? 1 : (m_FramesSinceSchema + 1) % MULTICAST_SCHEMA_INTERVAL;
+		schema = &m_Schema;
+	}
+
+	unsigned short flags = 0;
+	const size_t size = PackModelData(*local_data, (m_UsePoseCodec) ? &m_PoseCodec : nullptr,
+		m_Buffer.data() + sizeof(SMulticastFrameHeader), m_Buffer.size() - sizeof(SMulticastFrameHeader), flags, schema, write_schema);
+	local_data->m_LookAtRoot[3] = 0.0f;
+
+	if (size == 0)
+	{
+		if (g_VerboseLevel && g_Logger)
+		{
+			LogMessage(ELogMessage_DatagramOverflow, local_data->m_Header.m_ModelsCount);
+		}
+		return -5;
+	}
+
+	SMulticastFrameHeader header;
+	header.m_Frame.m_Magic = NETWORK_FRAME_MAGIC;
+	header.m_Frame.m_Size = static_cast<unsigned int>(size);
+	header.m_Frame.m_Type = ENetworkFrame_ServerData;
+	header.m_Frame.m_Flags = flags;
+	header.m_Frame.m_Sequence = ++m_Sequence;
+	header.m_PairHash = m_PairHash;
+	header.m_Epoch = m_Epoch;
+
+	memcpy(m_Buffer.data(), &header, sizeof(SMulticastFrameHeader));
+	m_SendSize = sizeof(SMulticastFrameHeader) + size;
+
+	if (auto_finish_event)
+	{
+		SendDatagram();
+	}
+	return 0;
+}
+
+void CAnimLiveBridgeMulticast::SendDatagram()
+{
+	if (m_SendSize == 0)
+		return;
+
+	// a frame that can't go out right now is dropped, a next one is going to replace it anyway
+	const int sent = static_cast<int>(sendto(m_Socket, m_Buffer.data(), static_cast<int>(m_SendSize), 0,
+		reinterpret_cast<const sockaddr*>(m_TargetAddress.data()), sizeof(sockaddr_in)));
+
+	if (sent > 0)
+	{
+		GetStats().OnFrameSent();
+		GetStats().OnBytesSent(static_cast<size_t>(sent));
+	}
+
+	m_SendSize = 0;
+}
+
+void CAnimLiveBridgeMulticast::Receive()
+{
+	CAnimLiveBridgeSession* session = GetSessionPtr();
+	const unsigned int client_tag = session->GetDataPtr()->m_Header.m_ClientTag;
+
+	while (true)
+	{
+		const int received = static_cast<int>(recv(m_Socket, m_Buffer.data(), static_cast<int>(m_Buffer.size()), 0));
+		if (received < static_cast<int>(sizeof(SMulticastFrameHeader)))
+			break;
+
+		GetStats().OnBytesReceived(static_cast<size_t>(received));
+
+		SMulticastFrameHeader header;
+		memcpy(&header, m_Buffer.data(), sizeof(SMulticastFrameHeader));
+
+		if (header.m_Frame.m_Magic != NETWORK_FRAME_MAGIC
+			|| header.m_Frame.m_Type != ENetworkFrame_ServerData
+			|| header.m_PairHash != m_PairHash
+			|| header.m_Frame.m_Size != static_cast<unsigned int>(received) - sizeof(SMulticastFrameHeader))
+		{
+			continue;
+		}
+
+		// a restarted server counts from 1 again, its frames are not late
+		if (m_HasLastSequence && header.m_Epoch != m_Epoch)
+		{
+			m_HasLastSequence = false;
+		}
+
+		// late or duplicated frame, wrap around safe comparison
+		if (m_HasLastSequence && static_cast<int>(header.m_Frame.m_Sequence - m_Sequence) <= 0)
+		{
+			// it's already counted in session stats as a sequence gap
+			++m_DroppedFrames;
+			continue;
+		}
+
+		if (!UnpackModelData(m_Buffer.data() + sizeof(SMulticastFrameHeader), header.m_Frame.m_Size, header.m_Frame.m_Flags, session, &m_Schema))
+			continue;
+
+		// unpacking could grow a local frame
+		session->GetDataPtr()->m_Header.m_ClientTag = client_tag;
+
+		// frames lost on a way, or an unread frame which is replaced by this one
+		if (m_HasLastSequence && header.m_Frame.m_Sequence - m_Sequence > 1)
+		{
+			GetStats().OnFramesDropped(header.m_Frame.m_Sequence - m_Sequence - 1);
+		}
+		if (m_HasNewFrame)
+		{
+			GetStats().OnFramesDropped(1);
+		}
+
+		m_Sequence = header.m_Frame.m_Sequence;
+		m_Epoch = header.m_Epoch;
+		m_HasLastSequence = true;
+		m_HasNewFrame = true;
+		GetStats().OnFrameReceived();
+	}
+}
+
+int CAnimLiveBridgeMulticast::CommitClient()
+{
+	Receive();
+
+	if (!m_HasNewFrame)
+		return -1;
+
+	m_HasNewFrame = false;
+
+	CAnimLiveBridgeSession* session = GetSessionPtr();
+	SSharedModelData* local_data = session->GetDataPtr();
+
+	session->GetTimelinePtr()->ReadFromData(true, *local_data);
+
+	// check if we have sync event from master
+	if (local_data->m_LookAtRoot[3] == 2.0f)
+	{
+		session->m_HasNewSync = true;
+	}
+	return 0;
+}
+
+bool CAnimLiveBridgeMulticast::PollFrame()
+{
+	if (!IsOpen())
+		return false;
+
+	// server never waits
+	if (m_IsServer)
+		return true;
+
+	Receive();
+	return m_HasNewFrame;
+}
+
+bool CAnimLiveBridgeMulticast::ParkForFrame(const unsigned int timeout_ms)
+{
+	if (!IsOpen() || m_IsServer)
+		return PollFrame();
+
+	fd_set read_set;
+	FD_ZERO(&read_set);
+	FD_SET(m_Socket, &read_set);
+
+	timeval timeout;
+	timeout.tv_sec = static_cast<long>(timeout_ms / 1000);
+	timeout.tv_usec = static_cast<long>((timeout_ms % 1000) * 1000);
+
+	select(static_cast<int>(m_Socket) + 1, &read_set, nullptr, nullptr, &timeout);
+	return PollFrame();
+}
+
+int CAnimLiveBridgeMulticast::ManualPostCommitFinish()
+{
+	if (!IsOpen() || !m_IsServer)
+		return -1;
+
+	SendDatagram();
+	return 0;
+}
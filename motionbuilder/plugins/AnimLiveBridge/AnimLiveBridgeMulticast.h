@@ -0,0 +1,114 @@
+#pragma once
+
+/*
+#
+# Copyright(c) 2021 Avalanche Studios.All rights reserved.
+# Licensed under the MIT License.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files(the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions :
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE
+#
+*/
+
+#include "AnimLiveBridgeNetwork.h"
+
+const char* const DEFAULT_MULTICAST_GROUP = "239.255.42.99";
+
+///////////////////////////////////////////////////////////////////////////
+// multicast datagram
+//  one datagram per frame - network frame header, server pair name hash and a packed model data
+//  datagrams are never retransmitted, a viewer keeps only frames newer than the last one it has applied
+
+struct SMulticastFrameHeader
+{
+	SNetworkFrameHeader		m_Frame;		//!< m_Type is ENetworkFrame_ServerData, m_Sequence is a server frame counter
+	unsigned int			m_PairHash;
+	unsigned int			m_Epoch;		//!< random per server open, a sequence starts again with a new one
+}; // 24 bytes
+
+// largest UDP payload, a whole frame has to fit into one datagram
+const size_t MAX_MULTICAST_DATAGRAM = 65507;
+// a joint schema block is repeated for viewers which join a group later
+const unsigned int MULTICAST_SCHEMA_INTERVAL = 30;
+
+///////////////////////////////////////////////////////////////////////////
+// CAnimLiveBridgeMulticast
+//  one way UDP fan-out, a server sends a frame once whatever number of viewers joined the group
+//  ELiveSessionProperty_NetworkAddress is a multicast group (or a broadcast / unicast address), ELiveSessionProperty_NetworkPort is a group port
+//  server commit never waits, client commit returns -1 until a newer frame is received, client feedback is not sent back
+
+class CAnimLiveBridgeMulticast : public CAnimLiveBridgeHardware
+{
+public:
+	//! a constructor
+	CAnimLiveBridgeMulticast(CAnimLiveBridgeSession* session);
+	virtual ~CAnimLiveBridgeMulticast();
+
+	int TypeId() const override { return 3; }
+	const char* TypeStr() const override { return "NetworkUDP"; }
+
+	int Open(const char* pair_name, const bool is_server) override;
+	int Close() override;
+
+	bool IsOpen() const override;
+
+	int Commit(const bool auto_finish_event) override;
+	int ManualPostCommitFinish() override;
+
+	//! frames that came after a newer one and were skipped
+	unsigned int GetDroppedFrames() const { return m_DroppedFrames; }
+
+protected:
+
+	bool PollFrame() override;
+	bool ParkForFrame(const unsigned int timeout_ms) override;
+
+	LiveBridgeSocket		m_Socket;
+
+	bool					m_IsOpen{ false };
+	bool					m_HasLastSequence{ false };
+	bool					m_HasNewFrame{ false };		//!< client got a newer frame, not yet committed
+	bool					m_UsePoseCodec{ false };
+	SPoseCodecSettings		m_PoseCodec;
+
+	bool					m_UseJointSchema{ false };
+	unsigned int			m_FramesSinceSchema{ 0 };
+	CJointSchema			m_Schema;					//!< server - last sent schema, client - last received one
+
+	unsigned int			m_PairHash{ 0 };
+	unsigned int			m_Sequence{ 0 };			//!< server - last sent frame, client - last applied frame
+	unsigned int			m_Epoch{ 0 };				//!< server - own epoch, client - epoch of a last applied frame
+	unsigned int			m_DroppedFrames{ 0 };
+
+	int						m_Port{ DEFAULT_NETWORK_PORT };
+	std::string				m_Address;
+	std::vector<char>		m_TargetAddress;			//!< sockaddr_in of a group
+
+	std::vector<char>		m_Buffer;
+	size_t					m_SendSize{ 0 };			//!< packed datagram waits for ManualPostCommitFinish when it is not zero
+
+	int OpenServer();
+	int OpenClient();
+
+	void SendDatagram();
+	//! drain queued datagrams, only the newest frame is left in a local data
+	void Receive();
+
+	int CommitServer(const bool auto_finish_event);
+	int CommitClient();
+};
@@ -0,0 +1,1105 @@
+
+/*
+#
+# Copyright(c) 2021 Avalanche Studios.All rights reserved.
+# Licensed under the MIT License.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files(the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions :
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE
+#
+*/
+
+#include "AnimLiveBridgeNetwork.h"
+#include "AnimLiveBridgeLog.h"
+#include <string>
+#include <cstring>
+#include <cstdint>
+
+#ifdef _WIN32
+	#include <winsock2.h>
+	#include <ws2tcpip.h>
+#else
+	#include <sys/types.h>
+	#include <sys/socket.h>
+	#include <sys/select.h>
+	#include <netinet/in.h>
+	#include <netinet/tcp.h>
+	#include <arpa/inet.h>
+	#include <netdb.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <errno.h>
+	#ifdef __linux__
+		#include <time.h>
+	#endif
+#endif
+
+#ifndef MSG_NOSIGNAL
+	#define MSG_NOSIGNAL 0
+#endif
+
+#ifdef _WIN32
+const LiveBridgeSocket INVALID_LIVEBRIDGE_SOCKET = static_cast<LiveBridgeSocket>(INVALID_SOCKET);
+#else
+const LiveBridgeSocket INVALID_LIVEBRIDGE_SOCKET = -1;
+#endif
+
+//////////////////////////////////////////////////////////////////////////////////
+// network frame
+
+size_t GetMaxPackedSize(const SSharedModelData& data, const bool pose_codec, const CJointSchema* schema)
+{
+	size_t joints_size = sizeof(SJointData) * data.m_Header.m_ModelsCount;
+
+	if (pose_codec)
+	{
+		joints_size = GetMaxEncodedPoseSize(data.m_Header.m_ModelsCount);
+	}
+	else if (schema)
+	{
+		joints_size = schema->GetBlockSize() + sizeof(unsigned int) + sizeof(STransform) * data.m_Header.m_ModelsCount;
+	}
+
+	return MODEL_DATA_PREFIX_SIZE + joints_size + sizeof(SPropertyData) * data.m_Header.m_PropsCount
+		+ sizeof(SEntityBlock) * data.m_Header.m_EntitiesCount;
+}
+
+size_t PackModelData(const SSharedModelData& data, const SPoseCodecSettings* pose_codec, char* buffer, const size_t buffer_size, unsigned short& flags,
+	const CJointSchema* schema, const bool write_schema)
+{
+	flags = 0;
+
+	// counts are already clamped to a frame capacity by a session commit
+	const unsigned int joints_count = data.m_Header.m_ModelsCount;
+	const size_t props_size = sizeof(SPropertyData) * data.m_Header.m_PropsCount;
+	const size_t entities_size = sizeof(SEntityBlock) * data.m_Header.m_EntitiesCount;
+	const size_t tail_size = props_size + entities_size;
+
+	if (pose_codec || (schema && schema->GetJointsCount() != joints_count))
+	{
+		schema = nullptr;
+	}
+
+	size_t size = 0;
+
+	if (schema && write_schema)
+	{
+		if (buffer_size < schema->GetBlockSize())
+			return 0;
+
+		size += schema->WriteBlock(buffer);
+		flags |= ENetworkFrameFlag_SchemaBlock;
+	}
+
+	if (buffer_size < size + MODEL_DATA_PREFIX_SIZE + tail_size)
+		return 0;
+
+	memcpy(buffer + size, &data, MODEL_DATA_PREFIX_SIZE);
+	size += MODEL_DATA_PREFIX_SIZE;
+
+	size_t joints_size = 0;
+
+	if (pose_codec)
+	{
+		joints_size = EncodePoseData(GetModelJoints(&data), joints_count, *pose_codec,
+			reinterpret_cast<unsigned char*>(buffer + size), buffer_size - size - tail_size);
+
+		if (joints_size > 0)
+			flags |= ENetworkFrameFlag_PoseCodec;
+	}
+	else if (schema)
+	{
+		// names, parents and flags are already on a remote side, a schema id tells which ones
+		joints_size = sizeof(unsigned int) + sizeof(STransform) * joints_count;
+
+		if (buffer_size < size + joints_size + tail_size)
+			return 0;
+
+		const unsigned int schema_id = schema->GetId();
+		memcpy(buffer + size, &schema_id, sizeof(unsigned int));
+
+		const SJointData* joints = GetModelJoints(&data);
+		STransform* transforms = reinterpret_cast<STransform*>(buffer + size + sizeof(unsigned int));
+
+		for (unsigned int i = 0; i < joints_count; ++i)
+		{
+			memcpy(transforms + i, &joints[i].m_Transform, sizeof(STransform));
+		}
+		flags |= ENetworkFrameFlag_JointSchema;
+	}
+
+	// encoded pose doesn't fit, send it as it is
+	if (joints_size == 0)
+	{
+		joints_size = sizeof(SJointData) * joints_count;
+
+		if (buffer_size < size + joints_size + tail_size)
+			return 0;
+
+		memcpy(buffer + size, GetModelJoints(&data), joints_size);
+	}
+	size += joints_size;
+
+	memcpy(buffer + size, GetModelProperties(&data), props_size);
+	size += props_size;
+
+	if (entities_size > 0)
+	{
+		memcpy(buffer + size, GetModelEntities(&data), entities_size);
+		size += entities_size;
+	}
+	return size;
+}
+
+// a schema block goes in front of a model data, it's taken by a receiver and skipped
+static bool ReadSchemaBlock(const char*& buffer, size_t& size, const unsigned short flags, CJointSchema* schema)
+{
+	if ((flags & ENetworkFrameFlag_SchemaBlock) == 0)
+		return true;
+
+	CJointSchema local_schema;
+	const size_t block_size = (schema) ? schema->ReadBlock(buffer, size) : local_schema.ReadBlock(buffer, size);
+
+	if (block_size == 0)
+		return false;
+
+	buffer += block_size;
+	size -= block_size;
+	return true;
+}
+
+// transforms only joints go after a schema id, pose codec size is variable and this is a raw size
+static size_t GetPackedJointsSize(const SHeader& header, const unsigned short flags)
+{
+	if (flags & ENetworkFrameFlag_JointSchema)
+		return sizeof(unsigned int) + sizeof(STransform) * static_cast<size_t>(header.m_ModelsCount);
+
+	return sizeof(SJointData) * static_cast<size_t>(header.m_ModelsCount);
+}
+
+// header counts have to match a payload size before anything is allocated for them
+static bool CheckPackedSize(const SHeader& header, const char* buffer, const size_t size, const unsigned short flags)
+{
+	if (header.m_ModelsCount > MAX_NETWORK_JOINTS)
+		return false;
+
+	const size_t joints_size_raw = GetPackedJointsSize(header, flags);
+	const size_t tail_size = sizeof(SPropertyData) * static_cast<size_t>(header.m_PropsCount)
+		+ sizeof(SEntityBlock) * static_cast<size_t>(header.m_EntitiesCount);
+
+	if (tail_size > size)
+		return false;
+
+	if ((flags & ENetworkFrameFlag_PoseCodec) == 0)
+		return size == MODEL_DATA_PREFIX_SIZE + joints_size_raw + tail_size;
+
+	// an encoded pose has a variable size, but every joint takes some bits and a codec header has a same count
+	if (size < MODEL_DATA_PREFIX_SIZE + sizeof(SPoseCodecHeader) + tail_size)
+		return false;
+
+	SPoseCodecHeader pose_header;
+	memcpy(&pose_header, buffer + MODEL_DATA_PREFIX_SIZE, sizeof(SPoseCodecHeader));
+
+	return pose_header.m_JointsCount == header.m_ModelsCount
+		&& size >= MODEL_DATA_PREFIX_SIZE + GetMinEncodedPoseSize(header.m_ModelsCount) + tail_size;
+}
+
+bool UnpackModelData(const char* buffer, size_t size, const unsigned short flags, CAnimLiveBridgeSession* session, CJointSchema* schema)
+{
+	if (!ReadSchemaBlock(buffer, size, flags, schema))
+		return false;
+
+	if (size < MODEL_DATA_PREFIX_SIZE)
+		return false;
+
+	SHeader header;
+	memcpy(&header, buffer, sizeof(SHeader));
+
+	if (!CheckPackedSize(header, buffer, size, flags))
+		return false;
+
+	session->ReserveFrame(header.m_ModelsCount, header.m_PropsCount, header.m_EntitiesCount);
+	return UnpackModelData(buffer, size, flags & ~ENetworkFrameFlag_SchemaBlock, session->GetFrame(), schema);
+}
+
+bool UnpackModelData(const char* buffer, size_t size, const unsigned short flags, SFrameBuffer& frame, CJointSchema* schema)
+{
+	if (!ReadSchemaBlock(buffer, size, flags, schema))
+		return false;
+
+	if (size < MODEL_DATA_PREFIX_SIZE)
+		return false;
+
+	SHeader header;
+	memcpy(&header, buffer, sizeof(SHeader));
+
+	const size_t joints_size_raw = GetPackedJointsSize(header, flags);
+	const size_t props_size = sizeof(SPropertyData) * static_cast<size_t>(header.m_PropsCount);
+	const size_t entities_size = sizeof(SEntityBlock) * static_cast<size_t>(header.m_EntitiesCount);
+	const size_t tail_size = props_size + entities_size;
+
+	if (!CheckPackedSize(header, buffer, size, flags))
+		return false;
+
+	if (header.m_ModelsCount > frame.m_JointsCapacity || header.m_PropsCount > frame.m_PropsCapacity || header.m_EntitiesCount > frame.m_EntitiesCapacity)
+		return false;
+
+	// a viewer which joined after a last schema block waits for a next one
+	if ((flags & ENetworkFrameFlag_JointSchema) && (schema == nullptr || schema->GetJointsCount() != header.m_ModelsCount))
+		return false;
+
+	SSharedModelData* data = frame.m_Data;
+
+	size_t joints_size = joints_size_raw;
+
+	if (flags & ENetworkFrameFlag_PoseCodec)
+	{
+		if (size < MODEL_DATA_PREFIX_SIZE + sizeof(SPoseCodecHeader) + tail_size)
+			return false;
+
+		SPoseCodecHeader pose_header;
+		memcpy(&pose_header, buffer + MODEL_DATA_PREFIX_SIZE, sizeof(SPoseCodecHeader));
+		joints_size = pose_header.m_Size;
+
+		if (size != MODEL_DATA_PREFIX_SIZE + joints_size + tail_size
+			|| DecodePoseData(reinterpret_cast<const unsigned char*>(buffer + MODEL_DATA_PREFIX_SIZE), joints_size, GetModelJoints(data), frame.m_JointsCapacity) != static_cast<int>(header.m_ModelsCount))
+		{
+			return false;
+		}
+	}
+	else if (flags & ENetworkFrameFlag_JointSchema)
+	{
+		// a same joints count is not enough, a rig could be renamed or reparented
+		unsigned int schema_id = 0;
+		memcpy(&schema_id, buffer + MODEL_DATA_PREFIX_SIZE, sizeof(unsigned int));
+
+		if (schema_id != schema->GetId())
+			return false;
+
+		SJointData* joints = GetModelJoints(data);
+		const STransform* transforms = reinterpret_cast<const STransform*>(buffer + MODEL_DATA_PREFIX_SIZE + sizeof(unsigned int));
+
+		for (unsigned int i = 0; i < header.m_ModelsCount; ++i)
+		{
+			memcpy(&joints[i].m_Transform, transforms + i, sizeof(STransform));
+		}
+		schema->Apply(joints);
+	}
+	else
+	{
+		memcpy(GetModelJoints(data), buffer + MODEL_DATA_PREFIX_SIZE, joints_size);
+	}
+
+	memcpy(GetModelProperties(data), buffer + MODEL_DATA_PREFIX_SIZE + joints_size, props_size);
+
+	if (entities_size > 0)
+	{
+		memcpy(GetModelEntities(data), buffer + MODEL_DATA_PREFIX_SIZE + joints_size + props_size, entities_size);
+	}
+
+	// keep a local frame layout
+	memcpy(data, buffer, MODEL_DATA_PREFIX_SIZE);
+	ValidateFrameLayout(*data, frame.m_JointsCapacity, frame.m_PropsCapacity, frame.m_EntitiesCapacity);
+	return true;
+}
+
+bool GetPoseCodecSettings(CAnimLiveBridgeSession* session, SPoseCodecSettings& settings)
+{
+	if (session->GetPropertyInt(ELiveSessionProperty_PoseCodec) == 0)
+		return false;
+
+	const int translation_bits = session->GetPropertyInt(ELiveSessionProperty_PoseCodecTranslationBits);
+	const int rotation_bits = session->GetPropertyInt(ELiveSessionProperty_PoseCodecRotationBits);
+
+	settings.m_TranslationBits = (translation_bits > 0) ? static_cast<unsigned int>(translation_bits) : DEFAULT_TRANSLATION_BITS;
+	settings.m_RotationBits = (rotation_bits > 0) ? static_cast<unsigned int>(rotation_bits) : DEFAULT_ROTATION_BITS;
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////
+// socket utilities
+
+bool NetworkStartup()
+{
+#ifdef _WIN32
+	static bool is_started = false;
+	if (!is_started)
+	{
+		WSADATA wsa_data;
+		is_started = (WSAStartup(MAKEWORD(2, 2), &wsa_data) == 0);
+	}
+	return is_started;
+#else
+	return true;
+#endif
+}
+
+void CloseSocket(LiveBridgeSocket& s)
+{
+	if (s == INVALID_LIVEBRIDGE_SOCKET)
+		return;
+#ifdef _WIN32
+	closesocket(static_cast<SOCKET>(s));
+#else
+	close(s);
+#endif
+	s = INVALID_LIVEBRIDGE_SOCKET;
+}
+
+bool SetSocketNonBlocking(LiveBridgeSocket s)
+{
+#ifdef _WIN32
+	u_long mode = 1;
+	return ioctlsocket(static_cast<SOCKET>(s), FIONBIO, &mode) == 0;
+#else
+	const int flags = fcntl(s, F_GETFL, 0);
+	return flags >= 0 && fcntl(s, F_SETFL, flags | O_NONBLOCK) == 0;
+#endif
+}
+
+int GetLastSocketError()
+{
+#ifdef _WIN32
+	return WSAGetLastError();
+#else
+	return errno;
+#endif
+}
+
+bool IsSocketWouldBlock(const int err)
+{
+#ifdef _WIN32
+	return err == WSAEWOULDBLOCK || err == WSAEINPROGRESS;
+#else
+	return err == EWOULDBLOCK || err == EAGAIN || err == EINPROGRESS;
+#endif
+}
+
+bool ResolveAddress(const char* host, const int port, void* sockaddr_in_out)
+{
+	sockaddr_in* addr = static_cast<sockaddr_in*>(sockaddr_in_out);
+	memset(addr, 0, sizeof(sockaddr_in));
+	addr->sin_family = AF_INET;
+	addr->sin_port = htons(static_cast<unsigned short>(port));
+
+	if (host == nullptr || host[0] == 0)
+	{
+		addr->sin_addr.s_addr = htonl(INADDR_ANY);
+		return true;
+	}
+
+	if (inet_pton(AF_INET, host, &addr->sin_addr) == 1)
+		return true;
+
+	addrinfo hints;
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_INET;
+
+	addrinfo* result = nullptr;
+	if (getaddrinfo(host, nullptr, &hints, &result) != 0 || result == nullptr)
+		return false;
+
+	addr->sin_addr = reinterpret_cast<sockaddr_in*>(result->ai_addr)->sin_addr;
+	freeaddrinfo(result);
+	return true;
+}
+
+static void SetNoDelay(LiveBridgeSocket s)
+{
+	// frames are small and latency sensitive, don't let Nagle's algorithm hold them
+	int value = 1;
+	setsockopt(static_cast<int>(s), IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&value), sizeof(value));
+
+#ifdef __linux__
+	// a kernel arrival time for clock samples, a caller could read a socket a frame later
+	setsockopt(s, SOL_SOCKET, SO_TIMESTAMPNS, &value, sizeof(value));
+#endif
+}
+
+// receive from a socket, receive_time is a kernel arrival time of last data on linux and a read time on other platforms
+static int ReceiveSocket(LiveBridgeSocket s, char* buffer, const size_t size, double& receive_time)
+{
+#ifdef __linux__
+	iovec iov;
+	iov.iov_base = buffer;
+	iov.iov_len = size;
+
+	char control[CMSG_SPACE(sizeof(timespec))];
+
+	msghdr msg;
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1;
+	msg.msg_control = control;
+	msg.msg_controllen = sizeof(control);
+
+	const int received = static_cast<int>(recvmsg(s, &msg, 0));
+	receive_time = 1e-9 * static_cast<double>(CLiveSessionStats::Now());
+
+	for (cmsghdr* cmsg = (received > 0) ? CMSG_FIRSTHDR(&msg) : nullptr; cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg))
+	{
+		if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_TIMESTAMPNS)
+			continue;
+
+		// a kernel stamp is a wall clock one, its age moves it to a steady clock
+		timespec stamp;
+		timespec wall_time;
+		memcpy(&stamp, CMSG_DATA(cmsg), sizeof(timespec));
+		clock_gettime(CLOCK_REALTIME, &wall_time);
+
+		const double age = static_cast<double>(wall_time.tv_sec - stamp.tv_sec) + 1e-9 * static_cast<double>(wall_time.tv_nsec - stamp.tv_nsec);
+		if (age > 0.0 && age < 1.0)
+			receive_time -= age;
+	}
+	return received;
+#else
+	const int received = static_cast<int>(recv(s, buffer, static_cast<int>(size), 0));
+	receive_time = 1e-9 * static_cast<double>(CLiveSessionStats::Now());
+	return received;
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////////////
+// CAnimLiveBridgeNetwork
+
+CAnimLiveBridgeNetwork::CAnimLiveBridgeNetwork(CAnimLiveBridgeSession* session)
+	: CAnimLiveBridgeHardware(session)
+	, m_ListenSocket(INVALID_LIVEBRIDGE_SOCKET)
+	, m_Socket(INVALID_LIVEBRIDGE_SOCKET)
+{
+	m_SendBuffer.resize(DEFAULT_NETWORK_FRAME);
+	m_RecvBuffer.resize(2 * DEFAULT_NETWORK_FRAME);
+}
+
+CAnimLiveBridgeNetwork::~CAnimLiveBridgeNetwork()
+{
+	Close();
+}
+
+bool CAnimLiveBridgeNetwork::IsOpen() const
+{
+	return m_IsOpen;
+}
+
+int CAnimLiveBridgeNetwork::Open(const char* pair_name, const bool is_server)
+{
+	if (IsOpen())
+		return 1;
+
+	if (!NetworkStartup())
+		return -1;
+
+	strncpy(m_PairName, pair_name, NAME_SIZE - 1);
+	m_PairName[NAME_SIZE - 1] = 0;
+	m_PairHash = HashPairName(m_PairName);
+
+	CAnimLiveBridgeSession* session = GetSessionPtr();
+	m_Address = session->GetPropertyString(ELiveSessionProperty_NetworkAddress);
+	m_Port = session->GetPropertyInt(ELiveSessionProperty_NetworkPort);
+
+	if (m_Port <= 0)
+		m_Port = DEFAULT_NETWORK_PORT;
+	if (!is_server && m_Address.empty())
+		m_Address = "127.0.0.1";
+
+	if (g_VerboseLevel && g_Logger)
+	{
+		std::string info("[HardwareOpen] Open network tcp ");
+		info += (is_server) ? "server on " : "client to ";
+		info += (m_Address.empty()) ? "*" : m_Address;
+		info += ":";
+		info += std::to_string(m_Port);
+
+		g_Logger->LogInfo(info.c_str());
+	}
+
+	m_IsServer = is_server;
+	m_Sequence = 0;
+	m_UsePoseCodec = GetPoseCodecSettings(session, m_PoseCodec);
+	m_UseJointSchema = session->GetPropertyInt(ELiveSessionProperty_JointSchema) != 0;
+	m_SchemaSent = false;
+	m_Schema.Clear();
+	m_UseClockSync = session->GetPropertyInt(ELiveSessionProperty_ClockSync) != 0;
+
+	const int err = (is_server) ? OpenServer() : OpenClient();
+	if (err != 0)
+	{
+		if (g_VerboseLevel && g_Logger)
+		{
+			std::string info("[HardwareOpen] Failed to open a network socket, error - ");
+			info += std::to_string(err);
+
+			g_Logger->LogError(info.c_str());
+		}
+		Close();
+		return err;
+	}
+
+	m_IsOpen = true;
+	return 0;
+}
+
+int CAnimLiveBridgeNetwork::OpenServer()
+{
+	sockaddr_in addr;
+	if (!ResolveAddress(m_Address.c_str(), m_Port, &addr))
+		return -1;
+
+	m_ListenSocket = static_cast<LiveBridgeSocket>(socket(AF_INET, SOCK_STREAM, IPPROTO_TCP));
+	if (m_ListenSocket == INVALID_LIVEBRIDGE_SOCKET)
+		return GetLastSocketError();
+
+	int reuse = 1;
+	setsockopt(static_cast<int>(m_ListenSocket), SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+
+	if (bind(m_ListenSocket, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0
+		|| listen(m_ListenSocket, 1) != 0
+		|| !SetSocketNonBlocking(m_ListenSocket))
+	{
+		return GetLastSocketError();
+	}
+	return 0;
+}
+
+int CAnimLiveBridgeNetwork::OpenClient()
+{
+	sockaddr_in addr;
+	if (!ResolveAddress(m_Address.c_str(), m_Port, &addr))
+		return -1;
+
+	m_Socket = static_cast<LiveBridgeSocket>(socket(AF_INET, SOCK_STREAM, IPPROTO_TCP));
+	if (m_Socket == INVALID_LIVEBRIDGE_SOCKET)
+		return GetLastSocketError();
+
+	SetNoDelay(m_Socket);
+
+	if (!SetSocketNonBlocking(m_Socket))
+		return GetLastSocketError();
+
+	// connection is completed in a commit, it's not blocking an open call
+	if (connect(m_Socket, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0)
+	{
+		const int err = GetLastSocketError();
+		if (!IsSocketWouldBlock(err))
+			return err;
+	}
+
+	m_Connected = false;
+	m_RecvSize = 0;
+	m_SendSize = m_SendOffset = 0;
+	return 0;
+}
+
+int CAnimLiveBridgeNetwork::Close()
+{
+	CloseSocket(m_Socket);
+	CloseSocket(m_ListenSocket);
+
+	m_IsOpen = false;
+	m_Connected = false;
+	m_HasTurn = false;
+	m_HoldSend = false;
+	m_HasNewFrame = false;
+	m_RecvSize = 0;
+	m_SendSize = m_SendOffset = 0;
+	return 0;
+}
+
+void CAnimLiveBridgeNetwork::Disconnect()
+{
+	if (g_VerboseLevel && g_Logger)
+	{
+		LogMessage(ELogMessage_NetworkClosed);
+	}
+
+	CloseSocket(m_Socket);
+
+	m_Connected = false;
+	m_HasTurn = false;
+	m_HoldSend = false;
+	m_RecvSize = 0;
+	m_SendSize = m_SendOffset = 0;
+
+	// a next peer could have another clock
+	GetSessionPtr()->GetClockSync().Reset();
+
+	// client is going to reconnect on a next commit
+	if (!m_IsServer)
+	{
+		OpenClient();
+	}
+}
+
+bool CAnimLiveBridgeNetwork::Accept()
+{
+	if (m_Connected)
+		return true;
+
+	const LiveBridgeSocket s = static_cast<LiveBridgeSocket>(accept(m_ListenSocket, nullptr, nullptr));
+	if (s == INVALID_LIVEBRIDGE_SOCKET)
+		return false;
+
+	m_Socket = s;
+	SetNoDelay(m_Socket);
+	SetSocketNonBlocking(m_Socket);
+
+	// wait for a client hello before sending a first frame
+	m_Connected = true;
+	m_HasTurn = false;
+	m_SchemaSent = false;
+	m_RecvSize = 0;
+	m_SendSize = m_SendOffset = 0;
+	return true;
+}
+
+bool CAnimLiveBridgeNetwork::CheckConnected()
+{
+	if (m_Connected)
+		return true;
+
+	if (m_Socket == INVALID_LIVEBRIDGE_SOCKET)
+	{
+		OpenClient();
+		return false;
+	}
+
+	fd_set write_set;
+	fd_set except_set;
+	FD_ZERO(&write_set);
+	FD_ZERO(&except_set);
+	FD_SET(m_Socket, &write_set);
+	FD_SET(m_Socket, &except_set);
+
+	timeval timeout{ 0, 0 };
+	if (select(static_cast<int>(m_Socket) + 1, nullptr, &write_set, &except_set, &timeout) <= 0)
+		return false;
+
+	int err = 0;
+	socklen_t len = sizeof(err);
+	getsockopt(static_cast<int>(m_Socket), SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&err), &len);
+
+	if (err != 0 || FD_ISSET(m_Socket, &except_set))
+	{
+		// server is not there yet, try again later
+		CloseSocket(m_Socket);
+		return false;
+	}
+
+	m_Connected = true;
+
+	// introduce ourselves with a pair name hash
+	QueueFrame(ENetworkFrame_Hello, 0, reinterpret_cast<const char*>(&m_PairHash), sizeof(m_PairHash));
+	FlushSend();
+	return m_Connected;
+}
+
+void CAnimLiveBridgeNetwork::QueueFrame(const unsigned short type, const unsigned short flags, const char* payload, const size_t size)
+{
+	SNetworkFrameHeader header;
+	header.m_Magic = NETWORK_FRAME_MAGIC;
+	header.m_Size = static_cast<unsigned int>(size);
+	header.m_Type = type;
+	header.m_Flags = flags;
+	header.m_Sequence = ++m_Sequence;
+
+	memcpy(m_SendBuffer.data(), &header, sizeof(SNetworkFrameHeader));
+	if (payload != nullptr && payload != m_SendBuffer.data() + sizeof(SNetworkFrameHeader))
+	{
+		memcpy(m_SendBuffer.data() + sizeof(SNetworkFrameHeader), payload, size);
+	}
+
+	m_SendSize = sizeof(SNetworkFrameHeader) + size;
+	m_SendOffset = 0;
+}
+
+bool CAnimLiveBridgeNetwork::FlushSend()
+{
+	while (m_SendOffset < m_SendSize)
+	{
+		const int sent = static_cast<int>(send(m_Socket, m_SendBuffer.data() + m_SendOffset, static_cast<int>(m_SendSize - m_SendOffset), MSG_NOSIGNAL));
+
+		if (sent < 0)
+		{
+			if (IsSocketWouldBlock(GetLastSocketError()))
+				return true;
+
+			Disconnect();
+			return false;
+		}
+		m_SendOffset += static_cast<size_t>(sent);
+		GetStats().OnBytesSent(static_cast<size_t>(sent));
+	}
+	m_SendSize = m_SendOffset = 0;
+	return true;
+}
+
+bool CAnimLiveBridgeNetwork::Receive()
+{
+	while (true)
+	{
+		if (m_RecvSize == m_RecvBuffer.size())
+		{
+			Disconnect();
+			return false;
+		}
+
+		const int received = ReceiveSocket(m_Socket, m_RecvBuffer.data() + m_RecvSize, m_RecvBuffer.size() - m_RecvSize, m_ReceiveTime);
+
+		if (received == 0)
+		{
+			Disconnect();
+			return false;
+		}
+		else if (received < 0)
+		{
+			if (IsSocketWouldBlock(GetLastSocketError()))
+				break;
+
+			Disconnect();
+			return false;
+		}
+
+		m_RecvSize += static_cast<size_t>(received);
+		GetStats().OnBytesReceived(static_cast<size_t>(received));
+
+		// parse complete frames
+		size_t offset = 0;
+		while (m_RecvSize - offset >= sizeof(SNetworkFrameHeader))
+		{
+			SNetworkFrameHeader header;
+			memcpy(&header, m_RecvBuffer.data() + offset, sizeof(SNetworkFrameHeader));
+
+			if (header.m_Magic != NETWORK_FRAME_MAGIC || header.m_Size > MAX_NETWORK_PAYLOAD)
+			{
+				Disconnect();
+				return false;
+			}
+
+			if (m_RecvSize - offset < sizeof(SNetworkFrameHeader) + header.m_Size)
+			{
+				// frames have no fixed size limit, let a buffer hold a whole frame
+				if (m_RecvBuffer.size() < sizeof(SNetworkFrameHeader) + header.m_Size)
+					m_RecvBuffer.resize(sizeof(SNetworkFrameHeader) + header.m_Size);
+				break;
+			}
+
+			if (!ProcessFrame(header, m_RecvBuffer.data() + offset + sizeof(SNetworkFrameHeader)))
+			{
+				Disconnect();
+				return false;
+			}
+			offset += sizeof(SNetworkFrameHeader) + header.m_Size;
+		}
+
+		if (offset > 0)
+		{
+			memmove(m_RecvBuffer.data(), m_RecvBuffer.data() + offset, m_RecvSize - offset);
+			m_RecvSize -= offset;
+		}
+	}
+	return true;
+}
+
+bool CAnimLiveBridgeNetwork::ProcessFrame(const SNetworkFrameHeader& header, const char* payload)
+{
+	CAnimLiveBridgeSession* session = GetSessionPtr();
+
+	size_t size = header.m_Size;
+
+	if (header.m_Flags & ENetworkFrameFlag_ClockSample)
+	{
+		if (size < sizeof(SClockSample))
+			return false;
+
+		size -= sizeof(SClockSample);
+
+		SClockSample sample;
+		memcpy(&sample, payload + size, sizeof(SClockSample));
+		session->GetClockSync().ReadSample(sample, m_ReceiveTime);
+	}
+
+	switch (header.m_Type)
+	{
+	case ENetworkFrame_Hello:
+	{
+		unsigned int pair_hash = 0;
+		if (!m_IsServer || header.m_Size != sizeof(pair_hash))
+			return false;
+
+		memcpy(&pair_hash, payload, sizeof(pair_hash));
+		if (pair_hash != m_PairHash)
+		{
+			if (g_VerboseLevel && g_Logger)
+			{
+				LogMessage(ELogMessage_NetworkPairMismatch);
+			}
+			return false;
+		}
+		m_HasTurn = true;
+	} break;
+
+	case ENetworkFrame_ClientFeedback:
+	{
+		if (!m_IsServer)
+			return false;
+
+		if (size != MODEL_DATA_PREFIX_SIZE)
+			return false;
+
+		SSharedModelData feedback;
+		memcpy(&feedback, payload, MODEL_DATA_PREFIX_SIZE);
+
+		ReadClientFeedback(feedback);
+		m_HasTurn = true;
+	} break;
+
+	case ENetworkFrame_ServerData:
+	{
+		if (m_IsServer)
+			return false;
+
+		const unsigned int client_tag = session->GetDataPtr()->m_Header.m_ClientTag;
+
+		const unsigned short flags = header.m_Flags & ~ENetworkFrameFlag_ClockSample;
+		if (!UnpackModelData(payload, size, flags, session, &m_Schema))
+			return false;
+
+		m_UseClockSync |= (header.m_Flags & ENetworkFrameFlag_ClockSample) != 0;
+
+		session->GetDataPtr()->m_Header.m_ClientTag = client_tag;
+		m_HasNewFrame = true;
+		GetStats().OnFrameReceived();
+	} break;
+
+	default:
+		return false;
+	}
+	return true;
+}
+
+int CAnimLiveBridgeNetwork::Commit(const bool auto_finish_event)
+{
+	if (!IsOpen())
+		return -3;
+
+	return (m_IsServer) ? CommitServer(auto_finish_event) : CommitClient(auto_finish_event);
+}
+
+int CAnimLiveBridgeNetwork::CommitServer(const bool auto_finish_event)
+{
+	if (!Accept())
+		return -1;
+
+	if (!FlushSend() || !Receive())
+		return -1;
+
+	// client has not finished with a previous frame yet
+	if (!m_HasTurn || m_SendSize > 0)
+		return -1;
+
+	CAnimLiveBridgeSession* session = GetSessionPtr();
+	SSharedModelData* local_data = session->GetDataPtr();
+
+	session->GetTimelinePtr()->WriteToData(true, *local_data);
+
+	if (session->m_SyncSaved)
+	{
+		local_data->m_LookAtRoot[3] = 2.0f;
+		session->m_SyncSaved = false;
+	}
+
+	// a server clock is a shared time base of a pair
+	const double now = 1e-9 * static_cast<double>(CLiveSessionStats::Now());
+	const size_t clock_size = (m_UseClockSync) ? sizeof(SClockSample) : 0;
+
+	if (m_UseClockSync)
+	{
+		local_data->m_ServerPlayer.m_SystemTime = now;
+	}
+
+	const CJointSchema* schema = nullptr;
+	bool write_schema = false;
+
+	if (m_UseJointSchema && !m_UsePoseCodec)
+	{
+		write_schema = m_Schema.Update(GetModelJoints(local_data), local_data->m_Header.m_ModelsCount) || !m_SchemaSent;
+		m_SchemaSent = true;
+		schema = &m_Schema;
+	}
+
+	const size_t max_size = sizeof(SNetworkFrameHeader) + GetMaxPackedSize(*local_data, m_UsePoseCodec, schema) + clock_size;
+	if (m_SendBuffer.size() < max_size)
+		m_SendBuffer.resize(max_size);
+
+	unsigned short flags = 0;
+	size_t size = PackModelData(*local_data, (m_UsePoseCodec) ? &m_PoseCodec : nullptr,
+		m_SendBuffer.data() + sizeof(SNetworkFrameHeader), m_SendBuffer.size() - sizeof(SNetworkFrameHeader) - clock_size, flags, schema, write_schema);
+	local_data->m_LookAtRoot[3] = 0.0f;
+
+	if (size == 0)
+	{
+		// a schema goes with a next frame which fits
+		if (write_schema)
+			m_SchemaSent = false;
+
+		if (g_VerboseLevel && g_Logger)
+		{
+			LogMessage(ELogMessage_FrameOverflow, local_data->m_Header.m_ModelsCount);
+		}
+		return -5;
+	}
+
+	if (m_UseClockSync)
+	{
+		SClockSample sample;
+		session->GetClockSync().WriteSample(sample, now);
+		memcpy(m_SendBuffer.data() + sizeof(SNetworkFrameHeader) + size, &sample, sizeof(SClockSample));
+
+		size += sizeof(SClockSample);
+		flags |= ENetworkFrameFlag_ClockSample;
+	}
+	QueueFrame(ENetworkFrame_ServerData, flags, nullptr, size);
+	GetStats().OnFrameSent();
+
+	m_HasTurn = false;
+	m_HoldSend = !auto_finish_event;
+
+	if (auto_finish_event)
+	{
+		FlushSend();
+	}
+	return 0;
+}
+
+int CAnimLiveBridgeNetwork::CommitClient(const bool auto_finish_event)
+{
+	if (!CheckConnected())
+		return -1;
+
+	if (!m_HoldSend && !FlushSend())
+		return -1;
+
+	// a last frame is still valid when a server closes a connection right after it
+	Receive();
+
+	if (!m_HasNewFrame)
+		return -1;
+
+	m_HasNewFrame = false;
+
+	CAnimLiveBridgeSession* session = GetSessionPtr();
+	SSharedModelData* local_data = session->GetDataPtr();
+
+	session->GetTimelinePtr()->ReadFromData(true, *local_data);
+
+	// check if we have sync event from master
+	if (local_data->m_LookAtRoot[3] == 2.0f)
+	{
+		session->m_HasNewSync = true;
+	}
+
+	if (!m_Connected)
+		return 0;
+
+	// feedback goes back with a data prefix only
+	SSharedModelData& feedback = *reinterpret_cast<SSharedModelData*>(m_SendBuffer.data() + sizeof(SNetworkFrameHeader));
+	memcpy(&feedback, local_data, MODEL_DATA_PREFIX_SIZE);
+
+	session->GetTimelinePtr()->WriteToData(false, feedback);
+	WriteClientFeedback(feedback);
+
+	if (m_UseClockSync)
+	{
+		SClockSample sample;
+		session->GetClockSync().WriteSample(sample, 1e-9 * static_cast<double>(CLiveSessionStats::Now()));
+		memcpy(m_SendBuffer.data() + sizeof(SNetworkFrameHeader) + MODEL_DATA_PREFIX_SIZE, &sample, sizeof(SClockSample));
+
+		QueueFrame(ENetworkFrame_ClientFeedback, ENetworkFrameFlag_ClockSample, nullptr, MODEL_DATA_PREFIX_SIZE + sizeof(SClockSample));
+	}
+	else
+	{
+		QueueFrame(ENetworkFrame_ClientFeedback, 0, nullptr, MODEL_DATA_PREFIX_SIZE);
+	}
+	m_HoldSend = !auto_finish_event;
+
+	if (auto_finish_event)
+	{
+		FlushSend();
+	}
+	return 0;
+}
+
+bool CAnimLiveBridgeNetwork::PollFrame()
+{
+	if (!IsOpen())
+		return false;
+
+	if (m_IsServer)
+	{
+		if (!Accept() || !FlushSend() || !Receive())
+			return false;
+
+		return m_HasTurn && m_SendSize == 0;
+	}
+
+	if (!CheckConnected())
+		return false;
+
+	if (!m_HoldSend)
+	{
+		FlushSend();
+	}
+	Receive();
+	return m_HasNewFrame;
+}
+
+bool CAnimLiveBridgeNetwork::ParkForFrame(const unsigned int timeout_ms)
+{
+	const LiveBridgeSocket s = (m_IsServer && !m_Connected) ? m_ListenSocket : m_Socket;
+
+	if (s == INVALID_LIVEBRIDGE_SOCKET)
+		return CAnimLiveBridgeHardware::ParkForFrame(timeout_ms);
+
+	fd_set read_set;
+	fd_set write_set;
+	FD_ZERO(&read_set);
+	FD_ZERO(&write_set);
+
+	// incoming connection or data, pending connect or a send which didn't fit into a socket buffer
+	FD_SET(s, &read_set);
+	if ((!m_IsServer && !m_Connected) || (m_SendSize > 0 && !m_HoldSend))
+	{
+		FD_SET(s, &write_set);
+	}
+
+	timeval timeout;
+	timeout.tv_sec = static_cast<long>(timeout_ms / 1000);
+	timeout.tv_usec = static_cast<long>((timeout_ms % 1000) * 1000);
+
+	select(static_cast<int>(s) + 1, &read_set, &write_set, nullptr, &timeout);
+	return PollFrame();
+}
+
+int CAnimLiveBridgeNetwork::ManualPostCommitFinish()
+{
+	if (!IsOpen() || !m_Connected)
+		return -1;
+
+	m_HoldSend = false;
+	return (FlushSend()) ? 0 : -1;
+}
@@ -27,11 +27,152 @@
 */
 
 #include "AnimLiveBridgeSession.h"
+#include "AnimLiveBridgeCodec.h"
+#include <vector>
 
+#ifdef _WIN32
+	typedef unsigned long long	LiveBridgeSocket;		//!< SOCKET, winsock headers are included only in a cpp
+#else
+	typedef int					LiveBridgeSocket;
+#endif
+
+extern const LiveBridgeSocket	INVALID_LIVEBRIDGE_SOCKET;
+
+const int DEFAULT_NETWORK_PORT = 8899;
+
+///////////////////////////////////////////////////////////////////////////
+// network frame
+//  length-prefixed frame, a header is followed by m_Size bytes of payload
+//  model data payload is a data prefix (header, players, look at) plus only used joints and properties
+//  NOTE: values are sent in a host byte order, both sides are expected to be little-endian
+
+enum ENetworkFrameType
+{
+	ENetworkFrame_Hello,			//!< client handshake, payload is a pair name hash
+	ENetworkFrame_ServerData,		//!< server model data
+	ENetworkFrame_ClientFeedback	//!< client model data prefix (client tag, player, look at)
+};
+
+enum ENetworkFrameFlags
+{
+	ENetworkFrameFlag_PoseCodec = 1 << 0,		//!< joints are encoded with a quantized pose codec
+	ENetworkFrameFlag_JointSchema = 1 << 1,		//!< joints are a schema id and transforms only, names, parents and flags come from a schema block with that id
+	ENetworkFrameFlag_SchemaBlock = 1 << 2,		//!< payload starts with a joint schema block (CJointSchema::WriteBlock)
+	ENetworkFrameFlag_ClockSample = 1 << 3		//!< payload ends with a clock sample (SClockSample)
+};
+
+struct SNetworkFrameHeader
+{
+	unsigned int		m_Magic;
+	unsigned int		m_Size;			//!< payload size in bytes
+	unsigned short		m_Type;			//!< ENetworkFrameType
+	unsigned short		m_Flags;
+	unsigned int		m_Sequence;		//!< sender frame counter
+}; // 16 bytes
+
+const unsigned int NETWORK_FRAME_MAGIC = 0x4E424C41; // ALBN
+const size_t MAX_NETWORK_PAYLOAD = 64 * 1024 * 1024;		// sanity limit, frames have no fixed joints limit
+const unsigned int MAX_NETWORK_JOINTS = 64 * 1024;			// sanity limit of a received joints count, a frame is reserved for it
+const size_t DEFAULT_NETWORK_FRAME = sizeof(SNetworkFrameHeader) + sizeof(SSharedModelData);
+
+//! worst case packed size of a model data, a schema is an updated server one when joints go with a joint schema
+size_t GetMaxPackedSize(const SSharedModelData& data, const bool pose_codec, const CJointSchema* schema = nullptr);
+//! pack used part of a model data, returns a packed size and frame flags or 0 if a buffer is too small
+/*!
+	with a schema (updated from the same data) joints are packed as transforms only, write_schema puts a schema block in front of them.
+	A pose codec has its own joint names encoding, a schema is not used with it
+*/
+size_t PackModelData(const SSharedModelData& data, const SPoseCodecSettings* pose_codec, char* buffer, const size_t buffer_size, unsigned short& flags,
+	const CJointSchema* schema = nullptr, const bool write_schema = false);
+//! unpack a payload into a session local frame, the frame grows when a payload has more joints or properties than its capacity
+/*!
+	returns false if payload size doesn't match the header counts, or joints need a schema which was not received yet
+*/
+bool UnpackModelData(const char* buffer, const size_t size, const unsigned short flags, CAnimLiveBridgeSession* session, CJointSchema* schema = nullptr);
+//! unpack a payload into a frame buffer, returns false if a frame capacity is smaller than payload counts
+bool UnpackModelData(const char* buffer, const size_t size, const unsigned short flags, SFrameBuffer& frame, CJointSchema* schema = nullptr);
+//! read pose codec session properties, returns false if codec is disabled
+bool GetPoseCodecSettings(CAnimLiveBridgeSession* session, SPoseCodecSettings& settings);
+
+// socket utilities, shared between network transports
+bool NetworkStartup();
+void CloseSocket(LiveBridgeSocket& s);
+bool SetSocketNonBlocking(LiveBridgeSocket s);
+int GetLastSocketError();
+bool IsSocketWouldBlock(const int err);
+//! resolve ipv4 address, empty host means any address
+bool ResolveAddress(const char* host, const int port, void* sockaddr_in_out);
 
 ///////////////////////////////////////////////////////////////////////////
-// TODO:
+// CAnimLiveBridgeNetwork
+//  non-blocking TCP transport, server and client take turns the same way as a shared memory ping pong
+//  server is listening on ELiveSessionProperty_NetworkAddress / ELiveSessionProperty_NetworkPort, client connects to it
+
 class CAnimLiveBridgeNetwork : public CAnimLiveBridgeHardware
 {
+public:
+	//! a constructor
+	CAnimLiveBridgeNetwork(CAnimLiveBridgeSession* session);
+	virtual ~CAnimLiveBridgeNetwork();
+
+	int TypeId() const override { return 2; }
+	const char* TypeStr() const override { return "NetworkTCP"; }
+
+	int Open(const char* pair_name, const bool is_server) override;
+	int Close() override;
+
+	bool IsOpen() const override;
+
+	int Commit(const bool auto_finish_event) override;
+	int ManualPostCommitFinish() override;
+
+protected:
+
+	bool PollFrame() override;
+	bool ParkForFrame(const unsigned int timeout_ms) override;
+
+	LiveBridgeSocket		m_ListenSocket;
+	LiveBridgeSocket		m_Socket;
+
+	bool					m_IsOpen{ false };
+	bool					m_Connected{ false };
+	bool					m_HasTurn{ false };			//!< server is allowed to send a next frame
+	bool					m_HoldSend{ false };		//!< packed frame waits for ManualPostCommitFinish
+	bool					m_HasNewFrame{ false };		//!< client got a server frame
+	bool					m_UsePoseCodec{ false };
+	SPoseCodecSettings		m_PoseCodec;
+
+	bool					m_UseJointSchema{ false };
+	bool					m_SchemaSent{ false };		//!< a schema block goes once per connection and when joints are changed
+	CJointSchema			m_Schema;					//!< server - last sent schema, client - last received one
+
+	bool					m_UseClockSync{ false };	//!< frames carry clock samples, a client answers a server which sends them
+	double					m_ReceiveTime{ 0.0 };		//!< local time of a last socket read, an arrival time of parsed frames
+
+	unsigned int			m_PairHash{ 0 };
+	unsigned int			m_Sequence{ 0 };
+	int						m_Port{ DEFAULT_NETWORK_PORT };
+	std::string				m_Address;
+
+	std::vector<char>		m_SendBuffer;
+	size_t					m_SendSize{ 0 };
+	size_t					m_SendOffset{ 0 };
+
+	std::vector<char>		m_RecvBuffer;
+	size_t					m_RecvSize{ 0 };
+
+	int OpenServer();
+	int OpenClient();
+
+	bool Accept();
+	bool CheckConnected();
+	void Disconnect();
+
+	void QueueFrame(const unsigned short type, const unsigned short flags, const char* payload, const size_t size);
+	bool FlushSend();
+	bool Receive();
+	bool ProcessFrame(const SNetworkFrameHeader& header, const char* payload);
 
-};
\ No newline at end of file
+	int CommitServer(const bool auto_finish_event);
+	int CommitClient(const bool auto_finish_event);
+};
@@ -0,0 +1,280 @@
+#pragma once
+
+/*
+#
+# Copyright(c) 2021 Avalanche Studios.All rights reserved.
+# Licensed under the MIT License.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files(the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions :
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE
+#
+*/
+
+
+
+#include <atomic>
+#include <thread>
+
+// forward
+class CAnimLiveBridgeSession;
+
+const unsigned int SESSION_BLOCK_SLOTS = 256;			// slots are allocated by blocks, a block never moves once it's allocated
+const unsigned int MAX_SESSION_BLOCKS = 256;
+const unsigned int MAX_LIVE_SESSIONS = SESSION_BLOCK_SLOTS * MAX_SESSION_BLOCKS;
+const unsigned int SESSION_HANDLE_INDEX_BITS = 16;
+const unsigned int SESSION_HANDLE_INDEX_MASK = MAX_LIVE_SESSIONS - 1;
+const unsigned int SESSION_HANDLE_GENERATION_MASK = 0xFFFFu;		// 16 bits left in a handle
+const unsigned int INVALID_SESSION_HANDLE = 0;
+
+////////////////////////////////////////////////////////////
+// CSessionRef
+//  a session which is in use by a caller, a registry doesn't detach a session until every reference is released
+
+class CSessionRef
+{
+public:
+
+	CSessionRef() = default;
+	CSessionRef(CAnimLiveBridgeSession* session, std::atomic<unsigned int>* users)
+		: m_Session(session)
+		, m_Users(users)
+	{}
+
+	CSessionRef(CSessionRef&& other) noexcept
+		: m_Session(other.m_Session)
+		, m_Users(other.m_Users)
+	{
+		other.m_Session = nullptr;
+		other.m_Users = nullptr;
+	}
+
+	~CSessionRef() { Reset(); }
+
+	CSessionRef(const CSessionRef&) = delete;
+	CSessionRef& operator=(const CSessionRef&) = delete;
+
+	void Reset()
+	{
+		if (m_Users)
+			m_Users->fetch_sub(1, std::memory_order_release);
+
+		m_Session = nullptr;
+		m_Users = nullptr;
+	}
+
+	CAnimLiveBridgeSession* Get() const { return m_Session; }
+	CAnimLiveBridgeSession* operator->() const { return m_Session; }
+	operator CAnimLiveBridgeSession*() const { return m_Session; }
+
+protected:
+	CAnimLiveBridgeSession*		m_Session{ nullptr };
+	std::atomic<unsigned int>*	m_Users{ nullptr };
+};
+
+////////////////////////////////////////////////////////////
+// CAnimLiveBridgeRegistry
+//  lock-free slot map of sessions, a handle is a slot generation in high bits and a slot index in low bits
+//  a slot generation is changed on every remove, so a stale handle never addresses another session
+//  a caller holds a slot users count while it's inside a session call, remove waits until it's released
+//  slots grow by blocks up to MAX_LIVE_SESSIONS, lookups and insert are lock-free and could be called from any thread
+//  NOTE: a registry doesn't own sessions, a removed session is deleted by a caller
+
+class CAnimLiveBridgeRegistry
+{
+public:
+
+	CAnimLiveBridgeRegistry()
+	{
+		for (unsigned int i = 0; i < MAX_SESSION_BLOCKS; ++i)
+		{
+			m_Blocks[i].store(nullptr, std::memory_order_relaxed);
+		}
+		Grow(0);
+	}
+
+	~CAnimLiveBridgeRegistry()
+	{
+		for (unsigned int i = 0; i < MAX_SESSION_BLOCKS; ++i)
+		{
+			delete[] m_Blocks[i].load(std::memory_order_relaxed);
+		}
+	}
+
+	//! returns a handle of a new slot or INVALID_SESSION_HANDLE when all MAX_LIVE_SESSIONS slots are in use
+	unsigned int Insert(CAnimLiveBridgeSession* session)
+	{
+		while (true)
+		{
+			const unsigned int blocks_count = m_BlocksCount.load(std::memory_order_acquire);
+			const unsigned int slots_count = blocks_count * SESSION_BLOCK_SLOTS;
+
+			// round robin start, a freed slot is taken again as late as possible
+			const unsigned int start = m_NextSlot.fetch_add(1, std::memory_order_relaxed);
+
+			for (unsigned int i = 0; i < slots_count; ++i)
+			{
+				const unsigned int index = (start + i) % slots_count;
+				SSlot& slot = *GetSlot(index);
+
+				unsigned int state = slot.m_State.load(std::memory_order_relaxed);
+				if (IsUsed(state))
+					continue;
+
+				if (slot.m_State.compare_exchange_strong(state, state | 1u, std::memory_order_acquire, std::memory_order_relaxed))
+				{
+					slot.m_Session.store(session, std::memory_order_release);
+					return MakeHandle(index, GetGeneration(state));
+				}
+			}
+
+			if (blocks_count == MAX_SESSION_BLOCKS)
+				return INVALID_SESSION_HANDLE;
+
+			Grow(blocks_count);
+		}
+	}
+
+	//! lock-free lookup, an empty reference for a stale or an unknown handle
+	CSessionRef Acquire(const unsigned int handle)
+	{
+		SSlot* slot = GetSlot(handle & SESSION_HANDLE_INDEX_MASK);
+		if (slot == nullptr)
+			return CSessionRef();
+
+		// a users count goes before a state check, a remove changes a state before it waits for users
+		slot->m_Users.fetch_add(1, std::memory_order_seq_cst);
+
+		CAnimLiveBridgeSession* session = nullptr;
+
+		if (slot->m_State.load(std::memory_order_seq_cst) == MakeState(handle >> SESSION_HANDLE_INDEX_BITS, true))
+		{
+			session = slot->m_Session.load(std::memory_order_acquire);
+		}
+
+		if (session == nullptr)
+		{
+			slot->m_Users.fetch_sub(1, std::memory_order_release);
+			return CSessionRef();
+		}
+		return CSessionRef(session, &slot->m_Users);
+	}
+
+	//! detach a session from a slot, nullptr if a handle is stale or it's already removed
+	/*!
+		waits until other threads release their references, a caller must not hold one of the same session
+	*/
+	CAnimLiveBridgeSession* Remove(const unsigned int handle)
+	{
+		SSlot* slot = GetSlot(handle & SESSION_HANDLE_INDEX_MASK);
+		if (slot == nullptr)
+			return nullptr;
+
+		const unsigned int generation = handle >> SESSION_HANDLE_INDEX_BITS;
+		unsigned int state = MakeState(generation, true);
+
+		// a next generation is still marked as used, a slot is not taken until a session pointer is detached
+		const unsigned int next_generation = NextGeneration(generation);
+		if (!slot->m_State.compare_exchange_strong(state, MakeState(next_generation, true), std::memory_order_seq_cst, std::memory_order_relaxed))
+			return nullptr;
+
+		// new lookups fail from now on, calls which are already inside a session finish first
+		while (slot->m_Users.load(std::memory_order_acquire) != 0)
+		{
+			std::this_thread::yield();
+		}
+
+		CAnimLiveBridgeSession* session = slot->m_Session.exchange(nullptr, std::memory_order_acq_rel);
+		slot->m_State.store(MakeState(next_generation, false), std::memory_order_release);
+
+		return session;
+	}
+
+	//! visit every used slot, a visited session is referenced during a call
+	template<typename F>
+	void ForEach(F&& func)
+	{
+		const unsigned int slots_count = m_BlocksCount.load(std::memory_order_acquire) * SESSION_BLOCK_SLOTS;
+
+		for (unsigned int i = 0; i < slots_count; ++i)
+		{
+			const unsigned int state = GetSlot(i)->m_State.load(std::memory_order_acquire);
+			if (!IsUsed(state))
+				continue;
+
+			const unsigned int handle = MakeHandle(i, GetGeneration(state));
+
+			if (CSessionRef session = Acquire(handle))
+				func(handle, session.Get());
+		}
+	}
+
+protected:
+
+	struct SSlot
+	{
+		std::atomic<unsigned int>				m_State{ 0 };		//!< generation << 1 | used bit
+		std::atomic<CAnimLiveBridgeSession*>	m_Session{ nullptr };
+		std::atomic<unsigned int>				m_Users{ 0 };		//!< callers which are inside a session call
+	};
+
+	std::atomic<SSlot*>			m_Blocks[MAX_SESSION_BLOCKS];
+	std::atomic<unsigned int>	m_BlocksCount{ 0 };
+	std::atomic<unsigned int>	m_NextSlot{ 0 };
+
+	SSlot* GetSlot(const unsigned int index) const
+	{
+		const unsigned int block = index / SESSION_BLOCK_SLOTS;
+		if (block >= m_BlocksCount.load(std::memory_order_acquire))
+			return nullptr;
+
+		return m_Blocks[block].load(std::memory_order_acquire) + index % SESSION_BLOCK_SLOTS;
+	}
+
+	// a block is published before a blocks count, so a counted block is always there
+	void Grow(const unsigned int blocks_count)
+	{
+		SSlot* block = new SSlot[SESSION_BLOCK_SLOTS];
+		for (unsigned int i = 0; i < SESSION_BLOCK_SLOTS; ++i)
+		{
+			block[i].m_State.store(MakeState(1, false), std::memory_order_relaxed);
+		}
+
+		SSlot* expected = nullptr;
+		if (!m_Blocks[blocks_count].compare_exchange_strong(expected, block, std::memory_order_acq_rel))
+			delete[] block;
+
+		unsigned int count = blocks_count;
+		m_BlocksCount.compare_exchange_strong(count, blocks_count + 1, std::memory_order_acq_rel);
+	}
+
+	static unsigned int MakeState(const unsigned int generation, const bool used) { return (generation << 1) | ((used) ? 1u : 0u); }
+	static bool IsUsed(const unsigned int state) { return (state & 1u) != 0; }
+	static unsigned int GetGeneration(const unsigned int state) { return state >> 1; }
+
+	// generation 0 is skipped, so a handle is never INVALID_SESSION_HANDLE
+	static unsigned int NextGeneration(const unsigned int generation)
+	{
+		const unsigned int next = (generation + 1) & SESSION_HANDLE_GENERATION_MASK;
+		return (next != 0) ? next : 1;
+	}
+
+	static unsigned int MakeHandle(const unsigned int index, const unsigned int generation)
+	{
+		return (generation << SESSION_HANDLE_INDEX_BITS) | index;
+	}
+};
@@ -26,9 +26,418 @@
 
 #include "AnimLiveBridgeSession.h"
 #include "AnimLiveBridgeSharedMemory.h"
+#include "AnimLiveBridgeNetwork.h"
+#include "AnimLiveBridgeMulticast.h"
+#include "AnimLiveBridgeIOThread.h"
+#include "AnimLiveBridgeTake.h"
+#include "AnimLiveBridgeJitterBuffer.h"
+#include <cstring>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+	#include <immintrin.h>
+#endif
+
+const int DEFAULT_WAIT_SPIN_COUNT = 2000;
+const int DEFAULT_WAIT_YIELD_COUNT = 50;
+
+// let a sibling hyper-thread run while we are busy polling
+static inline void CpuRelax()
+{
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+	_mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+	__asm__ __volatile__("yield");
+#endif
+}
+
+////////////////////////////////////////////////////////////////
+// CAnimLiveBridgeHardware
+
+int CAnimLiveBridgeHardware::WaitForFrame(const unsigned int timeout_ms)
+{
+	if (!IsOpen())
+		return -3;
+
+	if (PollFrame())
+		return 0;
+
+	if (timeout_ms == 0)
+		return -1;
+
+	CAnimLiveBridgeSession* session = GetSessionPtr();
+	const int strategy = session->GetPropertyInt(ELiveSessionProperty_WaitStrategy);
+	const int spin_count = session->GetPropertyInt(ELiveSessionProperty_WaitSpinCount);
+	const int yield_count = session->GetPropertyInt(ELiveSessionProperty_WaitYieldCount);
+
+	const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+
+	if (strategy == EWaitStrategy_Spin)
+	{
+		while (std::chrono::steady_clock::now() < deadline)
+		{
+			if (PollFrame())
+				return 0;
+			CpuRelax();
+		}
+		return -1;
+	}
+
+	if (strategy == EWaitStrategy_Hybrid)
+	{
+		// a frame is usually microseconds away when a remote side is streaming
+		const int spins = (spin_count > 0) ? spin_count : DEFAULT_WAIT_SPIN_COUNT;
+		for (int i = 0; i < spins; ++i)
+		{
+			if (PollFrame())
+				return 0;
+			CpuRelax();
+		}
+
+		const int yields = (yield_count > 0) ? yield_count : DEFAULT_WAIT_YIELD_COUNT;
+		for (int i = 0; i < yields; ++i)
+		{
+			if (PollFrame())
+				return 0;
+			std::this_thread::yield();
+		}
+	}
+
+	// remote side is idle, don't burn a core
+	while (true)
+	{
+		const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		if (now >= deadline)
+			return -1;
+
+		const long long remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count();
+		if (ParkForFrame(static_cast<unsigned int>((remaining > 0) ? remaining : 1)))
+			return 0;
+	}
+}
+
+CLiveSessionStats& CAnimLiveBridgeHardware::GetStats()
+{
+	return m_Session->GetStats();
+}
+
+bool CAnimLiveBridgeHardware::ParkForFrame(const unsigned int timeout_ms)
+{
+	// no kernel primitive to block on, sleep in small steps
+	std::this_thread::sleep_for(std::chrono::milliseconds((timeout_ms < 1) ? timeout_ms : 1));
+	return PollFrame();
+}
+
+void CAnimLiveBridgeHardware::WriteClientFeedback(SSharedModelData& feedback)
+{
+	CAnimLiveBridgeSession* session = GetSessionPtr();
+
+	feedback.m_Header.m_ClientTag = session->GetDataPtr()->m_Header.m_ClientTag;
+
+	// look at pos
+	feedback.m_LookAtRoot[0] = session->m_LookAtRootPos.m_X;
+	feedback.m_LookAtRoot[1] = session->m_LookAtRootPos.m_Y;
+	feedback.m_LookAtRoot[2] = session->m_LookAtRootPos.m_Z;
+	feedback.m_LookAtRoot[3] = (session->m_SyncSaved) ? 1.0f : 0.0f;
+
+	feedback.m_LookAtLeft[0] = session->m_LookAtLeftPos.m_X;
+	feedback.m_LookAtLeft[1] = session->m_LookAtLeftPos.m_Y;
+	feedback.m_LookAtLeft[2] = session->m_LookAtLeftPos.m_Z;
+
+	feedback.m_LookAtRight[0] = session->m_LookAtRightPos.m_X;
+	feedback.m_LookAtRight[1] = session->m_LookAtRightPos.m_Y;
+	feedback.m_LookAtRight[2] = session->m_LookAtRightPos.m_Z;
+
+	session->m_SyncSaved = false;
+}
+
+void CAnimLiveBridgeHardware::ReadClientFeedback(SSharedModelData& feedback)
+{
+	CAnimLiveBridgeSession* session = GetSessionPtr();
+	SSharedModelData* local_data = session->GetDataPtr();
+
+	session->GetTimelinePtr()->ReadFromData(false, feedback);
+
+	// check if we have sync event from client
+	if (feedback.m_LookAtRoot[3] == 1.0f)
+	{
+		session->m_HasNewSync = true;
+		feedback.m_LookAtRoot[3] = 0.0f;
+	}
+
+	memcpy(&session->m_LookAtRootPos.m_X, feedback.m_LookAtRoot, sizeof(float) * 4);
+	memcpy(&session->m_LookAtLeftPos.m_X, feedback.m_LookAtLeft, sizeof(float) * 4);
+	memcpy(&session->m_LookAtRightPos.m_X, feedback.m_LookAtRight, sizeof(float) * 4);
+
+	memcpy(local_data->m_LookAtRoot, feedback.m_LookAtRoot, sizeof(float) * 4);
+	memcpy(local_data->m_LookAtLeft, feedback.m_LookAtLeft, sizeof(float) * 4);
+	memcpy(local_data->m_LookAtRight, feedback.m_LookAtRight, sizeof(float) * 4);
+
+	local_data->m_Header.m_ClientTag = feedback.m_Header.m_ClientTag;
+}
+
+////////////////////////////////////////////////////////////////
+// variable-length frame
+
+static void ClampRange(unsigned int& start, unsigned int& count, const unsigned int total)
+{
+	if (start > total)
+		start = total;
+	if (count > total - start)
+		count = total - start;
+}
+
+void ValidateFrameLayout(SSharedModelData& data, const unsigned int joints_capacity, const unsigned int props_capacity, const unsigned int entities_capacity)
+{
+	const size_t props_offset = MODEL_DATA_PREFIX_SIZE + sizeof(SJointData) * joints_capacity;
+	const size_t entities_offset = props_offset + sizeof(SPropertyData) * props_capacity;
+
+	data.m_Header.m_ModelsOffset = static_cast<unsigned int>(MODEL_DATA_PREFIX_SIZE);
+	data.m_Header.m_PropsOffset = static_cast<unsigned int>(props_offset);
+	data.m_Header.m_EntitiesOffset = (entities_capacity > 0) ? static_cast<unsigned int>(entities_offset) : 0;
+
+	if (data.m_Header.m_ModelsCount > joints_capacity)
+		data.m_Header.m_ModelsCount = joints_capacity;
+	if (data.m_Header.m_PropsCount > props_capacity)
+		data.m_Header.m_PropsCount = props_capacity;
+	if (data.m_Header.m_EntitiesCount > entities_capacity)
+		data.m_Header.m_EntitiesCount = entities_capacity;
+
+	// a reader can trust entity ranges without checking them against counts
+	SEntityBlock* entities = GetModelEntities(&data);
+	for (unsigned int i = 0; i < data.m_Header.m_EntitiesCount; ++i)
+	{
+		ClampRange(entities[i].m_JointsStart, entities[i].m_JointsCount, data.m_Header.m_ModelsCount);
+		ClampRange(entities[i].m_PropsStart, entities[i].m_PropsCount, data.m_Header.m_PropsCount);
+	}
+}
+
+size_t CopyFrameData(SSharedModelData* dst, const SSharedModelData* src, const unsigned int joints_capacity, const unsigned int props_capacity,
+	const unsigned int entities_capacity)
+{
+	// a source could be a shared slot which is being written, counts are clamped before use
+	const unsigned int joints_count = (src->m_Header.m_ModelsCount < joints_capacity) ? src->m_Header.m_ModelsCount : joints_capacity;
+	const unsigned int props_count = (src->m_Header.m_PropsCount < props_capacity) ? src->m_Header.m_PropsCount : props_capacity;
+	const unsigned int entities_count = (src->m_Header.m_EntitiesCount < entities_capacity) ? src->m_Header.m_EntitiesCount : entities_capacity;
+
+	const size_t props_offset = MODEL_DATA_PREFIX_SIZE + sizeof(SJointData) * joints_capacity;
+	const size_t entities_offset = props_offset + sizeof(SPropertyData) * props_capacity;
+
+	char* dst_ptr = reinterpret_cast<char*>(dst);
+	const char* src_ptr = reinterpret_cast<const char*>(src);
+
+	memcpy(dst, src, MODEL_DATA_PREFIX_SIZE);
+	memcpy(dst_ptr + MODEL_DATA_PREFIX_SIZE, src_ptr + MODEL_DATA_PREFIX_SIZE, sizeof(SJointData) * joints_count);
+	memcpy(dst_ptr + props_offset, src_ptr + props_offset, sizeof(SPropertyData) * props_count);
+	memcpy(dst_ptr + entities_offset, src_ptr + entities_offset, sizeof(SEntityBlock) * entities_count);
+
+	ValidateFrameLayout(*dst, joints_capacity, props_capacity, entities_capacity);
+
+	return MODEL_DATA_PREFIX_SIZE + sizeof(SJointData) * joints_count + sizeof(SPropertyData) * props_count + sizeof(SEntityBlock) * entities_count;
+}
+
+////////////////////////////////////////////////////////////////
+// CJointSchema
+
+static inline unsigned int HashSchemaEntry(unsigned int hash, const SJointSchemaEntry& entry)
+{
+	const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&entry);
+
+	for (size_t i = 0; i < sizeof(SJointSchemaEntry); ++i)
+	{
+		hash = (hash ^ bytes[i]) * NAME_HASH_PRIME;
+	}
+	return hash;
+}
+
+// 0 is kept for no joints
+static inline unsigned int FinishSchemaId(const unsigned int hash)
+{
+	return (hash != 0) ? hash : 1;
+}
+
+unsigned int ComputeJointSchemaId(const SJointData* joints, const unsigned int count)
+{
+	if (count == 0)
+		return 0;
+
+	unsigned int hash = NAME_HASH_BASIS;
+
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		const SJointSchemaEntry entry{ joints[i].m_NameHash, joints[i].m_ParentHash, joints[i].m_Flags };
+		hash = HashSchemaEntry(hash, entry);
+	}
+	return FinishSchemaId(hash);
+}
+
+void CJointSchema::Clear()
+{
+	m_Joints.clear();
+	m_Id = 0;
+}
+
+bool CJointSchema::Update(const SJointData* joints, const unsigned int count)
+{
+	bool changed = (count != m_Joints.size());
+
+	for (unsigned int i = 0; i < count && !changed; ++i)
+	{
+		const SJointSchemaEntry& entry = m_Joints[i];
+		changed = entry.m_NameHash != joints[i].m_NameHash || entry.m_ParentHash != joints[i].m_ParentHash || entry.m_Flags != joints[i].m_Flags;
+	}
+
+	if (!changed)
+		return false;
+
+	m_Joints.resize(count);
+
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		m_Joints[i].m_NameHash = joints[i].m_NameHash;
+		m_Joints[i].m_ParentHash = joints[i].m_ParentHash;
+		m_Joints[i].m_Flags = joints[i].m_Flags;
+	}
+	m_Id = ComputeJointSchemaId(joints, count);
+	return true;
+}
+
+void CJointSchema::Apply(SJointData* joints) const
+{
+	for (size_t i = 0; i < m_Joints.size(); ++i)
+	{
+		joints[i].m_NameHash = m_Joints[i].m_NameHash;
+		joints[i].m_ParentHash = m_Joints[i].m_ParentHash;
+		joints[i].m_Flags = m_Joints[i].m_Flags;
+	}
+}
+
+size_t CJointSchema::WriteBlock(char* buffer) const
+{
+	const unsigned int count = GetJointsCount();
+
+	memcpy(buffer, &count, sizeof(unsigned int));
+	memcpy(buffer + sizeof(unsigned int), m_Joints.data(), sizeof(SJointSchemaEntry) * count);
+	return GetBlockSize();
+}
+
+size_t CJointSchema::ReadBlock(const char* buffer, const size_t size)
+{
+	unsigned int count = 0;
+	if (size < sizeof(unsigned int))
+		return 0;
+
+	memcpy(&count, buffer, sizeof(unsigned int));
+
+	const size_t block_size = sizeof(unsigned int) + sizeof(SJointSchemaEntry) * static_cast<size_t>(count);
+	if (block_size > size)
+		return 0;
+
+	m_Joints.resize(count);
+	memcpy(m_Joints.data(), buffer + sizeof(unsigned int), sizeof(SJointSchemaEntry) * count);
+
+	unsigned int hash = NAME_HASH_BASIS;
+
+	for (const SJointSchemaEntry& entry : m_Joints)
+	{
+		hash = HashSchemaEntry(hash, entry);
+	}
+	m_Id = (count > 0) ? FinishSchemaId(hash) : 0;
+	return block_size;
+}
+
+////////////////////////////////////////////////////////////////
+// SFrameBuffer
+
+void SFrameBuffer::Resize(const unsigned int joints_capacity, const unsigned int props_capacity, const unsigned int entities_capacity)
+{
+	if (m_Data && joints_capacity == m_JointsCapacity && props_capacity == m_PropsCapacity && entities_capacity == m_EntitiesCapacity)
+		return;
+
+	size_t frame_size = ComputeFrameSize(joints_capacity, props_capacity, entities_capacity);
+	if (frame_size < sizeof(SSharedModelData))
+		frame_size = sizeof(SSharedModelData);
+
+	std::shared_ptr<std::vector<unsigned long long>> storage =
+		std::make_shared<std::vector<unsigned long long>>((frame_size + sizeof(unsigned long long) - 1) / sizeof(unsigned long long), 0);
+	SSharedModelData* data = reinterpret_cast<SSharedModelData*>(storage->data());
+
+	if (m_Data)
+	{
+		const unsigned int joints_count = (m_Data->m_Header.m_ModelsCount < joints_capacity) ? m_Data->m_Header.m_ModelsCount : joints_capacity;
+		const unsigned int props_count = (m_Data->m_Header.m_PropsCount < props_capacity) ? m_Data->m_Header.m_PropsCount : props_capacity;
+		const unsigned int entities_count = (m_Data->m_Header.m_EntitiesCount < entities_capacity) ? m_Data->m_Header.m_EntitiesCount : entities_capacity;
+
+		memcpy(data, m_Data, MODEL_DATA_PREFIX_SIZE);
+		data->m_Header.m_EntitiesCount = 0;
+		ValidateFrameLayout(*data, joints_capacity, props_capacity, entities_capacity);
+
+		memcpy(GetModelJoints(data), GetModelJoints(m_Data), sizeof(SJointData) * joints_count);
+		memcpy(GetModelProperties(data), GetModelProperties(m_Data), sizeof(SPropertyData) * props_count);
+
+		if (entities_count > 0)
+		{
+			memcpy(GetModelEntities(data), GetModelEntities(m_Data), sizeof(SEntityBlock) * entities_count);
+			data->m_Header.m_EntitiesCount = entities_count;
+		}
+	}
+	else
+	{
+		ValidateFrameLayout(*data, joints_capacity, props_capacity, entities_capacity);
+	}
+
+	m_Storage = std::move(storage);
+	m_Data = data;
+	m_JointsCapacity = joints_capacity;
+	m_PropsCapacity = props_capacity;
+	m_EntitiesCapacity = entities_capacity;
+}
+
+void SFrameBuffer::CopyFrom(const SFrameBuffer& other)
+{
+	if (m_Data && other.m_JointsCapacity == m_JointsCapacity && other.m_PropsCapacity == m_PropsCapacity && other.m_EntitiesCapacity == m_EntitiesCapacity)
+	{
+		CopyFrameData(m_Data, other.m_Data, m_JointsCapacity, m_PropsCapacity, m_EntitiesCapacity);
+		return;
+	}
+
+	// a new capacity, nothing to keep from a previous frame
+	m_Data = nullptr;
+	Resize(other.m_JointsCapacity, other.m_PropsCapacity, other.m_EntitiesCapacity);
+	CopyFrameData(m_Data, other.m_Data, m_JointsCapacity, m_PropsCapacity, m_EntitiesCapacity);
+}
+
+////////////////////////////////////////////////////////////////
+// CAnimLiveBridgeSession
 
 CAnimLiveBridgeSession::CAnimLiveBridgeSession()
 {
+	ResizeFrame(NUMBER_OF_JOINTS, NUMBER_OF_PROPERTIES, 0);
+}
+
+void CAnimLiveBridgeSession::ResizeFrame(const unsigned int joints_capacity, const unsigned int props_capacity, const unsigned int entities_capacity)
+{
+	m_Frame.Resize(joints_capacity, props_capacity, entities_capacity);
+
+	m_PropertiesInt[ELiveSessionProperty_JointsCapacity] = static_cast<int>(joints_capacity);
+	m_PropertiesInt[ELiveSessionProperty_PropsCapacity] = static_cast<int>(props_capacity);
+	m_PropertiesInt[ELiveSessionProperty_EntitiesCapacity] = static_cast<int>(entities_capacity);
+}
+
+void CAnimLiveBridgeSession::ReserveFrame(const unsigned int joints_capacity, const unsigned int props_capacity, const unsigned int entities_capacity)
+{
+	const unsigned int joints = GetJointsCapacity();
+	const unsigned int props = GetPropsCapacity();
+	const unsigned int entities = GetEntitiesCapacity();
+
+	if (joints_capacity > joints || props_capacity > props || entities_capacity > entities)
+	{
+		ResizeFrame((joints_capacity > joints) ? joints_capacity : joints,
+			(props_capacity > props) ? props_capacity : props,
+			(entities_capacity > entities) ? entities_capacity : entities);
+	}
 }
 
 CAnimLiveBridgeSession::~CAnimLiveBridgeSession()
@@ -38,16 +447,84 @@ CAnimLiveBridgeSession::~CAnimLiveBridgeSession()
 
 int CAnimLiveBridgeSession::Open(const char* pair_name, const bool is_server)
 {
+	StopIOThread();
+
+	const int joints_capacity = m_PropertiesInt[ELiveSessionProperty_JointsCapacity];
+	const int props_capacity = m_PropertiesInt[ELiveSessionProperty_PropsCapacity];
+	const int entities_capacity = m_PropertiesInt[ELiveSessionProperty_EntitiesCapacity];
+
+	ResizeFrame((joints_capacity > 0) ? static_cast<unsigned int>(joints_capacity) : static_cast<unsigned int>(NUMBER_OF_JOINTS),
+		(props_capacity > 0) ? static_cast<unsigned int>(props_capacity) : static_cast<unsigned int>(NUMBER_OF_PROPERTIES),
+		(entities_capacity > 0) ? static_cast<unsigned int>(entities_capacity) : 0);
+
+	// a new connection gets a channels layout with a first frame
+	m_ChannelLayoutSent = false;
+	m_ChannelFrames = 0;
+	m_ClockSync.Reset();
+
 	if (!m_Hardware)
 	{
-		m_Hardware = new CAnimLiveBridgeSharedMemory(this);
+		switch (static_cast<ECommunicationType>(m_PropertiesInt[ELiveSessionProperty_CommunicationType]))
+		{
+		case ECommunicationType::NetworkTCP:
+			m_Hardware = new CAnimLiveBridgeNetwork(this);
+			break;
+		case ECommunicationType::NetworkUDP:
+			m_Hardware = new CAnimLiveBridgeMulticast(this);
+			break;
+		default:
+			m_Hardware = new CAnimLiveBridgeSharedMemory(this);
+		}
 	}
 
-	return (m_Hardware) ? m_Hardware->Open(pair_name, is_server) : -1;
+	m_PropertiesString[ELiveSessionProperty_SharedPairName] = pair_name;
+	m_PropertiesInt[ELiveSessionProperty_IsServer] = (is_server) ? 1 : 0;
+
+	const int result = (m_Hardware) ? m_Hardware->Open(pair_name, is_server) : -1;
+
+	const int jitter_delay = m_PropertiesInt[ELiveSessionProperty_JitterBufferDelay];
+
+	if (result == 0 && !is_server && jitter_delay > 0)
+	{
+		if (!m_JitterBuffer)
+			m_JitterBuffer = new CAnimLiveBridgeJitterBuffer();
+
+		m_JitterBuffer->Clear();
+		m_JitterBuffer->Configure(0.001 * static_cast<double>(jitter_delay), m_PropertiesInt[ELiveSessionProperty_JitterBufferInterpolation]);
+	}
+
+	if (result == 0 && m_PropertiesInt[ELiveSessionProperty_IOThread] != 0)
+	{
+		m_IOThread = new CAnimLiveBridgeIOThread(this, m_Hardware);
+		m_IOThread->Start(is_server, m_PropertiesInt[ELiveSessionProperty_IOThreadAffinity], 
+			m_PropertiesInt[ELiveSessionProperty_IOThreadPriority]);
+	}
+	return result;
+}
+
+void CAnimLiveBridgeSession::StopIOThread()
+{
+	if (m_IOThread)
+	{
+		m_IOThread->Stop();
+
+		delete m_IOThread;
+		m_IOThread = nullptr;
+	}
 }
 
 int CAnimLiveBridgeSession::Close()
 {
+	StopReplay();
+	StopRecording();
+	StopIOThread();
+
+	if (m_JitterBuffer)
+	{
+		delete m_JitterBuffer;
+		m_JitterBuffer = nullptr;
+	}
+
 	if (m_Hardware)
 	{
 		m_Hardware->Close();
@@ -67,10 +544,309 @@ bool CAnimLiveBridgeSession::IsOpen() const
 
 int CAnimLiveBridgeSession::Commit(const bool auto_finish_event) 
 { 
-	return (m_Hardware) ? m_Hardware->Commit(auto_finish_event) : -1; 
+	const unsigned long long start = CLiveSessionStats::Now();
+	int result = -1;
+
+	// channels go in place of properties, a layout goes with a first frame and is repeated for a late reader
+	const bool has_channels = m_WriteChannels.HasLayout();
+	const bool include_layout = has_channels && (!m_ChannelLayoutSent || m_ChannelFrames % CHANNEL_LAYOUT_INTERVAL == 0);
+
+	// a block which doesn't fit leaves a frame as it is, nothing goes out and a layout stays unsent
+	if (has_channels && m_WriteChannels.WriteBlock(GetUserFrame(), include_layout) != 0)
+	{
+		m_Stats.OnCommit(-5, start);
+		return -5;
+	}
+
+	// a server frame carries its commit time for any transport, a client jitter buffer maps it to its own clock
+	if (m_PropertiesInt[ELiveSessionProperty_IsServer] != 0)
+	{
+		GetUserFrame().m_Data->m_ServerPlayer.m_SystemTime = 1e-9 * static_cast<double>(start);
+	}
+
+	if (m_IOThread)
+	{
+		result = m_IOThread->Commit();
+	}
+	else
+	{
+		ValidateFrameLayout(*m_Frame.m_Data, m_Frame.m_JointsCapacity, m_Frame.m_PropsCapacity, m_Frame.m_EntitiesCapacity);
+		result = (m_Hardware) ? m_Hardware->Commit(auto_finish_event) : -1;
+
+		// an io thread feeds a jitter buffer on its own exchange
+		if (result == 0 && m_JitterBuffer)
+			OnFrameReceived(*m_Frame.m_Data);
+	}
+
+	m_Stats.OnCommit(result, start);
+
+	if (result == 0 && has_channels)
+	{
+		m_ChannelLayoutSent |= include_layout;
+		++m_ChannelFrames;
+	}
+
+	if (result == 0 && m_TakeWriter.load(std::memory_order_acquire))
+	{
+		std::lock_guard<std::mutex> lock(m_TakeLock);
+
+		if (CAnimLiveBridgeTakeWriter* writer = m_TakeWriter.load(std::memory_order_relaxed))
+			writer->Append(*GetUserFrame().m_Data);
+	}
+	return result;
+}
+
+int CAnimLiveBridgeSession::StartRecording(const char* file_name)
+{
+	std::lock_guard<std::mutex> lock(m_TakeLock);
+
+	CAnimLiveBridgeTakeWriter* writer = m_TakeWriter.load(std::memory_order_relaxed);
+	if (!writer)
+		writer = new CAnimLiveBridgeTakeWriter();
+
+	const int result = writer->Open(file_name);
+	m_TakeWriter.store((result == 0) ? writer : nullptr, std::memory_order_release);
+
+	if (result != 0)
+	{
+		delete writer;
+
+		if (g_VerboseLevel && g_Logger)
+		{
+			std::string info("[TakeRecording] failed to create a take file ");
+			info += file_name;
+
+			g_Logger->LogError(info.c_str());
+		}
+	}
+	return result;
+}
+
+int CAnimLiveBridgeSession::StopRecording()
+{
+	std::lock_guard<std::mutex> lock(m_TakeLock);
+
+	CAnimLiveBridgeTakeWriter* writer = m_TakeWriter.exchange(nullptr, std::memory_order_acq_rel);
+	if (!writer)
+		return -1;
+
+	const int frames_count = writer->Close();
+
+	delete writer;
+	return frames_count;
+}
+
+int CAnimLiveBridgeSession::StartReplay(const char* file_name, const double speed, const bool loop)
+{
+	if (!m_TakeReplay)
+		m_TakeReplay = new CAnimLiveBridgeTakeReplay(this);
+
+	const int result = m_TakeReplay->Start(file_name, speed, loop);
+	if (result != 0)
+	{
+		StopReplay();
+	}
+	return result;
+}
+
+void CAnimLiveBridgeSession::StopReplay()
+{
+	if (m_TakeReplay)
+	{
+		m_TakeReplay->Stop();
+
+		delete m_TakeReplay;
+		m_TakeReplay = nullptr;
+	}
 }
 
 int CAnimLiveBridgeSession::ManualPostCommitFinish() 
 { 
+	// a worker always finishes a commit event on its own
+	if (m_IOThread)
+		return 0;
+
 	return (m_Hardware) ? m_Hardware->ManualPostCommitFinish() : -1; 
-}
\ No newline at end of file
+}
+
+int CAnimLiveBridgeSession::WaitForFrame(const unsigned int timeout_ms)
+{
+	const unsigned long long start = CLiveSessionStats::Now();
+	int result = -3;
+
+	if (m_IOThread)
+	{
+		result = m_IOThread->WaitForFrame(timeout_ms);
+	}
+	else if (m_Hardware)
+	{
+		result = m_Hardware->WaitForFrame(timeout_ms);
+	}
+
+	m_Stats.OnWait(result, start);
+	return result;
+}
+
+SFrameBuffer& CAnimLiveBridgeSession::GetUserFrame()
+{
+	return (m_IOThread) ? m_IOThread->GetUserFrame() : m_Frame;
+}
+
+void CAnimLiveBridgeSession::SetFrameCallback(LiveBridgeFrameCallback callback, void* user_data, const unsigned int session_id)
+{
+	std::lock_guard<std::mutex> lock(m_CallbackLock);
+
+	m_FrameCallback = callback;
+	m_FrameCallbackData = user_data;
+	m_FrameCallbackId = session_id;
+}
+
+void CAnimLiveBridgeSession::NotifyFrameReady()
+{
+	LiveBridgeFrameCallback callback = nullptr;
+	void* user_data = nullptr;
+	unsigned int session_id = 0;
+	bool has_event = false;
+	{
+		std::lock_guard<std::mutex> lock(m_CallbackLock);
+
+		callback = m_FrameCallback;
+		user_data = m_FrameCallbackData;
+		session_id = m_FrameCallbackId;
+		has_event = m_FrameReadyEvent.IsOpen();
+	}
+
+	// an event handle is closed only with a session, after an io thread is stopped
+	if (has_event)
+		m_FrameReadyEvent.Signal();
+
+	// outside of a lock, a callback is free to assign another one
+	if (callback)
+		callback(session_id, user_data);
+}
+
+long long CAnimLiveBridgeSession::GetFrameReadyHandle()
+{
+	std::lock_guard<std::mutex> lock(m_CallbackLock);
+	return m_FrameReadyEvent.Open();
+}
+
+int CAnimLiveBridgeSession::ResetFrameReadyHandle()
+{
+	return m_FrameReadyEvent.Reset();
+}
+
+void CAnimLiveBridgeSession::SetPropertyInt(const unsigned int property_id, const int value)
+{
+	if (property_id < ELiveSessionProperty_Count)
+		m_PropertiesInt[property_id] = value;
+}
+
+void CAnimLiveBridgeSession::SetPropertyString(const unsigned int property_id, const char* value)
+{
+	if (property_id < ELiveSessionProperty_Count)
+		m_PropertiesString[property_id] = (value) ? value : "";
+}
+
+int CAnimLiveBridgeSession::GetPropertyInt(const unsigned int property_id) const
+{
+	return (property_id < ELiveSessionProperty_Count) ? m_PropertiesInt[property_id] : 0;
+}
+
+const char* CAnimLiveBridgeSession::GetPropertyString(const unsigned int property_id) const
+{
+	return (property_id < ELiveSessionProperty_Count) ? m_PropertiesString[property_id].c_str() : nullptr;
+}
+
+// zero-copy slots are owned by a worker in an io thread mode
+
+SSharedModelData* CAnimLiveBridgeSession::AcquireWriteSlot()
+{
+	return (m_Hardware && !m_IOThread) ? m_Hardware->AcquireWriteSlot() : nullptr;
+}
+
+int CAnimLiveBridgeSession::PublishWriteSlot(const bool auto_finish_event)
+{
+	return (m_Hardware && !m_IOThread) ? m_Hardware->PublishWriteSlot(auto_finish_event) : -1;
+}
+
+const SSharedModelData* CAnimLiveBridgeSession::AcquireReadView()
+{
+	const SSharedModelData* view = (m_Hardware && !m_IOThread) ? m_Hardware->AcquireReadView() : nullptr;
+
+	if (view && m_JitterBuffer)
+		OnFrameReceived(*view);
+
+	return view;
+}
+
+void CAnimLiveBridgeSession::OnFrameReceived(const SSharedModelData& data)
+{
+	if (m_JitterBuffer)
+	{
+		// a synced clock maps a sender stamp exactly, a jitter buffer estimates a mapping on its own otherwise
+		const double sender_time = data.m_ServerPlayer.m_SystemTime;
+		const double send_time = (sender_time > 0.0 && m_ClockSync.IsSynced()) ? m_ClockSync.ToLocalTime(sender_time) : 0.0;
+
+		m_JitterBuffer->Push(data, GetJointsCapacity(), GetPropsCapacity(), GetEntitiesCapacity(), 1e-9 * static_cast<double>(CLiveSessionStats::Now()), send_time);
+	}
+}
+
+const SSharedModelData* CAnimLiveBridgeSession::SampleFrame(const double time)
+{
+	return (m_JitterBuffer) ? m_JitterBuffer->Sample(time) : nullptr;
+}
+
+int CAnimLiveBridgeSession::SetChannelLayout(const unsigned int* name_hashes, const unsigned int* types, const unsigned int count)
+{
+	const int result = m_WriteChannels.SetLayout(name_hashes, types, count);
+	if (result != 0)
+		return result;
+
+	if (m_WriteChannels.GetBlockSize(true) > sizeof(SPropertyData) * GetUserFrame().m_PropsCapacity)
+	{
+		m_WriteChannels.SetLayout(nullptr, nullptr, 0);
+		return -5;
+	}
+
+	m_ChannelLayoutSent = false;
+	m_ChannelFrames = 0;
+	return 0;
+}
+
+int CAnimLiveBridgeSession::ConvertFrameSpace(const unsigned int space_hint)
+{
+	const SFrameBuffer& frame = GetUserFrame();
+	SSharedModelData* data = frame.m_Data;
+
+	SJointData* joints = GetModelJoints(data);
+	const unsigned int joints_count = (data->m_Header.m_ModelsCount < frame.m_JointsCapacity) ? data->m_Header.m_ModelsCount : frame.m_JointsCapacity;
+
+	const SEntityBlock* entities = GetModelEntities(data);
+	const unsigned int entities_count = (entities) ? std::min(data->m_Header.m_EntitiesCount, frame.m_EntitiesCapacity) : 0;
+
+	if (entities_count == 0)
+	{
+		m_Hierarchies.resize(1);
+		return m_Hierarchies[0].Convert(joints, joints_count, space_hint);
+	}
+
+	m_Hierarchies.resize(entities_count);
+
+	for (unsigned int i = 0; i < entities_count; ++i)
+	{
+		const SEntityBlock& entity = entities[i];
+		if (static_cast<unsigned long long>(entity.m_JointsStart) + entity.m_JointsCount > joints_count)
+			return -5;
+
+		const int result = m_Hierarchies[i].Convert(joints + entity.m_JointsStart, entity.m_JointsCount, space_hint);
+		if (result != 0)
+			return result;
+	}
+	return 0;
+}
+
+int CAnimLiveBridgeSession::ReleaseReadView(const bool auto_finish_event)
+{
+	return (m_Hardware && !m_IOThread) ? m_Hardware->ReleaseReadView(auto_finish_event) : -1;
+}
@@ -27,11 +27,103 @@
 */
 
 #include "AnimLiveBridge.h"
+#include "AnimLiveBridgeStats.h"
+#include "AnimLiveBridgeHierarchy.h"
+#include "AnimLiveBridgeChannels.h"
+#include "AnimLiveBridgeClock.h"
+#include "AnimLiveBridgeFrameEvent.h"
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <mutex>
+#include <memory>
+#include <atomic>
 
 const int NAME_SIZE = 64;
 
+// look at, player info and header, everything in front of joints
+const size_t MODEL_DATA_PREFIX_SIZE = offsetof(SSharedModelData, m_Joints);
+
+// variable-length frame - data prefix, joints[joints_capacity], properties[props_capacity], entities[entities_capacity]
+inline size_t ComputeFrameSize(const unsigned int joints_capacity, const unsigned int props_capacity, const unsigned int entities_capacity)
+{
+	return MODEL_DATA_PREFIX_SIZE + sizeof(SJointData) * joints_capacity + sizeof(SPropertyData) * props_capacity
+		+ sizeof(SEntityBlock) * entities_capacity;
+}
+
+//! assign frame offsets for a capacity and clamp counts and entity ranges to it
+void ValidateFrameLayout(SSharedModelData& data, const unsigned int joints_capacity, const unsigned int props_capacity, const unsigned int entities_capacity);
+//! copy only a used part of a frame, both frames have the same capacity, destination offsets are kept. Returns copied bytes
+size_t CopyFrameData(SSharedModelData* dst, const SSharedModelData* src, const unsigned int joints_capacity, const unsigned int props_capacity, 
+	const unsigned int entities_capacity);
+
+////////////////////////////////////////////////////////////////
+// SFrameBuffer
+//  variable-length frame storage, 8 bytes aligned and never smaller than a fixed SSharedModelData
+
+struct SFrameBuffer
+{
+	//! shared, so an external view (RetainModelDataBuffer) keeps a memory after a frame is reallocated
+	std::shared_ptr<std::vector<unsigned long long>>	m_Storage;
+	SSharedModelData*				m_Data{ nullptr };
+	unsigned int					m_JointsCapacity{ 0 };
+	unsigned int					m_PropsCapacity{ 0 };
+	unsigned int					m_EntitiesCapacity{ 0 };
+
+	//! reallocate a frame, used joints, properties and entities are kept. NOTE: a data pointer is changed
+	void Resize(const unsigned int joints_capacity, const unsigned int props_capacity, const unsigned int entities_capacity);
+	//! take a capacity and a used part of another frame
+	void CopyFrom(const SFrameBuffer& other);
+};
+
+////////////////////////////////////////////////////////////////
+// CJointSchema
+//  joint names, parents and flags of a stream, a network server sends them once and then only transforms
+
+struct SJointSchemaEntry
+{
+	unsigned int	m_NameHash;
+	unsigned int	m_ParentHash;
+	unsigned int	m_Flags;
+}; // 12 bytes
+
+//! FNV-1a over joint name hashes, parents and flags, 0 for no joints
+unsigned int ComputeJointSchemaId(const SJointData* joints, const unsigned int count);
+
+class CJointSchema
+{
+public:
+
+	unsigned int GetId() const { return m_Id; }
+	unsigned int GetJointsCount() const { return static_cast<unsigned int>(m_Joints.size()); }
+
+	void Clear();
+	//! take a layout of frame joints, returns true if it's different from a current one
+	bool Update(const SJointData* joints, const unsigned int count);
+	//! restore names, parents and flags of joints which came with transforms only
+	void Apply(SJointData* joints) const;
+
+	// wire block, joints count followed by entries
+	size_t GetBlockSize() const { return sizeof(unsigned int) + sizeof(SJointSchemaEntry) * m_Joints.size(); }
+	size_t WriteBlock(char* buffer) const;
+	//! returns a read size or 0 if a block doesn't fit into a given size
+	size_t ReadBlock(const char* buffer, const size_t size);
+
+protected:
+	std::vector<SJointSchemaEntry>	m_Joints;
+	unsigned int					m_Id{ 0 };
+};
+
+// log settings, defined in AnimLiveBridge.cpp and shared with hardware implementations
+extern int					g_VerboseLevel;
+extern CLiveBridgeLogger*	g_Logger;
+
 // forward
 class CAnimLiveBridgeSession;
+class CAnimLiveBridgeIOThread;
+class CAnimLiveBridgeTakeWriter;
+class CAnimLiveBridgeTakeReplay;
+class CAnimLiveBridgeJitterBuffer;
 
 //
 class CAnimLiveBridgeHardware
@@ -41,6 +133,8 @@ public:
 	CAnimLiveBridgeHardware(CAnimLiveBridgeSession* session)
 		: m_Session(session)
 	{}
+	//! a session deletes a transport through a base pointer
+	virtual ~CAnimLiveBridgeHardware() = default;
 
 	virtual int TypeId() const = 0;
 	virtual const char* TypeStr() const = 0;
@@ -56,13 +150,33 @@ public:
 	virtual int Commit(const bool auto_finish_event) { return - 1; }
 	virtual int ManualPostCommitFinish() { return -1; }
 
+	//! spin, yield and then park until a frame is ready to commit, 0 if ready, -1 on timeout, -3 if not open
+	int WaitForFrame(const unsigned int timeout_ms);
+
+	// zero-copy access, a slot is living directly inside a transport buffer
+	virtual SSharedModelData* AcquireWriteSlot() { return nullptr; }
+	virtual int PublishWriteSlot(const bool auto_finish_event) { return -1; }
+	virtual const SSharedModelData* AcquireReadView() { return nullptr; }
+	virtual int ReleaseReadView(const bool auto_finish_event) { return -1; }
+
 	CAnimLiveBridgeSession* GetSessionPtr() { return m_Session; }
+	CLiveSessionStats& GetStats();
 
 protected:
 	bool			m_IsServer{ true };
 	char			m_PairName[NAME_SIZE]{ 0 };
 
 	CAnimLiveBridgeSession*	m_Session{ nullptr };
+
+	// non-blocking check that a next commit has a frame to exchange (server turn or a new client frame)
+	virtual bool PollFrame() { return false; }
+	// block in a kernel primitive up to a timeout, returns a frame state the same way as PollFrame
+	virtual bool ParkForFrame(const unsigned int timeout_ms);
+
+	// client values which are going back to a server (client tag, look at, sync flag)
+	void WriteClientFeedback(SSharedModelData& feedback);
+	// server side, apply client values to a session and a local data
+	void ReadClientFeedback(SSharedModelData& feedback);
 };
 
 ////////////////////////////////////////////////////////////////
@@ -79,11 +193,88 @@ public:
 
 	bool IsOpen() const;
 
-	SSharedModelData*		GetDataPtr() { return &m_Data; }
+	SSharedModelData*		GetDataPtr() { return m_Frame.m_Data; }
 	STimelineSyncManager*	GetTimelinePtr() { return &m_TimelineSync; }
+	CLiveSessionStats&		GetStats() { return m_Stats; }
+	CClockSync&				GetClockSync() { return m_ClockSync; }
+
+	unsigned int GetJointsCapacity() const { return m_Frame.m_JointsCapacity; }
+	unsigned int GetPropsCapacity() const { return m_Frame.m_PropsCapacity; }
+	unsigned int GetEntitiesCapacity() const { return m_Frame.m_EntitiesCapacity; }
+
+	//! reallocate a local frame, used joints, properties and entities are kept. NOTE: a data pointer is changed
+	void ResizeFrame(const unsigned int joints_capacity, const unsigned int props_capacity, const unsigned int entities_capacity);
+	//! grow a local frame if it's smaller than requested
+	void ReserveFrame(const unsigned int joints_capacity, const unsigned int props_capacity, const unsigned int entities_capacity);
 
 	int Commit(const bool auto_finish_event);
 	int ManualPostCommitFinish();
+	int WaitForFrame(const unsigned int timeout_ms);
+
+	void SetPropertyInt(const unsigned int property_id, const int value);
+	void SetPropertyString(const unsigned int property_id, const char* value);
+	int GetPropertyInt(const unsigned int property_id) const;
+	const char* GetPropertyString(const unsigned int property_id) const;
+
+	SSharedModelData* AcquireWriteSlot();
+	int PublishWriteSlot(const bool auto_finish_event);
+	const SSharedModelData* AcquireReadView();
+	int ReleaseReadView(const bool auto_finish_event);
+
+	// io thread mode
+
+	bool HasIOThread() const { return m_IOThread != nullptr; }
+	//! a frame a caller fills and reads, an io thread mailbox frame when a worker is running
+	SFrameBuffer& GetUserFrame();
+	const SFrameBuffer& GetFrame() const { return m_Frame; }
+	SFrameBuffer& GetFrame() { return m_Frame; }
+	//! guards timeline, look at and sync values which are shared with an io thread
+	std::mutex& GetStateLock() { return m_StateLock; }
+
+	void SetFrameCallback(LiveBridgeFrameCallback callback, void* user_data, const unsigned int session_id);
+	//! called by an io thread after a frame exchange
+	void NotifyFrameReady();
+	//! a handle which is signaled by NotifyFrameReady, it's created on a first call, -1 if it can't be created
+	long long GetFrameReadyHandle();
+	//! returns a number of frames which were signaled since a last reset
+	int ResetFrameReadyHandle();
+
+	// take recording and replay
+
+	//! record every committed frame into a take file, 0 if succeed, -1 on a file error
+	int StartRecording(const char* file_name);
+	//! returns recorded frames count, -1 if a session is not recording
+	int StopRecording();
+
+	//! replay a take into a server session from a replay thread, 0 if succeed, -1 on a file error, -5 if a take doesn't fit a session
+	int StartReplay(const char* file_name, const double speed, const bool loop);
+	void StopReplay();
+	CAnimLiveBridgeTakeReplay* GetReplay() { return m_TakeReplay; }
+
+	// client jitter buffer
+
+	//! store a received frame in a jitter buffer, called on a caller commit, a zero-copy read or an io thread exchange
+	void OnFrameReceived(const SSharedModelData& data);
+	//! interpolated frame at a local time in seconds, nullptr if a jitter buffer is off or it's empty
+	const SSharedModelData* SampleFrame(const double time);
+
+	// joint space
+
+	//! convert user frame joints to HINT_TRANSFORM_LOCAL or HINT_TRANSFORM_MODEL space, every entity has its own joints order
+	/*!
+		\return 0 if succeed, -1 if joints have a parent cycle, -5 if an entity range is out of frame joints
+	*/
+	int ConvertFrameSpace(const unsigned int space_hint);
+
+	// typed property channels
+
+	//! returns 0 if succeed, -1 for an unknown type, -5 if a block with a layout doesn't fit a properties capacity
+	int SetChannelLayout(const unsigned int* name_hashes, const unsigned int* types, const unsigned int count);
+	CPropertyChannels& GetWriteChannels() { return m_WriteChannels; }
+	CPropertyChannels& GetReadChannels() { return m_ReadChannels; }
+
+protected:
+	void StopIOThread();
 
 public:
 	// TODO: need to be refactor
@@ -98,11 +289,47 @@ public:
 
 protected:
 
-	SSharedModelData				m_Data{ 0 };
+	// local frame, a hardware exchanges it with a remote side
+	SFrameBuffer					m_Frame;
 
 	// Ownership for the timeline between server and client
 
 	STimelineSyncManager			m_TimelineSync;
 
+	// commit, wait and transport counters
+	CLiveSessionStats				m_Stats;
+
+	// remote clock offset, samples come with tcp frames when ELiveSessionProperty_ClockSync is set
+	CClockSync						m_ClockSync;
+
 	CAnimLiveBridgeHardware*		m_Hardware{ nullptr };
+	CAnimLiveBridgeIOThread*		m_IOThread{ nullptr };
+
+	std::mutex						m_StateLock;
+
+	std::mutex						m_CallbackLock;
+	LiveBridgeFrameCallback			m_FrameCallback{ nullptr };
+	void*							m_FrameCallbackData{ nullptr };
+	unsigned int					m_FrameCallbackId{ 0 };
+	CFrameReadyEvent				m_FrameReadyEvent;
+
+	// a replay thread commits frames, a recording is guarded against a caller thread
+	std::mutex						m_TakeLock;
+	std::atomic<CAnimLiveBridgeTakeWriter*>	m_TakeWriter{ nullptr };		//!< checked by a commit without a lock, used under a lock
+	CAnimLiveBridgeTakeReplay*		m_TakeReplay{ nullptr };
+
+	CAnimLiveBridgeJitterBuffer*	m_JitterBuffer{ nullptr };
+
+	// a joints order of a frame or of every entity, rebuilt only when a layout is changed
+	std::vector<CJointHierarchy>	m_Hierarchies;
+
+	// channels a caller sends, they are put into frame properties on a commit, and channels of a last read frame
+	CPropertyChannels				m_WriteChannels;
+	CPropertyChannels				m_ReadChannels;
+	bool							m_ChannelLayoutSent{ false };
+	unsigned int					m_ChannelFrames{ 0 };
+
+	// values from ELiveSessionProperties, should be assigned before a hardware open
+	int								m_PropertiesInt[ELiveSessionProperty_Count]{ 0 };
+	std::string						m_PropertiesString[ELiveSessionProperty_Count];
 };
\ No newline at end of file
@@ -25,29 +25,196 @@
 */
 
 #include "AnimLiveBridgeSharedMemory.h"
+#include "AnimLiveBridgeLog.h"
 #include <string>
-
+#include <cstring>
+
+#ifndef _WIN32
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <errno.h>
+	#include <time.h>
+	#include <sched.h>
+	#include <climits>
+	#ifdef __linux__
+		#include <linux/futex.h>
+		#include <sys/syscall.h>
+	#endif
+#endif
+
+#ifdef _WIN32
 const char* SHARED_MAPPING_PREFIX = "Global\\";
+#else
+const char* SHARED_MAPPING_PREFIX = "/";
+#endif
 const char* SHARED_MAPPING_DEFNAME = "AnimationBridgePair";
 
 const char* EVENT_TOCLIENT = "_event_to_client";
 const char* EVENT_FROMCLIENT = "_event_from_client";
 
+const unsigned int SHARED_MAGIC = 0x424C4E41; // ANLB
+const unsigned int SHARED_VERSION = 4;
+
+// keep model data and exchange slots on their own cache lines
+const int DATA_OFFSET = (sizeof(SSharedMemoryControl) + 63) & ~63;
+
+static int ComputeSlotStride(const size_t frame_size)
+{
+	return static_cast<int>((sizeof(SExchangeSlot) + frame_size + 63) & ~static_cast<size_t>(63));
+}
+
+// one frame for a ping pong, 3 slots to a client and 3 slots from a client for a latest value exchange
+static int ComputeRegionSize(const unsigned int exchange_mode, const size_t frame_size)
+{
+	return (exchange_mode == EExchangeMode_LatestValue) ? DATA_OFFSET + 6 * ComputeSlotStride(frame_size)
+		: DATA_OFFSET + static_cast<int>(frame_size);
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////
+// POSIX handoff
+
+#ifndef _WIN32
+
+static void FutexWake(std::atomic<unsigned int>* addr)
+{
+#ifdef __linux__
+	syscall(SYS_futex, reinterpret_cast<unsigned int*>(addr), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#endif
+}
+
+static void FutexWait(std::atomic<unsigned int>* addr, const unsigned int expected, const timespec* timeout)
+{
+#ifdef __linux__
+	syscall(SYS_futex, reinterpret_cast<unsigned int*>(addr), FUTEX_WAIT, expected, timeout, nullptr, 0);
+#else
+	sched_yield();
+#endif
+}
+
+static double MonotonicSeconds()
+{
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return static_cast<double>(ts.tv_sec) + 1.0e-9 * static_cast<double>(ts.tv_nsec);
+}
+
+static bool TryResetEvent(SSharedEvent& ev)
+{
+	unsigned int expected = 1;
+	return ev.m_State.compare_exchange_strong(expected, 0, std::memory_order_acquire);
+}
+
+static bool WaitSharedEvent(SSharedEvent& ev, const unsigned int timeout_ms)
+{
+	if (TryResetEvent(ev))
+		return true;
+
+	if (timeout_ms == 0)
+		return false;
+
+	const double deadline = MonotonicSeconds() + 0.001 * static_cast<double>(timeout_ms);
 
-const int BUF_SIZE = sizeof(SSharedModelData);
+	while (true)
+	{
+		const double remaining = deadline - MonotonicSeconds();
+		if (remaining <= 0.0)
+			return false;
+
+		timespec ts;
+		ts.tv_sec = static_cast<time_t>(remaining);
+		ts.tv_nsec = static_cast<long>((remaining - static_cast<double>(ts.tv_sec)) * 1.0e9);
+
+		ev.m_Waiters.fetch_add(1);
+		FutexWait(&ev.m_State, 0, &ts);
+		ev.m_Waiters.fetch_sub(1);
+
+		if (TryResetEvent(ev))
+			return true;
+	}
+}
+
+static void SignalSharedEvent(SSharedEvent& ev)
+{
+	ev.m_State.store(1);
+
+	if (ev.m_Waiters.load() > 0)
+		FutexWake(&ev.m_State);
+}
 
-extern int										g_VerboseLevel{ 1 };		// 1 - minumum log, 2 - full log info
-extern CLiveBridgeLogger*						g_Logger{ nullptr };
+#endif
 
 //////////////////////////////////////////////////////////////////////////////////
 //
 
+void CAnimLiveBridgeSharedMemory::LogOpenError(const char* what, const int err)
+{
+	if (g_VerboseLevel && g_Logger)
+	{
+		std::string info("[HardwareOpen] Failed to ");
+		info += what;
+		info += ", error - ";
+		info += std::to_string(err);
+
+		g_Logger->LogError(info.c_str());
+	}
+}
+
+static void InitializeControl(SSharedMemoryControl* control, const unsigned int exchange_mode, const int region_size,
+	const unsigned int joints_capacity, const unsigned int props_capacity, const unsigned int entities_capacity)
+{
+	const size_t frame_size = ComputeFrameSize(joints_capacity, props_capacity, entities_capacity);
+
+	control->m_Version = SHARED_VERSION;
+	control->m_RegionSize = region_size;
+	control->m_DataOffset = DATA_OFFSET;
+	control->m_ExchangeMode = exchange_mode;
+	control->m_SlotStride = ComputeSlotStride(frame_size);
+	control->m_JointsCapacity = joints_capacity;
+	control->m_PropsCapacity = props_capacity;
+	control->m_EntitiesCapacity = entities_capacity;
+	control->m_FrameSize = static_cast<unsigned int>(frame_size);
+	control->m_ToClient.Initialize();
+	control->m_FromClient.Initialize();
+}
+
+static bool VerifyControl(const SSharedMemoryControl* control, const size_t mapped_size)
+{
+	return control->m_Magic == SHARED_MAGIC 
+		&& control->m_Version == SHARED_VERSION
+		&& control->m_RegionSize <= mapped_size
+		&& control->m_FrameSize == ComputeFrameSize(control->m_JointsCapacity, control->m_PropsCapacity, control->m_EntitiesCapacity)
+		&& control->m_RegionSize == static_cast<unsigned int>(ComputeRegionSize(control->m_ExchangeMode, control->m_FrameSize));
+}
+
+// stamp frame offsets into every frame of a region, zero-copy slots are handed out with a valid layout
+void CAnimLiveBridgeSharedMemory::InitializeLayout()
+{
+	SSharedMemoryControl* control = GetControl();
+
+	if (control->m_ExchangeMode == EExchangeMode_LatestValue)
+	{
+		for (unsigned int i = 0; i < 3; ++i)
+		{
+			ValidateFrameLayout(*GetExchangeSlot(true, i)->GetData(), control->m_JointsCapacity, control->m_PropsCapacity, control->m_EntitiesCapacity);
+			ValidateFrameLayout(*GetExchangeSlot(false, i)->GetData(), control->m_JointsCapacity, control->m_PropsCapacity, control->m_EntitiesCapacity);
+		}
+	}
+	else
+	{
+		ValidateFrameLayout(*GetSharedData(), control->m_JointsCapacity, control->m_PropsCapacity, control->m_EntitiesCapacity);
+	}
+}
+
 int CAnimLiveBridgeSharedMemory::Open(const char* pair_name, const bool is_server)
 {
 	if (IsOpen())
 		return 1;
 
-	strcpy_s(m_PairName, sizeof(char) * NAME_SIZE, pair_name);
+	strncpy(m_PairName, pair_name, NAME_SIZE - 1);
+	m_PairName[NAME_SIZE - 1] = 0;
 
 	std::string full_pair_name = SHARED_MAPPING_PREFIX;
 	full_pair_name += m_PairName;
@@ -76,35 +243,32 @@ int CAnimLiveBridgeSharedMemory::Open(const char* pair_name, const bool is_serve
 
 	//
 	m_IsServer = is_server;
+	m_ExchangeMode = static_cast<unsigned int>(GetSessionPtr()->GetPropertyInt(ELiveSessionProperty_ExchangeMode));
+	m_PendingPublish = false;
+
 	return (is_server) ? OpenServer(full_pair_name.c_str(), event_toclient_name.c_str(), event_fromclient_name.c_str()) 
 		: OpenClient(full_pair_name.c_str(), event_toclient_name.c_str(), event_fromclient_name.c_str());
 }
 
+#ifdef _WIN32
+
 int CAnimLiveBridgeSharedMemory::OpenServer(const char* full_pair_name, const char* event_toclient_name, const char* event_fromclient_name)
 {
+	CAnimLiveBridgeSession* session = GetSessionPtr();
+	const int region_size = ComputeRegionSize(m_ExchangeMode, ComputeFrameSize(session->GetJointsCapacity(), session->GetPropsCapacity(), session->GetEntitiesCapacity()));
+
 	m_MapFile = CreateFileMapping(
 		INVALID_HANDLE_VALUE,    // use paging file
 		NULL,                    // default security
 		PAGE_READWRITE,          // read/write access
 		0,                       // maximum object size (high-order DWORD)
-		BUF_SIZE,                // maximum object size (low-order DWORD)
+		region_size,             // maximum object size (low-order DWORD)
 		full_pair_name);                 // name of mapping object
 
-	m_FileOpen = true;
-
 	if (m_MapFile == NULL)
 	{
 		const int err = static_cast<int>(GetLastError());
-
-		if (g_VerboseLevel && g_Logger)
-		{
-			std::string info("[HardwareOpen] Failed to CreateFileMapping, error - ");
-			info += std::to_string(err);
-
-			g_Logger->LogError(info.c_str());
-		}
-
-		m_FileOpen = false;
+		LogOpenError("CreateFileMapping", err);
 		return err;
 	}
 
@@ -116,58 +280,41 @@ int CAnimLiveBridgeSharedMemory::OpenServer(const char* full_pair_name, const ch
 	if (m_EventToClient == NULL || m_EventFromClient == NULL)
 	{
 		const int err = static_cast<int>(GetLastError());
-
-		if (g_VerboseLevel && g_Logger)
-		{
-			std::string info("[HardwareOpen] Failed to CreateEvent, error - ");
-			info += std::to_string(err);
-
-			g_Logger->LogError(info.c_str());
-		}
-
-		m_FileOpen = false;
+		LogOpenError("CreateEvent", err);
+		Close();
 		return err;
 	}
 
-	char *buffer = static_cast<char*>(MapViewOfFile(m_MapFile,
-		FILE_MAP_WRITE, // write permission
+	m_Buffer = static_cast<char*>(MapViewOfFile(m_MapFile,
+		FILE_MAP_ALL_ACCESS, // read/write permission
 		0,
 		0,
-		BUF_SIZE));
+		region_size));
 
-	if (buffer == nullptr)
+	if (m_Buffer == nullptr)
 	{
-		CloseHandle(m_MapFile);
-
 		const int err = static_cast<int>(GetLastError());
-		if (g_VerboseLevel && g_Logger)
-		{
-			std::string info("[HardwareOpen] Failed to MapViewOfFile, error - ");
-			info += std::to_string(err);
-
-			g_Logger->LogError(info.c_str());
-		}
-
-		m_FileOpen = false;
+		LogOpenError("MapViewOfFile", err);
+		Close();
 		return err;
 	}
 
-	memset(buffer, 0, BUF_SIZE);
+	m_BufferSize = region_size;
+	memset(m_Buffer, 0, region_size);
+
+	SSharedMemoryControl* control = GetControl();
+	InitializeControl(control, m_ExchangeMode, region_size, session->GetJointsCapacity(), session->GetPropsCapacity(), session->GetEntitiesCapacity());
+	InitializeLayout();
+	std::atomic_thread_fence(std::memory_order_release);
+	control->m_Magic = SHARED_MAGIC;
 
-	UnmapViewOfFile(buffer);
+	m_FileOpen = true;
 
 	if (SetEvent(m_EventToClient) == FALSE)
 	{
 		const int err = static_cast<int>(GetLastError());
-		if (g_VerboseLevel && g_Logger)
-		{
-			std::string info("[HardwareOpen] Failed to SetEvent ToClient, error - ");
-			info += std::to_string(err);
-
-			g_Logger->LogError(info.c_str());
-		}
-
-		m_FileOpen = false;
+		LogOpenError("SetEvent ToClient", err);
+		Close();
 		return err;
 	}
 	return 0;
@@ -182,20 +329,10 @@ int CAnimLiveBridgeSharedMemory::OpenClient(const char* full_pair_name, const ch
 		full_pair_name	// name of mapping object
 	);
 
-	m_FileOpen = true;
-
 	if (m_MapFile == NULL)
 	{
 		const int err = static_cast<int>(GetLastError());
-		if (g_VerboseLevel && g_Logger)
-		{
-			std::string info("[HardwareOpen] Failed to OpenFileMapping, error - ");
-			info += std::to_string(err);
-
-			g_Logger->LogError(info.c_str());
-		}
-
-		m_FileOpen = false;
+		LogOpenError("OpenFileMapping", err);
 		return err;
 	}
 
@@ -205,23 +342,305 @@ int CAnimLiveBridgeSharedMemory::OpenClient(const char* full_pair_name, const ch
 	if (m_EventToClient == NULL || m_EventFromClient == NULL)
 	{
 		const int err = static_cast<int>(GetLastError());
-		if (g_VerboseLevel && g_Logger)
-		{
-			std::string info("[HardwareOpen] Failed to OpenEvent, error - ");
-			info += std::to_string(err);
+		LogOpenError("OpenEvent", err);
+		Close();
+		return err;
+	}
 
-			g_Logger->LogError(info.c_str());
-		}
+	// map the whole region, a size is defined by a server exchange mode
+	m_Buffer = static_cast<char*>(MapViewOfFile(m_MapFile, FILE_MAP_ALL_ACCESS, 0, 0, 0));
+
+	if (m_Buffer == nullptr)
+	{
+		const int err = static_cast<int>(GetLastError());
+		LogOpenError("MapViewOfFile", err);
+		Close();
+		return err;
+	}
+
+	MEMORY_BASIC_INFORMATION info;
+	m_BufferSize = (VirtualQuery(m_Buffer, &info, sizeof(info)) != 0) ? info.RegionSize : 0;
+
+	SSharedMemoryControl* control = GetControl();
+	if (m_BufferSize < sizeof(SSharedMemoryControl) || !VerifyControl(control, m_BufferSize))
+	{
+		LogOpenError("verify a shared region layout", ERROR_INVALID_DATA);
+		Close();
+		return ERROR_INVALID_DATA;
+	}
+	std::atomic_thread_fence(std::memory_order_acquire);
+
+	m_ExchangeMode = control->m_ExchangeMode;
+
+	// client local frame follows a server capacity
+	GetSessionPtr()->ResizeFrame(control->m_JointsCapacity, control->m_PropsCapacity, control->m_EntitiesCapacity);
+
+	m_FileOpen = true;
+	return 0;
+}
+
+bool CAnimLiveBridgeSharedMemory::WaitEventToClient(const unsigned int timeout_ms)
+{
+	return WaitForSingleObjectEx(m_EventToClient, timeout_ms, FALSE) == WAIT_OBJECT_0;
+}
+
+bool CAnimLiveBridgeSharedMemory::WaitEventFromClient(const unsigned int timeout_ms)
+{
+	return WaitForSingleObjectEx(m_EventFromClient, timeout_ms, FALSE) == WAIT_OBJECT_0;
+}
+
+bool CAnimLiveBridgeSharedMemory::SignalEventToClient()
+{
+	return SetEvent(m_EventToClient) != FALSE;
+}
+
+bool CAnimLiveBridgeSharedMemory::SignalEventFromClient()
+{
+	return SetEvent(m_EventFromClient) != FALSE;
+}
+
+int CAnimLiveBridgeSharedMemory::Close()
+{
+	if (m_Buffer)
+	{
+		UnmapViewOfFile(m_Buffer);
+		m_Buffer = nullptr;
+		m_BufferSize = 0;
+	}
+	if (m_EventToClient)
+	{
+		CloseHandle(m_EventToClient);
+		m_EventToClient = 0;
+	}
+	if (m_EventFromClient)
+	{
+		CloseHandle(m_EventFromClient);
+		m_EventFromClient = 0;
+	}
+	if (m_MapFile)
+	{
+		CloseHandle(m_MapFile);
+		m_MapFile = 0;
+	}
+	m_SlotAcquired = false;
+	m_HasTurnEvent = false;
+	m_LastFrameIndex = 0;
+	m_FileOpen = false;
+	return 0;
+}
+
+#else
+
+int CAnimLiveBridgeSharedMemory::OpenServer(const char* full_pair_name, const char* /*event_toclient_name*/, const char* /*event_fromclient_name*/)
+{
+	m_MapFile = shm_open(full_pair_name, O_CREAT | O_RDWR, 0666);
+
+	if (m_MapFile < 0)
+	{
+		const int err = errno;
+		LogOpenError("shm_open", err);
+		return err;
+	}
+
+	CAnimLiveBridgeSession* session = GetSessionPtr();
+	const int region_size = ComputeRegionSize(m_ExchangeMode, ComputeFrameSize(session->GetJointsCapacity(), session->GetPropsCapacity(), session->GetEntitiesCapacity()));
+
+	if (ftruncate(m_MapFile, region_size) != 0)
+	{
+		const int err = errno;
+		LogOpenError("ftruncate", err);
+		Close();
+		return err;
+	}
 
-		m_FileOpen = false;
+	void* view = mmap(nullptr, region_size, PROT_READ | PROT_WRITE, MAP_SHARED, m_MapFile, 0);
+
+	if (view == MAP_FAILED)
+	{
+		const int err = errno;
+		LogOpenError("mmap", err);
+		Close();
 		return err;
 	}
 
+	m_Buffer = static_cast<char*>(view);
+	m_BufferSize = region_size;
+	memset(m_Buffer, 0, region_size);
+
+	// events are living inside the region, both sides are allowed to make a first commit
+	SSharedMemoryControl* control = GetControl();
+	InitializeControl(control, m_ExchangeMode, region_size, session->GetJointsCapacity(), session->GetPropsCapacity(), session->GetEntitiesCapacity());
+	InitializeLayout();
+	control->m_EventFromClient.m_State.store(1);
+	control->m_EventToClient.m_State.store(1);
+	std::atomic_thread_fence(std::memory_order_release);
+	control->m_Magic = SHARED_MAGIC;
+
+	m_FileOpen = true;
 	return 0;
 }
 
+int CAnimLiveBridgeSharedMemory::OpenClient(const char* full_pair_name, const char* /*event_toclient_name*/, const char* /*event_fromclient_name*/)
+{
+	m_MapFile = shm_open(full_pair_name, O_RDWR, 0666);
+
+	if (m_MapFile < 0)
+	{
+		const int err = errno;
+		LogOpenError("shm_open", err);
+		return err;
+	}
+
+	struct stat info;
+	if (fstat(m_MapFile, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(SSharedMemoryControl)))
+	{
+		// server is not ready yet
+		LogOpenError("verify a shared region size", EAGAIN);
+		Close();
+		return EAGAIN;
+	}
+
+	// map the whole region, a size is defined by a server exchange mode
+	const size_t region_size = static_cast<size_t>(info.st_size);
+	void* view = mmap(nullptr, region_size, PROT_READ | PROT_WRITE, MAP_SHARED, m_MapFile, 0);
+
+	if (view == MAP_FAILED)
+	{
+		const int err = errno;
+		LogOpenError("mmap", err);
+		Close();
+		return err;
+	}
+
+	m_Buffer = static_cast<char*>(view);
+	m_BufferSize = region_size;
+
+	SSharedMemoryControl* control = GetControl();
+	if (!VerifyControl(control, m_BufferSize))
+	{
+		LogOpenError("verify a shared region layout", EINVAL);
+		Close();
+		return EINVAL;
+	}
+	std::atomic_thread_fence(std::memory_order_acquire);
+
+	m_ExchangeMode = control->m_ExchangeMode;
+
+	// client local frame follows a server capacity
+	GetSessionPtr()->ResizeFrame(control->m_JointsCapacity, control->m_PropsCapacity, control->m_EntitiesCapacity);
+
+	m_FileOpen = true;
+	return 0;
+}
+
+bool CAnimLiveBridgeSharedMemory::WaitEventToClient(const unsigned int timeout_ms)
+{
+	return WaitSharedEvent(GetControl()->m_EventToClient, timeout_ms);
+}
+
+bool CAnimLiveBridgeSharedMemory::WaitEventFromClient(const unsigned int timeout_ms)
+{
+	return WaitSharedEvent(GetControl()->m_EventFromClient, timeout_ms);
+}
+
+bool CAnimLiveBridgeSharedMemory::SignalEventToClient()
+{
+	SignalSharedEvent(GetControl()->m_EventToClient);
+	return true;
+}
+
+bool CAnimLiveBridgeSharedMemory::SignalEventFromClient()
+{
+	SignalSharedEvent(GetControl()->m_EventFromClient);
+	return true;
+}
+
+int CAnimLiveBridgeSharedMemory::Close()
+{
+	if (m_Buffer)
+	{
+		munmap(m_Buffer, m_BufferSize);
+		m_Buffer = nullptr;
+		m_BufferSize = 0;
+	}
+	if (m_MapFile >= 0)
+	{
+		close(m_MapFile);
+		m_MapFile = -1;
+
+		// name is removed by the owner, mapped views are still valid until unmapped
+		if (m_IsServer)
+		{
+			std::string full_pair_name = SHARED_MAPPING_PREFIX;
+			full_pair_name += m_PairName;
+			shm_unlink(full_pair_name.c_str());
+		}
+	}
+	m_SlotAcquired = false;
+	m_HasTurnEvent = false;
+	m_LastFrameIndex = 0;
+	m_FileOpen = false;
+	return 0;
+}
+
+#endif
+
+bool CAnimLiveBridgeSharedMemory::TakeTurnEvent()
+{
+	if (m_HasTurnEvent)
+	{
+		m_HasTurnEvent = false;
+		return true;
+	}
+	return (m_IsServer) ? WaitEventFromClient(0) : WaitEventToClient(0);
+}
+
+bool CAnimLiveBridgeSharedMemory::PollFrame()
+{
+	if (!IsOpen())
+		return false;
+
+	if (m_ExchangeMode == EExchangeMode_LatestValue)
+	{
+		// writer never waits
+		return (m_IsServer) ? true : GetControl()->m_ToClient.HasNewData();
+	}
+
+	if (!m_HasTurnEvent)
+	{
+		m_HasTurnEvent = (m_IsServer) ? WaitEventFromClient(0) : WaitEventToClient(0);
+	}
+	return m_HasTurnEvent;
+}
+
+bool CAnimLiveBridgeSharedMemory::ParkForFrame(const unsigned int timeout_ms)
+{
+	if (!IsOpen())
+		return false;
+
+	if (m_ExchangeMode == EExchangeMode_LatestValue)
+	{
+		if (m_IsServer)
+			return true;
+
+		// an event is signaled on every publish, it could be left from a frame which is already taken
+		WaitEventToClient(timeout_ms);
+		return GetControl()->m_ToClient.HasNewData();
+	}
+
+	if (!m_HasTurnEvent)
+	{
+		m_HasTurnEvent = (m_IsServer) ? WaitEventFromClient(timeout_ms) : WaitEventToClient(timeout_ms);
+	}
+	return m_HasTurnEvent;
+}
+
 int CAnimLiveBridgeSharedMemory::Commit(const bool auto_finish_event)
 {
+	if (m_ExchangeMode == EExchangeMode_LatestValue)
+	{
+		return (m_IsServer) ? CommitServerLatest(auto_finish_event) : CommitClientLatest(auto_finish_event);
+	}
 	return (m_IsServer) ? CommitServer(auto_finish_event) : CommitClient(auto_finish_event);
 }
 
@@ -230,19 +649,10 @@ int CAnimLiveBridgeSharedMemory::CommitServer(const bool auto_finish_event)
 	if (!IsOpen())
 		return -3;
 
-	if (WaitForSingleObjectEx(m_EventFromClient, 0, FALSE) != WAIT_TIMEOUT)
+	if (TakeTurnEvent())
 	{
-		char *buffer = static_cast<char*>(MapViewOfFile(m_MapFile,
-			FILE_MAP_ALL_ACCESS, // write permission
-			0,
-			0,
-			BUF_SIZE));
-
-		if (buffer == nullptr)
-			return -2;
-
 		// read client time and sync with a server time
-		SSharedModelData* shared_data = reinterpret_cast<SSharedModelData*>(buffer);
+		SSharedModelData* shared_data = GetSharedData();
 		SSharedModelData* local_data = GetSessionPtr()->GetDataPtr();
 
 		GetSessionPtr()->GetTimelinePtr()->ReadFromData(false, *shared_data);
@@ -271,13 +681,13 @@ int CAnimLiveBridgeSharedMemory::CommitServer(const bool auto_finish_event)
 
 		// write server data
 
-		CopyMemory(static_cast<PVOID>(buffer), GetSessionPtr()->GetDataPtr(), sizeof(char)*BUF_SIZE);
+		const size_t bytes = CopyFrameData(shared_data, local_data, GetControl()->m_JointsCapacity, GetControl()->m_PropsCapacity, GetControl()->m_EntitiesCapacity);
+		GetStats().OnFrameSent();
+		GetStats().OnBytesSent(bytes);
 
-		UnmapViewOfFile(buffer);
-
-		memcpy_s(&GetSessionPtr()->m_LookAtRootPos.m_X, sizeof(SVector4), local_data->m_LookAtRoot, sizeof(float) * 4);
-		memcpy_s(&GetSessionPtr()->m_LookAtLeftPos.m_X, sizeof(SVector4), local_data->m_LookAtLeft, sizeof(float) * 4);
-		memcpy_s(&GetSessionPtr()->m_LookAtRightPos.m_X, sizeof(SVector4), local_data->m_LookAtRight, sizeof(float) * 4);
+		memcpy(&GetSessionPtr()->m_LookAtRootPos.m_X, local_data->m_LookAtRoot, sizeof(float) * 4);
+		memcpy(&GetSessionPtr()->m_LookAtLeftPos.m_X, local_data->m_LookAtLeft, sizeof(float) * 4);
+		memcpy(&GetSessionPtr()->m_LookAtRightPos.m_X, local_data->m_LookAtRight, sizeof(float) * 4);
 		
 		//
 		if (auto_finish_event)
@@ -295,18 +705,9 @@ int CAnimLiveBridgeSharedMemory::CommitClient(const bool auto_finish_event)
 	if (!IsOpen())
 		return -3;
 
-	if (WaitForSingleObjectEx(m_EventToClient, 0, false) != WAIT_TIMEOUT)
+	if (TakeTurnEvent())
 	{
-		char *buffer = (char*)MapViewOfFile(m_MapFile,
-			FILE_MAP_ALL_ACCESS,
-			0,
-			0,
-			BUF_SIZE);
-
-		if (buffer == nullptr)
-			return -2;
-
-		SSharedModelData* shared_data = reinterpret_cast<SSharedModelData*>(buffer);
+		SSharedModelData* shared_data = GetSharedData();
 		SSharedModelData* local_data = GetSessionPtr()->GetDataPtr();
 
 		if (STimelineSyncManager* timeline = GetSessionPtr()->GetTimelinePtr())
@@ -321,27 +722,11 @@ int CAnimLiveBridgeSharedMemory::CommitClient(const bool auto_finish_event)
 			GetSessionPtr()->m_HasNewSync = true;
 		}
 
-		shared_data->m_Header.m_ClientTag = local_data->m_Header.m_ClientTag;
+		WriteClientFeedback(*shared_data);
 
-		// look at pos
-		shared_data->m_LookAtRoot[0] = GetSessionPtr()->m_LookAtRootPos.m_X;
-		shared_data->m_LookAtRoot[1] = GetSessionPtr()->m_LookAtRootPos.m_Y;
-		shared_data->m_LookAtRoot[2] = GetSessionPtr()->m_LookAtRootPos.m_Z;
-		shared_data->m_LookAtRoot[3] = (GetSessionPtr()->m_SyncSaved) ? 1.0f : 0.0f;
-
-		shared_data->m_LookAtLeft[0] = GetSessionPtr()->m_LookAtLeftPos.m_X;
-		shared_data->m_LookAtLeft[1] = GetSessionPtr()->m_LookAtLeftPos.m_Y;
-		shared_data->m_LookAtLeft[2] = GetSessionPtr()->m_LookAtLeftPos.m_Z;
-
-		shared_data->m_LookAtRight[0] = GetSessionPtr()->m_LookAtRightPos.m_X;
-		shared_data->m_LookAtRight[1] = GetSessionPtr()->m_LookAtRightPos.m_Y;
-		shared_data->m_LookAtRight[2] = GetSessionPtr()->m_LookAtRightPos.m_Z;
-
-		GetSessionPtr()->m_SyncSaved = false;
-
-		memcpy(local_data, shared_data, sizeof(SSharedModelData));
-
-		UnmapViewOfFile(buffer);
+		const size_t bytes = CopyFrameData(local_data, shared_data, GetControl()->m_JointsCapacity, GetControl()->m_PropsCapacity, GetControl()->m_EntitiesCapacity);
+		GetStats().OnFrameReceived();
+		GetStats().OnBytesReceived(bytes);
 
 		//
 
@@ -355,8 +740,130 @@ int CAnimLiveBridgeSharedMemory::CommitClient(const bool auto_finish_event)
 	return -1;
 }
 
+//////////////////////////////////////////////////////////////////////////////////
+// zero-copy path, the slot is the mapped region itself and it's owned by a side until publish/release
+
+SSharedModelData* CAnimLiveBridgeSharedMemory::AcquireWriteSlot()
+{
+	if (!IsOpen() || !m_IsServer)
+		return nullptr;
+
+	if (m_ExchangeMode == EExchangeMode_LatestValue)
+		return AcquireWriteSlotLatest();
+
+	if (m_SlotAcquired)
+		return GetSharedData();
+
+	if (!TakeTurnEvent())
+		return nullptr;
+
+	SSharedModelData* shared_data = GetSharedData();
+	CAnimLiveBridgeSession* session = GetSessionPtr();
+
+	session->GetTimelinePtr()->ReadFromData(false, *shared_data);
+
+	// check if we have sync event from client
+	if (shared_data->m_LookAtRoot[3] == 1.0f)
+	{
+		session->m_HasNewSync = true;
+		shared_data->m_LookAtRoot[3] = 0.0f;
+	}
+
+	memcpy(&session->m_LookAtRootPos.m_X, shared_data->m_LookAtRoot, sizeof(float) * 4);
+	memcpy(&session->m_LookAtLeftPos.m_X, shared_data->m_LookAtLeft, sizeof(float) * 4);
+	memcpy(&session->m_LookAtRightPos.m_X, shared_data->m_LookAtRight, sizeof(float) * 4);
+
+	m_SlotAcquired = true;
+	return shared_data;
+}
+
+int CAnimLiveBridgeSharedMemory::PublishWriteSlot(const bool auto_finish_event)
+{
+	if (!IsOpen() || !m_SlotAcquired)
+		return -1;
+
+	if (m_ExchangeMode == EExchangeMode_LatestValue)
+		return PublishWriteSlotLatest(auto_finish_event);
+
+	SSharedModelData* shared_data = GetSharedData();
+	CAnimLiveBridgeSession* session = GetSessionPtr();
+
+	ValidateFrameLayout(*shared_data, GetControl()->m_JointsCapacity, GetControl()->m_PropsCapacity, GetControl()->m_EntitiesCapacity);
+
+	if (session->m_SyncSaved)
+	{
+		shared_data->m_LookAtRoot[3] = 2.0f;
+		session->m_SyncSaved = false;
+	}
+
+	session->GetTimelinePtr()->WriteToData(true, *shared_data);
+
+	m_SlotAcquired = false;
+
+	if (auto_finish_event)
+	{
+		SetServerFinishEvent();
+	}
+	return 0;
+}
+
+const SSharedModelData* CAnimLiveBridgeSharedMemory::AcquireReadView()
+{
+	if (!IsOpen() || m_IsServer)
+		return nullptr;
+
+	if (m_ExchangeMode == EExchangeMode_LatestValue)
+		return AcquireReadViewLatest();
+
+	if (m_SlotAcquired)
+		return GetSharedData();
+
+	if (!TakeTurnEvent())
+		return nullptr;
+
+	SSharedModelData* shared_data = GetSharedData();
+	
+	GetSessionPtr()->GetTimelinePtr()->ReadFromData(true, *shared_data);
+
+	// check if we have sync event from master
+	if (shared_data->m_LookAtRoot[3] == 2.0f)
+	{
+		GetSessionPtr()->m_HasNewSync = true;
+	}
+
+	m_SlotAcquired = true;
+	return shared_data;
+}
+
+int CAnimLiveBridgeSharedMemory::ReleaseReadView(const bool auto_finish_event)
+{
+	if (!IsOpen() || !m_SlotAcquired)
+		return -1;
+
+	if (m_ExchangeMode == EExchangeMode_LatestValue)
+		return ReleaseReadViewLatest(auto_finish_event);
+
+	SSharedModelData* shared_data = GetSharedData();
+
+	GetSessionPtr()->GetTimelinePtr()->WriteToData(false, *shared_data);
+	WriteClientFeedback(*shared_data);
+
+	m_SlotAcquired = false;
+
+	if (auto_finish_event)
+	{
+		SetClientFinishEvent();
+	}
+	return 0;
+}
+
 int CAnimLiveBridgeSharedMemory::ManualPostCommitFinish()
 {
+	if (m_ExchangeMode == EExchangeMode_LatestValue)
+	{
+		PublishLatest();
+		return true;
+	}
 	return (m_IsServer) ? SetServerFinishEvent() : SetClientFinishEvent();
 }
 
@@ -364,14 +871,13 @@ int CAnimLiveBridgeSharedMemory::SetServerFinishEvent()
 {
 	if (g_VerboseLevel > 1 && g_Logger)
 	{
-		g_Logger->LogInfo("[SetServerFinishEvent] SetEvent eventToClient");
+		LogMessage(ELogMessage_ServerFinishEvent);
 	}
-	if (SetEvent(m_EventToClient) == FALSE)
+	if (!SignalEventToClient())
 	{
 		if (g_VerboseLevel && g_Logger)
 		{
-			
-			g_Logger->LogError("[SetServerFinishEvent] Failed to SetEvent eventToClient ");
+			LogMessage(ELogMessage_ServerFinishEventFailed);
 		}
 	}
 	return true;
@@ -381,25 +887,286 @@ int CAnimLiveBridgeSharedMemory::SetClientFinishEvent()
 {
 	if (g_VerboseLevel > 1 && g_Logger)
 	{
-		g_Logger->LogInfo("[SetClientFinishEvent] SetEvent eventFromClient ");
+		LogMessage(ELogMessage_ClientFinishEvent);
 	}
-	if (SetEvent(m_EventFromClient) == FALSE)
+	if (!SignalEventFromClient())
 	{
 		if (g_VerboseLevel && g_Logger)
 		{
-			g_Logger->LogInfo("[SetClientFinishEvent] Failed to SetEvent eventFromClient ");
+			LogMessage(ELogMessage_ClientFinishEventFailed);
 		}
 	}
 	return true;
 }
 
-int CAnimLiveBridgeSharedMemory::Close()
+//////////////////////////////////////////////////////////////////////////////////
+// latest value exchange
+//  server frames are going to a client through m_ToClient triple buffer, client feedback is going back through m_FromClient
+//  a writer never waits for a reader, a slot sequence is used as a seqlock to detect torn reads
+
+SExchangeSlot* CAnimLiveBridgeSharedMemory::GetExchangeSlot(const bool to_client, const unsigned int index)
 {
-	if (m_MapFile)
+	SSharedMemoryControl* control = GetControl();
+	const unsigned int slot_index = (to_client) ? index : 3 + index;
+	return reinterpret_cast<SExchangeSlot*>(m_Buffer + control->m_DataOffset + slot_index * control->m_SlotStride);
+}
+
+static void BeginSlotWrite(SExchangeSlot* slot)
+{
+	slot->m_Sequence.fetch_add(1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+}
+
+static void EndSlotWrite(SExchangeSlot* slot, const unsigned int frame_index)
+{
+	slot->m_FrameIndex = frame_index;
+	slot->m_Sequence.fetch_add(1, std::memory_order_release);
+}
+
+void CAnimLiveBridgeSharedMemory::PublishLatest()
+{
+	if (!m_PendingPublish)
+		return;
+
+	SSharedMemoryControl* control = GetControl();
+	STripleBufferState& channel = (m_IsServer) ? control->m_ToClient : control->m_FromClient;
+
+	channel.Publish();
+	m_PendingPublish = false;
+
+	// wake a client parked in a wait for frame, feedback is never waited for
+	if (m_IsServer)
 	{
-		CloseHandle(m_MapFile);
-		m_MapFile = 0;
+		SignalEventToClient();
+	}
+}
+
+void CAnimLiveBridgeSharedMemory::ReadLatestClientFeedback()
+{
+	STripleBufferState& channel = GetControl()->m_FromClient;
+
+	if (!channel.Acquire())
+		return;
+
+	SExchangeSlot* slot = GetExchangeSlot(false, channel.m_ReadIndex);
+
+	SSharedModelData feedback;
+	const unsigned int sequence = slot->m_Sequence.load(std::memory_order_acquire);
+	memcpy(&feedback, slot->GetData(), MODEL_DATA_PREFIX_SIZE);
+	std::atomic_thread_fence(std::memory_order_acquire);
+
+	if ((sequence & 1) != 0 || sequence != slot->m_Sequence.load(std::memory_order_relaxed))
+	{
+		if (g_VerboseLevel > 1 && g_Logger)
+		{
+			LogMessage(ELogMessage_TornClientFeedback);
+		}
+		return;
+	}
+
+	ReadClientFeedback(feedback);
+}
+
+void CAnimLiveBridgeSharedMemory::WriteLatestClientFeedback()
+{
+	STripleBufferState& channel = GetControl()->m_FromClient;
+	SExchangeSlot* slot = GetExchangeSlot(false, channel.m_WriteIndex);
+	SSharedModelData* feedback = slot->GetData();
+
+	BeginSlotWrite(slot);
+
+	GetSessionPtr()->GetTimelinePtr()->WriteToData(false, *feedback);
+	WriteClientFeedback(*feedback);
+
+	EndSlotWrite(slot, ++channel.m_FrameIndex);
+	m_PendingPublish = true;
+}
+
+int CAnimLiveBridgeSharedMemory::CommitServerLatest(const bool auto_finish_event)
+{
+	if (!IsOpen())
+		return -3;
+
+	ReadLatestClientFeedback();
+
+	CAnimLiveBridgeSession* session = GetSessionPtr();
+	SSharedModelData* local_data = session->GetDataPtr();
+
+	session->GetTimelinePtr()->WriteToData(true, *local_data);
+
+	if (session->m_SyncSaved)
+	{
+		local_data->m_LookAtRoot[3] = 2.0f;
+		session->m_SyncSaved = false;
+	}
+
+	STripleBufferState& channel = GetControl()->m_ToClient;
+	SExchangeSlot* slot = GetExchangeSlot(true, channel.m_WriteIndex);
+
+	BeginSlotWrite(slot);
+	const size_t bytes = CopyFrameData(slot->GetData(), local_data, GetControl()->m_JointsCapacity, GetControl()->m_PropsCapacity, GetControl()->m_EntitiesCapacity);
+	EndSlotWrite(slot, ++channel.m_FrameIndex);
+
+	GetStats().OnFrameSent();
+	GetStats().OnBytesSent(bytes);
+
+	local_data->m_LookAtRoot[3] = 0.0f;
+	m_PendingPublish = true;
+
+	if (auto_finish_event)
+	{
+		PublishLatest();
+	}
+	return 0;
+}
+
+int CAnimLiveBridgeSharedMemory::CommitClientLatest(const bool auto_finish_event)
+{
+	if (!IsOpen())
+		return -3;
+
+	STripleBufferState& channel = GetControl()->m_ToClient;
+
+	if (!channel.Acquire())
+		return -1;
+
+	SExchangeSlot* slot = GetExchangeSlot(true, channel.m_ReadIndex);
+	SSharedModelData* local_data = GetSessionPtr()->GetDataPtr();
+
+	const unsigned int client_tag = local_data->m_Header.m_ClientTag;
+	const unsigned int sequence = slot->m_Sequence.load(std::memory_order_acquire);
+	const size_t bytes = CopyFrameData(local_data, slot->GetData(), GetControl()->m_JointsCapacity, GetControl()->m_PropsCapacity, GetControl()->m_EntitiesCapacity);
+	const unsigned int frame_index = slot->m_FrameIndex;
+	std::atomic_thread_fence(std::memory_order_acquire);
+
+	local_data->m_Header.m_ClientTag = client_tag;
+
+	if ((sequence & 1) != 0 || sequence != slot->m_Sequence.load(std::memory_order_relaxed))
+	{
+		if (g_VerboseLevel > 1 && g_Logger)
+		{
+			LogMessage(ELogMessage_TornFrame);
+		}
+		return -4;
+	}
+
+	GetStats().OnFrameReceived();
+	GetStats().OnBytesReceived(bytes);
+
+	// a writer never waits, frames published between two client commits are replaced
+	if (m_LastFrameIndex > 0 && frame_index - m_LastFrameIndex > 1)
+	{
+		GetStats().OnFramesDropped(frame_index - m_LastFrameIndex - 1);
+	}
+	m_LastFrameIndex = frame_index;
+
+	GetSessionPtr()->GetTimelinePtr()->ReadFromData(true, *local_data);
+
+	// check if we have sync event from master
+	if (local_data->m_LookAtRoot[3] == 2.0f)
+	{
+		GetSessionPtr()->m_HasNewSync = true;
+	}
+
+	WriteLatestClientFeedback();
+
+	if (auto_finish_event)
+	{
+		PublishLatest();
+	}
+	return 0;
+}
+
+SSharedModelData* CAnimLiveBridgeSharedMemory::AcquireWriteSlotLatest()
+{
+	STripleBufferState& channel = GetControl()->m_ToClient;
+	SExchangeSlot* slot = GetExchangeSlot(true, channel.m_WriteIndex);
+
+	if (!m_SlotAcquired)
+	{
+		ReadLatestClientFeedback();
+		BeginSlotWrite(slot);
+		m_SlotAcquired = true;
+	}
+
+	// NOTE: back slot keeps an older frame, a producer should write a complete frame
+	return slot->GetData();
+}
+
+int CAnimLiveBridgeSharedMemory::PublishWriteSlotLatest(const bool auto_finish_event)
+{
+	STripleBufferState& channel = GetControl()->m_ToClient;
+	SExchangeSlot* slot = GetExchangeSlot(true, channel.m_WriteIndex);
+	SSharedModelData* slot_data = slot->GetData();
+	CAnimLiveBridgeSession* session = GetSessionPtr();
+
+	ValidateFrameLayout(*slot_data, GetControl()->m_JointsCapacity, GetControl()->m_PropsCapacity, GetControl()->m_EntitiesCapacity);
+
+	slot_data->m_LookAtRoot[3] = (session->m_SyncSaved) ? 2.0f : 0.0f;
+	session->m_SyncSaved = false;
+
+	session->GetTimelinePtr()->WriteToData(true, *slot_data);
+
+	EndSlotWrite(slot, ++channel.m_FrameIndex);
+	m_SlotAcquired = false;
+	m_PendingPublish = true;
+
+	if (auto_finish_event)
+	{
+		PublishLatest();
 	}
-	m_FileOpen = false;
 	return 0;
-}
\ No newline at end of file
+}
+
+const SSharedModelData* CAnimLiveBridgeSharedMemory::AcquireReadViewLatest()
+{
+	STripleBufferState& channel = GetControl()->m_ToClient;
+
+	if (!m_SlotAcquired)
+	{
+		if (!channel.Acquire())
+			return nullptr;
+
+		SExchangeSlot* slot = GetExchangeSlot(true, channel.m_ReadIndex);
+		m_ReadSequence = slot->m_Sequence.load(std::memory_order_acquire);
+
+		GetSessionPtr()->GetTimelinePtr()->ReadFromData(true, *slot->GetData());
+
+		// check if we have sync event from master
+		if (slot->GetData()->m_LookAtRoot[3] == 2.0f)
+		{
+			GetSessionPtr()->m_HasNewSync = true;
+		}
+
+		m_SlotAcquired = true;
+	}
+
+	return GetExchangeSlot(true, channel.m_ReadIndex)->GetData();
+}
+
+int CAnimLiveBridgeSharedMemory::ReleaseReadViewLatest(const bool auto_finish_event)
+{
+	SExchangeSlot* slot = GetExchangeSlot(true, GetControl()->m_ToClient.m_ReadIndex);
+
+	std::atomic_thread_fence(std::memory_order_acquire);
+	const bool is_torn = (m_ReadSequence & 1) != 0 || m_ReadSequence != slot->m_Sequence.load(std::memory_order_relaxed);
+
+	m_SlotAcquired = false;
+
+	WriteLatestClientFeedback();
+
+	if (auto_finish_event)
+	{
+		PublishLatest();
+	}
+
+	if (is_torn)
+	{
+		if (g_VerboseLevel > 1 && g_Logger)
+		{
+			LogMessage(ELogMessage_TornReadView);
+		}
+		return -4;
+	}
+	return 0;
+}
@@ -26,8 +26,63 @@
 #
 */
 
-#include <windows.h>
+#ifdef _WIN32
+	#include <windows.h>
+#endif
+
+#include <atomic>
+#include <cstddef>
 #include "AnimLiveBridgeSession.h"
+#include "AnimLiveBridgeTripleBuffer.h"
+
+////////////////////////////////////////////////////////////
+// SSharedEvent
+//  auto reset handoff flag, on POSIX it is used as a futex word in place of a named event
+
+struct SSharedEvent
+{
+	std::atomic<unsigned int>	m_State;		//!< 1 - signaled, reset by a successful wait
+	std::atomic<unsigned int>	m_Waiters;		//!< blocked waiters, no wake syscall when nobody is waiting
+};
+
+////////////////////////////////////////////////////////////
+// SExchangeSlot
+//  one of the triple buffer slots for a latest value exchange, frame data is following the slot header
+
+struct SExchangeSlot
+{
+	std::atomic<unsigned int>	m_Sequence;		//!< seqlock counter, odd while a slot is being written
+	unsigned int				m_FrameIndex;	//!< writer publish counter
+	unsigned int				m_Reserved[2];
+
+	SSharedModelData* GetData() { return reinterpret_cast<SSharedModelData*>(this + 1); }
+};
+
+////////////////////////////////////////////////////////////
+// SSharedMemoryControl
+//  placed at the beginning of a shared region, the model data is following at m_DataOffset
+//  ping pong mode keeps one frame, latest value mode keeps 3 slots to a client and 3 slots from a client
+//  a frame is a variable-length model data of m_FrameSize bytes
+
+struct SSharedMemoryControl
+{
+	unsigned int				m_Magic;
+	unsigned int				m_Version;
+	unsigned int				m_RegionSize;
+	unsigned int				m_DataOffset;
+	unsigned int				m_ExchangeMode;		//!< EExchangeMode, defined by a server
+	unsigned int				m_SlotStride;
+	unsigned int				m_JointsCapacity;	//!< frame layout, defined by a server
+	unsigned int				m_PropsCapacity;
+	unsigned int				m_EntitiesCapacity;
+	unsigned int				m_FrameSize;
+
+	SSharedEvent				m_EventToClient;
+	SSharedEvent				m_EventFromClient;
+
+	STripleBufferState			m_ToClient;
+	STripleBufferState			m_FromClient;
+};
 
 ///////////////////////////////////////////////////////////
 // CAnimLiveBridgeSharedMemory
@@ -51,13 +106,39 @@ public:
 	int Commit(const bool auto_finish_event) override;
 	int ManualPostCommitFinish() override;
 
+	SSharedModelData* AcquireWriteSlot() override;
+	int PublishWriteSlot(const bool auto_finish_event) override;
+	const SSharedModelData* AcquireReadView() override;
+	int ReleaseReadView(const bool auto_finish_event) override;
+
 protected:
 
+	bool PollFrame() override;
+	bool ParkForFrame(const unsigned int timeout_ms) override;
+
 	bool			m_FileOpen{ false };				//!< Is file open?
+	bool			m_SlotAcquired{ false };			//!< zero-copy slot is handed out until publish/release
+	bool			m_PendingPublish{ false };			//!< latest value slot is written, but not yet published
+	bool			m_HasTurnEvent{ false };			//!< ping pong event is consumed by a wait, but not yet by a commit
+	unsigned int	m_ReadSequence{ 0 };				//!< slot sequence when a latest value view was acquired
+	unsigned int	m_LastFrameIndex{ 0 };				//!< last latest value frame a client took, a gap is counted as dropped frames
+	unsigned int	m_ExchangeMode{ EExchangeMode_PingPong };
+
+#ifdef _WIN32
 	HANDLE			m_MapFile{ 0 };
 
 	HANDLE			m_EventToClient{ 0 };
 	HANDLE			m_EventFromClient{ 0 };
+#else
+	int				m_MapFile{ -1 };
+#endif
+
+	// view is mapped once in Open and is kept until Close
+	char*					m_Buffer{ nullptr };
+	size_t					m_BufferSize{ 0 };
+	
+	SSharedMemoryControl*	GetControl() { return reinterpret_cast<SSharedMemoryControl*>(m_Buffer); }
+	SSharedModelData*		GetSharedData() { return reinterpret_cast<SSharedModelData*>(m_Buffer + GetControl()->m_DataOffset); }
 
 	int OpenServer(const char* full_pair_name, const char* event_toclient_name, const char* event_fromclient_name);
 	int OpenClient(const char* full_pair_name, const char* event_toclient_name, const char* event_fromclient_name);
@@ -67,4 +148,32 @@ protected:
 
 	int SetServerFinishEvent();
 	int SetClientFinishEvent();
-};
\ No newline at end of file
+
+	// latest value exchange
+
+	SExchangeSlot* GetExchangeSlot(const bool to_client, const unsigned int index);
+	
+	int CommitServerLatest(const bool auto_finish_event);
+	int CommitClientLatest(const bool auto_finish_event);
+
+	SSharedModelData* AcquireWriteSlotLatest();
+	int PublishWriteSlotLatest(const bool auto_finish_event);
+	const SSharedModelData* AcquireReadViewLatest();
+	int ReleaseReadViewLatest(const bool auto_finish_event);
+
+	void ReadLatestClientFeedback();
+	void WriteLatestClientFeedback();
+	void PublishLatest();
+
+	//! ping pong turn, takes an event consumed by a wait or polls it
+	bool TakeTurnEvent();
+
+	// platform specific handoff, timeout 0 is only polling an event state
+	bool WaitEventToClient(const unsigned int timeout_ms);
+	bool WaitEventFromClient(const unsigned int timeout_ms);
+	bool SignalEventToClient();
+	bool SignalEventFromClient();
+
+	void LogOpenError(const char* what, const int err);
+	void InitializeLayout();
+};
@@ -0,0 +1,225 @@
+/*
+#
+# Copyright(c) 2021 Avalanche Studios.All rights reserved.
+# Licensed under the MIT License.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files(the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions :
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE
+#
+*/
+
+
+#include "AnimLiveBridgeStats.h"
+#include <chrono>
+
+#ifdef _MSC_VER
+	#include <intrin.h>
+#endif
+
+static inline unsigned int HighestBit(const unsigned long long value)
+{
+#ifdef _MSC_VER
+	unsigned long index = 0;
+	_BitScanReverse64(&index, value);
+	return static_cast<unsigned int>(index);
+#else
+	return 63u - static_cast<unsigned int>(__builtin_clzll(value));
+#endif
+}
+
+static inline void AtomicMin(std::atomic<unsigned long long>& target, const unsigned long long value)
+{
+	unsigned long long prev = target.load(std::memory_order_relaxed);
+	while (value < prev && !target.compare_exchange_weak(prev, value, std::memory_order_relaxed)) {}
+}
+
+static inline void AtomicMax(std::atomic<unsigned long long>& target, const unsigned long long value)
+{
+	unsigned long long prev = target.load(std::memory_order_relaxed);
+	while (value > prev && !target.compare_exchange_weak(prev, value, std::memory_order_relaxed)) {}
+}
+
+////////////////////////////////////////////////////////////////
+// SLatencyHistogram
+
+unsigned int SLatencyHistogram::BucketIndex(const unsigned long long value_ns)
+{
+	if (value_ns < LATENCY_LINEAR_LIMIT)
+		return static_cast<unsigned int>(value_ns);
+
+	unsigned int exponent = HighestBit(value_ns);
+	if (exponent >= LATENCY_MAX_EXPONENT)
+		return LATENCY_BUCKETS_COUNT - 1;
+
+	const unsigned int sub_bucket = static_cast<unsigned int>(value_ns >> (exponent - LATENCY_SUB_BUCKET_BITS)) & (LATENCY_SUB_BUCKETS - 1);
+	return LATENCY_LINEAR_LIMIT + (exponent - LATENCY_SUB_BUCKET_BITS - 1) * LATENCY_SUB_BUCKETS + sub_bucket;
+}
+
+unsigned long long SLatencyHistogram::BucketMiddle(const unsigned int index)
+{
+	if (index < LATENCY_LINEAR_LIMIT)
+		return index;
+
+	const unsigned int exponent = (index - LATENCY_LINEAR_LIMIT) / LATENCY_SUB_BUCKETS + LATENCY_SUB_BUCKET_BITS + 1;
+	const unsigned int sub_bucket = (index - LATENCY_LINEAR_LIMIT) % LATENCY_SUB_BUCKETS;
+	const unsigned int shift = exponent - LATENCY_SUB_BUCKET_BITS;
+
+	return (static_cast<unsigned long long>(LATENCY_SUB_BUCKETS + sub_bucket) << shift) + ((1ull << shift) >> 1);
+}
+
+void SLatencyHistogram::Reset()
+{
+	for (unsigned int i = 0; i < LATENCY_BUCKETS_COUNT; ++i)
+	{
+		m_Buckets[i].store(0, std::memory_order_relaxed);
+	}
+	m_Count.store(0, std::memory_order_relaxed);
+	m_Sum.store(0, std::memory_order_relaxed);
+	m_Min.store(~0ull, std::memory_order_relaxed);
+	m_Max.store(0, std::memory_order_relaxed);
+}
+
+void SLatencyHistogram::Record(const unsigned long long value_ns)
+{
+	m_Buckets[BucketIndex(value_ns)].fetch_add(1, std::memory_order_relaxed);
+	m_Count.fetch_add(1, std::memory_order_relaxed);
+	m_Sum.fetch_add(value_ns, std::memory_order_relaxed);
+	AtomicMin(m_Min, value_ns);
+	AtomicMax(m_Max, value_ns);
+}
+
+void SLatencyHistogram::Summarize(SLatencySummary& summary) const
+{
+	summary = SLatencySummary{ 0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+
+	// buckets are not a consistent snapshot while a writer is running, percentiles use their own total
+	unsigned long long total = 0;
+	for (unsigned int i = 0; i < LATENCY_BUCKETS_COUNT; ++i)
+	{
+		total += m_Buckets[i].load(std::memory_order_relaxed);
+	}
+
+	if (total == 0)
+		return;
+
+	const double percentiles[4] = { 0.5, 0.9, 0.99, 0.999 };
+	double* outputs[4] = { &summary.m_P50, &summary.m_P90, &summary.m_P99, &summary.m_P999 };
+
+	unsigned long long accumulated = 0;
+	unsigned int next = 0;
+
+	for (unsigned int i = 0; i < LATENCY_BUCKETS_COUNT && next < 4; ++i)
+	{
+		accumulated += m_Buckets[i].load(std::memory_order_relaxed);
+
+		while (next < 4 && static_cast<double>(accumulated) >= percentiles[next] * static_cast<double>(total))
+		{
+			*outputs[next] = 0.001 * static_cast<double>(BucketMiddle(i));
+			++next;
+		}
+	}
+
+	const unsigned long long count = m_Count.load(std::memory_order_relaxed);
+
+	summary.m_Count = count;
+	summary.m_Min = 0.001 * static_cast<double>(m_Min.load(std::memory_order_relaxed));
+	summary.m_Max = 0.001 * static_cast<double>(m_Max.load(std::memory_order_relaxed));
+	summary.m_Mean = (count > 0) ? 0.001 * static_cast<double>(m_Sum.load(std::memory_order_relaxed)) / static_cast<double>(count) : 0.0;
+}
+
+////////////////////////////////////////////////////////////////
+// CLiveSessionStats
+
+unsigned long long CLiveSessionStats::Now()
+{
+	return static_cast<unsigned long long>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void CLiveSessionStats::Reset()
+{
+	m_Commits.store(0, std::memory_order_relaxed);
+	m_CommitsMissed.store(0, std::memory_order_relaxed);
+	m_CommitErrors.store(0, std::memory_order_relaxed);
+	m_FramesSent.store(0, std::memory_order_relaxed);
+	m_FramesReceived.store(0, std::memory_order_relaxed);
+	m_FramesDropped.store(0, std::memory_order_relaxed);
+	m_BytesSent.store(0, std::memory_order_relaxed);
+	m_BytesReceived.store(0, std::memory_order_relaxed);
+	m_LastHandoff.store(0, std::memory_order_relaxed);
+
+	for (int i = 0; i < ELiveSessionLatency_Count; ++i)
+	{
+		m_Latency[i].Reset();
+	}
+}
+
+void CLiveSessionStats::OnCommit(const int result, const unsigned long long start_ns)
+{
+	const unsigned long long now = Now();
+
+	m_Commits.fetch_add(1, std::memory_order_relaxed);
+	m_Latency[ELiveSessionLatency_Commit].Record(now - start_ns);
+
+	if (result == -1)
+	{
+		m_CommitsMissed.fetch_add(1, std::memory_order_relaxed);
+	}
+	else if (result != 0)
+	{
+		m_CommitErrors.fetch_add(1, std::memory_order_relaxed);
+	}
+	else
+	{
+		const unsigned long long last = m_LastHandoff.exchange(now, std::memory_order_relaxed);
+		if (last > 0)
+		{
+			m_Latency[ELiveSessionLatency_Handoff].Record(now - last);
+		}
+	}
+}
+
+void CLiveSessionStats::OnWait(const int result, const unsigned long long start_ns)
+{
+	// timeouts are not a handoff latency, they are seen as missed commits anyway
+	if (result == 0)
+	{
+		m_Latency[ELiveSessionLatency_Wait].Record(Now() - start_ns);
+	}
+}
+
+void CLiveSessionStats::GetStats(SLiveSessionStats& stats) const
+{
+	stats.m_Commits = m_Commits.load(std::memory_order_relaxed);
+	stats.m_CommitsMissed = m_CommitsMissed.load(std::memory_order_relaxed);
+	stats.m_CommitErrors = m_CommitErrors.load(std::memory_order_relaxed);
+	stats.m_FramesSent = m_FramesSent.load(std::memory_order_relaxed);
+	stats.m_FramesReceived = m_FramesReceived.load(std::memory_order_relaxed);
+	stats.m_FramesDropped = m_FramesDropped.load(std::memory_order_relaxed);
+	stats.m_BytesSent = m_BytesSent.load(std::memory_order_relaxed);
+	stats.m_BytesReceived = m_BytesReceived.load(std::memory_order_relaxed);
+}
+
+bool CLiveSessionStats::GetLatency(const unsigned int latency_id, SLatencySummary& summary) const
+{
+	if (latency_id >= static_cast<unsigned int>(ELiveSessionLatency_Count))
+		return false;
+
+	m_Latency[latency_id].Summarize(summary);
+	return true;
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+/*
+#
+# Copyright(c) 2021 Avalanche Studios.All rights reserved.
+# Licensed under the MIT License.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files(the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions :
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE
+#
+*/
+
+
+#include "AnimLiveBridge.h"
+#include <atomic>
+#include <cstddef>
+
+// log-linear buckets, values below 64 ns have own buckets, every power of two above is split into 32 sub buckets
+const unsigned int LATENCY_SUB_BUCKET_BITS = 5;
+const unsigned int LATENCY_SUB_BUCKETS = 1u << LATENCY_SUB_BUCKET_BITS;
+const unsigned int LATENCY_LINEAR_LIMIT = 2 * LATENCY_SUB_BUCKETS;
+const unsigned int LATENCY_MAX_EXPONENT = 42;		// about 73 minutes in nanoseconds, values above are clamped
+const unsigned int LATENCY_BUCKETS_COUNT = LATENCY_LINEAR_LIMIT + (LATENCY_MAX_EXPONENT - LATENCY_SUB_BUCKET_BITS) * LATENCY_SUB_BUCKETS;
+
+////////////////////////////////////////////////////////////
+// SLatencyHistogram
+//  HDR style histogram of nanosecond values with a fixed relative precision
+//  a writer adds a sample with a few relaxed atomic increments, a reader could summarize it at any time
+
+struct SLatencyHistogram
+{
+	std::atomic<unsigned long long>	m_Buckets[LATENCY_BUCKETS_COUNT];
+	std::atomic<unsigned long long>	m_Count{ 0 };
+	std::atomic<unsigned long long>	m_Sum{ 0 };
+	std::atomic<unsigned long long>	m_Min{ ~0ull };
+	std::atomic<unsigned long long>	m_Max{ 0 };
+
+	SLatencyHistogram() { Reset(); }
+
+	void Reset();
+	void Record(const unsigned long long value_ns);
+	//! percentiles in microseconds, a percentile value is a middle of its bucket
+	void Summarize(SLatencySummary& summary) const;
+
+	static unsigned int BucketIndex(const unsigned long long value_ns);
+	static unsigned long long BucketMiddle(const unsigned int index);
+};
+
+////////////////////////////////////////////////////////////
+// CLiveSessionStats
+//  per session counters, hot path updates are relaxed atomics, so a hardware worker and a caller thread could both update them
+
+class CLiveSessionStats
+{
+public:
+
+	void Reset();
+
+	// returns a current steady clock time in nanoseconds, it's a start point for a latency sample
+	static unsigned long long Now();
+
+	void OnCommit(const int result, const unsigned long long start_ns);
+	void OnWait(const int result, const unsigned long long start_ns);
+
+	// a transport counts frames once they are handed off and bytes once they are moved (copied, sent or received)
+	void OnFrameSent() { m_FramesSent.fetch_add(1, std::memory_order_relaxed); }
+	void OnFrameReceived() { m_FramesReceived.fetch_add(1, std::memory_order_relaxed); }
+	void OnBytesSent(const size_t bytes) { m_BytesSent.fetch_add(bytes, std::memory_order_relaxed); }
+	void OnBytesReceived(const size_t bytes) { m_BytesReceived.fetch_add(bytes, std::memory_order_relaxed); }
+	void OnFramesDropped(const unsigned long long count) { m_FramesDropped.fetch_add(count, std::memory_order_relaxed); }
+
+	void GetStats(SLiveSessionStats& stats) const;
+	bool GetLatency(const unsigned int latency_id, SLatencySummary& summary) const;
+
+protected:
+
+	std::atomic<unsigned long long>	m_Commits{ 0 };
+	std::atomic<unsigned long long>	m_CommitsMissed{ 0 };
+	std::atomic<unsigned long long>	m_CommitErrors{ 0 };
+	std::atomic<unsigned long long>	m_FramesSent{ 0 };
+	std::atomic<unsigned long long>	m_FramesReceived{ 0 };
+	std::atomic<unsigned long long>	m_FramesDropped{ 0 };
+	std::atomic<unsigned long long>	m_BytesSent{ 0 };
+	std::atomic<unsigned long long>	m_BytesReceived{ 0 };
+
+	// last successful commit time, a handoff sample is an interval between two of them
+	std::atomic<unsigned long long>	m_LastHandoff{ 0 };
+
+	SLatencyHistogram				m_Latency[ELiveSessionLatency_Count];
+};
@@ -0,0 +1,757 @@
+/*
+#
+# Copyright(c) 2021 Avalanche Studios.All rights reserved.
+# Licensed under the MIT License.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files(the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions :
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE
+#
+*/
+
+
+#include "AnimLiveBridgeTake.h"
+#include "AnimLiveBridgeNetwork.h"
+#include <cstring>
+#include <string>
+#include <algorithm>
+
+#ifndef _WIN32
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+static inline size_t AlignRecord(const size_t size)
+{
+	return (size + 7) & ~static_cast<size_t>(7);
+}
+
+static const size_t TAKE_DATA_BEGIN = AlignRecord(sizeof(STakeFileHeader));
+#ifdef _WIN32
+static const size_t TAKE_INDEX_COMMIT_SIZE = 64 * 1024;
+#endif
+
+static long long TakeClockNow()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static double ReadLocalTime(const char* packed_data)
+{
+	SPlayerInfo player;
+	memcpy(&player, packed_data + offsetof(SSharedModelData, m_ServerPlayer), sizeof(SPlayerInfo));
+	return player.m_LocalTime;
+}
+
+////////////////////////////////////////////////////////////////
+// CAnimLiveBridgeTakeWriter
+
+CAnimLiveBridgeTakeWriter::~CAnimLiveBridgeTakeWriter()
+{
+	Close();
+}
+
+#ifdef _WIN32
+
+int CAnimLiveBridgeTakeWriter::Open(const char* file_name)
+{
+	Close();
+
+	m_File = CreateFileA(file_name, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (m_File == INVALID_HANDLE_VALUE)
+		return -1;
+
+	if (!MapFile(TAKE_FILE_GROW_SIZE) || !MapIndex())
+	{
+		UnmapFile();
+		CloseHandle(m_File);
+		m_File = INVALID_HANDLE_VALUE;
+		return -1;
+	}
+	m_StartTime = 0;
+
+	STakeFileHeader* header = GetHeader();
+	memset(header, 0, sizeof(STakeFileHeader));
+	header->m_Magic = TAKE_FILE_MAGIC;
+	header->m_Version = TAKE_FILE_VERSION;
+	header->m_DataEnd = TAKE_DATA_BEGIN;
+	return 0;
+}
+
+bool CAnimLiveBridgeTakeWriter::MapFile(const size_t capacity)
+{
+	const unsigned long long size = static_cast<unsigned long long>(capacity);
+
+	// a file is extended to a mapping size
+	m_Mapping = CreateFileMappingA(m_File, nullptr, PAGE_READWRITE, static_cast<DWORD>(size >> 32), static_cast<DWORD>(size & 0xFFFFFFFFull), nullptr);
+	if (m_Mapping == 0)
+		return false;
+
+	m_Buffer = static_cast<char*>(MapViewOfFile(m_Mapping, FILE_MAP_ALL_ACCESS, 0, 0, capacity));
+	if (m_Buffer == nullptr)
+	{
+		CloseHandle(m_Mapping);
+		m_Mapping = 0;
+		return false;
+	}
+	m_Capacity = capacity;
+	return true;
+}
+
+void CAnimLiveBridgeTakeWriter::UnmapFile()
+{
+	if (m_Buffer)
+	{
+		UnmapViewOfFile(m_Buffer);
+		m_Buffer = nullptr;
+	}
+	if (m_Mapping)
+	{
+		CloseHandle(m_Mapping);
+		m_Mapping = 0;
+	}
+	m_Capacity = 0;
+}
+
+bool CAnimLiveBridgeTakeWriter::MapIndex()
+{
+	// address space only, pages are committed by AppendIndex
+	const size_t size = sizeof(STakeIndexEntry) * TAKE_INDEX_MAX_FRAMES;
+
+	m_Index = static_cast<STakeIndexEntry*>(VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS));
+	m_IndexCount = 0;
+	m_IndexCommitted = 0;
+	return m_Index != nullptr;
+}
+
+void CAnimLiveBridgeTakeWriter::UnmapIndex()
+{
+	if (m_Index)
+	{
+		VirtualFree(m_Index, 0, MEM_RELEASE);
+		m_Index = nullptr;
+	}
+	m_IndexCount = 0;
+	m_IndexCommitted = 0;
+}
+
+bool CAnimLiveBridgeTakeWriter::AppendIndex(const STakeIndexEntry& entry)
+{
+	if (m_IndexCount == TAKE_INDEX_MAX_FRAMES)
+		return false;
+
+	const size_t size = sizeof(STakeIndexEntry) * (m_IndexCount + 1);
+
+	if (size > m_IndexCommitted)
+	{
+		const size_t max_size = sizeof(STakeIndexEntry) * TAKE_INDEX_MAX_FRAMES;
+		const size_t commit_size = std::min(max_size - m_IndexCommitted, TAKE_INDEX_COMMIT_SIZE);
+
+		if (!VirtualAlloc(reinterpret_cast<char*>(m_Index) + m_IndexCommitted, commit_size, MEM_COMMIT, PAGE_READWRITE))
+			return false;
+		m_IndexCommitted += commit_size;
+	}
+
+	m_Index[m_IndexCount] = entry;
+	++m_IndexCount;
+	return true;
+}
+
+int CAnimLiveBridgeTakeWriter::Close()
+{
+	if (m_File == INVALID_HANDLE_VALUE)
+		return 0;
+
+	int frames_count = 0;
+	unsigned long long file_size = 0;
+
+	if (m_Buffer)
+	{
+		file_size = WriteIndex();
+		frames_count = static_cast<int>(m_IndexCount);
+	}
+	UnmapFile();
+	UnmapIndex();
+
+	if (file_size > 0)
+	{
+		LARGE_INTEGER position;
+		position.QuadPart = static_cast<LONGLONG>(file_size);
+		SetFilePointerEx(m_File, position, nullptr, FILE_BEGIN);
+		SetEndOfFile(m_File);
+	}
+
+	CloseHandle(m_File);
+	m_File = INVALID_HANDLE_VALUE;
+	return frames_count;
+}
+
+#else
+
+int CAnimLiveBridgeTakeWriter::Open(const char* file_name)
+{
+	Close();
+
+	m_File = open(file_name, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (m_File < 0)
+		return -1;
+
+	if (!MapFile(TAKE_FILE_GROW_SIZE) || !MapIndex())
+	{
+		UnmapFile();
+		close(m_File);
+		m_File = -1;
+		return -1;
+	}
+	m_StartTime = 0;
+
+	STakeFileHeader* header = GetHeader();
+	memset(header, 0, sizeof(STakeFileHeader));
+	header->m_Magic = TAKE_FILE_MAGIC;
+	header->m_Version = TAKE_FILE_VERSION;
+	header->m_DataEnd = TAKE_DATA_BEGIN;
+	return 0;
+}
+
+bool CAnimLiveBridgeTakeWriter::MapFile(const size_t capacity)
+{
+	if (ftruncate(m_File, static_cast<off_t>(capacity)) != 0)
+		return false;
+
+	void* buffer = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, m_File, 0);
+	if (buffer == MAP_FAILED)
+		return false;
+
+	m_Buffer = static_cast<char*>(buffer);
+	m_Capacity = capacity;
+	return true;
+}
+
+void CAnimLiveBridgeTakeWriter::UnmapFile()
+{
+	if (m_Buffer)
+	{
+		munmap(m_Buffer, m_Capacity);
+		m_Buffer = nullptr;
+	}
+	m_Capacity = 0;
+}
+
+bool CAnimLiveBridgeTakeWriter::MapIndex()
+{
+	// pages of a private anonymous mapping are committed on a first write
+	const size_t size = sizeof(STakeIndexEntry) * TAKE_INDEX_MAX_FRAMES;
+
+	void* buffer = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	m_Index = (buffer != MAP_FAILED) ? static_cast<STakeIndexEntry*>(buffer) : nullptr;
+	m_IndexCount = 0;
+	return m_Index != nullptr;
+}
+
+void CAnimLiveBridgeTakeWriter::UnmapIndex()
+{
+	if (m_Index)
+	{
+		munmap(m_Index, sizeof(STakeIndexEntry) * TAKE_INDEX_MAX_FRAMES);
+		m_Index = nullptr;
+	}
+	m_IndexCount = 0;
+}
+
+bool CAnimLiveBridgeTakeWriter::AppendIndex(const STakeIndexEntry& entry)
+{
+	if (m_IndexCount == TAKE_INDEX_MAX_FRAMES)
+		return false;
+
+	m_Index[m_IndexCount] = entry;
+	++m_IndexCount;
+	return true;
+}
+
+int CAnimLiveBridgeTakeWriter::Close()
+{
+	if (m_File < 0)
+		return 0;
+
+	int frames_count = 0;
+	unsigned long long file_size = 0;
+
+	if (m_Buffer)
+	{
+		file_size = WriteIndex();
+		frames_count = static_cast<int>(m_IndexCount);
+	}
+	UnmapFile();
+	UnmapIndex();
+
+	if (file_size > 0)
+	{
+		ftruncate(m_File, static_cast<off_t>(file_size));
+	}
+
+	close(m_File);
+	m_File = -1;
+	return frames_count;
+}
+
+#endif
+
+unsigned long long CAnimLiveBridgeTakeWriter::WriteIndex()
+{
+	const size_t index_size = sizeof(STakeIndexEntry) * m_IndexCount;
+	const unsigned long long index_offset = GetHeader()->m_DataEnd;
+
+	if (Reserve(static_cast<size_t>(index_offset) + index_size))
+	{
+		memcpy(m_Buffer + index_offset, m_Index, index_size);
+		GetHeader()->m_IndexOffset = index_offset;
+		return index_offset + index_size;
+	}
+
+	// a take without an index is read by a record scan
+	return (m_Buffer) ? GetHeader()->m_DataEnd : 0;
+}
+
+bool CAnimLiveBridgeTakeWriter::Reserve(const size_t size)
+{
+	if (size <= m_Capacity)
+		return true;
+
+	const size_t capacity = ((size + TAKE_FILE_GROW_SIZE - 1) / TAKE_FILE_GROW_SIZE) * TAKE_FILE_GROW_SIZE;
+
+	// a view is mapped again, a file keeps written records
+	UnmapFile();
+	if (MapFile(capacity))
+		return true;
+
+	if (g_VerboseLevel && g_Logger)
+	{
+		std::string info("[TakeRecording] failed to grow a take file to ");
+		info += std::to_string(capacity);
+
+		g_Logger->LogError(info.c_str());
+	}
+	return false;
+}
+
+bool CAnimLiveBridgeTakeWriter::Append(const SSharedModelData& data)
+{
+	if (!m_Buffer)
+		return false;
+
+	if (m_IndexCount == TAKE_INDEX_MAX_FRAMES)
+	{
+		if (g_VerboseLevel && g_Logger)
+		{
+			g_Logger->LogError("[TakeRecording] a take index is full, a frame is not recorded");
+		}
+		return false;
+	}
+
+	const long long now = TakeClockNow();
+	if (m_IndexCount == 0)
+		m_StartTime = now;
+
+	const size_t record_offset = static_cast<size_t>(GetHeader()->m_DataEnd);
+	const size_t max_size = sizeof(STakeFrameHeader) + GetMaxPackedSize(data, false);
+
+	if (!Reserve(record_offset + AlignRecord(max_size)))
+		return false;
+
+	char* record = m_Buffer + record_offset;
+
+	// frames are stored as they are, a take is a lossless copy of a stream
+	unsigned short flags = 0;
+	const size_t size = PackModelData(data, nullptr, record + sizeof(STakeFrameHeader), max_size - sizeof(STakeFrameHeader), flags);
+	if (size == 0)
+		return false;
+
+	STakeFrameHeader frame_header;
+	frame_header.m_Time = 1e-9 * static_cast<double>(now - m_StartTime);
+	frame_header.m_Size = static_cast<unsigned int>(size);
+	frame_header.m_Flags = flags;
+	frame_header.m_Reserved = 0;
+	memcpy(record, &frame_header, sizeof(STakeFrameHeader));
+
+	STakeIndexEntry entry;
+	entry.m_Offset = record_offset;
+	entry.m_Time = frame_header.m_Time;
+	entry.m_LocalTime = data.m_ServerPlayer.m_LocalTime;
+	if (!AppendIndex(entry))
+		return false;
+
+	// a record is complete, a header is moved over it last
+	STakeFileHeader* header = GetHeader();
+	header->m_MaxJoints = (data.m_Header.m_ModelsCount > header->m_MaxJoints) ? data.m_Header.m_ModelsCount : header->m_MaxJoints;
+	header->m_MaxProps = (data.m_Header.m_PropsCount > header->m_MaxProps) ? data.m_Header.m_PropsCount : header->m_MaxProps;
+	header->m_MaxEntities = (data.m_Header.m_EntitiesCount > header->m_MaxEntities) ? data.m_Header.m_EntitiesCount : header->m_MaxEntities;
+	header->m_FramesCount = m_IndexCount;
+	header->m_DataEnd = record_offset + AlignRecord(sizeof(STakeFrameHeader) + size);
+	return true;
+}
+
+////////////////////////////////////////////////////////////////
+// CAnimLiveBridgeTakeReader
+
+CAnimLiveBridgeTakeReader::~CAnimLiveBridgeTakeReader()
+{
+	Close();
+}
+
+#ifdef _WIN32
+
+int CAnimLiveBridgeTakeReader::Open(const char* file_name)
+{
+	Close();
+
+	// a take could be still recording
+	m_File = CreateFileA(file_name, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (m_File == INVALID_HANDLE_VALUE)
+		return -1;
+
+	LARGE_INTEGER file_size;
+	if (!GetFileSizeEx(m_File, &file_size) || file_size.QuadPart < static_cast<LONGLONG>(sizeof(STakeFileHeader)))
+	{
+		Close();
+		return -1;
+	}
+
+	m_Mapping = CreateFileMappingA(m_File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (m_Mapping == 0)
+	{
+		Close();
+		return -1;
+	}
+
+	m_Buffer = static_cast<const char*>(MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0));
+	m_Size = static_cast<size_t>(file_size.QuadPart);
+
+	if (m_Buffer == nullptr || !ReadIndex())
+	{
+		Close();
+		return -1;
+	}
+	return 0;
+}
+
+void CAnimLiveBridgeTakeReader::Close()
+{
+	if (m_Buffer)
+	{
+		UnmapViewOfFile(m_Buffer);
+		m_Buffer = nullptr;
+	}
+	if (m_Mapping)
+	{
+		CloseHandle(m_Mapping);
+		m_Mapping = 0;
+	}
+	if (m_File != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(m_File);
+		m_File = INVALID_HANDLE_VALUE;
+	}
+	m_Size = 0;
+	m_Index.clear();
+}
+
+#else
+
+int CAnimLiveBridgeTakeReader::Open(const char* file_name)
+{
+	Close();
+
+	m_File = open(file_name, O_RDONLY);
+	if (m_File < 0)
+		return -1;
+
+	struct stat file_stat;
+	if (fstat(m_File, &file_stat) != 0 || file_stat.st_size < static_cast<off_t>(sizeof(STakeFileHeader)))
+	{
+		Close();
+		return -1;
+	}
+
+	void* buffer = mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ, MAP_SHARED, m_File, 0);
+	if (buffer == MAP_FAILED)
+	{
+		Close();
+		return -1;
+	}
+
+	m_Buffer = static_cast<const char*>(buffer);
+	m_Size = static_cast<size_t>(file_stat.st_size);
+
+	if (!ReadIndex())
+	{
+		Close();
+		return -1;
+	}
+	return 0;
+}
+
+void CAnimLiveBridgeTakeReader::Close()
+{
+	if (m_Buffer)
+	{
+		munmap(const_cast<char*>(m_Buffer), m_Size);
+		m_Buffer = nullptr;
+	}
+	if (m_File >= 0)
+	{
+		close(m_File);
+		m_File = -1;
+	}
+	m_Size = 0;
+	m_Index.clear();
+}
+
+#endif
+
+bool CAnimLiveBridgeTakeReader::ReadIndex()
+{
+	const STakeFileHeader& header = GetHeader();
+
+	if (header.m_Magic != TAKE_FILE_MAGIC || header.m_Version != TAKE_FILE_VERSION || header.m_DataEnd > m_Size)
+		return false;
+
+	const size_t index_size = sizeof(STakeIndexEntry) * header.m_FramesCount;
+
+	if (header.m_IndexOffset >= TAKE_DATA_BEGIN && header.m_IndexOffset + index_size <= m_Size)
+	{
+		m_Index.resize(header.m_FramesCount);
+		memcpy(m_Index.data(), m_Buffer + header.m_IndexOffset, index_size);
+	}
+	else
+	{
+		// a take was not closed, a header still points to a last complete record
+		ScanRecords();
+	}
+	return true;
+}
+
+void CAnimLiveBridgeTakeReader::ScanRecords()
+{
+	const size_t data_end = static_cast<size_t>(GetHeader().m_DataEnd);
+	size_t offset = TAKE_DATA_BEGIN;
+
+	m_Index.clear();
+
+	while (offset + sizeof(STakeFrameHeader) + MODEL_DATA_PREFIX_SIZE <= data_end)
+	{
+		STakeFrameHeader frame_header;
+		memcpy(&frame_header, m_Buffer + offset, sizeof(STakeFrameHeader));
+
+		if (frame_header.m_Size < MODEL_DATA_PREFIX_SIZE || offset + sizeof(STakeFrameHeader) + frame_header.m_Size > data_end)
+			break;
+
+		STakeIndexEntry entry;
+		entry.m_Offset = offset;
+		entry.m_Time = frame_header.m_Time;
+		entry.m_LocalTime = ReadLocalTime(m_Buffer + offset + sizeof(STakeFrameHeader));
+		m_Index.push_back(entry);
+
+		offset += AlignRecord(sizeof(STakeFrameHeader) + frame_header.m_Size);
+	}
+}
+
+unsigned int CAnimLiveBridgeTakeReader::FindFrame(const double time) const
+{
+	// records are appended in time order
+	unsigned int first = 0;
+	unsigned int last = GetFramesCount();
+
+	while (first < last)
+	{
+		const unsigned int middle = first + (last - first) / 2;
+		if (m_Index[middle].m_Time < time)
+			first = middle + 1;
+		else
+			last = middle;
+	}
+	return first;
+}
+
+bool CAnimLiveBridgeTakeReader::ReadFrame(const unsigned int frame_index, SFrameBuffer& frame) const
+{
+	if (frame_index >= GetFramesCount())
+		return false;
+
+	const size_t offset = static_cast<size_t>(m_Index[frame_index].m_Offset);
+	if (offset + sizeof(STakeFrameHeader) > m_Size)
+		return false;
+
+	STakeFrameHeader frame_header;
+	memcpy(&frame_header, m_Buffer + offset, sizeof(STakeFrameHeader));
+
+	if (offset + sizeof(STakeFrameHeader) + frame_header.m_Size > m_Size)
+		return false;
+
+	return UnpackModelData(m_Buffer + offset + sizeof(STakeFrameHeader), frame_header.m_Size, frame_header.m_Flags, frame);
+}
+
+////////////////////////////////////////////////////////////////
+// CAnimLiveBridgeTakeReplay
+
+CAnimLiveBridgeTakeReplay::CAnimLiveBridgeTakeReplay(CAnimLiveBridgeSession* session)
+	: m_Session(session)
+{}
+
+CAnimLiveBridgeTakeReplay::~CAnimLiveBridgeTakeReplay()
+{
+	Stop();
+}
+
+int CAnimLiveBridgeTakeReplay::Start(const char* file_name, const double speed, const bool loop)
+{
+	Stop();
+
+	if (m_Reader.Open(file_name) != 0)
+		return -1;
+
+	// a session capacity is fixed by a hardware open
+	const SFrameBuffer& frame = m_Session->GetUserFrame();
+	const STakeFileHeader& header = m_Reader.GetHeader();
+
+	if (header.m_MaxJoints > frame.m_JointsCapacity || header.m_MaxProps > frame.m_PropsCapacity || header.m_MaxEntities > frame.m_EntitiesCapacity)
+	{
+		if (g_VerboseLevel && g_Logger)
+		{
+			std::string info("[TakeReplay] take frames don't fit a session capacity, joints ");
+			info += std::to_string(header.m_MaxJoints);
+			info += ", properties ";
+			info += std::to_string(header.m_MaxProps);
+			info += ", entities ";
+			info += std::to_string(header.m_MaxEntities);
+
+			g_Logger->LogError(info.c_str());
+		}
+		m_Reader.Close();
+		return -5;
+	}
+
+	m_Speed = (speed > 0.0) ? speed : 0.0;
+	m_Loop = loop;
+	m_Position.store(0);
+	m_SeekTarget.store(0);
+	m_SeekRequest.store(false);
+	m_StopRequest.store(false);
+
+	m_Running.store(true);
+	m_Thread = std::thread(&CAnimLiveBridgeTakeReplay::Run, this);
+	return 0;
+}
+
+void CAnimLiveBridgeTakeReplay::Stop()
+{
+	if (m_Thread.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_Lock);
+			m_StopRequest.store(true);
+		}
+		m_Condition.notify_all();
+		m_Thread.join();
+	}
+	m_Reader.Close();
+}
+
+bool CAnimLiveBridgeTakeReplay::Seek(const unsigned int frame_index)
+{
+	if (!m_Running.load() || frame_index >= m_Reader.GetFramesCount())
+		return false;
+
+	{
+		std::lock_guard<std::mutex> lock(m_Lock);
+		m_SeekTarget.store(frame_index);
+		m_SeekRequest.store(true);
+	}
+	m_Condition.notify_all();
+	return true;
+}
+
+bool CAnimLiveBridgeTakeReplay::WaitUntil(const std::chrono::steady_clock::time_point& time)
+{
+	std::unique_lock<std::mutex> lock(m_Lock);
+	return !m_Condition.wait_until(lock, time, [this]() { return m_StopRequest.load() || m_SeekRequest.load(); });
+}
+
+void CAnimLiveBridgeTakeReplay::Run()
+{
+	const unsigned int frames_count = m_Reader.GetFramesCount();
+
+	unsigned int index = m_Position.load();
+	std::chrono::steady_clock::time_point clock_start = std::chrono::steady_clock::now();
+	double take_start = (index < frames_count) ? m_Reader.GetIndexEntry(index).m_Time : 0.0;
+
+	while (!m_StopRequest.load())
+	{
+		if (m_SeekRequest.exchange(false))
+		{
+			index = m_SeekTarget.load();
+			m_Position.store(index);
+			clock_start = std::chrono::steady_clock::now();
+			take_start = m_Reader.GetIndexEntry(index).m_Time;
+		}
+
+		if (index >= frames_count)
+		{
+			if (!m_Loop || frames_count == 0)
+				break;
+
+			index = 0;
+			clock_start = std::chrono::steady_clock::now();
+			take_start = m_Reader.GetIndexEntry(0).m_Time;
+		}
+
+		std::chrono::steady_clock::time_point next_time = std::chrono::steady_clock::time_point::max();
+
+		if (m_Speed > 0.0)
+		{
+			const double delay = (m_Reader.GetIndexEntry(index).m_Time - take_start) / m_Speed;
+			const std::chrono::steady_clock::time_point frame_time = clock_start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(delay));
+
+			if (!WaitUntil(frame_time))
+				continue;
+
+			if (index + 1 < frames_count)
+			{
+				const double next_delay = (m_Reader.GetIndexEntry(index + 1).m_Time - take_start) / m_Speed;
+				next_time = clock_start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(next_delay));
+			}
+		}
+
+		// a replay owns a session frame while it's running
+		m_Reader.ReadFrame(index, m_Session->GetUserFrame());
+
+		// a frame which can't be handed off until a next one is due is dropped
+		while (!m_StopRequest.load() && !m_SeekRequest.load() && m_Session->Commit(true) == -1)
+		{
+			if (std::chrono::steady_clock::now() >= next_time)
+				break;
+
+			m_Session->WaitForFrame(1);
+		}
+
+		++index;
+		m_Position.store(index);
+	}
+
+	m_Running.store(false);
+}
@@ -0,0 +1,213 @@
+#pragma once
+
+/*
+#
+# Copyright(c) 2021 Avalanche Studios.All rights reserved.
+# Licensed under the MIT License.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files(the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions :
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE
+#
+*/
+
+
+#include "AnimLiveBridgeSession.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+#ifdef _WIN32
+	#include <windows.h>
+#endif
+
+// take file layout
+//  STakeFileHeader, frame records (STakeFrameHeader + packed model data, 8 bytes aligned), STakeIndexEntry[frames count]
+//  a header is updated after every record, so a take which was not closed is still readable by a record scan
+
+const unsigned int TAKE_FILE_MAGIC = 0x4B424C41;	// ALBK
+const unsigned int TAKE_FILE_VERSION = 1;
+const size_t TAKE_FILE_GROW_SIZE = 64 * 1024 * 1024;	// a mapping grows in steps, a file is truncated to a used size on close
+const unsigned int TAKE_INDEX_MAX_FRAMES = 16 * 1024 * 1024;	// an index region reserves address space for 38 hours at 120 fps
+
+struct STakeFileHeader
+{
+	unsigned int		m_Magic;
+	unsigned int		m_Version;
+	unsigned int		m_FramesCount;
+	unsigned int		m_MaxJoints;			// max counts of recorded frames, a replay session capacity
+	unsigned int		m_MaxProps;
+	unsigned int		m_MaxEntities;
+	unsigned long long	m_DataEnd;				// end of a last complete record
+	unsigned long long	m_IndexOffset;			// 0 until a take is closed
+};
+
+struct STakeFrameHeader
+{
+	double				m_Time;					// seconds from a first recorded frame
+	unsigned int		m_Size;					// packed model data size
+	unsigned short		m_Flags;				// ENetworkFrameFlags of packed data
+	unsigned short		m_Reserved;
+};
+
+struct STakeIndexEntry
+{
+	unsigned long long	m_Offset;				// record offset from a file beginning
+	double				m_Time;
+	double				m_LocalTime;			// server player local time, a take could be seeked by a timeline
+};
+
+////////////////////////////////////////////////////////////////
+// CAnimLiveBridgeTakeWriter
+//  append-only memory-mapped take, frames are packed straight into a mapped view
+
+class CAnimLiveBridgeTakeWriter
+{
+public:
+	~CAnimLiveBridgeTakeWriter();
+
+	//! create or overwrite a take file, 0 if succeed, -1 on a file error
+	int Open(const char* file_name);
+	//! write a frame index, truncate a file to a used size and close it. Returns recorded frames count
+	int Close();
+
+	bool IsOpen() const { return m_Buffer != nullptr; }
+
+	//! append a frame record, returns false on a file error
+	bool Append(const SSharedModelData& data);
+
+	unsigned int GetFramesCount() const { return (m_Buffer) ? GetHeader()->m_FramesCount : 0; }
+
+protected:
+
+	char*							m_Buffer{ nullptr };
+	size_t							m_Capacity{ 0 };
+	long long						m_StartTime{ 0 };
+
+	// index is kept in a reserved virtual memory region until close, entries are written in place and never moved,
+	//  pages are committed as it grows
+	STakeIndexEntry*				m_Index{ nullptr };
+	unsigned int					m_IndexCount{ 0 };
+#ifdef _WIN32
+	size_t							m_IndexCommitted{ 0 };
+#endif
+
+#ifdef _WIN32
+	HANDLE							m_File{ INVALID_HANDLE_VALUE };
+	HANDLE							m_Mapping{ 0 };
+#else
+	int								m_File{ -1 };
+#endif
+
+	STakeFileHeader* GetHeader() const { return reinterpret_cast<STakeFileHeader*>(m_Buffer); }
+
+	bool Reserve(const size_t size);
+	bool MapFile(const size_t capacity);
+	void UnmapFile();
+
+	bool MapIndex();
+	void UnmapIndex();
+	//! returns false if an index region is full
+	bool AppendIndex(const STakeIndexEntry& entry);
+	//! copy an index to a file end, returns a file size
+	unsigned long long WriteIndex();
+};
+
+////////////////////////////////////////////////////////////////
+// CAnimLiveBridgeTakeReader
+//  read-only mapped take, a frame index is read from a footer or rebuilt by a record scan
+
+class CAnimLiveBridgeTakeReader
+{
+public:
+	~CAnimLiveBridgeTakeReader();
+
+	//! 0 if succeed, -1 if a file is not found or it's not a take
+	int Open(const char* file_name);
+	void Close();
+
+	unsigned int GetFramesCount() const { return static_cast<unsigned int>(m_Index.size()); }
+	const STakeFileHeader& GetHeader() const { return *reinterpret_cast<const STakeFileHeader*>(m_Buffer); }
+	const STakeIndexEntry& GetIndexEntry(const unsigned int frame_index) const { return m_Index[frame_index]; }
+
+	//! first frame at or after a given take time
+	unsigned int FindFrame(const double time) const;
+
+	//! unpack a frame into a frame buffer, returns false if a frame buffer is too small
+	bool ReadFrame(const unsigned int frame_index, SFrameBuffer& frame) const;
+
+protected:
+
+	const char*						m_Buffer{ nullptr };
+	size_t							m_Size{ 0 };
+	std::vector<STakeIndexEntry>	m_Index;
+
+#ifdef _WIN32
+	HANDLE							m_File{ INVALID_HANDLE_VALUE };
+	HANDLE							m_Mapping{ 0 };
+#else
+	int								m_File{ -1 };
+#endif
+
+	bool ReadIndex();
+	void ScanRecords();
+};
+
+////////////////////////////////////////////////////////////////
+// CAnimLiveBridgeTakeReplay
+//  a replay thread pushes take frames into a server session and commits them at a given speed
+
+class CAnimLiveBridgeTakeReplay
+{
+public:
+	CAnimLiveBridgeTakeReplay(CAnimLiveBridgeSession* session);
+	~CAnimLiveBridgeTakeReplay();
+
+	//! speed is a multiple of a real time, 0 to replay as fast as a session takes frames. Returns 0, -1 on a file error, -5 if a take doesn't fit a session
+	int Start(const char* file_name, const double speed, const bool loop);
+	void Stop();
+
+	bool IsRunning() const { return m_Running.load(); }
+	//! next frame to replay
+	unsigned int GetPosition() const { return m_Position.load(); }
+	bool Seek(const unsigned int frame_index);
+
+protected:
+
+	CAnimLiveBridgeSession*			m_Session{ nullptr };
+	CAnimLiveBridgeTakeReader		m_Reader;
+
+	double							m_Speed{ 1.0 };
+	bool							m_Loop{ false };
+
+	std::thread						m_Thread;
+	std::atomic<bool>				m_Running{ false };
+	std::atomic<bool>				m_StopRequest{ false };
+	std::atomic<unsigned int>		m_Position{ 0 };			//!< a next frame to replay, written by a replay thread only
+	std::atomic<unsigned int>		m_SeekTarget{ 0 };			//!< a frame requested by Seek, taken with m_SeekRequest
+	std::atomic<bool>				m_SeekRequest{ false };
+
+	std::mutex						m_Lock;
+	std::condition_variable			m_Condition;
+
+	void Run();
+	//! sleep until a time or a stop / seek request, returns false if a replay should stop or restart a clock
+	bool WaitUntil(const std::chrono::steady_clock::time_point& time);
+};
@@ -0,0 +1,76 @@
+#pragma once
+
+/*
+#
+# Copyright(c) 2021 Avalanche Studios.All rights reserved.
+# Licensed under the MIT License.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files(the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions :
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE
+#
+*/
+
+#include <atomic>
+
+const unsigned int TRIPLE_BUFFER_INDEX_MASK = 3;
+const unsigned int TRIPLE_BUFFER_NEW_DATA = 4;
+
+////////////////////////////////////////////////////////////
+// STripleBufferState
+//  lock-free latest value exchange between one writer and one reader
+//  writer owns a back slot, reader owns a front slot and they swap with a middle one
+//  state is a plain memory block, so it can live inside a shared region
+
+struct STripleBufferState
+{
+	std::atomic<unsigned int>	m_State;		//!< middle slot index and a new data bit
+	unsigned int				m_WriteIndex;	//!< back slot, modified only by a writer
+	unsigned int				m_ReadIndex;	//!< front slot, modified only by a reader
+	unsigned int				m_FrameIndex;	//!< last published frame, modified only by a writer
+
+	void Initialize()
+	{
+		m_WriteIndex = 0;
+		m_State.store(1);
+		m_ReadIndex = 2;
+		m_FrameIndex = 0;
+	}
+
+	//! writer never waits, back slot is swapped with a middle one
+	void Publish()
+	{
+		const unsigned int prev = m_State.exchange(m_WriteIndex | TRIPLE_BUFFER_NEW_DATA, std::memory_order_acq_rel);
+		m_WriteIndex = prev & TRIPLE_BUFFER_INDEX_MASK;
+	}
+
+	//! take the newest published slot, returns false if nothing new was published since the last call
+	bool Acquire()
+	{
+		if ((m_State.load(std::memory_order_acquire) & TRIPLE_BUFFER_NEW_DATA) == 0)
+			return false;
+
+		const unsigned int prev = m_State.exchange(m_ReadIndex, std::memory_order_acq_rel);
+		m_ReadIndex = prev & TRIPLE_BUFFER_INDEX_MASK;
+		return true;
+	}
+
+	bool HasNewData() const
+	{
+		return (m_State.load(std::memory_order_acquire) & TRIPLE_BUFFER_NEW_DATA) != 0;
+	}
+};
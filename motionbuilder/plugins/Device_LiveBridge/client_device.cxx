@@ -88,6 +88,9 @@ bool CClientDevice::FBCreate()
 	FBPropertyPublish(this, StoryClipIndex, "Story Clip Index", nullptr, nullptr);
 	StoryClipIndex = 0;
 	StoryClipIndex.SetMinMax(0.0, 10.0, true, true);
+	FBPropertyPublish(this, JitterBufferDelay, "Jitter Buffer Delay", nullptr, nullptr);
+	JitterBufferDelay = 0;
+	JitterBufferDelay.SetMinMax(0.0, 200.0, true, true);
 
 	FBPropertyPublish(this, LoadRotationSetup, "Load Rotation Setup", nullptr, ActionLoadRotationSetup);
 
@@ -231,6 +234,8 @@ bool CClientDevice::Start()
 	Progress.Caption	= "Setting up device";
 
 	// Step 1: Open device
+	mHardware.SetJitterBufferDelay(JitterBufferDelay);
+
 	if(! mHardware.Open(PairName) )
 	{
 		Information = "Could not open device";
@@ -99,6 +99,7 @@ public:
 	FBPropertyString		PairName;
 	FBPropertyBool			SyncTimeWithStoryClip;		// get local time from story clip instead of timeline
 	FBPropertyInt			StoryClipIndex;				// index of a clip on a story track to take start time from
+	FBPropertyInt			JitterBufferDelay;			// milliseconds, a pose is interpolated between received frames, 0 to take frames as they come
 
 	FBPropertyListObject	LookAtRoot;
 	FBPropertyListObject	LookAtLeft;
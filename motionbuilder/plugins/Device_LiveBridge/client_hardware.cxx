@@ -50,6 +50,7 @@ CClientHardware::CClientHardware()
 			m_ChannelData[i][j] = 0.0;
 		}
 		m_ChannelNameHash[i] = 0;
+		m_ChannelJoint[i] = -1;
 		m_DataReceived[i] = false;
 	}
 
@@ -71,6 +72,9 @@ CClientHardware::~CClientHardware()
  ************************************************/
 bool CClientHardware::Open(const char* pair_name)
 {
+	SetLiveSessionPropertyInt(m_SessionId, ELiveSessionProperty_JitterBufferDelay, m_JitterBufferDelay);
+	m_PoseSampled = false;
+
 	const int status = HardwareOpen(m_SessionId, pair_name, false);
 
 	if (status != 0)
@@ -106,6 +110,9 @@ bool CClientHardware::GetSetupInfo()
 		m_ChannelNameHash[i] = HashPairName(name);
 	}
 
+	// a remap is built again on a next frame
+	m_SchemaId = 0;
+
 	return true;
 }
 
@@ -130,6 +137,26 @@ bool CClientHardware::FetchDataPacket(FBTime &pTime)
 	// TODO: insert time stamp from data packet
 	//pTime = mSystem.SystemTime;
 
+	if (m_JitterBufferDelay > 0)
+	{
+		// one interpolated pose per device evaluation, a second call finishes a fetch loop
+		m_PoseSampled = !m_PoseSampled;
+		if (!m_PoseSampled)
+			return false;
+
+		// received frames go into a session jitter buffer
+		PollData();
+
+		if (!SamplePose())
+			return false;
+
+		if (m_TimeChanged)
+		{
+			pTime = m_LocalTime;
+		}
+		return true;
+	}
+
 	// TODO: Replace this bogus code with real NON-BLOCKING TCP, UDP or serial calls
 	// to your data server.
 	if (!PollData())
@@ -162,6 +189,45 @@ bool CClientHardware::FetchDataPacket(FBTime &pTime)
  *	Device should get itself to send more data.
  ************************************************/
 bool CClientHardware::PollData()
+{
+	m_Counter++;
+	
+	// read straight from the shared view, no copy into a local session buffer
+	if (const SSharedModelData* data = AcquireReadView(m_SessionId))
+	{
+		// a view is already stored by a session jitter buffer, channels are sampled from it
+		if (m_JitterBufferDelay == 0)
+		{
+			ReadChannels(data);
+		}
+
+		ReleaseReadView(m_SessionId, true);
+	}
+	else
+	{
+		return false;
+	}
+	
+	return true;
+}
+
+
+/************************************************
+ *	Sample a jitter buffer.
+ *	Pose is interpolated at a current time minus a jitter buffer delay.
+ ************************************************/
+bool CClientHardware::SamplePose()
+{
+	if (const SSharedModelData* data = SampleModelData(m_SessionId, 0.0))
+	{
+		ReadChannels(data);
+		return true;
+	}
+	return false;
+}
+
+
+void CClientHardware::ReadChannels(const SSharedModelData* data)
 {
 	//Rotational data is in Euler angles in degrees
 	//the order is: XYZ. In other words:
@@ -169,65 +235,50 @@ bool CClientHardware::PollData()
 	//- followed by a rotation around the 'Y' axis
 	//- followed by a rotation around the 'Z' axis
 
-	m_Counter++;
-	
-	const int error_code = HardwareCommit(m_SessionId, false);
-	if (error_code == 0)
+	// channels are matched with frame joints only when a streamed rig is changed
+	const unsigned int schema_id = GetJointSchemaId(data);
+	if (schema_id != m_SchemaId)
 	{
-		for (int j = 0; j < m_ChannelCount; ++j)
-		{
-			m_DataReceived[j] = false;
-		}
+		BuildJointRemap(data, m_ChannelNameHash, static_cast<unsigned int>(m_ChannelCount), m_ChannelJoint);
+		m_SchemaId = schema_id;
+	}
+
+	// quaternions of all channels are converted with one batch call
+	SVector4 quaternions[MAX_CHANNEL];
+	SVector3 euler[MAX_CHANNEL];
+	int quaternion_channels[MAX_CHANNEL];
+	unsigned int quaternions_count = 0;
+
+	const SJointData* joints = GetModelJoints(data);
+	const int count = data->m_Header.m_ModelsCount;
+	for (int j = 0; j < m_ChannelCount; ++j)
+	{
+		const int i = m_ChannelJoint[j];
 
-		FBVector3d r;
-		FBQuaternion q;
+		m_DataReceived[j] = (i >= 0 && i < count);
+		if (!m_DataReceived[j])
+			continue;
 
-		SSharedModelData* data = MapModelData(m_SessionId);
+		ConvertFloatsToDoubles(&joints[i].m_Transform.m_Translation.m_X, &m_ChannelData[j][DATA_TX], 3);
 
-		const int count = data->m_Header.m_ModelsCount;
-		for (int i = 0; i < count; ++i)
+		if (joints[i].m_Flags & HINT_ROTATION_EULERANGLES)
 		{
-			// find a channel
-			for (int j = 0; j < m_ChannelCount; ++j)
-			{
-				if (m_ChannelNameHash[j] == data->m_Joints.m_Data[i].m_NameHash)
-				{
-					const float* joint_translation{ &data->m_Joints.m_Data[i].m_Transform.m_Translation.m_X };
-					const float* joint_rotation{ &data->m_Joints.m_Data[i].m_Transform.m_Rotation.m_X };
-
-					for (int k = 0; k < 3; ++k)
-					{
-						m_ChannelData[j][DATA_TX + k] = static_cast<double>(joint_translation[k]);
-						q[k] = static_cast<double>(joint_rotation[k]);
-					}
-
-					if (data->m_Joints.m_Data[i].m_Flags & HINT_ROTATION_EULERANGLES)
-					{
-						memcpy(&m_ChannelData[j][DATA_RX], q, sizeof(double) * 3);
-					}
-					else
-					{
-						q[3] = static_cast<double>(joint_rotation[3]);
-						FBQuaternionToRotation(r, q);
-
-						memcpy(&m_ChannelData[j][DATA_RX], r, sizeof(double) * 3);
-					}
-
-					m_DataReceived[j] = true;
-					break;
-				}
-			}
+			ConvertFloatsToDoubles(&joints[i].m_Transform.m_Rotation.m_X, &m_ChannelData[j][DATA_RX], 3);
+		}
+		else
+		{
+			quaternions[quaternions_count] = joints[i].m_Transform.m_Rotation;
+			quaternion_channels[quaternions_count] = j;
+			++quaternions_count;
 		}
-
-		SetFinishEvent(m_SessionId);
 	}
-	else
+
+	QuaternionsToEuler(quaternions, euler, quaternions_count);
+
+	for (unsigned int k = 0; k < quaternions_count; ++k)
 	{
-		//FBTrace("Failed to flush on client side, error code %d and session id %d\n", error_code, m_SessionId);
-		return false;
+		ConvertFloatsToDoubles(&euler[k].m_X, &m_ChannelData[quaternion_channels[k]][DATA_RX], 3);
 	}
-	
-	return true;
 }
 
 /************************************************
@@ -70,6 +70,7 @@ public:
 	//--- Hardware communication
 	bool	FetchDataPacket	(FBTime &pTime);		//!< Fetch a data packet from the computer.
 	bool	PollData		();						//!< Poll the device for a data packet.
+	bool	SamplePose		();						//!< Interpolate channels from a jitter buffer at a current time.
 	bool	GetSetupInfo	();						//!< Get the setup information.
 	bool	StartDataStream	();						//!< Put the device in streaming mode.
 	bool	StopDataStream	();						//!< Take the device out of streaming mode.
@@ -90,6 +91,9 @@ public:
 	void SetLookAtLeft(const FBVector3d& pos) { m_LookAtLeftPos = pos; }
 	void SetLookAtRight(const FBVector3d& pos) { m_LookAtRightPos = pos; }
 
+	//! milliseconds, should be assigned before Open, 0 to read frames as they come
+	void SetJitterBufferDelay(const int delay_ms) { m_JitterBufferDelay = delay_ms; }
+
 	void		SyncSaved();
 	bool		HasNewSync();
 
@@ -113,11 +117,18 @@ private:
 	bool			m_DataReceived[MAX_CHANNEL];
 	FBString		m_ChannelName[MAX_CHANNEL];					//!< Channel name.
 	unsigned int	m_ChannelNameHash[MAX_CHANNEL];
+	int				m_ChannelJoint[MAX_CHANNEL];				//!< frame joint index of a channel, -1 if it's not streamed
+	unsigned int	m_SchemaId{ 0 };							//!< joints layout which a channel remap is built for
 	double			m_ChannelData[MAX_CHANNEL][DATA_TYPE_COUNT];	//!< Channel data.
 
 	int				m_ChannelCount;								//!< Channel count.
 	long			m_Counter;									//!< Time counter for hands.
 
+	int				m_JitterBufferDelay{ 0 };
+	bool			m_PoseSampled{ false };
+
+	void			ReadChannels(const SSharedModelData* data);
+
 	unsigned int				m_SessionId{ 0 };
 	STimelineSyncManager*		m_TimelineSync{ nullptr };
 };
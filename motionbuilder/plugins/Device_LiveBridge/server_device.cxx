@@ -376,14 +376,6 @@ void CServerDevice::ComputeFullRotationMatrix(FBMatrix& tm, FBEvaluateInfo* pEva
 		// model pre rotation
 		FBVector3d preRotation = pModel->PreRotation;
 		FBRotationToMatrix(pretm, preRotation);
-		
-		if (FBModel* parent = pModel->Parent)
-		{
-			FBMatrix parent_tm;
-			parent->GetMatrix(parent_tm, kModelTransformation, true, pEvaluateInfo);
-
-			FBGetLocalMatrix(tm, parent_tm, tm);
-		}
 	}
 }
 
@@ -408,6 +400,13 @@ bool CServerDevice::DeviceEvaluationNotify(kTransportMode pMode, FBEvaluateInfo*
 
 			const int numberOfJoints = GetSetJointsCount();
 
+			// joints with a parent out of a joint set, a local matrix is written after a space conversion
+			mModelJoints.clear();
+			mModelMatrices.clear();
+			mModelParents.clear();
+			mLocalJoints.clear();
+			mLocalMatrices.clear();
+
 			for (int i = 0; i < numberOfJoints; ++i)
 			{
 				mDataChannels.ReadOutputData(i, lPos, lRot, pEvaluateInfo);
@@ -441,7 +440,8 @@ bool CServerDevice::DeviceEvaluationNotify(kTransportMode pMode, FBEvaluateInfo*
 
 						mHardware.WritePos(i, v);
 						mHardware.WriteRot(i, r);
-						mHardware.WriteMatrix(i, tm);
+						const double* values = tm;
+						mHardware.WriteMatrices(&i, values, 1);
 					}
 				}
 				else
@@ -451,12 +451,42 @@ bool CServerDevice::DeviceEvaluationNotify(kTransportMode pMode, FBEvaluateInfo*
 
 					if (RotationIncludeDOF)
 					{
+						// a model matrix is taken once per joint, matrices are decomposed and parents from a joint set are solved after the loop
 						FBMatrix tm;
 						ComputeFullRotationMatrix(tm, pEvaluateInfo, i);
-						mHardware.WriteMatrix(i, tm);
+
+						FBModel* pModel = mDataChannels.GetChannelModel(i);
+						FBModel* parent = (pModel) ? pModel->Parent : nullptr;
+						const unsigned int parent_hash = (parent) ? HashPairName(parent->Name) : 0;
+
+						if (parent && !mHardware.HasModel(parent_hash))
+						{
+							FBMatrix parent_tm, local_tm;
+							parent->GetMatrix(parent_tm, kModelTransformation, true, pEvaluateInfo);
+							FBGetLocalMatrix(local_tm, parent_tm, tm);
+
+							const double* local_values = local_tm;
+							mLocalJoints.push_back(i);
+							mLocalMatrices.insert(end(mLocalMatrices), local_values, local_values + 16);
+						}
+
+						const double* values = tm;
+						mModelJoints.push_back(i);
+						mModelMatrices.insert(end(mModelMatrices), values, values + 16);
+						mModelParents.push_back((mHardware.HasModel(parent_hash)) ? parent_hash : 0);
 					}
 				}
 			}
+
+			if (!mModelJoints.empty())
+			{
+				const unsigned int model_count = static_cast<unsigned int>(mModelJoints.size());
+				mHardware.WriteModelMatrices(mModelJoints.data(), mModelMatrices.data(), mModelParents.data(), model_count);
+				mHardware.ConvertToLocalSpace();
+
+				const unsigned int local_count = static_cast<unsigned int>(mLocalJoints.size());
+				mHardware.WriteMatrices(mLocalJoints.data(), mLocalMatrices.data(), local_count);
+			}
 			
 			AckOneSampleReceived();
 		}
@@ -122,6 +122,13 @@ protected:
 	FBVector3d				mLookAtLeftPos;
 	FBVector3d				mLookAtRightPos;
 
+	// matrices of a frame are collected and decomposed by one batch call, buffers are kept between evaluations
+	std::vector<int>			mModelJoints;
+	std::vector<double>			mModelMatrices;		//!< 16 values per joint
+	std::vector<unsigned int>	mModelParents;
+	std::vector<int>			mLocalJoints;		//!< joints with a parent out of a joint set
+	std::vector<double>			mLocalMatrices;
+
 	void		DoImportTarget();
 	void		DoExportTarget();
 	void		DoSaveRotationSetup();
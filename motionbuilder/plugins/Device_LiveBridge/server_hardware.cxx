@@ -153,28 +153,30 @@ bool CServerHardware::SendDataPacket(FBTime &pTime)
 	// High priority IO thread, must have minimal CPU usage.
 	// Non-blocking IO, send data to hardware via comm port, network, etc.
 	
-	if (SSharedModelData* model_data = MapModelData(m_SessionId))
+	// write straight into the shared slot, only producer values and used joints/properties are copied
+	if (SSharedModelData* slot = AcquireWriteSlot(m_SessionId))
 	{
-		memcpy(model_data, m_Data, sizeof(SSharedModelData));
-		UnMapModelData(m_SessionId);
+		const unsigned int joints_count = (m_Data->m_Header.m_ModelsCount < NUMBER_OF_JOINTS) ? m_Data->m_Header.m_ModelsCount : NUMBER_OF_JOINTS;
+		const unsigned int props_count = (m_Data->m_Header.m_PropsCount < NUMBER_OF_PROPERTIES) ? m_Data->m_Header.m_PropsCount : NUMBER_OF_PROPERTIES;
 
-		const int error_code = HardwareCommit(m_SessionId, true);
+		slot->m_Header.m_ServerTag = m_Data->m_Header.m_ServerTag;
+		slot->m_Header.m_ModelsCount = joints_count;
+		slot->m_Header.m_PropsCount = props_count;
+		slot->m_ModelNameHash = m_Data->m_ModelNameHash;
+		slot->m_ModelResourceHash = m_Data->m_ModelResourceHash;
+
+		memcpy(slot->m_Joints.m_Data, m_Data->m_Joints.m_Data, sizeof(SJointData) * joints_count);
+		memcpy(slot->m_Properties.m_Data, m_Data->m_Properties.m_Data, sizeof(SPropertyData) * props_count);
+
+		const int error_code = PublishWriteSlot(m_SessionId, true);
 
 		if (error_code != 0)
 		{
 			//FBTrace("Failed to Flush Server Data with error code %d and session id %d\n", error_code, m_SessionId);
 			return false;
 		}
-		else
-		{
-			//FBTrace("Flush Server Data succeed for session %d\n", m_SessionId);
-		}
 		return true;
 	}
-	else
-	{
-		FBTrace("Failed to MapModelData for session %d\n", m_SessionId);
-	}
 
 	return false;
 }
@@ -183,11 +185,22 @@ bool CServerHardware::SendDataPacket(FBTime &pTime)
 void CServerHardware::SetNumberOfActiveModels(const int count)
 {
 	m_Data->m_Header.m_ModelsCount = count;
+
+	// a joint set is rebuilt, names come with SetModelName again
+	m_ModelIndices.clear();
 }
 
 void CServerHardware::SetModelName(const int index, const char* name)
 {
-	m_Data->m_Joints.m_Data[index].m_NameHash = static_cast<uint32_t>(std::hash<std::string>{}(name));
+	const unsigned int name_hash = HashPairName(name);
+
+	m_Data->m_Joints.m_Data[index].m_NameHash = name_hash;
+	m_ModelIndices[name_hash] = index;
+}
+
+bool CServerHardware::HasModel(const unsigned int name_hash) const
+{
+	return m_ModelIndices.find(name_hash) != end(m_ModelIndices);
 }
 unsigned int CServerHardware::GetModelNameHash(const int index)
 {
@@ -226,30 +239,38 @@ void CServerHardware::WriteRot( const int index, const double* pRot )
 	m_Data->m_Joints.m_Data[index].m_Flags = HINT_ROTATION_EULERANGLES;
 }
 
-void CServerHardware::WriteMatrix(const int index, const FBMatrix& tm)
+void CServerHardware::WriteMatrices(const int* indices, const double* matrices, const unsigned int count)
 {
-	// combine with pre-rotation
+	// the same decomposition as every other endpoint, translation, quaternion and scale
+	if (m_Transforms.size() < count)
+		m_Transforms.resize(count);
 
-	FBTVector t;
-	FBQuaternion q;
-	FBSVector s;
+	MatricesToTransforms(matrices, m_Transforms.data(), count);
 
-	FBMatrixToTQS(t, q, s, tm);
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		SJointData& info = m_Data->m_Joints.m_Data[indices[i]];
+		info.m_Transform = m_Transforms[i];
+		info.m_Flags = HINT_ROTATION_QUATERNION;
+	}
+}
 
-	SJointData& info = m_Data->m_Joints.m_Data[index];
-	
-	float* translation = &info.m_Transform.m_Translation.m_X;
-	float* rotation = &info.m_Transform.m_Rotation.m_X;
+void CServerHardware::WriteModelMatrices(const int* indices, const double* matrices, const unsigned int* parent_hashes, const unsigned int count)
+{
+	WriteMatrices(indices, matrices, count);
 
-	for (int i = 0; i < 3; ++i)
+	for (unsigned int i = 0; i < count; ++i)
 	{
-		translation[i] = static_cast<float>(t[i]);
-		rotation[i] = static_cast<float>(q[i]);
+		SJointData& info = m_Data->m_Joints.m_Data[indices[i]];
+		info.m_ParentHash = parent_hashes[i];
+		info.m_Flags |= HINT_TRANSFORM_MODEL;
 	}
+}
 
-	rotation[3] = static_cast<float>(q[3]);
-
-	info.m_Flags = HINT_ROTATION_QUATERNION;
+void CServerHardware::ConvertToLocalSpace()
+{
+	const unsigned int joints_count = (m_Data->m_Header.m_ModelsCount < NUMBER_OF_JOINTS) ? m_Data->m_Header.m_ModelsCount : NUMBER_OF_JOINTS;
+	ConvertJointSpace(m_Data->m_Joints.m_Data, joints_count, HINT_TRANSFORM_LOCAL);
 }
 
 void CServerHardware::WriteProp(const int index, const double value)
@@ -31,6 +31,8 @@
 //--- Class declarations
 #include <fbsdk/fbsdk.h>
 #include "shared.h"
+#include <unordered_map>
+#include <vector>
 
 ////////////////////////////////////////////////////////////////////////////////////////
 //! Server hardware.
@@ -65,7 +67,13 @@ public:
 	unsigned int GetModelNameHash(const int index);
 	void	WritePos( const int index, const double* pPos );
 	void	WriteRot( const int index, const double* pRot );
-	void	WriteMatrix(const int index, const FBMatrix& tm);
+	//! decompose count matrices (16 values each) of a frame with one batch call
+	void	WriteMatrices(const int* indices, const double* matrices, const unsigned int count);
+	//! model space matrices, parents from a joint set are solved by ConvertToLocalSpace
+	void	WriteModelMatrices(const int* indices, const double* matrices, const unsigned int* parent_hashes, const unsigned int count);
+	bool	HasModel(const unsigned int name_hash) const;
+	//! convert model space joints to a local space with one pass over all joints
+	void	ConvertToLocalSpace();
 	void	SetNumberOfActiveProperties(const int count);
 	void	WriteProp(const int index, const double value);
 	
@@ -92,4 +100,7 @@ private:
 	unsigned int				m_SessionId{ 0 };
 	SSharedModelData*			m_Data;
 	STimelineSyncManager*		m_TimelineSync{ nullptr };
+
+	std::unordered_map<unsigned int, int>	m_ModelIndices;		//!< joint set name hash -> joint index
+	std::vector<STransform>					m_Transforms;		//!< decomposed matrices of a frame before they go to joints
 };
@@ -62,6 +62,24 @@ namespace NShared
 		return nullptr;
 	}
 
+	// a loaded joint set is streamed by name hashes, report names which can't be told apart
+	int CheckJointSetHashes()
+	{
+		CNameHashRegistry registry;
+
+		for (const std::string& name : g_JointSet)
+		{
+			const int collisions = registry.GetCollisionsCount();
+			const unsigned int hash = registry.Register(name.c_str());
+
+			if (registry.GetCollisionsCount() > collisions)
+			{
+				FBTrace("[JointSet] %s has the same name hash as %s (%u)\n", name.c_str(), registry.FindName(hash), hash);
+			}
+		}
+		return registry.GetCollisionsCount();
+	}
+
 	bool FindParentInList(FBModel* model, FBModelList* models)
 	{
 
@@ -126,6 +144,7 @@ namespace NShared
 			g_JointSet.push_back(model_name);
 		}
 
+		CheckJointSetHashes();
 		return true;
 	}
 
@@ -224,6 +243,8 @@ namespace NShared
 				g_JointSet[i] = pFbxObject->FieldReadC();
 			}
 			pFbxObject->FieldReadEnd();
+
+			CheckJointSetHashes();
 		}
 
 		return (!g_ReferenceName.empty());
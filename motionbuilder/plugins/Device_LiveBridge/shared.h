@@ -45,6 +45,7 @@
 //namespace NAnimationLiveBridge
 //{
 	struct SSharedModelData;
+	struct STransform;
 	struct STimelineSyncManager;
 //};
 
@@ -274,6 +275,9 @@ namespace NShared
 	const int GetSetJointsCount();
 	const char* GetTestJointName(const int index);
 
+	//! returns a number of joint names with a hash of another name, collisions are traced
+	int CheckJointSetHashes();
+
 	bool ImportJointSet(const char* filename);
 	bool ExportJointSet(const char* filename);
 
@@ -0,0 +1,483 @@
+
+/*
+#
+# Copyright(c) 2021 Avalanche Studios.All rights reserved.
+# Licensed under the MIT License.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files(the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions :
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE
+#
+*/
+
+// Benchmark of live bridge transports
+// Server and client sessions run in one process, a server publishes a frame and a client takes it
+// Every configuration of a sweep reports frames per second and handoff latency percentiles
+//
+// usage: AnimLiveBridgeBenchmark [--format csv|json] [--output file] [--frames N] [--transport all|sm|sm_latest|tcp|udp] [--quick]
+
+#include "AnimLiveBridge.h"
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <vector>
+#include <memory>
+#include <string>
+#include <algorithm>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+
+#ifdef _WIN32
+	#include <windows.h>
+#else
+	#include <pthread.h>
+	#include <sched.h>
+#endif
+
+const char* BENCHMARK_ADDRESS = "127.0.0.1";
+const char* BENCHMARK_PAIR_NAME = "benchmark_pair";
+const int BENCHMARK_PORT = 18880;
+const unsigned int BENCHMARK_END_TAG = UINT32_MAX;
+
+// a streaming server doesn't wait for an answer longer than that, a frame is counted as lost
+const long long BENCHMARK_ACK_TIMEOUT_NS = 2000000;
+// a configuration is stopped when a client sees nothing for that long
+const long long BENCHMARK_STALL_TIMEOUT_NS = 3000000000ll;
+
+enum EBenchmarkPlacement
+{
+	EBenchmarkPlacement_Default,		// threads are placed by an os
+	EBenchmarkPlacement_Pinned,			// server and client are pinned to different cpus
+	EBenchmarkPlacement_IOThread,		// both sessions run with ELiveSessionProperty_IOThread
+	EBenchmarkPlacement_Count
+};
+
+const char* PLACEMENT_NAMES[EBenchmarkPlacement_Count] = { "default", "pinned", "io_thread" };
+
+struct STransportConfig
+{
+	const char*		m_Name;
+	int				m_CommunicationType;
+	int				m_ExchangeMode;
+};
+
+const STransportConfig TRANSPORTS[] = {
+	{ "sm", static_cast<int>(ECommunicationType::SharedMemory), EExchangeMode_PingPong },
+	{ "sm_latest", static_cast<int>(ECommunicationType::SharedMemory), EExchangeMode_LatestValue },
+	{ "tcp", static_cast<int>(ECommunicationType::NetworkTCP), EExchangeMode_PingPong },
+	{ "udp", static_cast<int>(ECommunicationType::NetworkUDP), EExchangeMode_PingPong }
+};
+
+struct SBenchmarkConfig
+{
+	const STransportConfig*	m_Transport;
+	EBenchmarkPlacement		m_Placement;
+	unsigned int			m_Joints;
+	unsigned int			m_Props;
+	int						m_Frames;
+	int						m_Port;
+};
+
+struct SBenchmarkResult
+{
+	int				m_Result{ 0 };			// 0 - ok, otherwise a first failed api result
+	int				m_FramesReceived{ 0 };
+	double			m_PayloadBytes{ 0.0 };	// bytes moved per received frame
+	double			m_FramesPerSecond{ 0.0 };
+	double			m_P50{ 0.0 };
+	double			m_P99{ 0.0 };
+	double			m_P999{ 0.0 };
+	double			m_Max{ 0.0 };
+	unsigned long long	m_Dropped{ 0 };
+};
+
+// a server and a client exchange publish times and acknowledges in process, a frame itself is not touched
+struct SBenchmarkState
+{
+	std::unique_ptr<std::atomic<long long>[]>	m_PublishTime;
+	std::atomic<long long>						m_Acknowledged{ -1 };
+	std::atomic<bool>							m_ClientReady{ false };
+	std::atomic<bool>							m_ClientDone{ false };
+	std::atomic<int>							m_Result{ 0 };
+};
+
+long long benchmark_now()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void pin_current_thread(const int cpu)
+{
+#ifdef _WIN32
+	SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << cpu);
+#elif defined(__linux__)
+	cpu_set_t cpu_set;
+	CPU_ZERO(&cpu_set);
+	CPU_SET(cpu, &cpu_set);
+	pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+#endif
+}
+
+unsigned int open_session(const SBenchmarkConfig& config, const bool is_server)
+{
+	const unsigned session_id = NewLiveSession();
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_CommunicationType, config.m_Transport->m_CommunicationType);
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_ExchangeMode, config.m_Transport->m_ExchangeMode);
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_NetworkPort, config.m_Port);
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_IOThread, (config.m_Placement == EBenchmarkPlacement_IOThread) ? 1 : 0);
+
+	// a multicast group is used as it is, other transports go over a loopback
+	if (config.m_Transport->m_CommunicationType != static_cast<int>(ECommunicationType::NetworkUDP))
+		SetLiveSessionPropertyString(session_id, ELiveSessionProperty_NetworkAddress, BENCHMARK_ADDRESS);
+
+	if (is_server)
+	{
+		SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_JointsCapacity, static_cast<int>(config.m_Joints));
+		SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_PropsCapacity, static_cast<int>(std::max(config.m_Props, 1u)));
+	}
+
+	int result = -1;
+	for (int attemps = 0; attemps < 50; ++attemps)
+	{
+		result = HardwareOpen(session_id, BENCHMARK_PAIR_NAME, is_server);
+		if (result == 0 || is_server)
+			break;
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	}
+
+	if (result != 0)
+	{
+		FreeLiveSession(session_id);
+		return 0;
+	}
+	return session_id;
+}
+
+void fill_frame(SSharedModelData* data, const SBenchmarkConfig& config, const unsigned int tag)
+{
+	data->m_Header.m_ServerTag = tag;
+	data->m_Header.m_ModelsCount = config.m_Joints;
+	data->m_Header.m_PropsCount = config.m_Props;
+
+	SJointData* joints = GetModelJoints(data);
+	for (unsigned int i = 0; i < config.m_Joints; ++i)
+	{
+		joints[i].m_NameHash = i;
+		joints[i].m_Transform.m_Translation.m_X = static_cast<float>(tag);
+		joints[i].m_Transform.m_Rotation.m_W = 1.0f;
+	}
+
+	SPropertyData* props = GetModelProperties(data);
+	for (unsigned int i = 0; i < config.m_Props; ++i)
+	{
+		props[i].m_NameHash = i;
+		props[i].m_Value = static_cast<float>(tag);
+	}
+}
+
+void benchmark_server(const SBenchmarkConfig& config, SBenchmarkState& state)
+{
+	if (config.m_Placement == EBenchmarkPlacement_Pinned)
+		pin_current_thread(0);
+
+	const unsigned int session_id = open_session(config, true);
+	if (session_id == 0)
+	{
+		state.m_Result.store(-3);
+		state.m_ClientDone.store(true);
+		return;
+	}
+
+	// a multicast client has to join a group before a first frame
+	const long long ready_deadline = benchmark_now() + BENCHMARK_STALL_TIMEOUT_NS;
+	while (!state.m_ClientReady.load() && !state.m_ClientDone.load() && benchmark_now() < ready_deadline)
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+	int frame = 0;
+	while (!state.m_ClientDone.load())
+	{
+		const unsigned int tag = (frame < config.m_Frames) ? static_cast<unsigned int>(frame) : BENCHMARK_END_TAG;
+
+		// one frame in flight, a handoff latency is not mixed with a queue time
+		const long long ack_deadline = benchmark_now() + BENCHMARK_ACK_TIMEOUT_NS;
+		while (frame > 0 && tag != BENCHMARK_END_TAG && state.m_Acknowledged.load(std::memory_order_acquire) < frame - 1
+			&& benchmark_now() < ack_deadline && !state.m_ClientDone.load())
+		{
+			std::this_thread::yield();
+		}
+
+		if (HardwareWaitForFrame(session_id, 10) != 0)
+			continue;
+
+		SSharedModelData* data = MapModelData(session_id);
+		fill_frame(data, config, tag);
+
+		if (tag != BENCHMARK_END_TAG)
+			state.m_PublishTime[frame].store(benchmark_now(), std::memory_order_relaxed);
+
+		const int result = HardwareCommit(session_id, true);
+		if (result == 0)
+		{
+			++frame;
+
+			// an end tag is repeated until a client gets it, don't flood a streaming transport with it
+			if (tag == BENCHMARK_END_TAG)
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		else if (result != -1)
+		{
+			// a frame doesn't fit into a transport (-5) or a session is closed
+			state.m_Result.store(result);
+			state.m_ClientDone.store(true);
+		}
+	}
+
+	HardwareClose(session_id);
+	FreeLiveSession(session_id);
+}
+
+void benchmark_client(const SBenchmarkConfig& config, SBenchmarkState& state, SBenchmarkResult& output)
+{
+	if (config.m_Placement == EBenchmarkPlacement_Pinned)
+		pin_current_thread(1);
+
+	const unsigned int session_id = open_session(config, false);
+	if (session_id == 0)
+	{
+		state.m_Result.store(-3);
+		state.m_ClientDone.store(true);
+		return;
+	}
+	state.m_ClientReady.store(true);
+
+	std::vector<long long> latencies;
+	latencies.reserve(config.m_Frames);
+
+	long long first_time = 0;
+	long long last_time = benchmark_now();
+	long long last_tag = -1;
+
+	while (!state.m_ClientDone.load())
+	{
+		if (benchmark_now() - last_time > BENCHMARK_STALL_TIMEOUT_NS)
+			break;
+
+		if (HardwareWaitForFrame(session_id, 10) != 0)
+			continue;
+
+		if (HardwareCommit(session_id, true) != 0)
+			continue;
+
+		const long long now = benchmark_now();
+		const unsigned int tag = MapModelData(session_id)->m_Header.m_ServerTag;
+
+		if (tag == BENCHMARK_END_TAG)
+			break;
+		// an initial frame of a region or a repeated one, it was not published by a sweep
+		const long long publish_time = (tag < static_cast<unsigned int>(config.m_Frames)) ? state.m_PublishTime[tag].load(std::memory_order_relaxed) : 0;
+		if (publish_time == 0 || static_cast<long long>(tag) <= last_tag)
+			continue;
+
+		last_tag = static_cast<long long>(tag);
+		latencies.push_back(now - publish_time);
+
+		first_time = (first_time == 0) ? now : first_time;
+		last_time = now;
+
+		state.m_Acknowledged.store(static_cast<long long>(tag), std::memory_order_release);
+	}
+	state.m_ClientDone.store(true);
+
+	SLiveSessionStats stats;
+	GetLiveSessionStats(session_id, stats);
+
+	HardwareClose(session_id);
+	FreeLiveSession(session_id);
+
+	output.m_FramesReceived = static_cast<int>(latencies.size());
+	output.m_Dropped = stats.m_FramesDropped;
+	output.m_PayloadBytes = (stats.m_FramesReceived > 0) ? static_cast<double>(stats.m_BytesReceived) / static_cast<double>(stats.m_FramesReceived) : 0.0;
+
+	if (latencies.empty())
+		return;
+
+	const double elapsed = 1e-9 * static_cast<double>(last_time - first_time);
+	output.m_FramesPerSecond = (elapsed > 0.0) ? static_cast<double>(latencies.size() - 1) / elapsed : 0.0;
+
+	std::sort(begin(latencies), end(latencies));
+
+	auto percentile = [&latencies](const double value) {
+		const size_t index = std::min(latencies.size() - 1, static_cast<size_t>(value * static_cast<double>(latencies.size())));
+		return 0.001 * static_cast<double>(latencies[index]);
+	};
+
+	output.m_P50 = percentile(0.5);
+	output.m_P99 = percentile(0.99);
+	output.m_P999 = percentile(0.999);
+	output.m_Max = 0.001 * static_cast<double>(latencies.back());
+}
+
+SBenchmarkResult run_benchmark(const SBenchmarkConfig& config)
+{
+	SBenchmarkState state;
+	state.m_PublishTime.reset(new std::atomic<long long>[config.m_Frames]);
+
+	for (int i = 0; i < config.m_Frames; ++i)
+	{
+		state.m_PublishTime[i].store(0, std::memory_order_relaxed);
+	}
+
+	SBenchmarkResult result;
+
+	std::thread client_thread(benchmark_client, std::cref(config), std::ref(state), std::ref(result));
+	std::thread server_thread(benchmark_server, std::cref(config), std::ref(state));
+
+	client_thread.join();
+	server_thread.join();
+
+	result.m_Result = state.m_Result.load();
+	return result;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// report
+
+void write_header(FILE* file, const bool json)
+{
+	if (json)
+		fprintf(file, "[\n");
+	else
+		fprintf(file, "transport,placement,joints,props,payload_bytes,frames,received,dropped,fps,p50_us,p99_us,p999_us,max_us,result\n");
+}
+
+void write_row(FILE* file, const bool json, const bool first, const SBenchmarkConfig& config, const SBenchmarkResult& result)
+{
+	if (json)
+	{
+		fprintf(file, "%s  {\"transport\": \"%s\", \"placement\": \"%s\", \"joints\": %u, \"props\": %u, \"payload_bytes\": %.1f, "
+			"\"frames\": %d, \"received\": %d, \"dropped\": %llu, \"fps\": %.1f, \"p50_us\": %.2f, \"p99_us\": %.2f, \"p999_us\": %.2f, "
+			"\"max_us\": %.2f, \"result\": %d}",
+			(first) ? "" : ",\n", config.m_Transport->m_Name, PLACEMENT_NAMES[config.m_Placement], config.m_Joints, config.m_Props,
+			result.m_PayloadBytes, config.m_Frames, result.m_FramesReceived, result.m_Dropped, result.m_FramesPerSecond,
+			result.m_P50, result.m_P99, result.m_P999, result.m_Max, result.m_Result);
+	}
+	else
+	{
+		fprintf(file, "%s,%s,%u,%u,%.1f,%d,%d,%llu,%.1f,%.2f,%.2f,%.2f,%.2f,%d\n",
+			config.m_Transport->m_Name, PLACEMENT_NAMES[config.m_Placement], config.m_Joints, config.m_Props,
+			result.m_PayloadBytes, config.m_Frames, result.m_FramesReceived, result.m_Dropped, result.m_FramesPerSecond,
+			result.m_P50, result.m_P99, result.m_P999, result.m_Max, result.m_Result);
+	}
+	fflush(file);
+}
+
+void write_footer(FILE* file, const bool json)
+{
+	if (json)
+		fprintf(file, "\n]\n");
+}
+
+int main(int argc, char* argv[])
+{
+	bool json = false;
+	bool quick = false;
+	int frames = 2000;
+	std::string transport_filter("all");
+	const char* output_path = nullptr;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string arg(argv[i]);
+		const bool has_value = (i + 1 < argc);
+
+		if (arg == "--format" && has_value)
+			json = (std::string(argv[++i]) == "json");
+		else if (arg == "--output" && has_value)
+			output_path = argv[++i];
+		else if (arg == "--frames" && has_value)
+			frames = std::max(1, atoi(argv[++i]));
+		else if (arg == "--transport" && has_value)
+			transport_filter = argv[++i];
+		else if (arg == "--quick")
+			quick = true;
+		else
+		{
+			fprintf(stderr, "usage: %s [--format csv|json] [--output file] [--frames N] [--transport all|sm|sm_latest|tcp|udp] [--quick]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	FILE* file = (output_path) ? fopen(output_path, "w") : stdout;
+	if (file == nullptr)
+	{
+		fprintf(stderr, "failed to open %s\n", output_path);
+		return 1;
+	}
+
+	const std::vector<unsigned int> joint_counts = (quick) ? std::vector<unsigned int>{ 1, 128 } : std::vector<unsigned int>{ 1, 16, 64, 128, 256, 512 };
+	const std::vector<unsigned int> prop_counts = (quick) ? std::vector<unsigned int>{ 32 } : std::vector<unsigned int>{ 0, 32, 256 };
+
+	// pinning needs two cpus at least
+	const bool can_pin = std::thread::hardware_concurrency() >= 2;
+
+	write_header(file, json);
+
+	bool first = true;
+	int port = BENCHMARK_PORT;
+
+	for (const STransportConfig& transport : TRANSPORTS)
+	{
+		if (transport_filter != "all" && transport_filter != transport.m_Name)
+			continue;
+
+		for (int placement = 0; placement < EBenchmarkPlacement_Count; ++placement)
+		{
+			if (placement == EBenchmarkPlacement_Pinned && !can_pin)
+				continue;
+
+			for (const unsigned int joints : joint_counts)
+			{
+				for (const unsigned int props : prop_counts)
+				{
+					SBenchmarkConfig config;
+					config.m_Transport = &transport;
+					config.m_Placement = static_cast<EBenchmarkPlacement>(placement);
+					config.m_Joints = joints;
+					config.m_Props = props;
+					config.m_Frames = frames;
+					// a fresh port, a previous listen socket could be in a time wait state
+					config.m_Port = port++;
+
+					fprintf(stderr, "%s / %s - %u joints, %u props\n", transport.m_Name, PLACEMENT_NAMES[placement], joints, props);
+
+					const SBenchmarkResult result = run_benchmark(config);
+					write_row(file, json, first, config, result);
+					first = false;
+				}
+			}
+		}
+	}
+
+	write_footer(file, json);
+
+	if (file != stdout)
+		fclose(file);
+
+	return 0;
+}
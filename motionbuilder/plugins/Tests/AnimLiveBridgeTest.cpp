@@ -30,6 +30,24 @@
 
 #include "AnimLiveBridge.h"
 #include <thread>
+#include <chrono>
+#include <atomic>
+#include <cstdio>
+#include <cstdint>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+	#include <poll.h>
+#endif
+
+#ifndef _ASSERT
+	#include <cassert>
+	#define _ASSERT assert
+#endif
 
 #define PBSTR "||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||"
 #define PBWIDTH 60
@@ -263,6 +281,2627 @@ void client_timeline()
 	FreeLiveSession(session_id);
 }
 
+///////////////////////////////////////////////////////////////////////////////////
+// zero-copy test
+
+void server_zerocopy()
+{
+	const unsigned session_id = NewLiveSession();
+
+	int result = HardwareOpen(session_id, "test_pair", true);
+	_ASSERT(result == 0);
+
+	for (int i = 0; i < 1000; )
+	{
+		// write straight into the shared region when it's our turn
+		if (SSharedModelData* slot = AcquireWriteSlot(session_id))
+		{
+			slot->m_Header.m_ModelsCount = 1;
+			slot->m_Header.m_ServerTag = i;
+			slot->m_Joints.m_Data[0].m_Transform.m_Translation.m_X = static_cast<float>(i);
+
+			result = PublishWriteSlot(session_id, true);
+			_ASSERT(result == 0);
+			++i;
+		}
+	}
+
+	while (true)
+	{
+		if (SSharedModelData* slot = AcquireWriteSlot(session_id))
+		{
+			slot->m_Header.m_ServerTag = UINT32_MAX;
+			PublishWriteSlot(session_id, true);
+			break;
+		}
+	}
+
+	HardwareClose(session_id);
+	FreeLiveSession(session_id);
+}
+
+void client_zerocopy()
+{
+	const unsigned session_id = NewLiveSession();
+
+	int result = -1;
+
+	for (int attemps = 0; attemps < 10; ++attemps)
+	{
+		result = HardwareOpen(session_id, "test_pair", false);
+		if (result == 0)
+			break;
+
+		constexpr std::chrono::milliseconds timespan(100);
+		std::this_thread::sleep_for(timespan);
+	}
+
+	if (result != 0)
+		return;
+
+	unsigned int last_tag = 0;
+	while (true)
+	{
+		const SSharedModelData* view = AcquireReadView(session_id);
+		if (view == nullptr)
+			continue;
+
+		last_tag = view->m_Header.m_ServerTag;
+		_ASSERT(last_tag == UINT32_MAX || view->m_Joints.m_Data[0].m_Transform.m_Translation.m_X == static_cast<float>(last_tag));
+
+		ReleaseReadView(session_id, true);
+
+		if (last_tag == UINT32_MAX)
+			break;
+	}
+
+	printf("client zero-copy - last server tag %u\n", last_tag);
+
+	HardwareClose(session_id);
+	FreeLiveSession(session_id);
+}
+
+///////////////////////////////////////////////////////////////////////////////////
+// latest value test, server and client are running at a different rate and never wait each other
+
+void server_latest()
+{
+	const unsigned session_id = NewLiveSession();
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_ExchangeMode, EExchangeMode_LatestValue);
+
+	int result = HardwareOpen(session_id, "test_pair", true);
+	_ASSERT(result == 0);
+
+	// wait for a client feedback
+	while (MapModelData(session_id)->m_Header.m_ClientTag == 0)
+	{
+		HardwareCommit(session_id, true);
+		std::this_thread::yield();
+	}
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		SSharedModelData* data = MapModelData(session_id);
+		_ASSERT(data != nullptr);
+
+		data->m_Header.m_ModelsCount = NUMBER_OF_JOINTS;
+		data->m_Header.m_ServerTag = i;
+
+		for (int j = 0; j < NUMBER_OF_JOINTS; ++j)
+		{
+			data->m_Joints.m_Data[j].m_Transform.m_Translation.m_X = static_cast<float>(i);
+		}
+
+		// writer never waits for a reader
+		result = HardwareCommit(session_id, true);
+		_ASSERT(result == 0);
+
+		constexpr std::chrono::microseconds timespan(100);
+		std::this_thread::sleep_for(timespan);
+	}
+
+	// close server - keep a final tag until client confirms it
+	for (int attemps = 0; attemps < 1000; ++attemps)
+	{
+		SSharedModelData* data = MapModelData(session_id);
+		data->m_Header.m_ServerTag = UINT32_MAX;
+		HardwareCommit(session_id, true);
+
+		if (data->m_Header.m_ClientTag == UINT32_MAX)
+			break;
+
+		constexpr std::chrono::milliseconds timespan(1);
+		std::this_thread::sleep_for(timespan);
+	}
+
+	HardwareClose(session_id);
+	FreeLiveSession(session_id);
+}
+
+void client_latest()
+{
+	const unsigned session_id = NewLiveSession();
+
+	int result = -1;
+
+	for (int attemps = 0; attemps < 10; ++attemps)
+	{
+		result = HardwareOpen(session_id, "test_pair", false);
+		if (result == 0)
+			break;
+
+		constexpr std::chrono::milliseconds timespan(100);
+		std::this_thread::sleep_for(timespan);
+	}
+
+	if (result != 0)
+		return;
+
+	int frames = 0;
+	int torn = 0;
+
+	MapModelData(session_id)->m_Header.m_ClientTag = 1;
+
+	while (true)
+	{
+		result = HardwareCommit(session_id, true);
+
+		if (result == -4)
+			++torn;
+		if (result != 0)
+			continue;
+
+		SSharedModelData* data = MapModelData(session_id);
+		++frames;
+
+		if (data->m_Header.m_ServerTag == UINT32_MAX)
+			break;
+
+		// every joint should come from the same frame
+		const float value = static_cast<float>(data->m_Header.m_ServerTag);
+		for (int j = 0; j < NUMBER_OF_JOINTS; ++j)
+		{
+			_ASSERT(data->m_Joints.m_Data[j].m_Transform.m_Translation.m_X == value);
+		}
+
+		// client is slower than a server
+		constexpr std::chrono::microseconds timespan(250);
+		std::this_thread::sleep_for(timespan);
+	}
+
+	// feedback is sent with a next received frame, server keeps repeating a final one
+	MapModelData(session_id)->m_Header.m_ClientTag = UINT32_MAX;
+	while (HardwareCommit(session_id, true) != 0)
+	{
+		std::this_thread::yield();
+	}
+
+	printf("client latest value - received frames %d, torn frames %d\n", frames, torn);
+
+	HardwareClose(session_id);
+	FreeLiveSession(session_id);
+}
+
+///////////////////////////////////////////////////////////////////////////////////
+// network test, tcp loopback with a non-blocking commit
+
+const char* NETWORK_TEST_ADDRESS = "127.0.0.1";
+const int NETWORK_TEST_PORT = 18899;
+const int NETWORK_TEST_JOINTS = 16;
+
+void server_network()
+{
+	const unsigned session_id = NewLiveSession();
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_CommunicationType, static_cast<int>(ECommunicationType::NetworkTCP));
+	SetLiveSessionPropertyString(session_id, ELiveSessionProperty_NetworkAddress, NETWORK_TEST_ADDRESS);
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_NetworkPort, NETWORK_TEST_PORT);
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_PoseCodec, 1);
+
+	int result = HardwareOpen(session_id, "test_pair", true);
+	_ASSERT(result == 0);
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		SSharedModelData* data = MapModelData(session_id);
+		_ASSERT(data != nullptr);
+
+		data->m_Header.m_ModelsCount = NETWORK_TEST_JOINTS;
+		data->m_Header.m_ServerTag = i;
+
+		for (int j = 0; j < NETWORK_TEST_JOINTS; ++j)
+		{
+			data->m_Joints.m_Data[j].m_Transform.m_Translation.m_X = static_cast<float>(i);
+		}
+
+		// commit is not blocking, -1 means client has not sent a feedback yet
+		while (HardwareCommit(session_id, true) != 0)
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	// close server - define a specified tag
+	MapModelData(session_id)->m_Header.m_ServerTag = UINT32_MAX;
+	while (HardwareCommit(session_id, true) != 0)
+	{
+		std::this_thread::yield();
+	}
+
+	HardwareClose(session_id);
+	FreeLiveSession(session_id);
+}
+
+void client_network()
+{
+	const unsigned session_id = NewLiveSession();
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_CommunicationType, static_cast<int>(ECommunicationType::NetworkTCP));
+	SetLiveSessionPropertyString(session_id, ELiveSessionProperty_NetworkAddress, NETWORK_TEST_ADDRESS);
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_NetworkPort, NETWORK_TEST_PORT);
+
+	int result = HardwareOpen(session_id, "test_pair", false);
+	_ASSERT(result == 0);
+
+	int frames = 0;
+	unsigned int last_tag = 0;
+
+	while (true)
+	{
+		MapModelData(session_id)->m_Header.m_ClientTag = frames;
+
+		if (HardwareCommit(session_id, true) != 0)
+		{
+			std::this_thread::yield();
+			continue;
+		}
+
+		SSharedModelData* data = MapModelData(session_id);
+
+		if (data->m_Header.m_ServerTag == UINT32_MAX)
+			break;
+
+		// ping pong over tcp keeps every frame and its order
+		_ASSERT(frames == 0 || data->m_Header.m_ServerTag == last_tag + 1);
+		_ASSERT(data->m_Header.m_ModelsCount == NETWORK_TEST_JOINTS);
+
+		const float value = static_cast<float>(data->m_Header.m_ServerTag);
+		for (int j = 0; j < NETWORK_TEST_JOINTS; ++j)
+		{
+			_ASSERT(data->m_Joints.m_Data[j].m_Transform.m_Translation.m_X == value);
+		}
+
+		last_tag = data->m_Header.m_ServerTag;
+		++frames;
+	}
+
+	printf("client network - received frames %d\n", frames);
+
+	HardwareClose(session_id);
+	FreeLiveSession(session_id);
+}
+
+///////////////////////////////////////////////////////////////////////////////////
+// multicast test, one server and several viewers, late frames are dropped
+
+const int MULTICAST_TEST_PORT = 18898;
+const int MULTICAST_TEST_VIEWERS = 2;
+
+std::atomic<int> g_MulticastViewers{ 0 };
+
+void server_multicast()
+{
+	const unsigned session_id = NewLiveSession();
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_CommunicationType, static_cast<int>(ECommunicationType::NetworkUDP));
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_NetworkPort, MULTICAST_TEST_PORT);
+
+	int result = HardwareOpen(session_id, "test_pair", true);
+	_ASSERT(result == 0);
+
+	// nobody is going to resend a frame, wait for viewers to join first
+	for (int attemps = 0; attemps < 1000 && g_MulticastViewers.load() < MULTICAST_TEST_VIEWERS; ++attemps)
+	{
+		constexpr std::chrono::milliseconds timespan(1);
+		std::this_thread::sleep_for(timespan);
+	}
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		SSharedModelData* data = MapModelData(session_id);
+		_ASSERT(data != nullptr);
+
+		data->m_Header.m_ModelsCount = NETWORK_TEST_JOINTS;
+		data->m_Header.m_ServerTag = i;
+
+		for (int j = 0; j < NETWORK_TEST_JOINTS; ++j)
+		{
+			data->m_Joints.m_Data[j].m_Transform.m_Translation.m_X = static_cast<float>(i);
+		}
+
+		// sender never waits for viewers
+		result = HardwareCommit(session_id, true);
+		_ASSERT(result == 0);
+
+		constexpr std::chrono::microseconds timespan(100);
+		std::this_thread::sleep_for(timespan);
+	}
+
+	// close server - repeat a final tag until every viewer got it
+	for (int attemps = 0; attemps < 1000 && g_MulticastViewers.load() > 0; ++attemps)
+	{
+		MapModelData(session_id)->m_Header.m_ServerTag = UINT32_MAX;
+		HardwareCommit(session_id, true);
+
+		constexpr std::chrono::milliseconds timespan(1);
+		std::this_thread::sleep_for(timespan);
+	}
+
+	HardwareClose(session_id);
+	FreeLiveSession(session_id);
+}
+
+void client_multicast()
+{
+	const unsigned session_id = NewLiveSession();
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_CommunicationType, static_cast<int>(ECommunicationType::NetworkUDP));
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_NetworkPort, MULTICAST_TEST_PORT);
+
+	int result = HardwareOpen(session_id, "test_pair", false);
+	_ASSERT(result == 0);
+
+	++g_MulticastViewers;
+
+	int frames = 0;
+	unsigned int last_tag = 0;
+
+	for (int attemps = 0; attemps < 10000; ++attemps)
+	{
+		if (HardwareCommit(session_id, true) != 0)
+		{
+			constexpr std::chrono::microseconds timespan(500);
+			std::this_thread::sleep_for(timespan);
+			continue;
+		}
+
+		SSharedModelData* data = MapModelData(session_id);
+
+		if (data->m_Header.m_ServerTag == UINT32_MAX)
+			break;
+
+		// frames could be skipped, but never come back in time
+		_ASSERT(frames == 0 || data->m_Header.m_ServerTag > last_tag);
+
+		const float value = static_cast<float>(data->m_Header.m_ServerTag);
+		for (int j = 0; j < NETWORK_TEST_JOINTS; ++j)
+		{
+			_ASSERT(data->m_Joints.m_Data[j].m_Transform.m_Translation.m_X == value);
+		}
+
+		last_tag = data->m_Header.m_ServerTag;
+		++frames;
+	}
+
+	--g_MulticastViewers;
+	printf("client multicast - received frames %d\n", frames);
+
+	HardwareClose(session_id);
+	FreeLiveSession(session_id);
+}
+
+// a restarted server counts its frames from 1 again, a viewer must not drop them as late
+void multicast_restart()
+{
+	const unsigned client_id = NewLiveSession();
+	SetLiveSessionPropertyInt(client_id, ELiveSessionProperty_CommunicationType, static_cast<int>(ECommunicationType::NetworkUDP));
+	SetLiveSessionPropertyInt(client_id, ELiveSessionProperty_NetworkPort, MULTICAST_TEST_PORT);
+
+	int result = HardwareOpen(client_id, "test_pair", false);
+	_ASSERT(result == 0);
+
+	for (int restart = 0; restart < 2; ++restart)
+	{
+		const unsigned server_id = NewLiveSession();
+		SetLiveSessionPropertyInt(server_id, ELiveSessionProperty_CommunicationType, static_cast<int>(ECommunicationType::NetworkUDP));
+		SetLiveSessionPropertyInt(server_id, ELiveSessionProperty_NetworkPort, MULTICAST_TEST_PORT);
+
+		result = HardwareOpen(server_id, "test_pair", true);
+		_ASSERT(result == 0);
+
+		// a first server gets ahead, a second one sends fewer frames than that
+		const unsigned int tag = 100 * (restart + 1);
+		const int frames = (restart == 0) ? 50 : 5;
+		bool received = false;
+
+		for (int attemps = 0; attemps < 1000 && !received; ++attemps)
+		{
+			if (attemps < frames)
+			{
+				MapModelData(server_id)->m_Header.m_ServerTag = tag;
+				HardwareCommit(server_id, true);
+			}
+
+			if (HardwareCommit(client_id, true) == 0 && MapModelData(client_id)->m_Header.m_ServerTag == tag)
+			{
+				received = true;
+			}
+			else
+			{
+				constexpr std::chrono::milliseconds timespan(1);
+				std::this_thread::sleep_for(timespan);
+			}
+		}
+
+		printf("multicast restart %d - received %d\n", restart, received ? 1 : 0);
+		_ASSERT(received);
+
+		HardwareClose(server_id);
+		FreeLiveSession(server_id);
+	}
+
+	HardwareClose(client_id);
+	FreeLiveSession(client_id);
+}
+
+///////////////////////////////////////////////////////////////////////////////////
+// pose codec test, round trip of a full rig stays within a stated error bound
+
+void pose_codec()
+{
+	SJointData joints[NUMBER_OF_JOINTS];
+	SJointData decoded[NUMBER_OF_JOINTS];
+
+	unsigned int seed = 1;
+	auto random = [&seed](const float min_value, const float max_value) {
+		seed = seed * 1664525u + 1013904223u;
+		return min_value + (max_value - min_value) * static_cast<float>(seed >> 8) / static_cast<float>(1 << 24);
+	};
+
+	for (int i = 0; i < NUMBER_OF_JOINTS; ++i)
+	{
+		SJointData& joint = joints[i];
+		joint.m_NameHash = 1000 + i;
+		joint.m_ParentHash = (i > 0) ? 1000 + (i - 1) / 2 : 0;
+		joint.m_Flags = (i % 8 == 0) ? HINT_ROTATION_EULERANGLES : HINT_ROTATION_QUATERNION;
+
+		joint.m_Transform.m_Translation = { random(-200.0f, 200.0f), random(-200.0f, 200.0f), random(0.0f, 180.0f) };
+
+		if (joint.m_Flags & HINT_ROTATION_EULERANGLES)
+		{
+			joint.m_Transform.m_Rotation = { random(-180.0f, 180.0f), random(-90.0f, 90.0f), random(-180.0f, 180.0f), 0.0f };
+		}
+		else
+		{
+			SVector4 q{ random(-1.0f, 1.0f), random(-1.0f, 1.0f), random(-1.0f, 1.0f), random(-1.0f, 1.0f) };
+			const float length = sqrtf(q.m_X * q.m_X + q.m_Y * q.m_Y + q.m_Z * q.m_Z + q.m_W * q.m_W);
+			joint.m_Transform.m_Rotation = { q.m_X / length, q.m_Y / length, q.m_Z / length, q.m_W / length };
+		}
+
+		joint.m_Transform.m_Scale = (i == 5) ? SVector3{ 1.0f, 2.0f, 0.5f } : SVector3{ 1.0f, 1.0f, 1.0f };
+	}
+
+	unsigned char buffer[sizeof(joints)];
+	const unsigned int size = EncodePose(joints, NUMBER_OF_JOINTS, 0, 0, buffer, sizeof(buffer));
+	_ASSERT(size > 0);
+
+	const int count = DecodePose(buffer, size, decoded, NUMBER_OF_JOINTS);
+	_ASSERT(count == NUMBER_OF_JOINTS);
+
+	SVector3 translation_error;
+	SVector3 euler_error;
+	float quaternion_error;
+	bool result = GetPoseErrorBound(buffer, size, translation_error, euler_error, quaternion_error);
+	_ASSERT(result);
+
+	for (int i = 0; i < count; ++i)
+	{
+		const SJointData& a = joints[i];
+		const SJointData& b = decoded[i];
+
+		_ASSERT(a.m_NameHash == b.m_NameHash && a.m_ParentHash == b.m_ParentHash && a.m_Flags == b.m_Flags);
+		_ASSERT(a.m_Transform.m_Scale.m_X == b.m_Transform.m_Scale.m_X && a.m_Transform.m_Scale.m_Y == b.m_Transform.m_Scale.m_Y && a.m_Transform.m_Scale.m_Z == b.m_Transform.m_Scale.m_Z);
+
+		_ASSERT(fabsf(a.m_Transform.m_Translation.m_X - b.m_Transform.m_Translation.m_X) <= translation_error.m_X);
+		_ASSERT(fabsf(a.m_Transform.m_Translation.m_Y - b.m_Transform.m_Translation.m_Y) <= translation_error.m_Y);
+		_ASSERT(fabsf(a.m_Transform.m_Translation.m_Z - b.m_Transform.m_Translation.m_Z) <= translation_error.m_Z);
+
+		const float* ra = &a.m_Transform.m_Rotation.m_X;
+		const float* rb = &b.m_Transform.m_Rotation.m_X;
+
+		if (a.m_Flags & HINT_ROTATION_EULERANGLES)
+		{
+			const float* bound = &euler_error.m_X;
+			for (int k = 0; k < 3; ++k)
+			{
+				_ASSERT(fabsf(ra[k] - rb[k]) <= bound[k]);
+			}
+		}
+		else
+		{
+			// q and -q is the same rotation
+			const float dot = ra[0] * rb[0] + ra[1] * rb[1] + ra[2] * rb[2] + ra[3] * rb[3];
+			const float sign = (dot < 0.0f) ? -1.0f : 1.0f;
+			for (int k = 0; k < 4; ++k)
+			{
+				_ASSERT(fabsf(ra[k] - sign * rb[k]) <= quaternion_error);
+			}
+		}
+	}
+
+	printf("pose codec - %d joints, raw %d bytes, encoded %u bytes, translation error %f, quaternion error %f\n",
+		count, static_cast<int>(sizeof(joints)), size, translation_error.m_X, quaternion_error);
+
+	_ASSERT(3 * size <= sizeof(joints));
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////
+// large rig test, frame capacity is above a default one, shared memory and tcp clients take a server layout
+
+const int LARGE_TEST_JOINTS = 300;
+const int LARGE_TEST_PROPS = 40;
+const int LARGE_TEST_PORT = 18897;
+
+void fill_large_frame(SSharedModelData* data, const unsigned int tag)
+{
+	data->m_Header.m_ModelsCount = LARGE_TEST_JOINTS;
+	data->m_Header.m_PropsCount = LARGE_TEST_PROPS;
+	data->m_Header.m_ServerTag = tag;
+
+	SJointData* joints = GetModelJoints(data);
+	for (int j = 0; j < LARGE_TEST_JOINTS; ++j)
+	{
+		joints[j].m_Transform.m_Translation.m_X = static_cast<float>(tag);
+		joints[j].m_Transform.m_Translation.m_Y = static_cast<float>(j);
+	}
+
+	SPropertyData* props = GetModelProperties(data);
+	for (int j = 0; j < LARGE_TEST_PROPS; ++j)
+	{
+		props[j].m_Value = static_cast<float>(j);
+	}
+}
+
+void check_large_frame(const SSharedModelData* data)
+{
+	_ASSERT(data->m_Header.m_ModelsCount == LARGE_TEST_JOINTS);
+	_ASSERT(data->m_Header.m_PropsCount == LARGE_TEST_PROPS);
+
+	const SJointData* joints = GetModelJoints(data);
+	for (int j = 0; j < LARGE_TEST_JOINTS; ++j)
+	{
+		_ASSERT(joints[j].m_Transform.m_Translation.m_X == static_cast<float>(data->m_Header.m_ServerTag));
+		_ASSERT(joints[j].m_Transform.m_Translation.m_Y == static_cast<float>(j));
+	}
+
+	const SPropertyData* props = GetModelProperties(data);
+	for (int j = 0; j < LARGE_TEST_PROPS; ++j)
+	{
+		_ASSERT(props[j].m_Value == static_cast<float>(j));
+	}
+}
+
+void server_large(const int communication_type)
+{
+	const unsigned session_id = NewLiveSession();
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_CommunicationType, communication_type);
+	SetLiveSessionPropertyString(session_id, ELiveSessionProperty_NetworkAddress, NETWORK_TEST_ADDRESS);
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_NetworkPort, LARGE_TEST_PORT);
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_JointsCapacity, LARGE_TEST_JOINTS);
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_PropsCapacity, LARGE_TEST_PROPS);
+
+	int result = HardwareOpen(session_id, "test_pair_large", true);
+	_ASSERT(result == 0);
+
+	for (unsigned int i = 0; i < 100; ++i)
+	{
+		fill_large_frame(MapModelData(session_id), i);
+
+		while (HardwareCommit(session_id, true) != 0)
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	// close server - define a specified tag
+	MapModelData(session_id)->m_Header.m_ServerTag = UINT32_MAX;
+	while (HardwareCommit(session_id, true) != 0)
+	{
+		std::this_thread::yield();
+	}
+
+	HardwareClose(session_id);
+	FreeLiveSession(session_id);
+}
+
+void client_large(const int communication_type)
+{
+	const unsigned session_id = NewLiveSession();
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_CommunicationType, communication_type);
+	SetLiveSessionPropertyString(session_id, ELiveSessionProperty_NetworkAddress, NETWORK_TEST_ADDRESS);
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_NetworkPort, LARGE_TEST_PORT);
+
+	int result = -1;
+
+	for (int attemps = 0; attemps < 10; ++attemps)
+	{
+		result = HardwareOpen(session_id, "test_pair_large", false);
+		if (result == 0)
+			break;
+
+		constexpr std::chrono::milliseconds timespan(100);
+		std::this_thread::sleep_for(timespan);
+	}
+
+	if (result != 0)
+		return;
+
+	int frames = 0;
+
+	while (true)
+	{
+		MapModelData(session_id)->m_Header.m_ClientTag = frames;
+
+		if (HardwareCommit(session_id, true) != 0)
+		{
+			std::this_thread::yield();
+			continue;
+		}
+
+		// a local frame could be reallocated by a commit
+		const SSharedModelData* data = MapModelData(session_id);
+
+		if (data->m_Header.m_ServerTag == UINT32_MAX)
+			break;
+
+		check_large_frame(data);
+		++frames;
+	}
+
+	printf("client large rig - received frames %d, joints capacity %d\n", frames,
+		GetLiveSessionPropertyInt(session_id, ELiveSessionProperty_JointsCapacity));
+
+	HardwareClose(session_id);
+	FreeLiveSession(session_id);
+}
+
+///////////////////////////////////////////////////////////////////////////////////
+// multi-entity test, several characters share one frame and one commit
+
+const int ENTITY_TEST_COUNT = 8;
+const int ENTITY_TEST_JOINTS = 24;
+const int ENTITY_TEST_PROPS = 4;
+const int ENTITY_TEST_PORT = 18896;
+
+void server_entities(const int communication_type)
+{
+	const unsigned session_id = NewLiveSession();
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_CommunicationType, communication_type);
+	SetLiveSessionPropertyString(session_id, ELiveSessionProperty_NetworkAddress, NETWORK_TEST_ADDRESS);
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_NetworkPort, ENTITY_TEST_PORT);
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_JointsCapacity, ENTITY_TEST_COUNT * ENTITY_TEST_JOINTS);
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_EntitiesCapacity, ENTITY_TEST_COUNT);
+
+	int result = HardwareOpen(session_id, "test_pair_entities", true);
+	_ASSERT(result == 0);
+
+	std::vector<SEntityBlock> entities(ENTITY_TEST_COUNT);
+	for (int i = 0; i < ENTITY_TEST_COUNT; ++i)
+	{
+		entities[i].m_ModelNameHash = 1000 + i;
+		entities[i].m_ModelResourceHash = 0;
+		entities[i].m_JointsStart = i * ENTITY_TEST_JOINTS;
+		entities[i].m_JointsCount = ENTITY_TEST_JOINTS;
+		entities[i].m_PropsStart = i * ENTITY_TEST_PROPS;
+		entities[i].m_PropsCount = ENTITY_TEST_PROPS;
+	}
+
+	for (unsigned int i = 0; i < 100; ++i)
+	{
+		SSharedModelData* data = MapModelData(session_id);
+		data->m_Header.m_ModelsCount = ENTITY_TEST_COUNT * ENTITY_TEST_JOINTS;
+		data->m_Header.m_PropsCount = ENTITY_TEST_COUNT * ENTITY_TEST_PROPS;
+		data->m_Header.m_ServerTag = i;
+
+		result = SetModelDataEntities(session_id, entities) ? 0 : -1;
+		_ASSERT(result == 0);
+
+		// joint value tells which entity it belongs to
+		SJointData* joints = GetModelJoints(data);
+		for (int j = 0; j < ENTITY_TEST_COUNT * ENTITY_TEST_JOINTS; ++j)
+		{
+			joints[j].m_NameHash = 1000 + j / ENTITY_TEST_JOINTS;
+			joints[j].m_Transform.m_Translation.m_X = static_cast<float>(i);
+		}
+
+		// all characters go with one handoff
+		while (HardwareCommit(session_id, true) != 0)
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	// close server - define a specified tag
+	MapModelData(session_id)->m_Header.m_ServerTag = UINT32_MAX;
+	while (HardwareCommit(session_id, true) != 0)
+	{
+		std::this_thread::yield();
+	}
+
+	HardwareClose(session_id);
+	FreeLiveSession(session_id);
+}
+
+void client_entities(const int communication_type)
+{
+	const unsigned session_id = NewLiveSession();
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_CommunicationType, communication_type);
+	SetLiveSessionPropertyString(session_id, ELiveSessionProperty_NetworkAddress, NETWORK_TEST_ADDRESS);
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_NetworkPort, ENTITY_TEST_PORT);
+
+	int result = -1;
+
+	for (int attemps = 0; attemps < 10; ++attemps)
+	{
+		result = HardwareOpen(session_id, "test_pair_entities", false);
+		if (result == 0)
+			break;
+
+		constexpr std::chrono::milliseconds timespan(100);
+		std::this_thread::sleep_for(timespan);
+	}
+
+	if (result != 0)
+		return;
+
+	int frames = 0;
+
+	while (true)
+	{
+		MapModelData(session_id)->m_Header.m_ClientTag = frames;
+
+		if (HardwareCommit(session_id, true) != 0)
+		{
+			std::this_thread::yield();
+			continue;
+		}
+
+		const SSharedModelData* data = MapModelData(session_id);
+
+		if (data->m_Header.m_ServerTag == UINT32_MAX)
+			break;
+
+		_ASSERT(data->m_Header.m_EntitiesCount == ENTITY_TEST_COUNT);
+		const SJointData* joints = GetModelJoints(data);
+
+		for (unsigned int i = 0; i < data->m_Header.m_EntitiesCount; ++i)
+		{
+			SEntityBlock entity;
+			result = GetModelDataEntity(session_id, i, entity) ? 0 : -1;
+			_ASSERT(result == 0);
+			_ASSERT(entity.m_JointsCount == ENTITY_TEST_JOINTS && entity.m_PropsCount == ENTITY_TEST_PROPS);
+
+			for (unsigned int j = entity.m_JointsStart; j < entity.m_JointsStart + entity.m_JointsCount; ++j)
+			{
+				_ASSERT(joints[j].m_NameHash == entity.m_ModelNameHash);
+				_ASSERT(joints[j].m_Transform.m_Translation.m_X == static_cast<float>(data->m_Header.m_ServerTag));
+			}
+		}
+		++frames;
+	}
+
+	printf("client entities - received frames %d, entities capacity %d\n", frames,
+		GetLiveSessionPropertyInt(session_id, ELiveSessionProperty_EntitiesCapacity));
+
+	HardwareClose(session_id);
+	FreeLiveSession(session_id);
+}
+
+///////////////////////////////////////////////////////////////////////////////////
+// wait for frame test, server is streaming at a low rate and a client is blocked until a frame arrives
+
+const int WAIT_TEST_PORT = 18895;
+const int WAIT_TEST_FRAMES = 200;
+
+std::atomic<long long> g_WaitPublishTime{ 0 };
+
+long long wait_test_now()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void server_wait(const int communication_type)
+{
+	const unsigned session_id = NewLiveSession();
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_CommunicationType, communication_type);
+	SetLiveSessionPropertyString(session_id, ELiveSessionProperty_NetworkAddress, NETWORK_TEST_ADDRESS);
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_NetworkPort, WAIT_TEST_PORT);
+
+	int result = HardwareOpen(session_id, "test_pair_wait", true);
+	_ASSERT(result == 0);
+
+	for (int i = 0; i <= WAIT_TEST_FRAMES; ++i)
+	{
+		// wait for a client to hand a turn back
+		result = HardwareWaitForFrame(session_id, 5000);
+		_ASSERT(result == 0);
+
+		MapModelData(session_id)->m_Header.m_ServerTag = (i < WAIT_TEST_FRAMES) ? i : UINT32_MAX;
+
+		g_WaitPublishTime.store(wait_test_now());
+		result = HardwareCommit(session_id, true);
+		_ASSERT(result == 0);
+
+		constexpr std::chrono::milliseconds timespan(1);
+		std::this_thread::sleep_for(timespan);
+	}
+
+	SLiveSessionStats stats;
+	GetLiveSessionStats(session_id, stats);
+	_ASSERT(stats.m_FramesSent == WAIT_TEST_FRAMES + 1 && stats.m_CommitsMissed == 0);
+
+	HardwareClose(session_id);
+	FreeLiveSession(session_id);
+}
+
+void client_wait(const int communication_type)
+{
+	const unsigned session_id = NewLiveSession();
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_CommunicationType, communication_type);
+	SetLiveSessionPropertyString(session_id, ELiveSessionProperty_NetworkAddress, NETWORK_TEST_ADDRESS);
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_NetworkPort, WAIT_TEST_PORT);
+
+	int result = -1;
+
+	for (int attemps = 0; attemps < 10; ++attemps)
+	{
+		result = HardwareOpen(session_id, "test_pair_wait", false);
+		if (result == 0)
+			break;
+
+		constexpr std::chrono::milliseconds timespan(100);
+		std::this_thread::sleep_for(timespan);
+	}
+
+	if (result != 0)
+		return;
+
+	int frames = 0;
+	long long total_latency = 0;
+	long long max_latency = 0;
+
+	while (true)
+	{
+		// a client is parked while a server sleeps between frames
+		result = HardwareWaitForFrame(session_id, 5000);
+		_ASSERT(result == 0);
+
+		const long long latency = wait_test_now() - g_WaitPublishTime.load();
+
+		result = HardwareCommit(session_id, true);
+		_ASSERT(result == 0);
+
+		if (MapModelData(session_id)->m_Header.m_ServerTag == UINT32_MAX)
+			break;
+
+		total_latency += latency;
+		max_latency = (latency > max_latency) ? latency : max_latency;
+		++frames;
+	}
+
+	printf("client wait - received frames %d, wake latency avg %lld us, max %lld us\n", frames,
+		(frames > 0) ? total_latency / frames : 0, max_latency);
+
+	// session counters see the same frames
+	SLiveSessionStats stats;
+	SLatencySummary wait_latency;
+
+	GetLiveSessionStats(session_id, stats);
+	GetLiveSessionLatency(session_id, ELiveSessionLatency_Wait, wait_latency);
+
+	printf("client wait stats - received frames %llu, bytes %llu, wait p50 %.1f us, p99 %.1f us, max %.1f us\n",
+		stats.m_FramesReceived, stats.m_BytesReceived, wait_latency.m_P50, wait_latency.m_P99, wait_latency.m_Max);
+
+	_ASSERT(stats.m_Commits == static_cast<unsigned long long>(frames + 1));
+	_ASSERT(stats.m_FramesReceived == static_cast<unsigned long long>(frames + 1));
+	_ASSERT(stats.m_BytesReceived > 0);
+	_ASSERT(wait_latency.m_Count == static_cast<unsigned long long>(frames + 1));
+	_ASSERT(wait_latency.m_P50 <= wait_latency.m_P99 && wait_latency.m_P99 <= wait_latency.m_Max * 1.05);
+
+	HardwareClose(session_id);
+	FreeLiveSession(session_id);
+}
+
+///////////////////////////////////////////////////////////////////////////////////
+// io thread test, both sides run a session worker, a server never waits for a client turn
+//  and a client is notified by a frame ready callback
+
+const int IO_TEST_PORT = 18894;
+const int IO_TEST_FRAMES = 200;
+const int IO_TEST_JOINTS = 16;
+
+std::atomic<bool> g_IOClientDone{ false };
+std::atomic<int> g_IOCallbackFrames{ 0 };
+
+void io_frame_ready(unsigned int, void* user_data)
+{
+	static_cast<std::atomic<int>*>(user_data)->fetch_add(1);
+}
+
+void server_io(const int communication_type)
+{
+	const unsigned session_id = NewLiveSession();
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_CommunicationType, communication_type);
+	SetLiveSessionPropertyString(session_id, ELiveSessionProperty_NetworkAddress, NETWORK_TEST_ADDRESS);
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_NetworkPort, IO_TEST_PORT);
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_IOThread, 1);
+
+	int result = HardwareOpen(session_id, "test_pair_io", true);
+	_ASSERT(result == 0);
+
+	int frame = 0;
+	while (!g_IOClientDone.load())
+	{
+		// a last frame is repeated until a client gets it
+		const unsigned int tag = (frame < IO_TEST_FRAMES) ? static_cast<unsigned int>(frame) : UINT32_MAX;
+
+		SSharedModelData* data = MapModelData(session_id);
+		data->m_Header.m_ServerTag = tag;
+		data->m_Header.m_ModelsCount = IO_TEST_JOINTS;
+
+		for (int i = 0; i < IO_TEST_JOINTS; ++i)
+		{
+			data->m_Joints.m_Data[i].m_Transform.m_Translation.m_X = static_cast<float>(tag % 1000);
+		}
+
+		// never blocks, a frame is queued for a worker
+		result = HardwareCommit(session_id, true);
+		_ASSERT(result == 0);
+		++frame;
+
+		constexpr std::chrono::milliseconds timespan(1);
+		std::this_thread::sleep_for(timespan);
+	}
+
+	HardwareClose(session_id);
+	FreeLiveSession(session_id);
+}
+
+void client_io(const int communication_type)
+{
+	const unsigned session_id = NewLiveSession();
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_CommunicationType, communication_type);
+	SetLiveSessionPropertyString(session_id, ELiveSessionProperty_NetworkAddress, NETWORK_TEST_ADDRESS);
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_NetworkPort, IO_TEST_PORT);
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_IOThread, 1);
+
+	g_IOCallbackFrames.store(0);
+	SetFrameReadyCallback(session_id, io_frame_ready, &g_IOCallbackFrames);
+
+	int result = -1;
+
+	for (int attemps = 0; attemps < 10; ++attemps)
+	{
+		result = HardwareOpen(session_id, "test_pair_io", false);
+		if (result == 0)
+			break;
+
+		constexpr std::chrono::milliseconds timespan(100);
+		std::this_thread::sleep_for(timespan);
+	}
+
+	if (result != 0)
+	{
+		g_IOClientDone.store(true);
+		return;
+	}
+
+	int frames = 0;
+	long long last_tag = -1;
+
+	while (true)
+	{
+		result = HardwareWaitForFrame(session_id, 5000);
+		_ASSERT(result == 0);
+
+		result = HardwareCommit(session_id, true);
+		_ASSERT(result == 0);
+
+		const SSharedModelData* data = MapModelData(session_id);
+		const unsigned int tag = data->m_Header.m_ServerTag;
+
+		// a first exchange could be a server open handshake, before any frame is committed
+		if (frames == 0 && data->m_Header.m_ModelsCount == 0)
+			continue;
+
+		// a mailbox keeps a newest frame, frames could be skipped but never reordered or torn
+		_ASSERT(static_cast<long long>(tag) > last_tag);
+		_ASSERT(data->m_Header.m_ModelsCount == IO_TEST_JOINTS);
+
+		for (int i = 0; i < IO_TEST_JOINTS; ++i)
+		{
+			_ASSERT(data->m_Joints.m_Data[i].m_Transform.m_Translation.m_X == static_cast<float>(tag % 1000));
+		}
+
+		last_tag = static_cast<long long>(tag);
+		++frames;
+
+		if (tag == UINT32_MAX)
+			break;
+	}
+
+	g_IOClientDone.store(true);
+
+	// a worker is joined on close, every exchanged frame has been reported by then
+	HardwareClose(session_id);
+	FreeLiveSession(session_id);
+
+	printf("client io - received frames %d, callback frames %d\n", frames, g_IOCallbackFrames.load());
+	_ASSERT(g_IOCallbackFrames.load() >= frames);
+}
+
+///////////////////////////////////////////////////////////////////////////////////
+// frame ready handle test, a client waits on a handle the way an event loop does (asyncio add_reader, QSocketNotifier)
+//  and takes frames with a commit, a server is the one from the io thread test
+
+bool wait_frame_ready_handle(const long long handle, const unsigned int session_id, const int timeout_ms)
+{
+#ifdef _WIN32
+	// a socket handle, without winsock in a test a reset is polled instead
+	for (int i = 0; i < timeout_ms; ++i)
+	{
+		if (ResetFrameReadyHandle(session_id) > 0)
+			return true;
+
+		constexpr std::chrono::milliseconds timespan(1);
+		std::this_thread::sleep_for(timespan);
+	}
+	return false;
+#else
+	pollfd fd;
+	fd.fd = static_cast<int>(handle);
+	fd.events = POLLIN;
+	fd.revents = 0;
+
+	if (poll(&fd, 1, timeout_ms) != 1 || (fd.revents & POLLIN) == 0)
+		return false;
+
+	return ResetFrameReadyHandle(session_id) > 0;
+#endif
+}
+
+void client_io_handle(const int communication_type)
+{
+	const unsigned session_id = NewLiveSession();
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_CommunicationType, communication_type);
+	SetLiveSessionPropertyString(session_id, ELiveSessionProperty_NetworkAddress, NETWORK_TEST_ADDRESS);
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_NetworkPort, IO_TEST_PORT);
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_IOThread, 1);
+
+	// a handle is created before an open and is kept by a session
+	const long long handle = GetFrameReadyHandle(session_id);
+	_ASSERT(handle >= 0);
+	_ASSERT(GetFrameReadyHandle(session_id) == handle);
+
+	int result = ResetFrameReadyHandle(session_id);
+	_ASSERT(result == 0);
+
+	for (int attemps = 0; attemps < 10; ++attemps)
+	{
+		result = HardwareOpen(session_id, "test_pair_io", false);
+		if (result == 0)
+			break;
+
+		constexpr std::chrono::milliseconds timespan(100);
+		std::this_thread::sleep_for(timespan);
+	}
+
+	if (result != 0)
+	{
+		g_IOClientDone.store(true);
+		return;
+	}
+
+	int frames = 0;
+	int wakeups = 0;
+	long long last_tag = -1;
+
+	while (true)
+	{
+		const bool is_ready = wait_frame_ready_handle(handle, session_id, 5000);
+		_ASSERT(is_ready);
+		++wakeups;
+
+		// a mailbox could be taken by a previous commit already, a signal is never lost after a reset
+		if (HardwareCommit(session_id, true) != 0)
+			continue;
+
+		const SSharedModelData* data = MapModelData(session_id);
+		const unsigned int tag = data->m_Header.m_ServerTag;
+
+		if (frames == 0 && data->m_Header.m_ModelsCount == 0)
+			continue;
+
+		_ASSERT(static_cast<long long>(tag) > last_tag);
+		_ASSERT(data->m_Header.m_ModelsCount == IO_TEST_JOINTS);
+
+		last_tag = static_cast<long long>(tag);
+		++frames;
+
+		if (tag == UINT32_MAX)
+			break;
+	}
+
+	g_IOClientDone.store(true);
+
+	HardwareClose(session_id);
+	FreeLiveSession(session_id);
+
+	_ASSERT(GetFrameReadyHandle(session_id) == -3);
+
+	printf("client frame ready handle - received frames %d, wakeups %d\n", frames, wakeups);
+	_ASSERT(frames > 0 && wakeups >= frames);
+}
+
+///////////////////////////////////////////////////////////////////////////////////
+// session registry test, sessions are created and freed from several threads at once
+//  and a stale session id must never reach a newer session in a reused slot
+
+const int REGISTRY_TEST_THREADS = 4;
+const int REGISTRY_TEST_ITERATIONS = 2000;
+const int REGISTRY_TEST_SESSIONS = 600;			// more than one block of slots
+const int REGISTRY_TEST_PORT = 18890;
+const unsigned int REGISTRY_TEST_WAIT_MS = 200;
+
+std::atomic<int> g_RegistryErrors{ 0 };
+
+void registry_worker(const int thread_index)
+{
+	for (int i = 0; i < REGISTRY_TEST_ITERATIONS; ++i)
+	{
+		const unsigned int session_id = NewLiveSession();
+		const int value = thread_index * REGISTRY_TEST_ITERATIONS + i + 1;
+
+		SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_NetworkPort, value);
+
+		if (session_id == 0 || GetLiveSessionPropertyInt(session_id, ELiveSessionProperty_NetworkPort) != value)
+			g_RegistryErrors.fetch_add(1);
+
+		if (!FreeLiveSession(session_id))
+			g_RegistryErrors.fetch_add(1);
+
+		// a stale id is rejected, even if a slot is already taken by another thread
+		if (FreeLiveSession(session_id) || GetLiveSessionPropertyInt(session_id, ELiveSessionProperty_NetworkPort) != 0)
+			g_RegistryErrors.fetch_add(1);
+	}
+}
+
+void session_registry()
+{
+	std::thread threads[REGISTRY_TEST_THREADS];
+
+	for (int i = 0; i < REGISTRY_TEST_THREADS; ++i)
+	{
+		threads[i] = std::thread(registry_worker, i);
+	}
+
+	for (int i = 0; i < REGISTRY_TEST_THREADS; ++i)
+	{
+		threads[i].join();
+	}
+
+	// a table grows when every slot is in use
+	std::vector<unsigned int> sessions(REGISTRY_TEST_SESSIONS);
+	for (unsigned int& session_id : sessions)
+	{
+		session_id = NewLiveSession();
+		if (session_id == 0)
+			g_RegistryErrors.fetch_add(1);
+	}
+
+	std::vector<unsigned int> sorted_sessions(sessions);
+	std::sort(sorted_sessions.begin(), sorted_sessions.end());
+	if (std::unique(sorted_sessions.begin(), sorted_sessions.end()) != sorted_sessions.end())
+		g_RegistryErrors.fetch_add(1);
+
+	for (const unsigned int session_id : sessions)
+	{
+		if (!FreeLiveSession(session_id))
+			g_RegistryErrors.fetch_add(1);
+	}
+
+	// a session which another thread is waiting on is freed only after that call returns
+	const unsigned int session_id = NewLiveSession();
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_CommunicationType, static_cast<int>(ECommunicationType::NetworkUDP));
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_NetworkPort, REGISTRY_TEST_PORT);
+
+	int result = HardwareOpen(session_id, "test_pair_registry", false);
+	_ASSERT(result == 0);
+
+	std::atomic<bool> waiting{ false };
+	std::thread wait_thread([session_id, &waiting]() {
+		waiting.store(true);
+
+		// nobody sends to a viewer, a wait runs until a timeout
+		if (HardwareWaitForFrame(session_id, REGISTRY_TEST_WAIT_MS) != -1)
+			g_RegistryErrors.fetch_add(1);
+	});
+
+	while (!waiting.load())
+	{
+		std::this_thread::yield();
+	}
+
+	constexpr std::chrono::milliseconds timespan(20);
+	std::this_thread::sleep_for(timespan);
+
+	const double free_start = GetLiveBridgeTime();
+	const bool freed = FreeLiveSession(session_id);
+	const double free_time = GetLiveBridgeTime() - free_start;
+
+	wait_thread.join();
+
+	printf("session registry - sessions %d, errors %d, free waited %.1f ms\n", REGISTRY_TEST_THREADS * REGISTRY_TEST_ITERATIONS + REGISTRY_TEST_SESSIONS,
+		g_RegistryErrors.load(), 1000.0 * free_time);
+	_ASSERT(freed);
+	_ASSERT(free_time > 0.0005 * REGISTRY_TEST_WAIT_MS);
+	_ASSERT(g_RegistryErrors.load() == 0);
+}
+
+///////////////////////////////////////////////////////////////////////////////////
+// take test, a server stream is recorded into a take file and then replayed into a new session
+
+const char* TAKE_TEST_FILE = "test_take.albk";
+const int TAKE_TEST_FRAMES = 300;
+const int TAKE_TEST_JOINTS = 32;
+
+void take_record_server()
+{
+	const unsigned session_id = NewLiveSession();
+
+	int result = HardwareOpen(session_id, "test_pair_take", true);
+	_ASSERT(result == 0);
+
+	result = StartTakeRecording(session_id, TAKE_TEST_FILE);
+	_ASSERT(result == 0);
+
+	for (int i = 0; i <= TAKE_TEST_FRAMES; ++i)
+	{
+		result = HardwareWaitForFrame(session_id, 5000);
+		_ASSERT(result == 0);
+
+		SSharedModelData* data = MapModelData(session_id);
+		data->m_Header.m_ModelsCount = TAKE_TEST_JOINTS;
+		data->m_Header.m_ServerTag = (i < TAKE_TEST_FRAMES) ? i : UINT32_MAX;
+		data->m_ServerPlayer.m_LocalTime = 0.001 * static_cast<double>(i);
+
+		SJointData* joints = GetModelJoints(data);
+		for (int j = 0; j < TAKE_TEST_JOINTS; ++j)
+		{
+			joints[j].m_Transform.m_Translation.m_X = static_cast<float>(i);
+			joints[j].m_Transform.m_Translation.m_Y = static_cast<float>(j);
+		}
+
+		result = HardwareCommit(session_id, true);
+		_ASSERT(result == 0);
+	}
+
+	result = StopTakeRecording(session_id);
+	printf("take record - recorded frames %d\n", result);
+	_ASSERT(result == TAKE_TEST_FRAMES + 1);
+
+	result = StopTakeRecording(session_id);
+	_ASSERT(result == -1);
+
+	HardwareClose(session_id);
+	FreeLiveSession(session_id);
+}
+
+void take_replay_server()
+{
+	// a take doesn't fit a smaller session
+	const unsigned small_session_id = NewLiveSession();
+	SetLiveSessionPropertyInt(small_session_id, ELiveSessionProperty_JointsCapacity, TAKE_TEST_JOINTS / 2);
+
+	int result = HardwareOpen(small_session_id, "test_pair_take_small", true);
+	_ASSERT(result == 0);
+
+	result = StartTakeReplay(small_session_id, TAKE_TEST_FILE, 0.0, false);
+	_ASSERT(result == -5);
+	_ASSERT(GetTakeReplayPosition(small_session_id) == -1);
+
+	HardwareClose(small_session_id);
+	FreeLiveSession(small_session_id);
+
+	const unsigned session_id = NewLiveSession();
+
+	result = HardwareOpen(session_id, "test_pair_take_replay", true);
+	_ASSERT(result == 0);
+
+	result = StartTakeReplay(session_id, "missing_take.albk", 0.0, false);
+	_ASSERT(result == -1);
+
+	result = StartTakeReplay(session_id, TAKE_TEST_FILE, 0.0, false);
+	_ASSERT(result == 0);
+
+	for (int attemps = 0; attemps < 500 && GetTakeReplayPosition(session_id) < TAKE_TEST_FRAMES + 1; ++attemps)
+	{
+		constexpr std::chrono::milliseconds timespan(10);
+		std::this_thread::sleep_for(timespan);
+	}
+
+	printf("take replay - replayed frames %d\n", GetTakeReplayPosition(session_id));
+	_ASSERT(GetTakeReplayPosition(session_id) == TAKE_TEST_FRAMES + 1);
+
+	StopTakeReplay(session_id);
+	HardwareClose(session_id);
+	FreeLiveSession(session_id);
+}
+
+void take_client(const char* pair_name)
+{
+	const unsigned session_id = NewLiveSession();
+
+	int result = -1;
+
+	for (int attemps = 0; attemps < 10; ++attemps)
+	{
+		result = HardwareOpen(session_id, pair_name, false);
+		if (result == 0)
+			break;
+
+		constexpr std::chrono::milliseconds timespan(100);
+		std::this_thread::sleep_for(timespan);
+	}
+
+	if (result != 0)
+		return;
+
+	int frames = 0;
+
+	while (true)
+	{
+		result = HardwareWaitForFrame(session_id, 5000);
+		_ASSERT(result == 0);
+
+		result = HardwareCommit(session_id, true);
+		_ASSERT(result == 0);
+
+		const SSharedModelData* data = MapModelData(session_id);
+		if (data->m_Header.m_ServerTag == UINT32_MAX)
+			break;
+
+		// a first exchange could be a server open handshake, before any frame is committed
+		if (frames == 0 && data->m_Header.m_ModelsCount == 0)
+			continue;
+
+		// every frame is handed off in order, a replay at speed 0 doesn't drop frames
+		_ASSERT(data->m_Header.m_ServerTag == static_cast<unsigned int>(frames));
+		_ASSERT(data->m_Header.m_ModelsCount == TAKE_TEST_JOINTS);
+		_ASSERT(data->m_ServerPlayer.m_LocalTime == 0.001 * static_cast<double>(frames));
+
+		const SJointData* joints = GetModelJoints(data);
+		for (int j = 0; j < TAKE_TEST_JOINTS; ++j)
+		{
+			_ASSERT(joints[j].m_Transform.m_Translation.m_X == static_cast<float>(frames));
+			_ASSERT(joints[j].m_Transform.m_Translation.m_Y == static_cast<float>(j));
+		}
+		++frames;
+	}
+
+	printf("take client %s - received frames %d\n", pair_name, frames);
+	_ASSERT(frames == TAKE_TEST_FRAMES);
+
+	HardwareClose(session_id);
+	FreeLiveSession(session_id);
+}
+
+///////////////////////////////////////////////////////////////////////////////////
+// jitter buffer test, a server commits with an irregular cadence, a session stamps frames with a commit time,
+//  a client samples a pose on a regular step, a joint moves and rotates linearly with a server time
+
+const int JITTER_TEST_FRAMES = 150;
+const int JITTER_TEST_DELAY_MS = 50;
+const int JITTER_TEST_JOINTS = 4;
+
+std::atomic<double> g_JitterStartTime{ 0.0 };
+
+void jitter_server()
+{
+	const unsigned session_id = NewLiveSession();
+
+	int result = HardwareOpen(session_id, "test_pair_jitter", true);
+	_ASSERT(result == 0);
+
+	g_JitterStartTime.store(GetLiveBridgeTime());
+
+	for (int i = 0; i <= JITTER_TEST_FRAMES; ++i)
+	{
+		result = HardwareWaitForFrame(session_id, 5000);
+		_ASSERT(result == 0);
+
+		const double time = GetLiveBridgeTime();
+		const float value = static_cast<float>(time - g_JitterStartTime.load());
+
+		SSharedModelData* data = MapModelData(session_id);
+		data->m_Header.m_ModelsCount = JITTER_TEST_JOINTS;
+		data->m_Header.m_ServerTag = (i < JITTER_TEST_FRAMES) ? i : UINT32_MAX;
+
+		SJointData* joints = GetModelJoints(data);
+		for (int j = 0; j < JITTER_TEST_JOINTS; ++j)
+		{
+			joints[j].m_NameHash = j + 1;
+			joints[j].m_Flags = HINT_ROTATION_QUATERNION;
+			joints[j].m_Transform.m_Translation = { value, 0.0f, 0.0f };
+			joints[j].m_Transform.m_Rotation = { 0.0f, 0.0f, std::sin(0.5f * value), std::cos(0.5f * value) };
+			joints[j].m_Transform.m_Scale = { 1.0f, 1.0f, 1.0f };
+		}
+
+		result = HardwareCommit(session_id, true);
+		_ASSERT(result == 0);
+
+		// an irregular cadence, a pose is still expected to move smoothly
+		const std::chrono::milliseconds timespan((i % 3 == 0) ? 12 : 3);
+		std::this_thread::sleep_for(timespan);
+	}
+
+	HardwareClose(session_id);
+	FreeLiveSession(session_id);
+}
+
+void jitter_client()
+{
+	const unsigned session_id = NewLiveSession();
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_JitterBufferDelay, JITTER_TEST_DELAY_MS);
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_JitterBufferInterpolation, EPoseInterpolation_Slerp);
+
+	int result = -1;
+
+	for (int attemps = 0; attemps < 10; ++attemps)
+	{
+		result = HardwareOpen(session_id, "test_pair_jitter", false);
+		if (result == 0)
+			break;
+
+		constexpr std::chrono::milliseconds timespan(100);
+		std::this_thread::sleep_for(timespan);
+	}
+
+	if (result != 0)
+		return;
+
+	_ASSERT(SampleModelData(session_id, 0.0) == nullptr);
+
+	int samples = 0;
+	int accurate_samples = 0;
+	float last_value = -1.0f;
+	bool finished = false;
+
+	while (!finished)
+	{
+		if (HardwareWaitForFrame(session_id, 1) == 0)
+		{
+			result = HardwareCommit(session_id, true);
+			_ASSERT(result == 0);
+
+			finished = MapModelData(session_id)->m_Header.m_ServerTag == UINT32_MAX;
+		}
+
+		const double time = GetLiveBridgeTime();
+		const SSharedModelData* data = SampleModelData(session_id, time);
+
+		if (data == nullptr || data->m_Header.m_ModelsCount != JITTER_TEST_JOINTS)
+			continue;
+
+		const SJointData* joints = GetModelJoints(data);
+		const float value = joints[0].m_Transform.m_Translation.m_X;
+
+		const SVector4& q = joints[0].m_Transform.m_Rotation;
+		const float angle = 2.0f * std::atan2(q.m_Z, q.m_W);
+
+		// a sampled pose never goes back and a rotation is blended with the same weight as a translation
+		_ASSERT(value >= last_value);
+		_ASSERT(std::fabs(angle - value) < 0.001f);
+		_ASSERT(std::fabs(q.m_X * q.m_X + q.m_Y * q.m_Y + q.m_Z * q.m_Z + q.m_W * q.m_W - 1.0f) < 0.001f);
+
+		const double expected = time - 0.001 * JITTER_TEST_DELAY_MS - g_JitterStartTime.load();
+
+		if (expected > 0.02)
+		{
+			++samples;
+			accurate_samples += (std::fabs(value - expected) < 0.005) ? 1 : 0;
+		}
+		last_value = value;
+	}
+
+	printf("client jitter buffer - samples %d, within 5 ms %d\n", samples, accurate_samples);
+	_ASSERT(samples > 0 && accurate_samples * 10 >= samples * 9);
+
+	HardwareClose(session_id);
+	FreeLiveSession(session_id);
+}
+
+///////////////////////////////////////////////////////////////////////////////////
+// joint schema test, a tcp server sends joint names once and a client reads joints by a remap,
+//  a rig order is changed in a middle of a stream
+
+const int SCHEMA_TEST_PORT = 18893;
+const int SCHEMA_TEST_FRAMES = 100;
+const int SCHEMA_TEST_JOINTS = 64;
+
+unsigned int schema_joint_hash(const int joint_index, const bool reversed)
+{
+	return 1000 + static_cast<unsigned int>((reversed) ? SCHEMA_TEST_JOINTS - 1 - joint_index : joint_index);
+}
+
+void server_schema()
+{
+	const unsigned session_id = NewLiveSession();
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_CommunicationType, static_cast<int>(ECommunicationType::NetworkTCP));
+	SetLiveSessionPropertyString(session_id, ELiveSessionProperty_NetworkAddress, NETWORK_TEST_ADDRESS);
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_NetworkPort, SCHEMA_TEST_PORT);
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_JointSchema, 1);
+
+	int result = HardwareOpen(session_id, "test_pair_schema", true);
+	_ASSERT(result == 0);
+
+	for (int i = 0; i <= SCHEMA_TEST_FRAMES; ++i)
+	{
+		result = HardwareWaitForFrame(session_id, 5000);
+		_ASSERT(result == 0);
+
+		const bool reversed = i >= SCHEMA_TEST_FRAMES / 2;
+
+		SSharedModelData* data = MapModelData(session_id);
+		data->m_Header.m_ModelsCount = SCHEMA_TEST_JOINTS;
+		data->m_Header.m_ServerTag = (i < SCHEMA_TEST_FRAMES) ? i : UINT32_MAX;
+
+		SJointData* joints = GetModelJoints(data);
+		for (int j = 0; j < SCHEMA_TEST_JOINTS; ++j)
+		{
+			joints[j].m_NameHash = schema_joint_hash(j, reversed);
+			joints[j].m_ParentHash = (j > 0) ? schema_joint_hash(j - 1, reversed) : 0;
+			joints[j].m_Flags = HINT_ROTATION_QUATERNION;
+			joints[j].m_Transform.m_Translation.m_X = static_cast<float>(i);
+			joints[j].m_Transform.m_Translation.m_Y = static_cast<float>(joints[j].m_NameHash);
+		}
+
+		result = HardwareCommit(session_id, true);
+		_ASSERT(result == 0);
+	}
+
+	HardwareClose(session_id);
+	FreeLiveSession(session_id);
+}
+
+void client_schema()
+{
+	const unsigned session_id = NewLiveSession();
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_CommunicationType, static_cast<int>(ECommunicationType::NetworkTCP));
+	SetLiveSessionPropertyString(session_id, ELiveSessionProperty_NetworkAddress, NETWORK_TEST_ADDRESS);
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_NetworkPort, SCHEMA_TEST_PORT);
+
+	int result = -1;
+
+	for (int attemps = 0; attemps < 10; ++attemps)
+	{
+		result = HardwareOpen(session_id, "test_pair_schema", false);
+		if (result == 0)
+			break;
+
+		constexpr std::chrono::milliseconds timespan(100);
+		std::this_thread::sleep_for(timespan);
+	}
+
+	if (result != 0)
+		return;
+
+	// local objects in their own order
+	unsigned int local_hashes[SCHEMA_TEST_JOINTS];
+	int remap[SCHEMA_TEST_JOINTS];
+
+	for (int j = 0; j < SCHEMA_TEST_JOINTS; ++j)
+	{
+		local_hashes[j] = schema_joint_hash((j * 7) % SCHEMA_TEST_JOINTS, false);
+	}
+
+	int frames = 0;
+	int schema_changes = 0;
+	unsigned int schema_id = 0;
+
+	while (true)
+	{
+		if (HardwareCommit(session_id, true) != 0)
+		{
+			std::this_thread::yield();
+			continue;
+		}
+
+		const SSharedModelData* data = MapModelData(session_id);
+		if (data->m_Header.m_ServerTag == UINT32_MAX)
+			break;
+
+		if (GetJointSchemaId(data) != schema_id)
+		{
+			schema_id = GetJointSchemaId(data);
+			++schema_changes;
+
+			result = BuildJointRemap(data, local_hashes, SCHEMA_TEST_JOINTS, remap);
+			_ASSERT(result == SCHEMA_TEST_JOINTS);
+		}
+
+		// names, parents and flags are restored from a schema
+		const SJointData* joints = GetModelJoints(data);
+		for (int j = 0; j < SCHEMA_TEST_JOINTS; ++j)
+		{
+			const SJointData& joint = joints[remap[j]];
+
+			_ASSERT(joint.m_NameHash == local_hashes[j]);
+			_ASSERT(joint.m_Flags == HINT_ROTATION_QUATERNION);
+			_ASSERT(joint.m_Transform.m_Translation.m_X == static_cast<float>(data->m_Header.m_ServerTag));
+			_ASSERT(joint.m_Transform.m_Translation.m_Y == static_cast<float>(local_hashes[j]));
+		}
+		_ASSERT(joints[0].m_ParentHash == 0 && joints[1].m_ParentHash == joints[0].m_NameHash);
+		++frames;
+	}
+
+	SLiveSessionStats stats;
+	GetLiveSessionStats(session_id, stats);
+
+	const unsigned long long frame_bytes = stats.m_BytesReceived / stats.m_FramesReceived;
+	printf("client joint schema - received frames %d, schema changes %d, bytes per frame %llu\n", frames, schema_changes, frame_bytes);
+
+	_ASSERT(frames == SCHEMA_TEST_FRAMES);
+	_ASSERT(schema_changes == 2);
+	_ASSERT(frame_bytes < sizeof(SJointData) * SCHEMA_TEST_JOINTS);
+
+	HardwareClose(session_id);
+	FreeLiveSession(session_id);
+}
+
+///////////////////////////////////////////////////////////////////////////////////
+// name hash test, compile time and run time hashes are the same FNV-1a values on any platform,
+//  a registry finds names with the same hash
+
+static_assert(HashNameConst("") == 0x811c9dc5u, "name hash basis");
+static_assert(HashNameConst("foobar") == 0xbf9cf968u, "FNV-1a reference value");
+
+void name_hash()
+{
+	constexpr unsigned int hips_hash = HashNameConst("Hips");
+
+	_ASSERT(HashPairName("Hips") == hips_hash);
+	_ASSERT(HashPairName("foobar") == 0xbf9cf968u);
+
+	CNameHashRegistry registry;
+	registry.Register("Hips");
+	registry.Register("Spine");
+	registry.Register("Hips");				// the same name is not a collision
+	_ASSERT(registry.GetCollisionsCount() == 0);
+
+	// known FNV-1a 32 bit collisions
+	const unsigned int hash = registry.Register("costarring");
+	_ASSERT(registry.Register("liquid") == hash);
+	_ASSERT(registry.Register("declinate") == registry.Register("macallums"));
+
+	_ASSERT(registry.GetCollisionsCount() == 2);
+	_ASSERT(strcmp(registry.FindName(hash), "costarring") == 0);
+	_ASSERT(strcmp(registry.FindName(hips_hash), "Hips") == 0);
+
+	printf("name hash - hips %u, collisions %d\n", hips_hash, registry.GetCollisionsCount());
+
+	registry.Clear();
+	_ASSERT(registry.GetCollisionsCount() == 0 && registry.FindName(hash) == nullptr);
+}
+
+///////////////////////////////////////////////////////////////////////////////////
+// structure of arrays test, float and double arrays are written into a server frame,
+//  double arrays are converted by blocks, so a joints count crosses a block
+
+const unsigned int SOA_TEST_JOINTS = 100;
+const unsigned int SOA_TEST_PROPS = 8;
+
+void soa_ingestion()
+{
+	const unsigned session_id = NewLiveSession();
+
+	int result = HardwareOpen(session_id, "test_pair_soa", true);
+	_ASSERT(result == 0);
+
+	unsigned int hashes[SOA_TEST_JOINTS];
+	float translations[SOA_TEST_JOINTS * 3];
+	float rotations[SOA_TEST_JOINTS * 4];
+	double scales[SOA_TEST_JOINTS * 3];
+
+	for (unsigned int i = 0; i < SOA_TEST_JOINTS; ++i)
+	{
+		hashes[i] = 1000 + i;
+		for (int k = 0; k < 3; ++k)
+		{
+			translations[i * 3 + k] = static_cast<float>(i * 10 + k);
+			scales[i * 3 + k] = 1.0 + 0.25 * k + i;
+		}
+		for (int k = 0; k < 4; ++k)
+		{
+			rotations[i * 4 + k] = 0.5f;
+		}
+	}
+
+	result = SetModelDataJointsSoA(session_id, 0, SOA_TEST_JOINTS, hashes, translations, rotations, nullptr);
+	_ASSERT(result == 0);
+
+	// a second call only changes scales
+	result = SetModelDataJointsSoAd(session_id, 0, SOA_TEST_JOINTS, nullptr, nullptr, nullptr, scales);
+	_ASSERT(result == 0);
+
+	unsigned int prop_hashes[SOA_TEST_PROPS];
+	double prop_values[SOA_TEST_PROPS];
+	for (unsigned int i = 0; i < SOA_TEST_PROPS; ++i)
+	{
+		prop_hashes[i] = 2000 + i;
+		prop_values[i] = 0.125 * i;
+	}
+	result = SetModelDataPropertiesSoAd(session_id, 4, SOA_TEST_PROPS, prop_hashes, prop_values);
+	_ASSERT(result == 0);
+
+	const SSharedModelData* data = MapModelData(session_id);
+	const SJointData* joints = GetModelJoints(data);
+	const SPropertyData* props = GetModelProperties(data);
+
+	int errors = 0;
+	for (unsigned int i = 0; i < SOA_TEST_JOINTS; ++i)
+	{
+		const STransform& tm = joints[i].m_Transform;
+
+		errors += (joints[i].m_NameHash != 1000 + i) ? 1 : 0;
+		errors += (tm.m_Translation.m_X != i * 10.0f || tm.m_Translation.m_Z != i * 10.0f + 2.0f) ? 1 : 0;
+		errors += (tm.m_Rotation.m_X != 0.5f || tm.m_Rotation.m_W != 0.5f) ? 1 : 0;
+		errors += (tm.m_Scale.m_X != 1.0f + i || tm.m_Scale.m_Y != 1.25f + i || tm.m_Scale.m_Z != 1.5f + i) ? 1 : 0;
+	}
+	for (unsigned int i = 0; i < SOA_TEST_PROPS; ++i)
+	{
+		errors += (props[4 + i].m_NameHash != 2000 + i || props[4 + i].m_Value != 0.125f * i) ? 1 : 0;
+	}
+
+	// python buffer views are sized by a session capacity
+	_ASSERT(GetModelDataJointsCapacity(session_id) == NUMBER_OF_JOINTS);
+	_ASSERT(GetModelDataPropertiesCapacity(session_id) == NUMBER_OF_PROPERTIES);
+
+	// a range out of a capacity is rejected
+	result = SetModelDataJointsSoA(session_id, NUMBER_OF_JOINTS - 1, 2, hashes, nullptr, nullptr, nullptr);
+	_ASSERT(result == -5);
+	result = SetModelDataPropertiesSoA(session_id, NUMBER_OF_PROPERTIES, 1, prop_hashes, nullptr);
+	_ASSERT(result == -5);
+
+	printf("soa ingestion - joints %u, properties %u, errors %d\n", SOA_TEST_JOINTS, SOA_TEST_PROPS, errors);
+	_ASSERT(errors == 0);
+
+	HardwareClose(session_id);
+
+	result = SetModelDataJointsSoA(session_id, 0, 1, hashes, nullptr, nullptr, nullptr);
+	_ASSERT(result == -3);
+	_ASSERT(GetModelDataJointsCapacity(session_id) == -3);
+
+	void* closed_token = RetainModelDataBuffer(session_id);
+	_ASSERT(closed_token == nullptr);
+
+	// a retained frame memory outlives a session, like a python view does
+	result = HardwareOpen(session_id, "test_pair_soa", true);
+	_ASSERT(result == 0);
+
+	void* token = RetainModelDataBuffer(session_id);
+	SJointData* retained = GetModelJoints(MapModelData(session_id));
+	_ASSERT(token != nullptr);
+
+	HardwareClose(session_id);
+	FreeLiveSession(session_id);
+
+	retained[0].m_NameHash = 1;
+	ReleaseModelDataBuffer(token);
+}
+
+///////////////////////////////////////////////////////////////////////////////////
+// transform math test, batch kernels are compared with a double precision scalar reference
+
+const unsigned int MATH_TEST_COUNT = 203;		// not a multiple of simd lanes, a scalar tail is tested as well
+
+void reference_euler_to_quaternion(const double ex, const double ey, const double ez, double q[4])
+{
+	const double h = 0.5 * 3.14159265358979323846 / 180.0;
+	const double cx = cos(ex * h), sx = sin(ex * h);
+	const double cy = cos(ey * h), sy = sin(ey * h);
+	const double cz = cos(ez * h), sz = sin(ez * h);
+
+	// q = qz * qy * qx
+	q[0] = sx * cy * cz - cx * sy * sz;
+	q[1] = cx * sy * cz + sx * cy * sz;
+	q[2] = cx * cy * sz - sx * sy * cz;
+	q[3] = cx * cy * cz + sx * sy * sz;
+}
+
+double angle_error(const double a, const double b)
+{
+	const double d = fmod(fabs(a - b), 360.0);
+	return (d > 180.0) ? 360.0 - d : d;
+}
+
+void transform_math()
+{
+	unsigned int seed = 7;
+	auto random = [&seed](const float min_value, const float max_value) {
+		seed = seed * 1664525u + 1013904223u;
+		return min_value + (max_value - min_value) * static_cast<float>(seed >> 8) / static_cast<float>(1 << 24);
+	};
+
+	std::vector<SVector3> euler(MATH_TEST_COUNT);
+	std::vector<SVector4> quaternions(MATH_TEST_COUNT);
+	std::vector<SVector3> euler_back(MATH_TEST_COUNT);
+	std::vector<double> reference(MATH_TEST_COUNT * 4);
+
+	for (unsigned int i = 0; i < MATH_TEST_COUNT; ++i)
+	{
+		euler[i] = { random(-180.0f, 180.0f), random(-85.0f, 85.0f), random(-180.0f, 180.0f) };
+		reference_euler_to_quaternion(euler[i].m_X, euler[i].m_Y, euler[i].m_Z, &reference[i * 4]);
+	}
+
+	// euler to quaternion and back
+	EulerToQuaternions(euler.data(), quaternions.data(), MATH_TEST_COUNT);
+	QuaternionsToEuler(quaternions.data(), euler_back.data(), MATH_TEST_COUNT);
+
+	double quaternion_error = 0.0;
+	double euler_error = 0.0;
+
+	for (unsigned int i = 0; i < MATH_TEST_COUNT; ++i)
+	{
+		const float* q = &quaternions[i].m_X;
+		for (int k = 0; k < 4; ++k)
+			quaternion_error = std::max(quaternion_error, fabs(q[k] - reference[i * 4 + k]));
+
+		euler_error = std::max(euler_error, angle_error(euler[i].m_X, euler_back[i].m_X));
+		euler_error = std::max(euler_error, angle_error(euler[i].m_Y, euler_back[i].m_Y));
+		euler_error = std::max(euler_error, angle_error(euler[i].m_Z, euler_back[i].m_Z));
+	}
+
+	// a product of two euler rotations is a rotation of concatenated axes, qz * qx
+	std::vector<SVector4> qx(MATH_TEST_COUNT);
+	std::vector<SVector4> qz(MATH_TEST_COUNT);
+	std::vector<SVector3> ex(MATH_TEST_COUNT);
+	std::vector<SVector3> ez(MATH_TEST_COUNT);
+
+	for (unsigned int i = 0; i < MATH_TEST_COUNT; ++i)
+	{
+		ex[i] = { euler[i].m_X, 0.0f, 0.0f };
+		ez[i] = { 0.0f, 0.0f, euler[i].m_Z };
+	}
+	EulerToQuaternions(ex.data(), qx.data(), MATH_TEST_COUNT);
+	EulerToQuaternions(ez.data(), qz.data(), MATH_TEST_COUNT);
+	MultiplyQuaternions(qz.data(), qx.data(), qz.data(), MATH_TEST_COUNT);
+
+	double product_error = 0.0;
+	for (unsigned int i = 0; i < MATH_TEST_COUNT; ++i)
+	{
+		double q[4];
+		reference_euler_to_quaternion(euler[i].m_X, 0.0, euler[i].m_Z, q);
+
+		const float* p = &qz[i].m_X;
+		for (int k = 0; k < 4; ++k)
+			product_error = std::max(product_error, fabs(p[k] - q[k]));
+	}
+
+	// matrix round trip, a decomposed quaternion could have an opposite sign
+	std::vector<STransform> transforms(MATH_TEST_COUNT);
+	std::vector<STransform> decomposed(MATH_TEST_COUNT);
+	std::vector<double> matrices(MATH_TEST_COUNT * 16);
+	std::vector<double> matrices_back(MATH_TEST_COUNT * 16);
+
+	for (unsigned int i = 0; i < MATH_TEST_COUNT; ++i)
+	{
+		transforms[i].m_Translation = { random(-200.0f, 200.0f), random(-200.0f, 200.0f), random(-200.0f, 200.0f) };
+		transforms[i].m_Rotation = quaternions[i];
+		transforms[i].m_Scale = { random(0.5f, 2.0f), random(0.5f, 2.0f), random(0.5f, 2.0f) };
+	}
+
+	TransformsToMatrices(transforms.data(), matrices.data(), MATH_TEST_COUNT);
+	MatricesToTransforms(matrices.data(), decomposed.data(), MATH_TEST_COUNT);
+	TransformsToMatrices(decomposed.data(), matrices_back.data(), MATH_TEST_COUNT);
+
+	double matrix_error = 0.0;
+	for (unsigned int i = 0; i < MATH_TEST_COUNT; ++i)
+	{
+		const STransform& a = transforms[i];
+		const STransform& b = decomposed[i];
+
+		const float dot = a.m_Rotation.m_X * b.m_Rotation.m_X + a.m_Rotation.m_Y * b.m_Rotation.m_Y
+			+ a.m_Rotation.m_Z * b.m_Rotation.m_Z + a.m_Rotation.m_W * b.m_Rotation.m_W;
+
+		matrix_error = std::max(matrix_error, 1.0 - fabs(dot));
+		matrix_error = std::max(matrix_error, fabs(a.m_Scale.m_X - b.m_Scale.m_X) + fabs(a.m_Scale.m_Y - b.m_Scale.m_Y) + fabs(a.m_Scale.m_Z - b.m_Scale.m_Z));
+		matrix_error = std::max(matrix_error, fabs(a.m_Translation.m_X - b.m_Translation.m_X) + fabs(a.m_Translation.m_Z - b.m_Translation.m_Z));
+
+		for (int k = 0; k < 16; ++k)
+			matrix_error = std::max(matrix_error, fabs(matrices[i * 16 + k] - matrices_back[i * 16 + k]) / 200.0);
+	}
+	_ASSERT(matrices[15] == 1.0 && matrices[3] == 0.0);
+
+	// joints of mixed rotation types
+	std::vector<SJointData> joints(MATH_TEST_COUNT);
+	for (unsigned int i = 0; i < MATH_TEST_COUNT; ++i)
+	{
+		joints[i].m_Flags = (i % 3 == 0) ? (HINT_ROTATION_QUATERNION | HINT_TRANSFORM_LOCAL) : HINT_ROTATION_EULERANGLES;
+		joints[i].m_Transform.m_Rotation = (i % 3 == 0) ? quaternions[i] : SVector4{ euler[i].m_X, euler[i].m_Y, euler[i].m_Z, 0.0f };
+	}
+	ConvertJointRotations(joints.data(), MATH_TEST_COUNT, HINT_ROTATION_QUATERNION);
+
+	double joints_error = 0.0;
+	for (unsigned int i = 0; i < MATH_TEST_COUNT; ++i)
+	{
+		_ASSERT((joints[i].m_Flags & HINT_ROTATION_QUATERNION) && !(joints[i].m_Flags & HINT_ROTATION_EULERANGLES));
+		_ASSERT(i % 3 != 0 || (joints[i].m_Flags & HINT_TRANSFORM_LOCAL));
+
+		const float* q = &joints[i].m_Transform.m_Rotation.m_X;
+		for (int k = 0; k < 4; ++k)
+			joints_error = std::max(joints_error, fabs(q[k] - reference[i * 4 + k]));
+	}
+
+	// double and float buffers
+	double values[11];
+	float converted[11];
+	double converted_back[11];
+	for (int i = 0; i < 11; ++i)
+		values[i] = 0.1 * i - 0.3;
+
+	ConvertDoublesToFloats(values, converted, 11);
+	ConvertFloatsToDoubles(converted, converted_back, 11);
+	for (int i = 0; i < 11; ++i)
+	{
+		_ASSERT(converted[i] == static_cast<float>(values[i]));
+		_ASSERT(converted_back[i] == static_cast<double>(converted[i]));
+	}
+
+	printf("transform math (%s) - quaternion %g, euler %g deg, product %g, matrix %g, joints %g\n",
+		GetMathKernelName(), quaternion_error, euler_error, product_error, matrix_error, joints_error);
+
+	_ASSERT(quaternion_error < 1e-5);
+	_ASSERT(euler_error < 1e-3);
+	_ASSERT(product_error < 1e-5);
+	_ASSERT(matrix_error < 1e-5);
+	_ASSERT(joints_error < 1e-5);
+}
+
+///////////////////////////////////////////////////////////////////////////////////
+// joint space test, a shuffled tree is converted to model space and back,
+//  a model space is compared with a naive walk over parents in double precision
+
+const unsigned int HIERARCHY_TEST_JOINTS = 100;
+
+struct SReferenceTransform
+{
+	double	m_Translation[3];
+	double	m_Rotation[4];		// x y z w
+	double	m_Scale;			// uniform, a shear is not in a test
+};
+
+void reference_rotate(const double q[4], const double v[3], double result[3])
+{
+	// v + 2w (q x v) + 2 q x (q x v)
+	const double t[3] = { 2.0 * (q[1] * v[2] - q[2] * v[1]), 2.0 * (q[2] * v[0] - q[0] * v[2]), 2.0 * (q[0] * v[1] - q[1] * v[0]) };
+	result[0] = v[0] + q[3] * t[0] + (q[1] * t[2] - q[2] * t[1]);
+	result[1] = v[1] + q[3] * t[1] + (q[2] * t[0] - q[0] * t[2]);
+	result[2] = v[2] + q[3] * t[2] + (q[0] * t[1] - q[1] * t[0]);
+}
+
+void reference_model_transform(const std::vector<SJointData>& joints, const std::vector<int>& parents, const int index, SReferenceTransform& result)
+{
+	const STransform& tm = joints[index].m_Transform;
+	SReferenceTransform local{ { tm.m_Translation.m_X, tm.m_Translation.m_Y, tm.m_Translation.m_Z },
+		{ tm.m_Rotation.m_X, tm.m_Rotation.m_Y, tm.m_Rotation.m_Z, tm.m_Rotation.m_W }, tm.m_Scale.m_X };
+
+	if (parents[index] < 0)
+	{
+		result = local;
+		return;
+	}
+
+	SReferenceTransform parent;
+	reference_model_transform(joints, parents, parents[index], parent);
+
+	const double scaled[3] = { parent.m_Scale * local.m_Translation[0], parent.m_Scale * local.m_Translation[1], parent.m_Scale * local.m_Translation[2] };
+	reference_rotate(parent.m_Rotation, scaled, result.m_Translation);
+	for (int k = 0; k < 3; ++k)
+		result.m_Translation[k] += parent.m_Translation[k];
+
+	const double* a = parent.m_Rotation;
+	const double* b = local.m_Rotation;
+	result.m_Rotation[0] = a[3] * b[0] + a[0] * b[3] + a[1] * b[2] - a[2] * b[1];
+	result.m_Rotation[1] = a[3] * b[1] + a[1] * b[3] + a[2] * b[0] - a[0] * b[2];
+	result.m_Rotation[2] = a[3] * b[2] + a[2] * b[3] + a[0] * b[1] - a[1] * b[0];
+	result.m_Rotation[3] = a[3] * b[3] - a[0] * b[0] - a[1] * b[1] - a[2] * b[2];
+	result.m_Scale = parent.m_Scale * local.m_Scale;
+}
+
+double rotation_error(const SVector4& a, const SVector4& b)
+{
+	return 1.0 - fabs(a.m_X * b.m_X + a.m_Y * b.m_Y + a.m_Z * b.m_Z + a.m_W * b.m_W);
+}
+
+void joint_space()
+{
+	unsigned int seed = 11;
+	auto random = [&seed](const float min_value, const float max_value) {
+		seed = seed * 1664525u + 1013904223u;
+		return min_value + (max_value - min_value) * static_cast<float>(seed >> 8) / static_cast<float>(1 << 24);
+	};
+
+	// a binary tree, stored in a reversed order, so children are before parents
+	std::vector<SJointData> joints(HIERARCHY_TEST_JOINTS);
+	std::vector<int> parents(HIERARCHY_TEST_JOINTS);
+	std::vector<SVector3> euler(HIERARCHY_TEST_JOINTS);
+
+	for (unsigned int i = 0; i < HIERARCHY_TEST_JOINTS; ++i)
+	{
+		const unsigned int tree_index = HIERARCHY_TEST_JOINTS - 1 - i;
+		SJointData& joint = joints[i];
+
+		joint.m_NameHash = 1000 + tree_index;
+		joint.m_ParentHash = (tree_index > 0) ? 1000 + (tree_index - 1) / 2 : 0;
+		joint.m_Flags = HINT_ROTATION_QUATERNION | HINT_TRANSFORM_LOCAL;
+		parents[i] = (tree_index > 0) ? static_cast<int>(HIERARCHY_TEST_JOINTS - 1 - (tree_index - 1) / 2) : -1;
+
+		euler[i] = { random(-90.0f, 90.0f), random(-60.0f, 60.0f), random(-90.0f, 90.0f) };
+		const float scale = random(0.9f, 1.1f);
+
+		joint.m_Transform.m_Translation = { random(-10.0f, 10.0f), random(-10.0f, 10.0f), random(-10.0f, 10.0f) };
+		joint.m_Transform.m_Scale = { scale, scale, scale };
+	}
+
+	std::vector<SVector4> rotations(HIERARCHY_TEST_JOINTS);
+	EulerToQuaternions(euler.data(), rotations.data(), HIERARCHY_TEST_JOINTS);
+	for (unsigned int i = 0; i < HIERARCHY_TEST_JOINTS; ++i)
+		joints[i].m_Transform.m_Rotation = rotations[i];
+
+	// every fourth joint is in euler angles, it stays in euler angles
+	std::vector<SJointData> local(joints);
+	for (unsigned int i = 0; i < HIERARCHY_TEST_JOINTS; i += 4)
+	{
+		local[i].m_Flags = HINT_ROTATION_EULERANGLES;
+		local[i].m_Transform.m_Rotation = { euler[i].m_X, euler[i].m_Y, euler[i].m_Z, 0.0f };
+	}
+
+	std::vector<SJointData> model(local);
+	int result = ConvertJointSpace(model.data(), HIERARCHY_TEST_JOINTS, HINT_TRANSFORM_MODEL);
+	_ASSERT(result == 0);
+
+	double translation_error = 0.0;
+	double model_rotation_error = 0.0;
+
+	for (unsigned int i = 0; i < HIERARCHY_TEST_JOINTS; ++i)
+	{
+		_ASSERT(model[i].m_Flags & HINT_TRANSFORM_MODEL);
+		_ASSERT(!(model[i].m_Flags & HINT_TRANSFORM_LOCAL));
+		_ASSERT(((model[i].m_Flags & HINT_ROTATION_EULERANGLES) != 0) == (i % 4 == 0));
+
+		SReferenceTransform reference;
+		reference_model_transform(joints, parents, i, reference);
+
+		const STransform& tm = model[i].m_Transform;
+		translation_error = std::max(translation_error, fabs(tm.m_Translation.m_X - reference.m_Translation[0]));
+		translation_error = std::max(translation_error, fabs(tm.m_Translation.m_Y - reference.m_Translation[1]));
+		translation_error = std::max(translation_error, fabs(tm.m_Translation.m_Z - reference.m_Translation[2]));
+		translation_error = std::max(translation_error, fabs(tm.m_Scale.m_X - reference.m_Scale));
+
+		SVector4 q = tm.m_Rotation;
+		if (i % 4 == 0)
+		{
+			const SVector3 e{ q.m_X, q.m_Y, q.m_Z };
+			EulerToQuaternions(&e, &q, 1);
+		}
+		const SVector4 expected{ static_cast<float>(reference.m_Rotation[0]), static_cast<float>(reference.m_Rotation[1]),
+			static_cast<float>(reference.m_Rotation[2]), static_cast<float>(reference.m_Rotation[3]) };
+		model_rotation_error = std::max(model_rotation_error, rotation_error(q, expected));
+	}
+
+	// and back to a local space, a second call reuses a joints order
+	const std::vector<SJointData> model_space(model);
+
+	// joints which are already in a requested space are kept as they are
+	std::vector<SJointData> same_space(model_space);
+	result = ConvertJointSpace(same_space.data(), HIERARCHY_TEST_JOINTS, HINT_TRANSFORM_MODEL);
+	_ASSERT(result == 0);
+	_ASSERT(memcmp(same_space.data(), model_space.data(), sizeof(SJointData) * HIERARCHY_TEST_JOINTS) == 0);
+
+	result = ConvertJointSpace(model.data(), HIERARCHY_TEST_JOINTS, HINT_TRANSFORM_LOCAL);
+	_ASSERT(result == 0);
+
+	double local_error = 0.0;
+	for (unsigned int i = 0; i < HIERARCHY_TEST_JOINTS; ++i)
+	{
+		_ASSERT(model[i].m_Flags & HINT_TRANSFORM_LOCAL);
+
+		const STransform& a = joints[i].m_Transform;
+		const STransform& b = model[i].m_Transform;
+
+		local_error = std::max(local_error, fabs(a.m_Translation.m_X - b.m_Translation.m_X) + fabs(a.m_Translation.m_Y - b.m_Translation.m_Y)
+			+ fabs(a.m_Translation.m_Z - b.m_Translation.m_Z) + fabs(a.m_Scale.m_Y - b.m_Scale.m_Y));
+
+		if (i % 4 != 0)
+			local_error = std::max(local_error, rotation_error(a.m_Rotation, b.m_Rotation));
+		else
+			local_error = std::max(local_error, angle_error(euler[i].m_Y, b.m_Rotation.m_Y) / 180.0);
+	}
+
+	// a parent cycle is rejected
+	std::vector<SJointData> cycle(3);
+	for (unsigned int i = 0; i < 3; ++i)
+	{
+		cycle[i].m_NameHash = 10 + i;
+		cycle[i].m_ParentHash = 10 + (i + 1) % 3;
+	}
+	result = ConvertJointSpace(cycle.data(), 3, HINT_TRANSFORM_MODEL);
+	_ASSERT(result == -1);
+
+	// a session converts its local buffer
+	const unsigned session_id = NewLiveSession();
+	result = HardwareOpen(session_id, "test_pair_hierarchy", true);
+	_ASSERT(result == 0);
+
+	SSharedModelData* data = MapModelData(session_id);
+	data->m_Header.m_ModelsCount = HIERARCHY_TEST_JOINTS;
+	memcpy(GetModelJoints(data), joints.data(), sizeof(SJointData) * HIERARCHY_TEST_JOINTS);
+
+	result = ConvertModelDataSpace(session_id, HINT_TRANSFORM_MODEL);
+	_ASSERT(result == 0);
+
+	double session_error = 0.0;
+	const SJointData* session_joints = GetModelJoints(data);
+	for (unsigned int i = 0; i < HIERARCHY_TEST_JOINTS; ++i)
+	{
+		session_error = std::max(session_error, fabs(session_joints[i].m_Transform.m_Translation.m_X - model_space[i].m_Transform.m_Translation.m_X));
+	}
+
+	HardwareClose(session_id);
+	FreeLiveSession(session_id);
+
+	result = ConvertModelDataSpace(session_id, HINT_TRANSFORM_MODEL);
+	_ASSERT(result == -3);
+
+	printf("joint space - translation %g, rotation %g, local round trip %g, session %g\n",
+		translation_error, model_rotation_error, local_error, session_error);
+
+	_ASSERT(translation_error < 1e-3);
+	_ASSERT(model_rotation_error < 1e-5);
+	_ASSERT(local_error < 1e-4);
+	_ASSERT(session_error < 1e-3);
+}
+
+///////////////////////////////////////////////////////////////////////////////////
+// property channels test, a tcp server streams typed facial channels without name hashes,
+//  int channels are removed from a layout in a middle of a stream
+
+const int CHANNELS_TEST_PORT = 18892;
+const int CHANNELS_TEST_FRAMES = 60;
+const int CHANNELS_TEST_LAYOUT_CHANGE = 40;
+const int CHANNELS_TEST_WEIGHTS = 256;
+const int CHANNELS_TEST_PROPS_CAPACITY = 512;
+
+struct SChannelsTestLayout
+{
+	unsigned int	m_Hashes[CHANNELS_TEST_WEIGHTS + 40];
+	unsigned int	m_Types[CHANNELS_TEST_WEIGHTS + 40];
+	unsigned int	m_Count{ 0 };
+	unsigned int	m_Components{ 0 };
+
+	// weights, 16 floats, 8 vectors, 8 quaternions and 8 optional ints
+	explicit SChannelsTestLayout(const bool with_ints)
+	{
+		const unsigned int groups[5][2] = { { EChannelType_Weight16, CHANNELS_TEST_WEIGHTS }, { EChannelType_Float, 16 },
+			{ EChannelType_Vector3, 8 }, { EChannelType_Quaternion, 8 }, { EChannelType_Int, (with_ints) ? 8u : 0u } };
+
+		for (const auto& group : groups)
+		{
+			for (unsigned int i = 0; i < group[1]; ++i)
+			{
+				m_Hashes[m_Count] = 5000 + m_Count;
+				m_Types[m_Count] = group[0];
+				m_Components += (group[0] == EChannelType_Vector3) ? 3 : (group[0] == EChannelType_Quaternion) ? 4 : 1;
+				++m_Count;
+			}
+		}
+	}
+};
+
+float channels_test_value(const unsigned int type, const int frame, const unsigned int component)
+{
+	switch (type)
+	{
+	case EChannelType_Weight16: return static_cast<float>((frame * 7 + component) % 101) / 100.0f;
+	case EChannelType_Int: return static_cast<float>(frame * 1000 + static_cast<int>(component));
+	}
+	return 0.5f * frame - 0.25f * component;
+}
+
+void server_channels()
+{
+	const unsigned session_id = NewLiveSession();
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_CommunicationType, static_cast<int>(ECommunicationType::NetworkTCP));
+	SetLiveSessionPropertyString(session_id, ELiveSessionProperty_NetworkAddress, NETWORK_TEST_ADDRESS);
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_NetworkPort, CHANNELS_TEST_PORT);
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_PropsCapacity, CHANNELS_TEST_PROPS_CAPACITY);
+
+	int result = HardwareOpen(session_id, "test_pair_channels", true);
+	_ASSERT(result == 0);
+
+	const SChannelsTestLayout full_layout(true);
+	const SChannelsTestLayout short_layout(false);
+
+	// a raised props capacity holds a full layout
+	result = SetModelDataChannelLayout(session_id, full_layout.m_Hashes, full_layout.m_Types, full_layout.m_Count);
+	_ASSERT(result == 0);
+
+	std::vector<float> values(full_layout.m_Components);
+
+	for (int i = 0; i <= CHANNELS_TEST_FRAMES; ++i)
+	{
+		result = HardwareWaitForFrame(session_id, 5000);
+		_ASSERT(result == 0);
+
+		const SChannelsTestLayout& layout = (i < CHANNELS_TEST_LAYOUT_CHANGE) ? full_layout : short_layout;
+		if (i == CHANNELS_TEST_LAYOUT_CHANGE)
+		{
+			result = SetModelDataChannelLayout(session_id, layout.m_Hashes, layout.m_Types, layout.m_Count);
+			_ASSERT(result == 0);
+		}
+
+		size_t k = 0;
+		for (unsigned int c = 0; c < layout.m_Count; ++c)
+		{
+			const unsigned int components = (layout.m_Types[c] == EChannelType_Vector3) ? 3 : (layout.m_Types[c] == EChannelType_Quaternion) ? 4 : 1;
+			for (unsigned int n = 0; n < components; ++n)
+			{
+				values[k++] = channels_test_value(layout.m_Types[c], i, c + n);
+			}
+		}
+		result = SetModelDataChannelValues(session_id, 0, layout.m_Count, values.data());
+		_ASSERT(result == 0);
+
+		SSharedModelData* data = MapModelData(session_id);
+		data->m_Header.m_ServerTag = (i < CHANNELS_TEST_FRAMES) ? i : UINT32_MAX;
+
+		result = HardwareCommit(session_id, true);
+		_ASSERT(result == 0);
+	}
+
+	result = SetModelDataChannelValues(session_id, short_layout.m_Count, 1, values.data());
+	_ASSERT(result == -5);
+
+	HardwareClose(session_id);
+	FreeLiveSession(session_id);
+}
+
+void client_channels()
+{
+	const unsigned session_id = NewLiveSession();
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_CommunicationType, static_cast<int>(ECommunicationType::NetworkTCP));
+	SetLiveSessionPropertyString(session_id, ELiveSessionProperty_NetworkAddress, NETWORK_TEST_ADDRESS);
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_NetworkPort, CHANNELS_TEST_PORT);
+
+	int result = -1;
+
+	for (int attemps = 0; attemps < 10; ++attemps)
+	{
+		result = HardwareOpen(session_id, "test_pair_channels", false);
+		if (result == 0)
+			break;
+
+		constexpr std::chrono::milliseconds timespan(100);
+		std::this_thread::sleep_for(timespan);
+	}
+
+	if (result != 0)
+		return;
+
+	std::vector<float> values(CHANNELS_TEST_WEIGHTS * 4);
+
+	int frames = 0;
+	int layout_frames = 0;
+	unsigned int min_props = UINT32_MAX;
+	double max_error = 0.0;
+
+	while (true)
+	{
+		if (HardwareCommit(session_id, true) != 0)
+		{
+			std::this_thread::yield();
+			continue;
+		}
+
+		const SSharedModelData* data = MapModelData(session_id);
+		const int frame = static_cast<int>(data->m_Header.m_ServerTag);
+		if (data->m_Header.m_ServerTag == UINT32_MAX)
+			break;
+
+		const int count = ReadModelDataChannels(session_id);
+		const SChannelsTestLayout layout(frame < CHANNELS_TEST_LAYOUT_CHANGE);
+		_ASSERT(count == static_cast<int>(layout.m_Count));
+
+		// a frame with a layout is larger than a frame with values only
+		min_props = std::min(min_props, data->m_Header.m_PropsCount);
+		layout_frames += (data->m_Header.m_PropsCount * sizeof(SPropertyData) > layout.m_Count * sizeof(unsigned int) * 2) ? 1 : 0;
+
+		result = GetModelDataChannelValues(session_id, 0, count, values.data());
+		_ASSERT(result == static_cast<int>(layout.m_Components));
+
+		size_t k = 0;
+		for (int c = 0; c < count; ++c)
+		{
+			const unsigned int type = static_cast<unsigned int>(GetModelDataChannelType(session_id, c));
+			_ASSERT(type == layout.m_Types[c]);
+
+			const unsigned int components = (type == EChannelType_Vector3) ? 3 : (type == EChannelType_Quaternion) ? 4 : 1;
+			for (unsigned int n = 0; n < components; ++n)
+			{
+				const double error = fabs(values[k++] - channels_test_value(type, frame, c + n));
+				max_error = std::max(max_error, error);
+			}
+		}
+		_ASSERT(FindModelDataChannel(session_id, layout.m_Hashes[count - 1]) == count - 1);
+		++frames;
+	}
+
+	_ASSERT(GetModelDataChannelType(session_id, CHANNELS_TEST_WEIGHTS + 100) == -1);
+
+	// the same values as name / value properties, weights, floats and every vector and quaternion component
+	const SChannelsTestLayout layout(true);
+	const unsigned int property_bytes = layout.m_Components * static_cast<unsigned int>(sizeof(SPropertyData));
+	const unsigned int channel_bytes = min_props * static_cast<unsigned int>(sizeof(SPropertyData));
+
+	printf("client channels - received frames %d, layout frames %d, bytes %u (as properties %u), max error %g\n",
+		frames, layout_frames, channel_bytes, property_bytes, max_error);
+
+	_ASSERT(frames == CHANNELS_TEST_FRAMES);
+	_ASSERT(layout_frames == 3);			// a first frame, a repeat after 30 frames and a layout change
+	_ASSERT(max_error <= 0.5 / 65535.0 + 1e-6);
+	_ASSERT(channel_bytes * 3 < property_bytes);
+
+	HardwareClose(session_id);
+	FreeLiveSession(session_id);
+}
+
+// a layout which doesn't fit a props capacity is refused, a layout kept from a larger frame fails a commit
+void channels_capacity()
+{
+	const unsigned session_id = NewLiveSession();
+	const SChannelsTestLayout layout(true);
+
+	int result = HardwareOpen(session_id, "test_pair_channels_capacity", true);
+	_ASSERT(result == 0);
+
+	// a default capacity can't hold a layout
+	result = SetModelDataChannelLayout(session_id, layout.m_Hashes, layout.m_Types, layout.m_Count);
+	_ASSERT(result == -5);
+
+	HardwareClose(session_id);
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_PropsCapacity, CHANNELS_TEST_PROPS_CAPACITY);
+
+	result = HardwareOpen(session_id, "test_pair_channels_capacity", true);
+	_ASSERT(result == 0);
+
+	result = SetModelDataChannelLayout(session_id, layout.m_Hashes, layout.m_Types, layout.m_Count);
+	_ASSERT(result == 0);
+
+	// reopen with a default capacity, a layout stays with a session
+	HardwareClose(session_id);
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_PropsCapacity, 0);
+
+	result = HardwareOpen(session_id, "test_pair_channels_capacity", true);
+	_ASSERT(result == 0);
+
+	result = HardwareCommit(session_id, true);
+	_ASSERT(result == -5);
+
+	SLiveSessionStats stats;
+	GetLiveSessionStats(session_id, stats);
+	printf("channels capacity - commit %d, commit errors %llu\n", result, stats.m_CommitErrors);
+	_ASSERT(stats.m_CommitErrors == 1);
+
+	HardwareClose(session_id);
+	FreeLiveSession(session_id);
+}
+
+///////////////////////////////////////////////////////////////////////////////////
+// clock sync test, a tcp server stamps frames with its clock, a client estimates an offset and a frame age
+//  both sides share one machine clock, so an offset and a drift rate have to be close to zero
+
+const int CLOCK_TEST_PORT = 18891;
+const int CLOCK_TEST_FRAMES = 250;
+
+void server_clock()
+{
+	const unsigned session_id = NewLiveSession();
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_CommunicationType, static_cast<int>(ECommunicationType::NetworkTCP));
+	SetLiveSessionPropertyString(session_id, ELiveSessionProperty_NetworkAddress, NETWORK_TEST_ADDRESS);
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_NetworkPort, CLOCK_TEST_PORT);
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_ClockSync, 1);
+
+	int result = HardwareOpen(session_id, "test_pair_clock", true);
+	_ASSERT(result == 0);
+
+	for (int i = 0; i <= CLOCK_TEST_FRAMES; ++i)
+	{
+		result = HardwareWaitForFrame(session_id, 5000);
+		_ASSERT(result == 0);
+
+		SSharedModelData* data = MapModelData(session_id);
+		data->m_Header.m_ServerTag = (i < CLOCK_TEST_FRAMES) ? i : UINT32_MAX;
+
+		result = HardwareCommit(session_id, true);
+		_ASSERT(result == 0);
+
+		// a drift rate needs a second of samples
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+	}
+
+	// a server has a client offset too, it's a same clock
+	SLiveSessionClock clock;
+	_ASSERT(GetLiveSessionClock(session_id, clock));
+	_ASSERT(clock.m_Samples > 0 && fabs(clock.m_Offset) < 0.002);
+	_ASSERT(fabs(GetLiveSessionClockTime(session_id) - GetLiveBridgeTime()) < 0.001);
+
+	HardwareClose(session_id);
+	FreeLiveSession(session_id);
+}
+
+void client_clock()
+{
+	const unsigned session_id = NewLiveSession();
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_CommunicationType, static_cast<int>(ECommunicationType::NetworkTCP));
+	SetLiveSessionPropertyString(session_id, ELiveSessionProperty_NetworkAddress, NETWORK_TEST_ADDRESS);
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_NetworkPort, CLOCK_TEST_PORT);
+	SetLiveSessionPropertyInt(session_id, ELiveSessionProperty_JitterBufferDelay, 20);
+
+	int result = -1;
+
+	for (int attemps = 0; attemps < 10; ++attemps)
+	{
+		result = HardwareOpen(session_id, "test_pair_clock", false);
+		if (result == 0)
+			break;
+
+		constexpr std::chrono::milliseconds timespan(100);
+		std::this_thread::sleep_for(timespan);
+	}
+
+	if (result != 0)
+		return;
+
+	// a client answers clock samples of a server without a property
+	_ASSERT(GetModelDataFrameAge(session_id) == -1.0);
+
+	int frames = 0;
+	double max_age = 0.0;
+	double min_age = 1.0;
+
+	while (true)
+	{
+		if (HardwareCommit(session_id, true) != 0)
+		{
+			std::this_thread::yield();
+			continue;
+		}
+
+		const SSharedModelData* data = MapModelData(session_id);
+		if (data->m_Header.m_ServerTag == UINT32_MAX)
+			break;
+
+		_ASSERT(data->m_ServerPlayer.m_SystemTime > 0.0);
+
+		const double age = GetModelDataFrameAge(session_id);
+		max_age = std::max(max_age, age);
+		min_age = std::min(min_age, age);
+		++frames;
+	}
+
+	SLiveSessionClock clock;
+	_ASSERT(GetLiveSessionClock(session_id, clock));
+
+	const double time_error = GetLiveSessionClockTime(session_id) - GetLiveBridgeTime();
+
+	printf("client clock - frames %d, samples %llu, offset %.3f us, round trip %.3f us, drift %.3f ppm, time error %.3f us, age %.3f - %.3f ms\n",
+		frames, clock.m_Samples, 1e6 * clock.m_Offset, 1e6 * clock.m_RoundTrip, clock.m_Drift, 1e6 * time_error, 1e3 * min_age, 1e3 * max_age);
+
+	_ASSERT(frames == CLOCK_TEST_FRAMES);
+	_ASSERT(clock.m_Samples + 1 >= static_cast<unsigned long long>(CLOCK_TEST_FRAMES));
+	_ASSERT(fabs(clock.m_Offset) < 0.002);
+	_ASSERT(clock.m_RoundTrip >= 0.0 && clock.m_RoundTrip < 0.05);
+	_ASSERT(fabs(clock.m_Drift) < 1000.0);
+	_ASSERT(fabs(time_error) < 0.002);
+	_ASSERT(min_age > -0.002 && max_age < 0.1);
+	_ASSERT(SampleModelData(session_id, 0.0) != nullptr);
+
+	HardwareClose(session_id);
+	FreeLiveSession(session_id);
+}
+
+///////////////////////////////////////////////////////////////////////////////////
+// deferred log test, session messages are queued without formatting and reach a logger only with a drain,
+//  a full ring drops messages and a drain reports how many
+
+const int LOG_TEST_SESSIONS = 64;
+const int LOG_TEST_OVERFLOW_SESSIONS = 1000;
+
+class CCountingLogger : public CLiveBridgeLogger
+{
+public:
+	std::atomic<int>	m_Infos{ 0 };
+	std::atomic<int>	m_Warnings{ 0 };
+	std::atomic<int>	m_Errors{ 0 };
+	char				m_LastWarning[256]{ 0 };
+
+	void LogInfo(const char*) override { ++m_Infos; }
+	void LogWarning(const char* info) override
+	{
+		++m_Warnings;
+		strncpy(m_LastWarning, info, sizeof(m_LastWarning) - 1);
+	}
+	void LogError(const char*) override { ++m_Errors; }
+
+	int GetTotal() const { return m_Infos.load() + m_Warnings.load() + m_Errors.load(); }
+};
+
+void deferred_log()
+{
+	CCountingLogger logger;
+
+	SetVerboseLevel(1);
+	SetLiveBridgeLogger(&logger);
+	SetLiveBridgeLogMode(ELiveBridgeLogMode_Deferred);
+
+	const unsigned int dropped_before = GetLiveBridgeLogDropped();
+
+	// a new session logs an info, a free of a not opened session logs a warning
+	for (int i = 0; i < LOG_TEST_SESSIONS; ++i)
+	{
+		FreeLiveSession(NewLiveSession());
+	}
+	_ASSERT(logger.GetTotal() == 0);
+
+	int drained = DrainLiveBridgeLog();
+	_ASSERT(drained == 2 * LOG_TEST_SESSIONS);
+	_ASSERT(logger.m_Infos.load() == LOG_TEST_SESSIONS && logger.m_Warnings.load() == LOG_TEST_SESSIONS);
+
+	for (int i = 0; i < LOG_TEST_OVERFLOW_SESSIONS; ++i)
+	{
+		FreeLiveSession(NewLiveSession());
+	}
+
+	const unsigned int dropped = GetLiveBridgeLogDropped() - dropped_before;
+	drained = DrainLiveBridgeLog();
+
+	printf("deferred log - drained %d, dropped %u, %s\n", drained, dropped, logger.m_LastWarning);
+	_ASSERT(drained + static_cast<int>(dropped) == 2 * LOG_TEST_OVERFLOW_SESSIONS);
+	_ASSERT(dropped > 0 && strstr(logger.m_LastWarning, std::to_string(dropped).c_str()) != nullptr);
+
+	// a library thread drains a ring on its own while a session is alive
+	const int total = logger.GetTotal();
+	SetLiveBridgeLogMode(ELiveBridgeLogMode_DeferredThread);
+
+	const unsigned int keep_session_id = NewLiveSession();
+
+	for (int i = 0; i < LOG_TEST_SESSIONS; ++i)
+	{
+		FreeLiveSession(NewLiveSession());
+	}
+	for (int i = 0; i < 1000 && logger.GetTotal() < total + 1 + 2 * LOG_TEST_SESSIONS; ++i)
+	{
+		constexpr std::chrono::milliseconds timespan(1);
+		std::this_thread::sleep_for(timespan);
+	}
+	_ASSERT(logger.GetTotal() == total + 1 + 2 * LOG_TEST_SESSIONS);
+
+	// a free of the last session joins the thread and drains its own message on a calling thread
+	FreeLiveSession(keep_session_id);
+	_ASSERT(logger.GetTotal() == total + 2 + 2 * LOG_TEST_SESSIONS);
+
+	SetLiveBridgeLogMode(ELiveBridgeLogMode_Immediate);
+	SetVerboseLevel(0);
+	SetLiveBridgeLogger(nullptr);
+}
 
 int main()
 {
@@ -294,6 +2933,237 @@ int main()
 		server_thread.join();
 	}
 
+	// Test 3 - zero-copy
+	printf("\n=== Test 3 ===\n");
+	{
+		std::thread server_thread(server_zerocopy);
+		std::thread client_thread(client_zerocopy);
+
+		client_thread.join();
+		server_thread.join();
+	}
+
+	// Test 4 - latest value exchange
+	printf("\n=== Test 4 ===\n");
+	{
+		std::thread server_thread(server_latest);
+		std::thread client_thread(client_latest);
+
+		client_thread.join();
+		server_thread.join();
+	}
+
+	// Test 5 - network tcp loopback
+	printf("\n=== Test 5 ===\n");
+	{
+		std::thread server_thread(server_network);
+		std::thread client_thread(client_network);
+
+		client_thread.join();
+		server_thread.join();
+	}
+
+	// Test 6 - multicast fan-out
+	printf("\n=== Test 6 ===\n");
+	{
+		std::thread server_thread(server_multicast);
+		std::thread client_threads[MULTICAST_TEST_VIEWERS];
+
+		for (int i = 0; i < MULTICAST_TEST_VIEWERS; ++i)
+		{
+			client_threads[i] = std::thread(client_multicast);
+		}
+
+		for (int i = 0; i < MULTICAST_TEST_VIEWERS; ++i)
+		{
+			client_threads[i].join();
+		}
+		server_thread.join();
+
+		multicast_restart();
+	}
+
+	// Test 7 - pose codec
+	printf("\n=== Test 7 ===\n");
+	{
+		pose_codec();
+	}
+
+	// Test 8 - large rig, shared memory and tcp
+	printf("\n=== Test 8 ===\n");
+	{
+		const int communication_types[2] = { static_cast<int>(ECommunicationType::SharedMemory), static_cast<int>(ECommunicationType::NetworkTCP) };
+
+		for (const int communication_type : communication_types)
+		{
+			std::thread server_thread(server_large, communication_type);
+			std::thread client_thread(client_large, communication_type);
+
+			client_thread.join();
+			server_thread.join();
+		}
+	}
+
+	// Test 9 - multi-entity frame, shared memory and tcp
+	printf("\n=== Test 9 ===\n");
+	{
+		const int communication_types[2] = { static_cast<int>(ECommunicationType::SharedMemory), static_cast<int>(ECommunicationType::NetworkTCP) };
+
+		for (const int communication_type : communication_types)
+		{
+			std::thread server_thread(server_entities, communication_type);
+			std::thread client_thread(client_entities, communication_type);
+
+			client_thread.join();
+			server_thread.join();
+		}
+	}
+
+	// Test 10 - wait for frame, shared memory and tcp
+	printf("\n=== Test 10 ===\n");
+	{
+		const int communication_types[2] = { static_cast<int>(ECommunicationType::SharedMemory), static_cast<int>(ECommunicationType::NetworkTCP) };
+
+		for (const int communication_type : communication_types)
+		{
+			std::thread server_thread(server_wait, communication_type);
+			std::thread client_thread(client_wait, communication_type);
+
+			client_thread.join();
+			server_thread.join();
+		}
+	}
+
+	// Test 11 - io thread, shared memory and tcp
+	printf("\n=== Test 11 ===\n");
+	{
+		const int communication_types[2] = { static_cast<int>(ECommunicationType::SharedMemory), static_cast<int>(ECommunicationType::NetworkTCP) };
+
+		for (const int communication_type : communication_types)
+		{
+			g_IOClientDone.store(false);
+
+			std::thread server_thread(server_io, communication_type);
+			std::thread client_thread(client_io, communication_type);
+
+			client_thread.join();
+			server_thread.join();
+		}
+	}
+
+	// Test 12 - session registry
+	printf("\n=== Test 12 ===\n");
+	{
+		session_registry();
+	}
+
+	// Test 13 - take recording and replay
+	printf("\n=== Test 13 ===\n");
+	{
+		std::thread server_thread(take_record_server);
+		std::thread client_thread(take_client, "test_pair_take");
+
+		client_thread.join();
+		server_thread.join();
+
+		std::thread replay_thread(take_replay_server);
+		std::thread replay_client_thread(take_client, "test_pair_take_replay");
+
+		replay_client_thread.join();
+		replay_thread.join();
+
+		std::remove(TAKE_TEST_FILE);
+	}
+
+	// Test 14 - client jitter buffer
+	printf("\n=== Test 14 ===\n");
+	{
+		std::thread server_thread(jitter_server);
+		std::thread client_thread(jitter_client);
+
+		client_thread.join();
+		server_thread.join();
+	}
+
+	// Test 15 - joint schema
+	printf("\n=== Test 15 ===\n");
+	{
+		std::thread server_thread(server_schema);
+		std::thread client_thread(client_schema);
+
+		client_thread.join();
+		server_thread.join();
+	}
+
+	// Test 16 - stable name hash and collisions
+	printf("\n=== Test 16 ===\n");
+	{
+		name_hash();
+	}
+
+	// Test 17 - structure of arrays ingestion
+	printf("\n=== Test 17 ===\n");
+	{
+		soa_ingestion();
+	}
+
+	// Test 18 - transform math kernels
+	printf("\n=== Test 18 ===\n");
+	{
+		transform_math();
+	}
+
+	// Test 19 - local and model joint space
+	printf("\n=== Test 19 ===\n");
+	{
+		joint_space();
+	}
+
+	// Test 20 - frame ready handle, shared memory and tcp
+	printf("\n=== Test 20 ===\n");
+	{
+		const int communication_types[2] = { static_cast<int>(ECommunicationType::SharedMemory), static_cast<int>(ECommunicationType::NetworkTCP) };
+
+		for (const int communication_type : communication_types)
+		{
+			g_IOClientDone.store(false);
+
+			std::thread server_thread(server_io, communication_type);
+			std::thread client_thread(client_io_handle, communication_type);
+
+			client_thread.join();
+			server_thread.join();
+		}
+	}
+
+	// Test 21 - deferred log ring buffer
+	printf("\n=== Test 21 ===\n");
+	{
+		deferred_log();
+	}
+
+	// Test 22 - typed property channels
+	printf("\n=== Test 22 ===\n");
+	{
+		std::thread server_thread(server_channels);
+		std::thread client_thread(client_channels);
+
+		client_thread.join();
+		server_thread.join();
+
+		channels_capacity();
+	}
+
+	// Test 23 - network clock offset and frame age
+	printf("\n=== Test 23 ===\n");
+	{
+		std::thread server_thread(server_clock);
+		std::thread client_thread(client_clock);
+
+		client_thread.join();
+		server_thread.join();
+	}
+
 	getchar();
 	return 0;
 }
\ No newline at end of file